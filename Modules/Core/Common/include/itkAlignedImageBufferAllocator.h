@@ -0,0 +1,87 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAlignedImageBufferAllocator_h
+#define itkAlignedImageBufferAllocator_h
+
+#include "itkImageBufferAllocator.h"
+#include "itkObjectFactory.h"
+
+namespace itk
+{
+/** \class AlignedImageBufferAllocator
+ * \brief Allocates image buffers aligned for vector loads and stores.
+ *
+ * The buffers are aligned to 64 bytes by default, the size of a cache line
+ * and of an AVX-512 register, so that vectorized loops over the pixels do
+ * not need a peeled prologue, and that no cache line is shared by two
+ * images.
+ *
+ * \sa ImageBufferAllocator
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT AlignedImageBufferAllocator : public ImageBufferAllocator
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AlignedImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = AlignedImageBufferAllocator;
+  using Superclass = ImageBufferAllocator;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(AlignedImageBufferAllocator);
+
+  void *
+  Allocate(SizeValueType numberOfBytes, bool zeroInitialize) override;
+
+  void
+  Deallocate(void * buffer, SizeValueType numberOfBytes) override;
+
+  [[nodiscard]] SizeValueType
+  GetAlignment() const override
+  {
+    return m_Alignment;
+  }
+
+  /** Set the alignment of the buffers, a power of two. Defaults to 64. */
+  void
+  SetAlignment(SizeValueType alignment);
+
+protected:
+  AlignedImageBufferAllocator() = default;
+  ~AlignedImageBufferAllocator() override = default;
+
+  /** Allocate numberOfBytes bytes aligned to alignment, a power of two, or
+   * return null. The buffer is freed by FreeAligned(). */
+  static void *
+  AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment);
+
+  static void
+  FreeAligned(void * buffer);
+
+private:
+  SizeValueType m_Alignment{ 64 };
+};
+} // end namespace itk
+
+#endif
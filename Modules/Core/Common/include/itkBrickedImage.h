@@ -0,0 +1,246 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBrickedImage_h
+#define itkBrickedImage_h
+
+#include "itkImageBase.h"
+#include "itkImportImageContainer.h"
+
+#include <array>
+#include <vector>
+
+namespace itk
+{
+/** \class BrickedImage
+ * \brief Image whose pixels are stored in bricks of VBrickSize pixels along
+ * each dimension.
+ *
+ * The pixels of an Image are stored row by row, so that the neighbors of a
+ * pixel along the slowest dimension of a 3D image are a slice apart in the
+ * buffer: neighborhood operations on large volumes touch as many pages and
+ * cache lines as there are slices in the neighborhood. A BrickedImage stores
+ * each brick of VBrickSize^VImageDimension pixels contiguously, row by row
+ * within the brick, and the bricks one after the other, row by row. The
+ * pixels of a small neighborhood are then in one or a few bricks, that is
+ * in a few contiguous blocks of memory, whatever the dimension.
+ *
+ * The buffered region is padded to a whole number of bricks along each
+ * dimension. The offset of a pixel in the buffer is the sum over the
+ * dimensions of the entries of per-dimension tables, GetBrickOffsetTable(),
+ * so that it is computed without divisions.
+ *
+ * Since its buffer is not row-major, a BrickedImage is not iterated by the
+ * image iterators, but by BrickedImageRegionRange and
+ * BrickedImageNeighborhoodRange, which have the interface of
+ * ImageRegionRange and ShapedImageNeighborhoodRange: code written in terms
+ * of these ranges processes both layouts.
+ *
+ * \sa Image
+ * \sa BrickedImageRegionRange
+ * \sa BrickedImageNeighborhoodRange
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+template <typename TPixel, unsigned int VImageDimension = 3, unsigned int VBrickSize = 8>
+class ITK_TEMPLATE_EXPORT BrickedImage : public ImageBase<VImageDimension>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(BrickedImage);
+
+  static_assert(VBrickSize > 0, "The bricks must not be empty.");
+
+  /** Standard class type aliases */
+  using Self = BrickedImage;
+  using Superclass = ImageBase<VImageDimension>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(BrickedImage);
+
+  /** Pixel type alias support. */
+  using PixelType = TPixel;
+  using ValueType = TPixel;
+  using InternalPixelType = TPixel;
+
+  using typename Superclass::ImageDimensionType;
+  using typename Superclass::IndexType;
+  using typename Superclass::IndexValueType;
+  using typename Superclass::OffsetType;
+  using typename Superclass::OffsetValueType;
+  using typename Superclass::SizeType;
+  using typename Superclass::SizeValueType;
+  using typename Superclass::RegionType;
+  using typename Superclass::DirectionType;
+  using typename Superclass::SpacingType;
+  using typename Superclass::SpacingValueType;
+  using typename Superclass::PointType;
+
+  /** Container used to store the bricks. */
+  using PixelContainer = ImportImageContainer<SizeValueType, PixelType>;
+  using PixelContainerPointer = typename PixelContainer::Pointer;
+
+  /** Number of pixels of a brick along each dimension, and in total. */
+  static constexpr unsigned int  BrickSize = VBrickSize;
+  static constexpr SizeValueType PixelsPerBrick = Math::UnsignedPower<SizeValueType>(VBrickSize, VImageDimension);
+
+  template <typename UPixelType, unsigned int VUImageDimension = VImageDimension>
+  using RebindImageType = BrickedImage<UPixelType, VUImageDimension, VBrickSize>;
+
+  /** Allocate the bricks of the buffered region, which must already be set,
+   * e.g. by calling SetRegions(). */
+  void
+  Allocate(bool initializePixels = false) override;
+
+  /** Restore the data object to its initial state, releasing the memory. */
+  void
+  Initialize() override;
+
+  /** Set the buffered region, and compute the tables of the offsets of its
+   * pixels in the bricks. */
+  void
+  SetBufferedRegion(const RegionType & region) override;
+
+  /** Fill the bricks with a value. */
+  void
+  FillBuffer(const TPixel & value);
+
+  /** Offset in the buffer of the pixel at an index of the buffered region. */
+  OffsetValueType
+  ComputeBrickOffset(const IndexType & index) const
+  {
+    const IndexType & bufferedIndex = this->GetBufferedRegion().GetIndex();
+    OffsetValueType   offset = 0;
+    for (unsigned int i = 0; i < VImageDimension; ++i)
+    {
+      offset += m_BrickOffsetTables[i][index[i] - bufferedIndex[i]];
+    }
+    return offset;
+  }
+
+  /** Table of the contributions to the offset in the buffer of the
+   * coordinates along a dimension, relative to the index of the buffered
+   * region: the offset of the pixel at index is the sum of the
+   * GetBrickOffsetTable(i)[index[i] - GetBufferedRegion().GetIndex()[i]]. */
+  const OffsetValueType *
+  GetBrickOffsetTable(unsigned int dimension) const
+  {
+    return m_BrickOffsetTables[dimension].data();
+  }
+
+  /** Set/Get a pixel. For efficiency, these do not check that the image has
+   * been allocated. */
+  /** @ITKStartGrouping */
+  void
+  SetPixel(const IndexType & index, const TPixel & value)
+  {
+    (*m_Buffer)[this->ComputeBrickOffset(index)] = value;
+  }
+  const TPixel &
+  GetPixel(const IndexType & index) const
+  {
+    return (*m_Buffer)[this->ComputeBrickOffset(index)];
+  }
+  TPixel &
+  GetPixel(const IndexType & index)
+  {
+    return (*m_Buffer)[this->ComputeBrickOffset(index)];
+  }
+  TPixel &
+  operator[](const IndexType & index)
+  {
+    return this->GetPixel(index);
+  }
+  const TPixel &
+  operator[](const IndexType & index) const
+  {
+    return this->GetPixel(index);
+  }
+  /** @ITKEndGrouping */
+
+  /** Return a pointer to the first pixel of the first brick. */
+  /** @ITKStartGrouping */
+  TPixel *
+  GetBufferPointer()
+  {
+    return m_Buffer ? m_Buffer->GetBufferPointer() : nullptr;
+  }
+  const TPixel *
+  GetBufferPointer() const
+  {
+    return m_Buffer ? m_Buffer->GetBufferPointer() : nullptr;
+  }
+  /** @ITKEndGrouping */
+
+  /** Return the container of the bricks. */
+  /** @ITKStartGrouping */
+  PixelContainer *
+  GetPixelContainer()
+  {
+    return m_Buffer.GetPointer();
+  }
+  const PixelContainer *
+  GetPixelContainer() const
+  {
+    return m_Buffer.GetPointer();
+  }
+  /** @ITKEndGrouping */
+
+  /** Number of bricks of the buffered region along each dimension. */
+  const SizeType &
+  GetNumberOfBricks() const
+  {
+    return m_NumberOfBricks;
+  }
+
+  /** Graft the meta-data and the bricks of another bricked image. */
+  virtual void
+  Graft(const Self * image);
+
+  [[nodiscard]] unsigned int
+  GetNumberOfComponentsPerPixel() const override;
+
+protected:
+  BrickedImage() = default;
+  ~BrickedImage() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+  void
+  Graft(const DataObject * data) override;
+  using Superclass::Graft;
+
+private:
+  void
+  ComputeBrickOffsetTables();
+
+  PixelContainerPointer m_Buffer{ PixelContainer::New() };
+
+  SizeType m_NumberOfBricks{ {} };
+
+  std::array<std::vector<OffsetValueType>, VImageDimension> m_BrickOffsetTables{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkBrickedImage.hxx"
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBrickedImage_hxx
+#define itkBrickedImage_hxx
+
+#include "itkNumericTraits.h"
+#include <algorithm>
+
+namespace itk
+{
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::Allocate(bool initializePixels)
+{
+  this->ComputeOffsetTable();
+  this->ComputeBrickOffsetTables();
+
+  // The bricks are padded, so that the buffer holds whole bricks.
+  const SizeValueType numberOfBricks = m_NumberOfBricks.CalculateProductOfElements();
+  m_Buffer->Reserve(numberOfBricks * PixelsPerBrick, initializePixels);
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::Initialize()
+{
+  // As Image::Initialize(), does not modify the image.
+  Superclass::Initialize();
+  this->ComputeBrickOffsetTables();
+  m_Buffer = PixelContainer::New();
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::SetBufferedRegion(const RegionType & region)
+{
+  Superclass::SetBufferedRegion(region);
+  this->ComputeBrickOffsetTables();
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::FillBuffer(const TPixel & value)
+{
+  std::fill_n(m_Buffer->GetBufferPointer(), m_Buffer->Size(), value);
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::ComputeBrickOffsetTables()
+{
+  const SizeType & size = this->GetBufferedRegion().GetSize();
+
+  // Offset between consecutive pixels within a brick, and between
+  // consecutive bricks, along each dimension.
+  OffsetValueType pixelStride = 1;
+  auto            brickStride = static_cast<OffsetValueType>(PixelsPerBrick);
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    m_NumberOfBricks[i] = (size[i] + VBrickSize - 1) / VBrickSize;
+
+    std::vector<OffsetValueType> & table = m_BrickOffsetTables[i];
+    table.resize(size[i]);
+    for (SizeValueType x = 0; x < size[i]; ++x)
+    {
+      table[x] = static_cast<OffsetValueType>(x / VBrickSize) * brickStride +
+                 static_cast<OffsetValueType>(x % VBrickSize) * pixelStride;
+    }
+    pixelStride *= VBrickSize;
+    brickStride *= static_cast<OffsetValueType>(m_NumberOfBricks[i]);
+  }
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::Graft(const Self * image)
+{
+  Superclass::Graft(image);
+
+  if (image)
+  {
+    m_Buffer = const_cast<PixelContainer *>(image->GetPixelContainer());
+  }
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::Graft(const DataObject * data)
+{
+  if (data)
+  {
+    const auto * const imgData = dynamic_cast<const Self *>(data);
+
+    if (imgData != nullptr)
+    {
+      this->Graft(imgData);
+    }
+    else
+    {
+      itkExceptionMacro("itk::BrickedImage::Graft() cannot cast " << typeid(data).name() << " to "
+                                                                  << typeid(const Self *).name());
+    }
+  }
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+unsigned int
+BrickedImage<TPixel, VImageDimension, VBrickSize>::GetNumberOfComponentsPerPixel() const
+{
+  return NumericTraits<PixelType>::GetLength({});
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, unsigned int VBrickSize>
+void
+BrickedImage<TPixel, VImageDimension, VBrickSize>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BrickSize: " << VBrickSize << std::endl;
+  os << indent << "NumberOfBricks: " << m_NumberOfBricks << std::endl;
+  os << indent << "PixelContainer: " << std::endl;
+  m_Buffer->Print(os, indent.GetNextIndent());
+}
+
+} // end namespace itk
+
+#endif
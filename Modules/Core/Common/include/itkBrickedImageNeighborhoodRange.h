@@ -0,0 +1,453 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkBrickedImageNeighborhoodRange_h
+#define itkBrickedImageNeighborhoodRange_h
+
+#include <algorithm> // For clamp and max.
+#include <array>
+#include <cassert>
+#include <cstddef>     // For ptrdiff_t.
+#include <cstdlib>     // For abs.
+#include <iterator>    // For random_access_iterator_tag.
+#include <type_traits> // For conditional_t and is_const_v.
+#include <vector>
+
+#include "itkBrickedImage.h"
+
+namespace itk
+{
+
+/**
+ * \class BrickedImageNeighborhoodRange
+ * Range of the pixels of a neighborhood in a BrickedImage, with the interface
+ * of ShapedImageNeighborhoodRange, and the same boundary condition as its
+ * default pixel access policy: the pixels outside of the buffered region are
+ * those of the nearest pixel of the boundary (zero-flux Neumann).
+ *
+ * The range is aware of the bricks: SetLocation() checks whether the whole
+ * neighborhood lies in the brick of its location. It then does, for most
+ * locations of a small neighborhood, and the offsets of the neighbors from
+ * the location are those within a brick, computed once when the range is
+ * constructed: a neighbor is accessed with a single addition, whatever its
+ * dimension. Otherwise, the offsets of the neighbors are computed by
+ * SetLocation() from the brick offset tables of the image, with the
+ * coordinates clamped to the buffered region.
+ *
+ * The iterators of the range are invalidated by SetLocation().
+ *
+ * \see BrickedImage
+ * \see ShapedImageNeighborhoodRange
+ * \see BrickedImageRegionRange
+ * \ingroup ImageIterators
+ * \ingroup ITKCommon
+ */
+template <typename TImage>
+class BrickedImageNeighborhoodRange final
+{
+private:
+  using ImageDimensionType = typename TImage::ImageDimensionType;
+  using PixelType = typename TImage::PixelType;
+
+  static constexpr bool               IsImageTypeConst = std::is_const_v<TImage>;
+  static constexpr ImageDimensionType ImageDimension = TImage::ImageDimension;
+  static constexpr OffsetValueType    BrickSize = TImage::BrickSize;
+
+  using IndexType = typename TImage::IndexType;
+  using OffsetType = typename TImage::OffsetType;
+  using SizeType = typename TImage::SizeType;
+
+  using QualifiedPixelType = std::conditional_t<IsImageTypeConst, const PixelType, PixelType>;
+
+  /**
+   * \class QualifiedIterator
+   * Iterator class that is either 'const' or non-const qualified.
+   *
+   * \note The definition of this class is private. Please use its type alias
+   * BrickedImageNeighborhoodRange::iterator, or BrickedImageNeighborhoodRange::const_iterator!
+   * \see BrickedImageNeighborhoodRange
+   * \ingroup ImageIterators
+   * \ingroup ITKCommon
+   */
+  template <bool VIsConst>
+  class QualifiedIterator final
+  {
+  private:
+    friend class QualifiedIterator<!VIsConst>;
+    friend class BrickedImageNeighborhoodRange;
+
+    using IteratorPixelType = std::conditional_t<VIsConst, const PixelType, PixelType>;
+
+    // The pixel from which the offsets of the neighbors are counted.
+    IteratorPixelType * m_Base{ nullptr };
+
+    // Offset of the current neighbor.
+    const OffsetValueType * m_Offset{ nullptr };
+
+    QualifiedIterator(IteratorPixelType * base, const OffsetValueType * offset) noexcept
+      : m_Base(base)
+      , m_Offset(offset)
+    {}
+
+  public:
+    // Types conforming the iterator requirements of the C++ standard library:
+    using difference_type = ptrdiff_t;
+    using value_type = PixelType;
+    using reference = IteratorPixelType &;
+    using pointer = IteratorPixelType *;
+    using iterator_category = std::random_access_iterator_tag;
+
+    /** Default-constructor, as required for any C++11 Forward Iterator. */
+    QualifiedIterator() = default;
+
+    /** Constructor for implicit conversion from non-const to const iterator.  */
+    template <bool VIsArgumentConst, typename = std::enable_if_t<VIsConst && !VIsArgumentConst>>
+    QualifiedIterator(const QualifiedIterator<VIsArgumentConst> & arg) noexcept
+      : m_Base(arg.m_Base)
+      , m_Offset(arg.m_Offset)
+    {}
+
+    /**  Returns a reference to the current neighbor. */
+    reference
+    operator*() const noexcept
+    {
+      return m_Base[*m_Offset];
+    }
+
+    /** Returns it[n] for iterator 'it' and integer value 'n'. */
+    reference
+    operator[](const difference_type n) const noexcept
+    {
+      return m_Base[m_Offset[n]];
+    }
+
+    QualifiedIterator &
+    operator++() noexcept
+    {
+      ++m_Offset;
+      return *this;
+    }
+
+    QualifiedIterator
+    operator++(int) noexcept
+    {
+      auto result = *this;
+      ++m_Offset;
+      return result;
+    }
+
+    QualifiedIterator &
+    operator--() noexcept
+    {
+      --m_Offset;
+      return *this;
+    }
+
+    QualifiedIterator
+    operator--(int) noexcept
+    {
+      auto result = *this;
+      --m_Offset;
+      return result;
+    }
+
+    QualifiedIterator &
+    operator+=(const difference_type n) noexcept
+    {
+      m_Offset += n;
+      return *this;
+    }
+
+    QualifiedIterator &
+    operator-=(const difference_type n) noexcept
+    {
+      m_Offset -= n;
+      return *this;
+    }
+
+    friend QualifiedIterator
+    operator+(QualifiedIterator it, const difference_type n) noexcept
+    {
+      return it += n;
+    }
+
+    friend QualifiedIterator
+    operator+(const difference_type n, QualifiedIterator it) noexcept
+    {
+      return it += n;
+    }
+
+    friend QualifiedIterator
+    operator-(QualifiedIterator it, const difference_type n) noexcept
+    {
+      return it -= n;
+    }
+
+    friend difference_type
+    operator-(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return lhs.m_Offset - rhs.m_Offset;
+    }
+
+    friend bool
+    operator==(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return lhs.m_Offset == rhs.m_Offset;
+    }
+
+    friend bool
+    operator!=(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
+
+    friend bool
+    operator<(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return lhs.m_Offset < rhs.m_Offset;
+    }
+
+    friend bool
+    operator>(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return rhs < lhs;
+    }
+
+    friend bool
+    operator<=(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return !(rhs < lhs);
+    }
+
+    friend bool
+    operator>=(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return !(lhs < rhs);
+    }
+  };
+
+  // BrickedImageNeighborhoodRange data members (strictly private):
+
+  QualifiedPixelType * m_Buffer{ nullptr };
+
+  // The brick offset tables of the image.
+  std::array<const OffsetValueType *, ImageDimension> m_Tables{};
+
+  IndexType m_BufferedRegionIndex{ {} };
+  SizeType  m_BufferedRegionSize{ {} };
+
+  // The offsets relative to the location that specify the neighborhood shape.
+  const OffsetType * m_ShapeOffsets{ nullptr };
+  size_t             m_NumberOfNeighborhoodPixels{ 0 };
+
+  // Largest absolute coordinate of the shape offsets along each dimension.
+  OffsetType m_Radius{ {} };
+
+  // The offsets of the neighbors from their location, when they are in its
+  // brick.
+  std::vector<OffsetValueType> m_OffsetsWithinBrick{};
+
+  // The offsets of the neighbors from the first pixel of the buffer,
+  // otherwise.
+  std::vector<OffsetValueType> m_OffsetsFromBuffer{};
+
+  // The pixel from which the offsets are counted, for the current location,
+  // and whether its neighbors are in its brick.
+  QualifiedPixelType * m_Base{ nullptr };
+  bool                 m_IsWithinBrick{ false };
+
+  const OffsetValueType *
+  GetOffsets() const noexcept
+  {
+    return m_IsWithinBrick ? m_OffsetsWithinBrick.data() : m_OffsetsFromBuffer.data();
+  }
+
+public:
+  using const_iterator = QualifiedIterator<true>;
+  using iterator = QualifiedIterator<IsImageTypeConst>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /** Constructs an empty range. */
+  BrickedImageNeighborhoodRange() = default;
+
+  /** Specifies a range for the neighborhood of a pixel at the specified
+   * location. The shape of the neighborhood is specified by a pointer to a
+   * contiguous sequence of offsets, relative to the location index.
+   * \note The caller (the client code) should ensure that both the specified
+   * image and the specified shape offsets remain alive while the range (or one
+   * of its iterators) is being used.
+   */
+  BrickedImageNeighborhoodRange(TImage &                 image,
+                                const IndexType &        location,
+                                const OffsetType * const shapeOffsets,
+                                const size_t             numberOfNeighborhoodPixels)
+    : m_Buffer(image.GetBufferPointer())
+    , m_BufferedRegionIndex(image.GetBufferedRegion().GetIndex())
+    , m_BufferedRegionSize(image.GetBufferedRegion().GetSize())
+    , m_ShapeOffsets(shapeOffsets)
+    , m_NumberOfNeighborhoodPixels(numberOfNeighborhoodPixels)
+    , m_OffsetsWithinBrick(numberOfNeighborhoodPixels)
+    , m_OffsetsFromBuffer(numberOfNeighborhoodPixels)
+  {
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      m_Tables[i] = image.GetBrickOffsetTable(i);
+    }
+    for (size_t n = 0; n < numberOfNeighborhoodPixels; ++n)
+    {
+      OffsetValueType stride = 1;
+      m_OffsetsWithinBrick[n] = 0;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        m_Radius[i] = std::max(m_Radius[i], std::abs(shapeOffsets[n][i]));
+        m_OffsetsWithinBrick[n] += shapeOffsets[n][i] * stride;
+        stride *= BrickSize;
+      }
+    }
+    this->SetLocation(location);
+  }
+
+  /** Specifies a range for the neighborhood of a pixel at the specified
+   * location. The shape of the neighborhood is specified by a contiguous
+   * container of offsets, e.g. std::vector<OffsetType>.
+   */
+  template <typename TContainerOfOffsets>
+  BrickedImageNeighborhoodRange(TImage & image, const IndexType & location, const TContainerOfOffsets & shapeOffsets)
+    : BrickedImageNeighborhoodRange{ image, location, std::data(shapeOffsets), std::size(shapeOffsets) }
+  {}
+
+  /** Returns an iterator to the first neighborhood pixel. */
+  [[nodiscard]] iterator
+  begin() const noexcept
+  {
+    return iterator{ m_Base, this->GetOffsets() };
+  }
+
+  /** Returns an 'end iterator' for this range. */
+  [[nodiscard]] iterator
+  end() const noexcept
+  {
+    return iterator{ m_Base, this->GetOffsets() + m_NumberOfNeighborhoodPixels };
+  }
+
+  /** Returns a const iterator to the first neighborhood pixel. */
+  [[nodiscard]] const_iterator
+  cbegin() const noexcept
+  {
+    return this->begin();
+  }
+
+  /** Returns a const 'end iterator' for this range. */
+  [[nodiscard]] const_iterator
+  cend() const noexcept
+  {
+    return this->end();
+  }
+
+  /** Returns a reverse 'begin iterator' for this range. */
+  [[nodiscard]] reverse_iterator
+  rbegin() const noexcept
+  {
+    return reverse_iterator(this->end());
+  }
+
+  /** Returns a reverse 'end iterator' for this range. */
+  [[nodiscard]] reverse_iterator
+  rend() const noexcept
+  {
+    return reverse_iterator(this->begin());
+  }
+
+  /** Returns the number of neighborhood pixels. */
+  [[nodiscard]] size_t
+  size() const noexcept
+  {
+    return m_NumberOfNeighborhoodPixels;
+  }
+
+  /** Tells whether the range is empty. */
+  [[nodiscard]] bool
+  empty() const noexcept
+  {
+    return m_NumberOfNeighborhoodPixels == 0;
+  }
+
+  /** Subscript operator. Allows random access, to the nth neighbor pixel. */
+  typename iterator::reference
+  operator[](const size_t n) const noexcept
+  {
+    assert(n < this->size());
+    return m_Base[this->GetOffsets()[n]];
+  }
+
+  /** Tells whether the neighborhood of the current location lies in a
+   * single brick, within the buffered region. */
+  [[nodiscard]] bool
+  IsWithinBrick() const noexcept
+  {
+    return m_IsWithinBrick;
+  }
+
+  /** Sets the location of this neighborhood by specifying its pixel index.
+   * Typically, this is the index of the center pixel of the neighborhood.
+   */
+  void
+  SetLocation(const IndexType & location) noexcept
+  {
+    OffsetType relativeLocation;
+    m_IsWithinBrick = true;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      relativeLocation[i] = location[i] - m_BufferedRegionIndex[i];
+      const OffsetValueType coordinateInBrick = relativeLocation[i] % BrickSize;
+      m_IsWithinBrick = m_IsWithinBrick && relativeLocation[i] >= m_Radius[i] &&
+                      relativeLocation[i] + m_Radius[i] < static_cast<OffsetValueType>(m_BufferedRegionSize[i]) &&
+                      coordinateInBrick >= m_Radius[i] && coordinateInBrick + m_Radius[i] < BrickSize;
+    }
+
+    if (m_IsWithinBrick)
+    {
+      OffsetValueType locationOffset = 0;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        locationOffset += m_Tables[i][relativeLocation[i]];
+      }
+      m_Base = m_Buffer + locationOffset;
+      return;
+    }
+
+    for (size_t n = 0; n < m_NumberOfNeighborhoodPixels; ++n)
+    {
+      OffsetValueType offset = 0;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        const OffsetValueType coordinate = std::clamp(relativeLocation[i] + m_ShapeOffsets[n][i],
+                                                      OffsetValueType{ 0 },
+                                                      static_cast<OffsetValueType>(m_BufferedRegionSize[i]) - 1);
+        offset += m_Tables[i][coordinate];
+      }
+      m_OffsetsFromBuffer[n] = offset;
+    }
+    m_Base = m_Buffer;
+  }
+};
+
+} // namespace itk
+
+#endif
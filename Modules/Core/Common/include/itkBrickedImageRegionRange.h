@@ -0,0 +1,394 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkBrickedImageRegionRange_h
+#define itkBrickedImageRegionRange_h
+
+#include <array>
+#include <cstddef>     // For ptrdiff_t.
+#include <iterator>    // For bidirectional_iterator_tag.
+#include <type_traits> // For conditional_t and is_const_v.
+
+#include "itkBrickedImage.h"
+
+namespace itk
+{
+
+/**
+ * \class BrickedImageRegionRange
+ * Range of the pixels of a region of a BrickedImage, in the same order as
+ * ImageRegionRange iterates over the pixels of an Image: the pixels of a row
+ * one after the other, and the rows one after the other. It has the interface
+ * of ImageRegionRange, so that code written in terms of ImageRegionRange is
+ * written for both layouts, e.g.:
+   \code
+   std::copy(ImageRegionRange{ *image, region }.cbegin(),
+             ImageRegionRange{ *image, region }.cend(),
+             BrickedImageRegionRange{ *brickedImage, region }.begin());
+   \endcode
+ *
+ * The offset of each pixel is the sum of the entries of the brick offset
+ * tables of the image, BrickedImage::GetBrickOffsetTable(), for its
+ * coordinates: only the entry of the first dimension changes from one pixel
+ * of a row to the next.
+ *
+ * \see BrickedImage
+ * \see ImageRegionRange
+ * \see BrickedImageNeighborhoodRange
+ * \ingroup ImageIterators
+ * \ingroup ITKCommon
+ */
+template <typename TImage>
+class BrickedImageRegionRange final
+{
+private:
+  using Self = BrickedImageRegionRange;
+  using ImageDimensionType = typename TImage::ImageDimensionType;
+  using PixelType = typename TImage::PixelType;
+
+  static constexpr bool               IsImageTypeConst = std::is_const_v<TImage>;
+  static constexpr ImageDimensionType ImageDimension = TImage::ImageDimension;
+
+  using RegionType = typename TImage::RegionType;
+  using SizeType = typename TImage::SizeType;
+  using IndexType = typename TImage::IndexType;
+  using OffsetType = typename TImage::OffsetType;
+  using TableArrayType = std::array<const OffsetValueType *, ImageDimension>;
+
+  /**
+   * \class QualifiedIterator
+   * Iterator class that is either 'const' or non-const qualified.
+   *
+   * \note The definition of this class is private. Please use its type alias
+   * BrickedImageRegionRange::iterator, or BrickedImageRegionRange::const_iterator!
+   * \see BrickedImageRegionRange
+   * \ingroup ImageIterators
+   * \ingroup ITKCommon
+   */
+  template <bool VIsConst>
+  class QualifiedIterator final
+  {
+  private:
+    friend class QualifiedIterator<!VIsConst>;
+    friend class BrickedImageRegionRange;
+
+    using QualifiedPixelType = std::conditional_t<VIsConst, const PixelType, PixelType>;
+
+    // First pixel of the buffer.
+    QualifiedPixelType * m_Buffer{ nullptr };
+
+    // The brick offset tables of the image.
+    TableArrayType m_Tables{};
+
+    // Sum of the entries of the tables for the coordinates of the current
+    // row, that is for all but the first dimension.
+    OffsetValueType m_RowOffset{ 0 };
+
+    // Coordinates of the current pixel, relative to the buffered region.
+    OffsetType m_Position{ {} };
+
+    // Coordinates of the first pixel, and of the end, of the iteration
+    // region, relative to the buffered region.
+    OffsetType m_RegionBegin{ {} };
+    OffsetType m_RegionEnd{ {} };
+
+    QualifiedIterator(QualifiedPixelType *   buffer,
+                      const TableArrayType & tables,
+                      const OffsetType &     position,
+                      const OffsetType &     regionBegin,
+                      const OffsetType &     regionEnd) noexcept
+      : m_Buffer(buffer)
+      , m_Tables(tables)
+      , m_Position(position)
+      , m_RegionBegin(regionBegin)
+      , m_RegionEnd(regionEnd)
+    {
+      this->ComputeRowOffset();
+    }
+
+    void
+    ComputeRowOffset() noexcept
+    {
+      m_RowOffset = 0;
+      if (m_Buffer != nullptr && m_Position.back() < m_RegionEnd.back())
+      {
+        for (unsigned int i = 1; i < ImageDimension; ++i)
+        {
+          m_RowOffset += m_Tables[i][m_Position[i]];
+        }
+      }
+    }
+
+    // Moves to the next row, once the current one is done.
+    void
+    NextRow() noexcept
+    {
+      for (unsigned int i = 1; i < ImageDimension; ++i)
+      {
+        m_Position[i - 1] = m_RegionBegin[i - 1];
+        if (++m_Position[i] < m_RegionEnd[i] || i == ImageDimension - 1)
+        {
+          break;
+        }
+      }
+      this->ComputeRowOffset();
+    }
+
+    // Moves to the last pixel of the previous row.
+    void
+    PreviousRow() noexcept
+    {
+      for (unsigned int i = 1; i < ImageDimension; ++i)
+      {
+        m_Position[i - 1] = m_RegionEnd[i - 1] - 1;
+        if (--m_Position[i] >= m_RegionBegin[i])
+        {
+          break;
+        }
+      }
+      this->ComputeRowOffset();
+    }
+
+  public:
+    // Types conforming the iterator requirements of the C++ standard library:
+    using difference_type = ptrdiff_t;
+    using value_type = PixelType;
+    using reference = QualifiedPixelType &;
+    using pointer = QualifiedPixelType *;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    /** Default-constructor, as required for any C++11 Forward Iterator. */
+    QualifiedIterator() = default;
+
+    /** Constructor for implicit conversion from non-const to const iterator.  */
+    template <bool VIsArgumentConst, typename = std::enable_if_t<VIsConst && !VIsArgumentConst>>
+    QualifiedIterator(const QualifiedIterator<VIsArgumentConst> & arg) noexcept
+      : m_Buffer(arg.m_Buffer)
+      , m_Tables(arg.m_Tables)
+      , m_RowOffset(arg.m_RowOffset)
+      , m_Position(arg.m_Position)
+      , m_RegionBegin(arg.m_RegionBegin)
+      , m_RegionEnd(arg.m_RegionEnd)
+    {}
+
+    /**  Returns a reference to the current pixel. */
+    reference
+    operator*() const noexcept
+    {
+      return m_Buffer[m_RowOffset + m_Tables[0][m_Position[0]]];
+    }
+
+    /** Prefix increment ('++it'). */
+    QualifiedIterator &
+    operator++() noexcept
+    {
+      if (++m_Position[0] == m_RegionEnd[0] && ImageDimension > 1)
+      {
+        this->NextRow();
+      }
+      return *this;
+    }
+
+    /** Postfix increment ('it++').
+     * \note Usually prefix increment ('++it') is preferable. */
+    QualifiedIterator
+    operator++(int) noexcept
+    {
+      auto result = *this;
+      ++(*this);
+      return result;
+    }
+
+    /** Prefix decrement ('--it'). */
+    QualifiedIterator &
+    operator--() noexcept
+    {
+      if (m_Position[0] == m_RegionBegin[0] && ImageDimension > 1)
+      {
+        this->PreviousRow();
+      }
+      else
+      {
+        --m_Position[0];
+      }
+      return *this;
+    }
+
+    /** Postfix decrement ('it--').
+     * \note Usually prefix decrement ('--it') is preferable. */
+    QualifiedIterator
+    operator--(int) noexcept
+    {
+      auto result = *this;
+      --(*this);
+      return result;
+    }
+
+    /** Returns (it1 == it2) for iterators it1 and it2 of the same range. */
+    friend bool
+    operator==(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return lhs.m_Position == rhs.m_Position;
+    }
+
+    /** Returns (it1 != it2) for iterators it1 and it2. */
+    friend bool
+    operator!=(const QualifiedIterator & lhs, const QualifiedIterator & rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
+  };
+
+  using QualifiedPixelType = std::conditional_t<IsImageTypeConst, const PixelType, PixelType>;
+
+  // BrickedImageRegionRange data members (strictly private):
+
+  QualifiedPixelType * m_Buffer{ nullptr };
+
+  TableArrayType m_Tables{};
+
+  OffsetType m_RegionBegin{ {} };
+
+  OffsetType m_RegionEnd{ {} };
+
+public:
+  using const_iterator = QualifiedIterator<true>;
+  using iterator = QualifiedIterator<IsImageTypeConst>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /** Constructs an empty range. */
+  BrickedImageRegionRange() noexcept = default;
+
+  /** Constructs a range of the pixels of a region, within the buffered
+   * region of the image.
+   * \note This constructor supports class template argument deduction (CTAD).
+   */
+  explicit BrickedImageRegionRange(TImage & image, const RegionType & iterationRegion)
+    : m_Buffer(image.GetBufferPointer())
+  {
+    const RegionType & bufferedRegion = image.GetBufferedRegion();
+    if (iterationRegion.GetNumberOfPixels() > 0)
+    {
+      itkAssertOrThrowMacro((bufferedRegion.IsInside(iterationRegion)),
+                            "Iteration region " << iterationRegion << " is outside of buffered region "
+                                                << bufferedRegion);
+    }
+
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      m_Tables[i] = image.GetBrickOffsetTable(i);
+      m_RegionBegin[i] = iterationRegion.GetIndex()[i] - bufferedRegion.GetIndex()[i];
+      m_RegionEnd[i] = m_RegionBegin[i] + static_cast<OffsetValueType>(iterationRegion.GetSize()[i]);
+    }
+  }
+
+  /** Constructs a range of the pixels of the requested region of an image.
+   * \note This constructor supports class template argument deduction (CTAD).
+   */
+  explicit BrickedImageRegionRange(TImage & image)
+    : BrickedImageRegionRange(image, image.GetRequestedRegion())
+  {}
+
+  /** Returns an iterator to the first pixel. */
+  [[nodiscard]] iterator
+  begin() const noexcept
+  {
+    const OffsetType position = this->empty() ? this->EndPosition() : m_RegionBegin;
+    return iterator{ m_Buffer, m_Tables, position, m_RegionBegin, m_RegionEnd };
+  }
+
+  /** Returns an 'end iterator' for this range. */
+  [[nodiscard]] iterator
+  end() const noexcept
+  {
+    return iterator{ m_Buffer, m_Tables, this->EndPosition(), m_RegionBegin, m_RegionEnd };
+  }
+
+  /** Returns a const iterator to the first pixel. */
+  [[nodiscard]] const_iterator
+  cbegin() const noexcept
+  {
+    return this->begin();
+  }
+
+  /** Returns a const 'end iterator' for this range. */
+  [[nodiscard]] const_iterator
+  cend() const noexcept
+  {
+    return this->end();
+  }
+
+  /** Returns a reverse 'begin iterator' for this range. */
+  [[nodiscard]] reverse_iterator
+  rbegin() const noexcept
+  {
+    return reverse_iterator{ this->end() };
+  }
+
+  /** Returns a reverse 'end iterator' for this range. */
+  [[nodiscard]] reverse_iterator
+  rend() const noexcept
+  {
+    return reverse_iterator{ this->begin() };
+  }
+
+  /** Returns the number of pixels in the region. */
+  [[nodiscard]] size_t
+  size() const noexcept
+  {
+    size_t result = 1;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      result *= static_cast<size_t>(m_RegionEnd[i] - m_RegionBegin[i]);
+    }
+    return result;
+  }
+
+  /** Tells whether the range is empty. */
+  [[nodiscard]] bool
+  empty() const noexcept
+  {
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      if (m_RegionEnd[i] <= m_RegionBegin[i])
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  // The position of the end iterator: the first row after the region.
+  OffsetType
+  EndPosition() const noexcept
+  {
+    OffsetType position = m_RegionBegin;
+    position.back() = m_RegionEnd.back();
+    return position;
+  }
+};
+
+// Deduction guide to avoid compiler warnings (-wctad-maybe-unsupported) when using class template argument deduction.
+template <typename TImage>
+BrickedImageRegionRange(TImage &) -> BrickedImageRegionRange<TImage>;
+
+} // namespace itk
+
+#endif
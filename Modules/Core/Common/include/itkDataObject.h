@@ -40,6 +40,7 @@ namespace itk
 // Forward reference because of circular dependencies
 class ITK_FORWARD_EXPORT ProcessObject;
 class ITK_FORWARD_EXPORT DataObject;
+class ITK_FORWARD_EXPORT ImageBufferAllocator;
 
 /*--------------------Data Object Exceptions---------------------------*/
 
@@ -340,6 +341,36 @@ public:
   itkGetConstReferenceMacro(ReleaseDataFlag, bool);
   itkBooleanMacro(ReleaseDataFlag);
 
+  /** Turn on/off a flag to control whether the bulk data of this object
+   * may be reused by an in-place filter which takes it as input, and
+   * overwrites it with its output. On by default. PipelineMemoryPlanner
+   * turns it off, while it executes the pipeline, for the data objects used
+   * by several filters, or kept after the execution. */
+  /** @ITKStartGrouping */
+  void
+  SetReuseDataFlag(bool flag)
+  {
+    m_ReuseDataFlag = flag;
+  }
+
+  itkGetConstReferenceMacro(ReuseDataFlag, bool);
+  itkBooleanMacro(ReuseDataFlag);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the allocator of the bulk data which this object allocates,
+   * for the data objects allocating it with an ImageBufferAllocator, like
+   * images. When none is set (the default), the allocator of their buffer
+   * container, or the global default one, is used. PipelineMemoryPlanner
+   * sets it, while it executes the pipeline, for the outputs of the filters
+   * which it executes. Like the flags above, it does not modify the object.
+   * \sa ImportImageContainer::SetAllocator() */
+  /** @ITKStartGrouping */
+  void
+  SetBufferAllocator(ImageBufferAllocator * allocator);
+  ImageBufferAllocator *
+  GetBufferAllocator() const;
+  /** @ITKEndGrouping */
+
   /** Turn on/off a flag to control whether every object releases its data
    * after being used by a filter. Being a global flag, it controls the
    * behavior of all DataObjects and ProcessObjects. */
@@ -533,6 +564,27 @@ public:
   Graft(const DataObject *)
   {}
 
+  /** Write the content of the data object, its meta-data and its bulk data,
+   * to a binary stream, from which DeserializeContent() restores it. Used by
+   * ProcessObjectResultCache to identify the inputs of a filter and to store
+   * its outputs. Returns false when the data object does not support it,
+   * which is the default. */
+  virtual bool
+  SerializeContent(std::ostream &) const
+  {
+    return false;
+  }
+
+  /** Restore the content written by SerializeContent() into a data object
+   * of the same type, leaving its requested region unchanged. Returns false
+   * when the data object does not support it, which is the default, or when
+   * the content does not match this data object. */
+  virtual bool
+  DeserializeContent(std::istream &)
+  {
+    return false;
+  }
+
 protected:
   DataObject();
   ~DataObject() override;
@@ -557,8 +609,11 @@ private:
   /** When, in real time, this data was generated. */
   RealTimeStamp m_RealTimeStamp{};
 
-  bool m_ReleaseDataFlag{}; // Data will release after use by a filter if on
-  bool m_DataReleased{};    // Keep track of data release during pipeline execution
+  bool m_ReleaseDataFlag{};     // Data will release after use by a filter if on
+  bool m_DataReleased{};        // Keep track of data release during pipeline execution
+  bool m_ReuseDataFlag{ true }; // Data may be overwritten by an in-place filter if on
+
+  SmartPointer<ImageBufferAllocator> m_BufferAllocator{};
 
   /** The maximum MTime of all upstream filters and data objects.
    * This does not include the MTime of this data object. */
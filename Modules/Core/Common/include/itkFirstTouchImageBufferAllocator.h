@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFirstTouchImageBufferAllocator_h
+#define itkFirstTouchImageBufferAllocator_h
+
+#include "itkAlignedImageBufferAllocator.h"
+
+namespace itk
+{
+/** \class FirstTouchImageBufferAllocator
+ * \brief Allocates image buffers whose pages are first touched in parallel.
+ *
+ * Operating systems place a page of memory on the NUMA node of the thread
+ * which first writes to it. A buffer initialized by a single thread thus
+ * lives on a single node, and the threads of the other nodes process it
+ * through the slower interconnect. This allocator initializes the pages of
+ * large buffers with the global default number of work units, splitting
+ * the buffer in contiguous pieces, as the filters split the largest
+ * dimension of an image between their work units, so that each piece tends
+ * to be placed on the node of the thread which will process it.
+ *
+ * The buffers of images, allocated by AllocateForRegion(), are touched with
+ * the split of their buffered region by MultiThreaderBase::
+ * ParallelizeImageRegion(), which the filters use, each page by the work
+ * unit of the pixel at its start. A filter which processes the image with
+ * the same number of work units thus processes each piece in the same work
+ * unit which placed it. With a WorkStealingThreadPool whose NUMAAffinity is
+ * on, that work unit is executed by the same thread, pinned to the same
+ * CPU, so that the whole pipeline accesses the memory of the local node.
+ *
+ * The pages are written even when the pixels are not to be initialized, by
+ * writing a zero byte to each of them. Buffers smaller than
+ * MinimumParallelBufferSize are initialized by the calling thread.
+ *
+ * The allocation must not be done by a work unit of a multi-threaded
+ * section, as it runs work units itself.
+ *
+ * \sa ImageBufferAllocator
+ * \sa WorkStealingThreadPool
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT FirstTouchImageBufferAllocator : public AlignedImageBufferAllocator
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FirstTouchImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = FirstTouchImageBufferAllocator;
+  using Superclass = AlignedImageBufferAllocator;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(FirstTouchImageBufferAllocator);
+
+  void *
+  Allocate(SizeValueType numberOfBytes, bool zeroInitialize) override;
+
+  void *
+  AllocateForRegion(SizeValueType numberOfBytes, const ImageIORegion & region, bool zeroInitialize) override;
+
+  /** Set/Get the size, in bytes, from which buffers are initialized in
+   * parallel. Defaults to 4 MiB. */
+  /** @ITKStartGrouping */
+  itkSetMacro(MinimumParallelBufferSize, SizeValueType);
+  itkGetConstMacro(MinimumParallelBufferSize, SizeValueType);
+  /** @ITKEndGrouping */
+
+protected:
+  FirstTouchImageBufferAllocator() = default;
+  ~FirstTouchImageBufferAllocator() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  SizeValueType m_MinimumParallelBufferSize{ SizeValueType{ 4 } << 20 };
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,80 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHugePageImageBufferAllocator_h
+#define itkHugePageImageBufferAllocator_h
+
+#include "itkAlignedImageBufferAllocator.h"
+
+namespace itk
+{
+/** \class HugePageImageBufferAllocator
+ * \brief Allocates large image buffers on transparent huge pages.
+ *
+ * Buffers of at least the huge page size, 2 MiB by default, are aligned to
+ * and padded to a multiple of the huge page size and, on Linux, advised to
+ * be backed by transparent huge pages (madvise(MADV_HUGEPAGE)), which
+ * reduces the TLB misses of the traversal of multi-gigabyte images. Smaller
+ * buffers are allocated as by AlignedImageBufferAllocator.
+ *
+ * On other systems, or when the kernel does not support transparent huge
+ * pages, the buffers are only aligned.
+ *
+ * \sa ImageBufferAllocator
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT HugePageImageBufferAllocator : public AlignedImageBufferAllocator
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(HugePageImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = HugePageImageBufferAllocator;
+  using Superclass = AlignedImageBufferAllocator;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(HugePageImageBufferAllocator);
+
+  void *
+  Allocate(SizeValueType numberOfBytes, bool zeroInitialize) override;
+
+  /** Set/Get the size of the huge pages, a power of two. Defaults to
+   * 2 MiB, their size on x86-64 and most ARM64 systems. */
+  /** @ITKStartGrouping */
+  void
+  SetHugePageSize(SizeValueType hugePageSize);
+  itkGetConstMacro(HugePageSize, SizeValueType);
+  /** @ITKEndGrouping */
+
+protected:
+  HugePageImageBufferAllocator() = default;
+  ~HugePageImageBufferAllocator() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  SizeValueType m_HugePageSize{ SizeValueType{ 2 } << 20 };
+};
+} // end namespace itk
+
+#endif
@@ -298,6 +298,16 @@ public:
   virtual void
   Graft(const Self * image);
 
+  /** Write the meta-data and the pixels of the buffered region to a binary
+   * stream, or restore them, when the pixels are trivially copyable.
+   * \sa DataObject::SerializeContent() */
+  /** @ITKStartGrouping */
+  bool
+  SerializeContent(std::ostream & os) const override;
+  bool
+  DeserializeContent(std::istream & is) override;
+  /** @ITKEndGrouping */
+
   /** Return the Pixel Accessor object */
   AccessorType
   GetPixelAccessor()
@@ -41,7 +41,12 @@ Image<TPixel, VImageDimension>::Allocate(bool initializePixels)
   this->ComputeOffsetTable();
   SizeValueType num = static_cast<SizeValueType>(this->GetOffsetTable()[VImageDimension]);
 
-  m_Buffer->Reserve(num, initializePixels);
+  // For the allocators which follow the split of the region by the filters.
+  ImageIORegion bufferedRegion(VImageDimension);
+  ImageIORegionAdaptor<VImageDimension>::Convert(this->GetBufferedRegion(), bufferedRegion, IndexType{});
+  m_Buffer->SetImageRegion(bufferedRegion);
+
+  m_Buffer->Reserve(num, initializePixels, this->GetBufferAllocator());
 }
 
 
@@ -124,6 +129,51 @@ Image<TPixel, VImageDimension>::Graft(const DataObject * data)
 }
 
 
+template <typename TPixel, unsigned int VImageDimension>
+bool
+Image<TPixel, VImageDimension>::SerializeContent(std::ostream & os) const
+{
+  if constexpr (std::is_trivially_copyable_v<TPixel>)
+  {
+    const SizeValueType numberOfBytes = this->GetBufferedRegion().GetNumberOfPixels() * sizeof(TPixel);
+    if (numberOfBytes > 0 && this->GetBufferPointer() == nullptr)
+    {
+      return false;
+    }
+    this->SerializeInformation(os, sizeof(TPixel) / this->GetNumberOfComponentsPerPixel());
+    os.write(reinterpret_cast<const char *>(this->GetBufferPointer()), numberOfBytes);
+    return static_cast<bool>(os);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+bool
+Image<TPixel, VImageDimension>::DeserializeContent(std::istream & is)
+{
+  if constexpr (std::is_trivially_copyable_v<TPixel>)
+  {
+    unsigned int numberOfComponents = this->GetNumberOfComponentsPerPixel();
+    if (!this->DeserializeInformation(is, sizeof(TPixel) / numberOfComponents, numberOfComponents))
+    {
+      return false;
+    }
+    this->Allocate();
+    const SizeValueType numberOfBytes = this->GetBufferedRegion().GetNumberOfPixels() * sizeof(TPixel);
+    is.read(reinterpret_cast<char *>(this->GetBufferPointer()), numberOfBytes);
+    return static_cast<bool>(is);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
 template <typename TPixel, unsigned int VImageDimension>
 void
 Image<TPixel, VImageDimension>::ComputeIndexToPhysicalPointMatrices()
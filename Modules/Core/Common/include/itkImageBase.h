@@ -853,6 +853,22 @@ protected:
   virtual void
   ComputeIndexToPhysicalPointMatrices();
 
+  /** Write the meta-data of the image to a binary stream, for the
+   * SerializeContent() of the subclasses: the number of components of its
+   * pixels and their size in bytes, its largest possible and buffered
+   * regions, its spacing, origin and direction. */
+  void
+  SerializeInformation(std::ostream & os, SizeValueType bytesPerComponent) const;
+
+  /** Restore the meta-data written by SerializeInformation(), leaving the
+   * requested region unchanged. numberOfComponents is the number of
+   * components of the pixels of this image, or 0 to accept any, and is set
+   * to that of the image written. Returns false, leaving the image
+   * unchanged, when the dimension or the pixels of the image written differ
+   * from those of this image. */
+  bool
+  DeserializeInformation(std::istream & is, SizeValueType bytesPerComponent, unsigned int & numberOfComponents);
+
 protected:
   /** Origin, spacing, and direction in physical coordinates. This variables are
    * protected for efficiency.  They are referenced frequently by
@@ -445,6 +445,81 @@ ImageBase<VImageDimension>::InitializeBufferedRegion()
 }
 
 
+template <unsigned int VImageDimension>
+void
+ImageBase<VImageDimension>::SerializeInformation(std::ostream & os, SizeValueType bytesPerComponent) const
+{
+  const auto write = [&os](const auto * values, SizeValueType numberOfValues) {
+    os.write(reinterpret_cast<const char *>(values), numberOfValues * sizeof(*values));
+  };
+
+  const SizeValueType header[3] = { VImageDimension, this->GetNumberOfComponentsPerPixel(), bytesPerComponent };
+  write(header, 3);
+  for (const RegionType * region : { &m_LargestPossibleRegion, &m_BufferedRegion })
+  {
+    write(region->GetIndex().data(), VImageDimension);
+    write(region->GetSize().data(), VImageDimension);
+  }
+  write(m_Spacing.GetDataPointer(), VImageDimension);
+  write(m_Origin.GetDataPointer(), VImageDimension);
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    write(m_Direction[i], VImageDimension);
+  }
+}
+
+
+template <unsigned int VImageDimension>
+bool
+ImageBase<VImageDimension>::DeserializeInformation(std::istream & is,
+                                                   SizeValueType  bytesPerComponent,
+                                                   unsigned int & numberOfComponents)
+{
+  const auto read = [&is](auto * values, SizeValueType numberOfValues) {
+    is.read(reinterpret_cast<char *>(values), numberOfValues * sizeof(*values));
+  };
+
+  SizeValueType header[3] = { 0, 0, 0 };
+  read(header, 3);
+  if (!is || header[0] != VImageDimension || header[1] == 0 ||
+      (numberOfComponents != 0 && header[1] != numberOfComponents) || header[2] != bytesPerComponent)
+  {
+    return false;
+  }
+
+  RegionType regions[2];
+  for (RegionType & region : regions)
+  {
+    IndexType index;
+    SizeType  size;
+    read(index.data(), VImageDimension);
+    read(size.data(), VImageDimension);
+    region = RegionType(index, size);
+  }
+  SpacingType   spacing;
+  PointType     origin;
+  DirectionType direction;
+  read(spacing.GetDataPointer(), VImageDimension);
+  read(origin.GetDataPointer(), VImageDimension);
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    read(direction[i], VImageDimension);
+  }
+  if (!is)
+  {
+    return false;
+  }
+
+  this->SetLargestPossibleRegion(regions[0]);
+  this->SetBufferedRegion(regions[1]);
+  this->SetSpacing(spacing);
+  this->SetOrigin(origin);
+  this->SetDirection(direction);
+  numberOfComponents = static_cast<unsigned int>(header[1]);
+  return true;
+}
+
+
 template <unsigned int VImageDimension>
 void
 ImageBase<VImageDimension>::SetRequestedRegion(const RegionType & region)
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferAllocator_h
+#define itkImageBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkImageIORegion.h"
+#include "itkIntTypes.h"
+#include "itkSingletonMacro.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace itk
+{
+
+struct ImageBufferAllocatorGlobals;
+
+/** \class ImageBufferAllocator
+ * \brief Base class of the allocators of the pixel buffers of images.
+ *
+ * By default, ImportImageContainer allocates its elements with new[]. When
+ * an allocator is set on the container, or as the global default, the
+ * buffer is allocated by the allocator instead. Subclasses allocate raw
+ * memory, aligned to at least GetAlignment() bytes, and may initialize it
+ * in their own way, for instance in parallel. The elements of non trivial
+ * types are then constructed, and destroyed before the memory is given
+ * back, by AllocateElements() and DeallocateElements().
+ *
+ * The buffer of an image is allocated by AllocateForRegion(), given the
+ * buffered region of the image, so that allocators which initialize it in
+ * parallel can split it as the filters will.
+ *
+ * The global default allocator is initially null, so that images use
+ * new[]. It is set by SetGlobalDefaultAllocator() or, the first time it is
+ * requested, from the environment variable ITK_IMAGE_BUFFER_ALLOCATOR,
+ * which holds the name of a class derived from ImageBufferAllocator: one
+ * of AlignedImageBufferAllocator, HugePageImageBufferAllocator,
+ * FirstTouchImageBufferAllocator and PoolImageBufferAllocator, or of a
+ * class registered with the object factory.
+ *
+ * Buffers allocated by an allocator must not be freed with delete[], so a
+ * buffer whose management was taken over from its container must be given
+ * back to the allocator.
+ *
+ * The number of buffers and bytes allocated for images, whichever way, are
+ * counted globally, and reported by GetStatistics() and MemoryProbe.
+ *
+ * \sa ImportImageContainer
+ * \sa MemoryProbe
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferAllocator : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = ImageBufferAllocator;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ImageBufferAllocator);
+
+  /** Counts of the buffers allocated for images, since the program
+   * started. */
+  struct Statistics
+  {
+    SizeValueType NumberOfAllocations{ 0 };
+    SizeValueType NumberOfDeallocations{ 0 };
+    /** Number of allocations served from a pool of released buffers. */
+    SizeValueType NumberOfReuses{ 0 };
+    SizeValueType AllocatedBytes{ 0 };
+    SizeValueType BytesInUse{ 0 };
+    /** Maximum of BytesInUse since the program started, or since the last
+     * call to ResetPeakBytesInUse(). */
+    SizeValueType PeakBytesInUse{ 0 };
+  };
+
+  /** Allocate a buffer of numberOfBytes bytes, aligned to at least
+   * GetAlignment() bytes, and filled with zeros if zeroInitialize is true.
+   * Returns null when the memory cannot be allocated. */
+  virtual void *
+  Allocate(SizeValueType numberOfBytes, bool zeroInitialize) = 0;
+
+  /** Allocate the buffer of numberOfBytes bytes of an image whose buffered
+   * region is region, stored in the usual order, with the same number of
+   * bytes for each pixel. Calls Allocate() by default. */
+  virtual void *
+  AllocateForRegion(SizeValueType numberOfBytes, const ImageIORegion & region, bool zeroInitialize);
+
+  /** Give back a buffer returned by Allocate() for the same number of
+   * bytes. */
+  virtual void
+  Deallocate(void * buffer, SizeValueType numberOfBytes) = 0;
+
+  /** Alignment, in bytes, of the allocated buffers. */
+  [[nodiscard]] virtual SizeValueType
+  GetAlignment() const = 0;
+
+  /** Allocate numberOfElements elements, value initialized if
+   * useValueInitialization is true and default initialized otherwise, for
+   * the pixels of the given region if it is not null. Returns null when the
+   * memory cannot be allocated. */
+  template <typename TElement>
+  TElement *
+  AllocateElements(SizeValueType         numberOfElements,
+                   bool                  useValueInitialization,
+                   const ImageIORegion * region = nullptr)
+  {
+    static_assert(alignof(TElement) <= alignof(std::max_align_t), "Over aligned elements are not supported.");
+    if (numberOfElements > std::numeric_limits<SizeValueType>::max() / sizeof(TElement))
+    {
+      return nullptr;
+    }
+    const SizeValueType numberOfBytes = numberOfElements * sizeof(TElement);
+
+    // Value initialization of trivially default constructible types fills
+    // them with zeros, which the allocator may do in its own way.
+    constexpr bool isTrivial = std::is_trivially_default_constructible_v<TElement>;
+    const bool     zeroInitialize = isTrivial && useValueInitialization;
+    void *         buffer = region ? this->AllocateForRegion(numberOfBytes, *region, zeroInitialize)
+                                   : this->Allocate(numberOfBytes, zeroInitialize);
+    if (buffer == nullptr || isTrivial)
+    {
+      return static_cast<TElement *>(buffer);
+    }
+    auto * elements = static_cast<TElement *>(buffer);
+    try
+    {
+      if (useValueInitialization)
+      {
+        std::uninitialized_value_construct_n(elements, numberOfElements);
+      }
+      else
+      {
+        std::uninitialized_default_construct_n(elements, numberOfElements);
+      }
+    }
+    catch (...)
+    {
+      this->Deallocate(buffer, numberOfBytes);
+      return nullptr;
+    }
+    return elements;
+  }
+
+  /** Destroy and give back numberOfElements elements allocated by
+   * AllocateElements(). */
+  template <typename TElement>
+  void
+  DeallocateElements(TElement * elements, SizeValueType numberOfElements)
+  {
+    if (elements == nullptr)
+    {
+      return;
+    }
+    if constexpr (!std::is_trivially_destructible_v<TElement>)
+    {
+      std::destroy_n(elements, numberOfElements);
+    }
+    this->Deallocate(elements, numberOfElements * sizeof(TElement));
+  }
+
+  /** Set/Get the allocator used by the containers which have none, or null
+   * to allocate with new[]. */
+  /** @ITKStartGrouping */
+  static void
+  SetGlobalDefaultAllocator(ImageBufferAllocator * allocator);
+  static Pointer
+  GetGlobalDefaultAllocator();
+  /** @ITKEndGrouping */
+
+  /** Create the allocator of the given class name, or return null when
+   * there is none of that name. */
+  static Pointer
+  CreateAllocator(const std::string & className);
+
+  /** Get the counts of the buffers allocated for images. */
+  static Statistics
+  GetStatistics();
+
+  /** Restart the tracking of the peak number of bytes in use from the
+   * current number. */
+  static void
+  ResetPeakBytesInUse();
+
+  /** Count an allocation, or a deallocation, of numberOfBytes bytes for an
+   * image. Called by ImportImageContainer, which counts its buffers whether
+   * or not they come from an allocator. */
+  /** @ITKStartGrouping */
+  static void
+  RecordAllocation(SizeValueType numberOfBytes);
+  static void
+  RecordDeallocation(SizeValueType numberOfBytes);
+  /** @ITKEndGrouping */
+
+protected:
+  ImageBufferAllocator() = default;
+  ~ImageBufferAllocator() override = default;
+
+  /** Count an allocation served from released buffers, in addition to
+   * RecordAllocation(). */
+  static void
+  RecordReuse();
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  itkGetGlobalDeclarationMacro(ImageBufferAllocatorGlobals, PimplGlobals);
+  static ImageBufferAllocatorGlobals * m_PimplGlobals;
+};
+
+/** Print the counts of the buffers allocated for images. */
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const ImageBufferAllocator::Statistics & statistics);
+} // end namespace itk
+
+#endif
@@ -32,6 +32,7 @@
 #include "itkImage.h"
 #include "itkImageRegionSplitterBase.h"
 #include "itkImageSourceCommon.h"
+#include "itkPipelineProfiler.h"
 
 namespace itk
 {
@@ -389,7 +390,9 @@ protected:
   /** Internal structure used for passing image data into the threading library */
   struct ThreadStruct
   {
-    Pointer Filter;
+    Pointer                         Filter;
+    /** The event of the filter, for the work units of its threads. */
+    PipelineProfiler::EventRecord * ProfilerEvent{ PipelineProfiler::GetCurrentEvent() };
   };
 
   void
@@ -281,6 +281,7 @@ ImageSource<TOutputImage>::ThreaderCallback(void * arg)
 
   if (workUnitID < total)
   {
+    const PipelineProfiler::WorkUnitScope profilerScope(str->ProfilerEvent);
     str->Filter->ThreadedGenerateData(splitRegion, workUnitID);
   }
   // else don't use this thread. Threads were not split conveniently.
@@ -18,6 +18,7 @@
 #ifndef itkImportImageContainer_h
 #define itkImportImageContainer_h
 
+#include "itkImageBufferAllocator.h"
 #include "itkObject.h"
 #include "itkObjectFactory.h"
 #include <utility>
@@ -31,6 +32,9 @@ namespace itk
  * conforms to the ImageContainerInterface. This is a full-fledged Object,
  * so there is modification time, debug, and reference count information.
  *
+ * The elements are allocated with new[], unless an ImageBufferAllocator is
+ * set on the container or as the global default allocator.
+ *
  * \tparam TElementIdentifier An INTEGRAL type for use in indexing the
  * imported buffer.
  *
@@ -133,6 +137,13 @@ public:
   void
   Reserve(ElementIdentifier size, const bool UseValueInitialization = false);
 
+  /** Reserve() the elements, allocating them with the given allocator
+   * instead of the allocator of the container, when it is not null. The
+   * allocator of the container is left unchanged, for the buffers which it
+   * allocates later. */
+  void
+  Reserve(ElementIdentifier size, bool UseValueInitialization, ImageBufferAllocator * allocator);
+
   /** Tell the container to try to minimize its memory usage for
    * storage of the current number of elements.  If new memory is
    * allocated, the contents of old buffer are copied to the new area.
@@ -160,6 +171,35 @@ public:
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
   /** @ITKEndGrouping */
+
+  /** Set/Get the allocator of the buffers allocated by the container. When
+   * none is set, the global default allocator of ImageBufferAllocator is
+   * used, and when there is none either, the elements are allocated with
+   * new[]. Setting it does not reallocate the current buffer, which is
+   * given back to the allocator which allocated it.
+   * \sa ImageBufferAllocator::SetGlobalDefaultAllocator() */
+  /** @ITKStartGrouping */
+  itkSetObjectMacro(Allocator, ImageBufferAllocator);
+  itkGetModifiableObjectMacro(Allocator, ImageBufferAllocator);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the buffered region of the image whose pixels are held by the
+   * buffers which the container allocates, passed on to the allocator, or
+   * an empty region (the default) when there is none. Images set it before
+   * they allocate their buffer.
+   * \sa ImageBufferAllocator::AllocateForRegion() */
+  /** @ITKStartGrouping */
+  void
+  SetImageRegion(const ImageIORegion & region)
+  {
+    m_ImageRegion = region;
+  }
+  const ImageIORegion &
+  GetImageRegion() const
+  {
+    return m_ImageRegion;
+  }
+  /** @ITKEndGrouping */
 protected:
   ImportImageContainer() = default;
   ~ImportImageContainer() override;
@@ -207,10 +247,29 @@ protected:
   }
 
 private:
+  /** Make the buffer last returned by AllocateElements() the current one,
+   * once the previous one was deallocated. */
+  void
+  AdoptAllocatedElements(TElement * ptr);
+
   TElement *         m_ImportPointer{};
   TElementIdentifier m_Size{};
   TElementIdentifier m_Capacity{};
   bool               m_ContainerManageMemory{ true };
+
+  ImageBufferAllocator::Pointer m_Allocator{};
+  ImageIORegion                 m_ImageRegion{};
+
+  // The allocator of the current buffer, or null when it was allocated with
+  // new[] or imported, and its number of bytes when it was allocated by
+  // AllocateElements().
+  ImageBufferAllocator::Pointer m_BufferAllocator{};
+  SizeValueType                 m_BufferBytes{};
+
+  // The same, for the buffer last returned by AllocateElements(), until it
+  // replaces the current buffer.
+  mutable ImageBufferAllocator::Pointer m_AllocatedElementsAllocator{};
+  mutable SizeValueType                 m_AllocatedElementsBytes{};
 };
 } // end namespace itk
 
@@ -29,6 +29,7 @@
 #define itkImportImageContainer_hxx
 
 #include <algorithm> // For copy_n.
+#include <utility>   // For exchange.
 
 namespace itk
 {
@@ -59,7 +60,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
 
       DeallocateManagedMemory();
 
-      m_ImportPointer = temp;
+      this->AdoptAllocatedElements(temp);
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -73,7 +74,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   }
   else
   {
-    m_ImportPointer = this->AllocateElements(size, UseValueInitialization);
+    this->AdoptAllocatedElements(this->AllocateElements(size, UseValueInitialization));
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -81,6 +82,31 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   }
 }
 
+template <typename TElementIdentifier, typename TElement>
+void
+ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier      size,
+                                                            bool                   UseValueInitialization,
+                                                            ImageBufferAllocator * allocator)
+{
+  if (allocator == nullptr)
+  {
+    this->Reserve(size, UseValueInitialization);
+    return;
+  }
+
+  const ImageBufferAllocator::Pointer containerAllocator = std::exchange(m_Allocator, allocator);
+  try
+  {
+    this->Reserve(size, UseValueInitialization);
+  }
+  catch (...)
+  {
+    m_Allocator = containerAllocator;
+    throw;
+  }
+  m_Allocator = containerAllocator;
+}
+
 /**
  * Tell the container to try to minimize its memory usage for storage of
  * the current number of elements.
@@ -99,7 +125,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Squeeze()
 
       DeallocateManagedMemory();
 
-      m_ImportPointer = temp;
+      this->AdoptAllocatedElements(temp);
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -157,20 +183,39 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
 {
   TElement * data = nullptr;
 
-  try
+  const ImageBufferAllocator::Pointer allocator =
+    m_Allocator ? m_Allocator : ImageBufferAllocator::GetGlobalDefaultAllocator();
+  if (allocator)
   {
-    if (UseValueInitialization)
+    // The region is only passed on when it matches the number of elements.
+    const ImageIORegion * region = nullptr;
+    if (m_ImageRegion.GetImageDimension() > 0)
     {
-      data = new TElement[size]();
-    }
-    else
-    {
-      data = new TElement[size];
+      const SizeValueType numberOfPixels = m_ImageRegion.GetNumberOfPixels();
+      if (numberOfPixels > 0 && static_cast<SizeValueType>(size) % numberOfPixels == 0)
+      {
+        region = &m_ImageRegion;
+      }
     }
+    data = allocator->template AllocateElements<TElement>(size, UseValueInitialization, region);
   }
-  catch (...)
+  else
   {
-    data = nullptr;
+    try
+    {
+      if (UseValueInitialization)
+      {
+        data = new TElement[size]();
+      }
+      else
+      {
+        data = new TElement[size];
+      }
+    }
+    catch (...)
+    {
+      data = nullptr;
+    }
   }
   if (!data)
   {
@@ -178,9 +223,21 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
     // of memory.  Do not use the exception macro.
     throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
   }
+  m_AllocatedElementsAllocator = allocator;
+  m_AllocatedElementsBytes = static_cast<SizeValueType>(size) * sizeof(TElement);
+  ImageBufferAllocator::RecordAllocation(m_AllocatedElementsBytes);
   return data;
 }
 
+template <typename TElementIdentifier, typename TElement>
+void
+ImportImageContainer<TElementIdentifier, TElement>::AdoptAllocatedElements(TElement * ptr)
+{
+  m_ImportPointer = ptr;
+  m_BufferAllocator = std::exchange(m_AllocatedElementsAllocator, nullptr);
+  m_BufferBytes = std::exchange(m_AllocatedElementsBytes, 0);
+}
+
 template <typename TElementIdentifier, typename TElement>
 void
 ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
@@ -188,8 +245,21 @@ ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
   // Encapsulate all image memory deallocation here
   if (m_ContainerManageMemory)
   {
-    delete[] m_ImportPointer;
+    if (m_BufferAllocator)
+    {
+      m_BufferAllocator->DeallocateElements(m_ImportPointer, m_Capacity);
+    }
+    else
+    {
+      delete[] m_ImportPointer;
+    }
+  }
+  if (m_BufferBytes > 0)
+  {
+    ImageBufferAllocator::RecordDeallocation(m_BufferBytes);
   }
+  m_BufferAllocator = nullptr;
+  m_BufferBytes = 0;
   m_ImportPointer = nullptr;
   m_Capacity = 0;
   m_Size = 0;
@@ -205,6 +275,7 @@ ImportImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os,
   os << indent << "Container manages memory: " << (m_ContainerManageMemory ? "true" : "false") << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  itkPrintSelfObjectMacro(Allocator);
 }
 } // end namespace itk
 
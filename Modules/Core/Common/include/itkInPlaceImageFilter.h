@@ -107,7 +107,8 @@ public:
 
   /** In place operation can be turned on and off. Asking for
    * in-place operation, i.e. calling SetInplace(true) or InplaceOn(),
-   * will be effective only if CanRunInPlace also returns true.
+   * will be effective only if CanRunInPlace also returns true, and the
+   * ReuseDataFlag of the input is on.
    * By default CanRunInPlace checks whether the input and output
    * image type match. */
   /** @ITKStartGrouping */
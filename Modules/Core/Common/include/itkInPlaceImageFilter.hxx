@@ -75,7 +75,7 @@ InPlaceImageFilter<TInputImage, TOutputImage>::InternalAllocateOutputs()
   {
     rMatch = false;
   }
-  if (inputPtr != nullptr && this->GetInPlace() && this->CanRunInPlace() && rMatch)
+  if (inputPtr != nullptr && this->GetInPlace() && this->CanRunInPlace() && rMatch && inputPtr->GetReuseDataFlag())
   {
     // Graft this first input to the output.  Later, we'll need to
     // remove the input's hold on the bulk data.
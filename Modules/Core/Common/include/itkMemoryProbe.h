@@ -19,6 +19,7 @@
 #define itkMemoryProbe_h
 
 #include "itkResourceProbe.h"
+#include "itkImageBufferAllocator.h"
 #include "itkMemoryUsageObserver.h"
 #include "itkIntTypes.h"
 
@@ -34,11 +35,19 @@ namespace itk
  *   GetProcessMemoryInfo() for Windows, the SMAPS file for Linux
  *   and getrusage() otherwise.
  *
+ *   The probe also counts the pixel buffers allocated for images between
+ *   its starts and stops, as recorded by ImageBufferAllocator. Start()
+ *   restarts the tracking of the peak number of bytes in use, which is
+ *   global: the peaks of probes running at the same time are only exact
+ *   for the last one started.
+ *
  * \ingroup ITKCommon
  */
 class ITKCommon_EXPORT MemoryProbe : public ResourceProbe<OffsetValueType, double>
 {
 public:
+  using Superclass = ResourceProbe<OffsetValueType, double>;
+
   MemoryProbe();
   ~MemoryProbe() override;
 
@@ -48,12 +57,62 @@ public:
   /** Type for measuring the average memory. */
   using MeanMemoryLoadType = double;
 
+  void
+  Start() override;
+
+  void
+  Stop() override;
+
+  void
+  Reset() override;
+
+  /** Get the number of image buffers allocated between the starts and
+   * stops of the probe. */
+  [[nodiscard]] SizeValueType
+  GetNumberOfImageBufferAllocations() const
+  {
+    return m_NumberOfImageBufferAllocations;
+  }
+
+  /** Get the number of these allocations served from a pool of released
+   * buffers. */
+  [[nodiscard]] SizeValueType
+  GetNumberOfImageBufferReuses() const
+  {
+    return m_NumberOfImageBufferReuses;
+  }
+
+  /** Get the number of bytes of the image buffers allocated between the
+   * starts and stops of the probe. */
+  [[nodiscard]] SizeValueType
+  GetImageBufferAllocatedBytes() const
+  {
+    return m_ImageBufferAllocatedBytes;
+  }
+
+  /** Get the maximum, over the starts and stops of the probe, of the peak
+   * increase of the bytes of the image buffers in use. */
+  [[nodiscard]] SizeValueType
+  GetImageBufferPeakBytes() const
+  {
+    return m_ImageBufferPeakBytes;
+  }
+
+  void
+  Print(std::ostream & os, Indent indent) const override;
+
 protected:
   MemoryLoadType
   GetInstantValue() const override;
 
 private:
   mutable MemoryUsageObserver m_MemoryObserver{};
+
+  ImageBufferAllocator::Statistics m_ImageBufferStatisticsAtStart{};
+  SizeValueType                    m_NumberOfImageBufferAllocations{ 0 };
+  SizeValueType                    m_NumberOfImageBufferReuses{ 0 };
+  SizeValueType                    m_ImageBufferAllocatedBytes{ 0 };
+  SizeValueType                    m_ImageBufferPeakBytes{ 0 };
 };
 } // end namespace itk
 
@@ -35,6 +35,7 @@
 #include "itkImageRegion.h"
 #include "itkImageIORegion.h"
 #include "itkSingletonMacro.h"
+#include "itkPipelineProfiler.h"
 #include <atomic>
 #include <functional>
 #include <thread>
@@ -65,7 +66,8 @@ public:
     Pool,
     TBB,
     Single,
-    Last = Single,
+    WorkStealing,
+    Last = WorkStealing,
     Unknown = -1
   };
 
@@ -170,6 +172,7 @@ public:
   static constexpr ThreaderEnum Pool = ThreaderEnum::Pool;
   static constexpr ThreaderEnum TBB = ThreaderEnum::TBB;
   static constexpr ThreaderEnum Single = ThreaderEnum::Single;
+  static constexpr ThreaderEnum WorkStealing = ThreaderEnum::WorkStealing;
   static constexpr ThreaderEnum Last = ThreaderEnum::Last;
   static constexpr ThreaderEnum Unknown = ThreaderEnum::Unknown;
 #endif
@@ -192,6 +195,8 @@ public:
         return "TBB";
       case ThreaderEnum::Single:
         return "Single";
+      case ThreaderEnum::WorkStealing:
+        return "WorkStealing";
       case ThreaderEnum::Unknown:
       default:
         return "Unknown";
@@ -359,8 +364,10 @@ ITK_GCC_PRAGMA_DIAG_POP()
       VDimension,
       requestedRegion.GetIndex().m_InternalArray,
       requestedRegion.GetSize().m_InternalArray,
-      [&funcP](const IndexValueType index[], const SizeValueType size[]) {
-        ImageRegion<VDimension> region;
+      [&funcP, profilerEvent = PipelineProfiler::GetCurrentEvent()](const IndexValueType index[],
+                                                                    const SizeValueType  size[]) {
+        const PipelineProfiler::WorkUnitScope profilerScope(profilerEvent);
+        ImageRegion<VDimension>               region;
         for (unsigned int d = 0; d < VDimension; ++d)
         {
           region.SetIndex(d, index[d]);
@@ -407,8 +414,10 @@ ITK_GCC_PRAGMA_DIAG_POP()
         SplitDimension,
         splitIndex.m_InternalArray,
         splitSize.m_InternalArray,
-        [restrictedDirection, &requestedRegion, &funcP](const IndexValueType index[], const SizeValueType size[]) {
-          ImageRegion<VDimension> restrictedRequestedRegion;
+        [restrictedDirection, &requestedRegion, &funcP, profilerEvent = PipelineProfiler::GetCurrentEvent()](
+          const IndexValueType index[], const SizeValueType size[]) {
+          const PipelineProfiler::WorkUnitScope profilerScope(profilerEvent);
+          ImageRegion<VDimension>               restrictedRequestedRegion;
           restrictedRequestedRegion.SetIndex(restrictedDirection, requestedRegion.GetIndex(restrictedDirection));
           restrictedRequestedRegion.SetSize(restrictedDirection, requestedRegion.GetSize(restrictedDirection));
           for (unsigned int splitDimension = 0, dimension = 0; dimension < VDimension; ++dimension)
@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPipelineMemoryPlanner_h
+#define itkPipelineMemoryPlanner_h
+
+#include "itkPoolImageBufferAllocator.h"
+#include "itkProcessObject.h"
+
+#include <map>
+#include <vector>
+
+namespace itk
+{
+
+/** \class PipelineMemoryPlanner
+ * \brief Executes a pipeline, releasing and recycling the bulk data of
+ * its intermediate data objects as soon as they are no longer used.
+ *
+ * The planner is given the outputs of a pipeline, which it keeps. Before
+ * executing the pipeline, it updates their output information and
+ * propagates their requested regions, then plans the execution from the
+ * graph of the filters upstream of them:
+ *
+ * - the filters are executed in a topological order, each once, and only
+ *   when their outputs need to be updated;
+ * - the bulk data of each intermediate data object is released as soon as
+ *   the last filter which uses it has been executed, or the filter which
+ *   generates it when no filter uses it, so that its lifetime is the
+ *   shortest possible;
+ * - in-place filters overwrite their input only when no other filter uses
+ *   it, and it is not an output of the pipeline, by turning off the
+ *   ReuseDataFlag of the other data objects during the execution;
+ * - the buffers released are recycled for the outputs of the filters
+ *   executed later, by a PoolImageBufferAllocator which is their buffer
+ *   allocator during the execution. The other images, and the global
+ *   default allocator, are left alone.
+ *
+ * The ReuseDataFlag and the buffer allocator of the data objects are
+ * restored when the execution ends, and the buffers left in the pool are
+ * given back. The pixel containers of the outputs do not refer to the pool,
+ * which does not keep their buffers when they are released later.
+ *
+ * The data objects needed after the execution must be added as outputs.
+ * Those which are not generated by a filter, like the images given as
+ * inputs to the pipeline, are never released. The data objects
+ * of the pipeline which are released must not be used by other pipelines
+ * during the execution.
+ *
+ * After Update(), the planner reports the peak number of bytes allocated
+ * for images during the execution, in addition to the bytes in use before,
+ * and the number of buffers which were recycled.
+ *
+ * \sa DataObject::SetReuseDataFlag()
+ * \sa DataObject::SetBufferAllocator()
+ * \sa ImageBufferAllocator
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineMemoryPlanner : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PipelineMemoryPlanner);
+
+  /** Standard class type aliases. */
+  using Self = PipelineMemoryPlanner;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(PipelineMemoryPlanner);
+
+  /** Add an output of the pipeline, which is kept after its execution. */
+  void
+  AddOutput(DataObject * output);
+
+  /** Remove the outputs of the pipeline. */
+  void
+  ClearOutputs();
+
+  /** Set/Get whether the buffers released are recycled. On by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(RecycleBuffers, bool);
+  itkGetConstMacro(RecycleBuffers, bool);
+  itkBooleanMacro(RecycleBuffers);
+  /** @ITKEndGrouping */
+
+  /** Execute the pipeline, as planned. */
+  void
+  Update();
+
+  /** Get the filters of the pipeline, in the order of their execution. */
+  [[nodiscard]] std::vector<ProcessObject *>
+  GetExecutionOrder() const;
+
+  /** Get the number of filters executed by the last Update(). */
+  itkGetConstMacro(NumberOfExecutedFilters, SizeValueType);
+
+  /** Get the number of data objects released by the last Update(). */
+  itkGetConstMacro(NumberOfReleasedDataObjects, SizeValueType);
+
+  /** Get the number of buffers recycled by the last Update(). */
+  itkGetConstMacro(NumberOfRecycledBuffers, SizeValueType);
+
+  /** Get the peak number of bytes allocated for images during the last
+   * Update(), in addition to those in use before. */
+  itkGetConstMacro(PeakBytes, SizeValueType);
+
+protected:
+  PipelineMemoryPlanner();
+  ~PipelineMemoryPlanner() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** A filter of the pipeline, with the data objects whose bulk data is
+   * released after its execution. */
+  struct Step
+  {
+    ProcessObject::Pointer           Filter;
+    std::vector<DataObject::Pointer> LastUses;
+    bool                             IsNeeded{ false };
+  };
+
+  /** Compute the steps of the execution. */
+  void
+  Plan();
+
+  std::vector<DataObject::Pointer>  m_Outputs;
+  std::vector<Step>                 m_Steps;
+  std::map<DataObject *, bool>      m_ReuseDataFlags;
+  PoolImageBufferAllocator::Pointer m_Pool;
+  SizeValueType                     m_MaximumPooledBytes;
+  bool                              m_RecycleBuffers{ true };
+  SizeValueType                     m_NumberOfExecutedFilters{ 0 };
+  SizeValueType                     m_NumberOfReleasedDataObjects{ 0 };
+  SizeValueType                     m_NumberOfRecycledBuffers{ 0 };
+  SizeValueType                     m_PeakBytes{ 0 };
+};
+} // end namespace itk
+
+#endif
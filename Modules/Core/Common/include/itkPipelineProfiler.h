@@ -0,0 +1,178 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPipelineProfiler_h
+#define itkPipelineProfiler_h
+
+#include "itkIntTypes.h"
+#include "itkSingletonMacro.h"
+#include "ITKCommonExport.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+class ProcessObject;
+struct PipelineProfilerGlobals;
+
+/** \class PipelineProfiler
+ * \brief Records the execution of the filters of the pipelines.
+ *
+ * When enabled, an event is recorded for each execution of
+ * ProcessObject::UpdateOutputData(): the class and name of the filter, its
+ * wall time, the number of bytes allocated for images meanwhile, and the
+ * requested regions of its image outputs. The pieces of work executed by
+ * MultiThreaderBase::ParallelizeImageRegion() and
+ * ParallelizeImageRegionRestrictDirection(), and by the classic
+ * multi-threading of ImageSource, on behalf of the filter, are recorded as
+ * its work units, with their wall and CPU times. The CPU time of the event
+ * is the one of the thread which updates the filter, plus the one of the
+ * work units executed by other threads; the load imbalance of the event is
+ * the ratio of the longest to the mean wall time of its work units.
+ *
+ * The events are written as a Chrome trace, in the JSON format read by
+ * chrome://tracing, Perfetto and speedscope, in which the nested filters
+ * of a pipeline form a flame graph, or summarized by class in a text
+ * report.
+ *
+ * Profiling is disabled by default. It is enabled by SetEnabled() or, the
+ * first time it is queried, by the environment variable
+ * ITK_PIPELINE_PROFILE, which holds the name of a file in which the Chrome
+ * trace is written when the program exits.
+ *
+ * The bytes allocated include those of other pipelines executed
+ * concurrently. Clear() must not be called while filters are updated.
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineProfiler
+{
+public:
+  /** A piece of work executed on behalf of a filter. The times are in
+   * seconds, from the time the profiler started. */
+  struct WorkUnitRecord
+  {
+    double        StartTime{ 0.0 };
+    double        WallTime{ 0.0 };
+    double        CPUTime{ 0.0 };
+    SizeValueType ThreadIndex{ 0 };
+  };
+
+  /** An execution of ProcessObject::UpdateOutputData(). */
+  struct EventRecord
+  {
+    std::string                 ClassName;
+    std::string                 ObjectName;
+    double                      StartTime{ 0.0 };
+    double                      WallTime{ 0.0 };
+    double                      CPUTime{ 0.0 };
+    SizeValueType               ThreadIndex{ 0 };
+    /** Number of the enclosing events of the same thread. */
+    unsigned int                Depth{ 0 };
+    SizeValueType               AllocatedBytes{ 0 };
+    /** The requested regions of the image outputs, and their total number
+     * of pixels. */
+    std::string                 RequestedRegions;
+    SizeValueType               RequestedPixels{ 0 };
+    std::vector<WorkUnitRecord> WorkUnits;
+
+    /** Ratio of the longest to the mean wall time of the work units, or 1
+     * when there are none. */
+    [[nodiscard]] double
+    GetLoadImbalance() const;
+  };
+
+  /** Set/Get whether the filters are profiled. */
+  /** @ITKStartGrouping */
+  static void
+  SetEnabled(bool enabled);
+  static bool
+  GetEnabled();
+  /** @ITKEndGrouping */
+
+  /** Get a copy of the events recorded, in the order the filters started. */
+  static std::vector<EventRecord>
+  GetEvents();
+
+  /** Remove the events recorded. */
+  static void
+  Clear();
+
+  /** Write the events as a Chrome trace. */
+  /** @ITKStartGrouping */
+  static void
+  WriteChromeTrace(std::ostream & os);
+  static bool
+  WriteChromeTrace(const std::string & fileName);
+  /** @ITKEndGrouping */
+
+  /** Write the number of executions, times, load imbalance, bytes
+   * allocated and pixels requested of each class of filter. */
+  static void
+  WriteReport(std::ostream & os);
+
+  /** The event of the filter which the current thread updates, or null. */
+  static EventRecord *
+  GetCurrentEvent();
+
+  /** Records an event for the lifetime of the scope, when profiling is
+   * enabled. Used by ProcessObject::UpdateOutputData(). */
+  class ITKCommon_EXPORT EventScope
+  {
+  public:
+    explicit EventScope(ProcessObject * filter);
+    ~EventScope();
+    EventScope(const EventScope &) = delete;
+    EventScope &
+    operator=(const EventScope &) = delete;
+
+  private:
+    EventRecord * m_Event{ nullptr };
+    EventRecord * m_EnclosingEvent{ nullptr };
+    double        m_StartCPUTime{ 0.0 };
+    SizeValueType m_StartAllocatedBytes{ 0 };
+  };
+
+  /** Records a work unit of the given event, which may be null, for the
+   * lifetime of the scope. */
+  class ITKCommon_EXPORT WorkUnitScope
+  {
+  public:
+    explicit WorkUnitScope(EventRecord * event);
+    ~WorkUnitScope();
+    WorkUnitScope(const WorkUnitScope &) = delete;
+    WorkUnitScope &
+    operator=(const WorkUnitScope &) = delete;
+
+  private:
+    EventRecord * m_Event;
+    double        m_StartTime{ 0.0 };
+    double        m_StartCPUTime{ 0.0 };
+  };
+
+  PipelineProfiler() = delete;
+
+private:
+  itkGetGlobalDeclarationMacro(PipelineProfilerGlobals, PimplGlobals);
+  static PipelineProfilerGlobals * m_PimplGlobals;
+};
+} // end namespace itk
+
+#endif
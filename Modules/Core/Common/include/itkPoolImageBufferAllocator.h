@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPoolImageBufferAllocator_h
+#define itkPoolImageBufferAllocator_h
+
+#include "itkImageBufferAllocator.h"
+#include "itkObjectFactory.h"
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+/** \class PoolImageBufferAllocator
+ * \brief Recycles the released image buffers of the same size class.
+ *
+ * Iterative pipelines allocate and release many temporary images of the
+ * same size. Instead of giving a released buffer back to the system, this
+ * allocator keeps it in a pool, and returns it for a later allocation of
+ * the same size class. The size classes are the powers of two up to 4 KiB,
+ * then eight classes between consecutive powers of two, so that at most an
+ * eighth of a buffer is wasted.
+ *
+ * The buffers are allocated by another allocator, an
+ * AlignedImageBufferAllocator by default. The pool holds at most
+ * MaximumPooledBytes bytes; buffers released beyond it are given back.
+ * The pooled buffers are given back by ReleasePooledBuffers(), and when
+ * the allocator is destroyed.
+ *
+ * \sa ImageBufferAllocator
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PoolImageBufferAllocator : public ImageBufferAllocator
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PoolImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = PoolImageBufferAllocator;
+  using Superclass = ImageBufferAllocator;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(PoolImageBufferAllocator);
+
+  void *
+  Allocate(SizeValueType numberOfBytes, bool zeroInitialize) override;
+
+  void
+  Deallocate(void * buffer, SizeValueType numberOfBytes) override;
+
+  [[nodiscard]] SizeValueType
+  GetAlignment() const override
+  {
+    return m_Allocator->GetAlignment();
+  }
+
+  /** Set/Get the allocator of the pooled buffers. Setting it releases the
+   * pooled buffers. */
+  /** @ITKStartGrouping */
+  void
+  SetAllocator(ImageBufferAllocator * allocator);
+  itkGetModifiableObjectMacro(Allocator, ImageBufferAllocator);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the maximum number of bytes held by the pool. Defaults to
+   * 1 GiB. */
+  /** @ITKStartGrouping */
+  itkSetMacro(MaximumPooledBytes, SizeValueType);
+  itkGetConstMacro(MaximumPooledBytes, SizeValueType);
+  /** @ITKEndGrouping */
+
+  /** Get the number of bytes of the buffers held by the pool. */
+  [[nodiscard]] SizeValueType
+  GetPooledBytes() const;
+
+  /** Give back the pooled buffers to the allocator. */
+  void
+  ReleasePooledBuffers();
+
+  /** The number of bytes of the size class of numberOfBytes. */
+  static SizeValueType
+  GetSizeClass(SizeValueType numberOfBytes);
+
+protected:
+  PoolImageBufferAllocator();
+  ~PoolImageBufferAllocator() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ImageBufferAllocator::Pointer                m_Allocator;
+  SizeValueType                                m_MaximumPooledBytes{ SizeValueType{ 1 } << 30 };
+  SizeValueType                                m_PooledBytes{ 0 };
+  std::map<SizeValueType, std::vector<void *>> m_Pool;
+  mutable std::mutex                           m_Mutex;
+};
+} // end namespace itk
+
+#endif
@@ -43,6 +43,7 @@ namespace itk
 {
 
 class MultiThreaderBase;
+class ProcessObjectResultCache;
 
 /** \class ProcessObject
  * \brief The base class for all process objects (source,
@@ -515,6 +516,32 @@ public:
   void
   SetMultiThreader(MultiThreaderBase * threader);
 
+  /** Set/Get the cache of the outputs of the process object. When a cache
+   * is set, the outputs are restored from it, instead of being generated,
+   * when they were stored for the same inputs and parameters. None is set
+   * by default. The cache is only used by the process objects which
+   * implement SerializeParameters().
+   * \sa ProcessObjectResultCache */
+  /** @ITKStartGrouping */
+  virtual void
+  SetResultCache(ProcessObjectResultCache * cache);
+  virtual ProcessObjectResultCache *
+  GetModifiableResultCache();
+  virtual const ProcessObjectResultCache *
+  GetResultCache() const;
+  /** @ITKEndGrouping */
+
+  /** Write the parameters which affect the outputs of the process object,
+   * other than its inputs, to a binary stream. Used by
+   * ProcessObjectResultCache to identify the outputs, so that only the
+   * process objects which support it are cached. Returns false when the
+   * process object does not support it, which is the default. */
+  virtual bool
+  SerializeParameters(std::ostream &) const
+  {
+    return false;
+  }
+
   /** An opportunity to deallocate a ProcessObject's bulk data
    *  storage. Some filters may wish to reuse existing bulk data
    *  storage to avoid unnecessary deallocation/allocation
@@ -1014,6 +1041,8 @@ private:
   /** Memory management ivars */
   bool m_ReleaseDataBeforeUpdateFlag{};
 
+  SmartPointer<ProcessObjectResultCache> m_ResultCache{};
+
   /** Friends of ProcessObject */
   friend class DataObject;
 
@@ -0,0 +1,190 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkProcessObjectResultCache_h
+#define itkProcessObjectResultCache_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace itk
+{
+class ProcessObject;
+
+/** \class ProcessObjectResultCache
+ * \brief Cache of the outputs of process objects, keyed by the content of
+ * their inputs and by their parameters.
+ *
+ * The pipeline only avoids executing a process object again while it and
+ * its inputs are not modified. A ProcessObjectResultCache, given to process
+ * objects by ProcessObject::SetResultCache(), also avoids executing them on
+ * inputs and with parameters for which their outputs were computed before,
+ * e.g. by other instances of the same filter. Before a process object
+ * executes, a key is computed from:
+ * - its class,
+ * - its parameters, written by ProcessObject::SerializeParameters(),
+ * - the content of its inputs, their meta-data and bulk data, written by
+ *   DataObject::SerializeContent().
+ *
+ * Caching is opted in by each class of process objects, by overriding
+ * SerializeParameters(). The process objects which do not, and those whose
+ * inputs cannot be serialized, such as decorated transforms, are always
+ * executed.
+ *
+ * On a hit, the outputs are restored from the cache with
+ * DataObject::DeserializeContent() instead of being generated; on a miss,
+ * they are generated and written to the cache with
+ * DataObject::SerializeContent(). A process object whose outputs cannot be
+ * serialized is always executed.
+ *
+ * The entries are held in memory, up to MaximumMemorySize bytes, and the
+ * least recently used ones are evicted first. When a CacheDirectory is set,
+ * the evicted entries are written to it, one file per entry, and read back
+ * from it on a later miss in memory. The files are kept, so that the
+ * directory may be shared with later runs.
+ *
+ * A ProcessObjectResultCache may be shared by several process objects,
+ * executed from several threads.
+ *
+ * \sa ProcessObject::SetResultCache()
+ * \ingroup ITKSystemObjects
+ * \ingroup DataProcessing
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ProcessObjectResultCache : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ProcessObjectResultCache);
+
+  /** Standard class type aliases. */
+  using Self = ProcessObjectResultCache;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ProcessObjectResultCache);
+
+  /** Counts of the lookups in the cache, and of its entries. */
+  struct Statistics
+  {
+    SizeValueType NumberOfHits{ 0 };
+    /** Number of the hits read from the cache directory. */
+    SizeValueType NumberOfDiskHits{ 0 };
+    SizeValueType NumberOfMisses{ 0 };
+    /** Number of entries evicted from memory, written to the cache
+     * directory or not. */
+    SizeValueType NumberOfEvictions{ 0 };
+    /** Number of evicted entries written to the cache directory. */
+    SizeValueType NumberOfSpills{ 0 };
+    /** Number of entries in memory, and their size in bytes. */
+    SizeValueType NumberOfEntries{ 0 };
+    SizeValueType MemorySize{ 0 };
+  };
+
+  /** Set/Get the maximum size, in bytes, of the entries held in memory.
+   * Defaults to 1 GiB. */
+  /** @ITKStartGrouping */
+  void
+  SetMaximumMemorySize(SizeValueType maximumMemorySize);
+  SizeValueType
+  GetMaximumMemorySize() const;
+  /** @ITKEndGrouping */
+
+  /** Set/Get the directory where the entries evicted from memory are
+   * written, or an empty string, the default, to discard them. */
+  /** @ITKStartGrouping */
+  void
+  SetCacheDirectory(const std::string & directory);
+  std::string
+  GetCacheDirectory() const;
+  /** @ITKEndGrouping */
+
+  /** Compute the key of the outputs of a process object, whose inputs are
+   * up to date. Returns an empty string when the parameters of the process
+   * object, or the content of one of its inputs, cannot be serialized. */
+  std::string
+  ComputeKey(ProcessObject * processObject) const;
+
+  /** Restore the outputs of the process object stored with the key.
+   * Returns false, on a miss, when there are none, or when they do not
+   * contain the requested regions of the outputs. */
+  bool
+  Retrieve(const std::string & key, ProcessObject * processObject);
+
+  /** Store the outputs of the process object with the key. Returns false
+   * when they cannot be serialized. */
+  bool
+  Store(const std::string & key, ProcessObject * processObject);
+
+  /** Get the counts of the lookups and of the entries. */
+  Statistics
+  GetStatistics() const;
+
+  /** Reset the counts of the lookups, evictions and spills. */
+  void
+  ResetStatistics();
+
+  /** Remove the entries held in memory. The files of the cache directory
+   * are kept. */
+  void
+  Clear();
+
+protected:
+  ProcessObjectResultCache() = default;
+  ~ProcessObjectResultCache() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  using ContentType = std::shared_ptr<const std::string>;
+  using EntryList = std::list<std::pair<std::string, ContentType>>;
+
+  // The following are called with the mutex locked.
+  void
+  Insert(const std::string & key, ContentType content);
+  void
+  EvictToMaximumMemorySize();
+  std::string
+  GetFileName(const std::string & key) const;
+
+  mutable std::mutex m_Mutex{};
+
+  /** The entries in memory, from the most to the least recently used. */
+  EntryList                                            m_Entries{};
+  std::unordered_map<std::string, EntryList::iterator> m_EntryOfKey{};
+
+  SizeValueType m_MaximumMemorySize{ SizeValueType{ 1 } << 30 };
+  std::string   m_CacheDirectory{};
+  Statistics    m_Statistics{};
+};
+
+/** Print the counts of the lookups and of the entries. */
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const ProcessObjectResultCache::Statistics & statistics);
+} // end namespace itk
+
+#endif
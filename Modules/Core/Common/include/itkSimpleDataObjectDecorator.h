@@ -100,6 +100,18 @@ public:
     return m_Component;
   }
   /** @ITKEndGrouping */
+
+  /** Write the contained object to a stream, as bytes when it is trivially
+   * copyable, or else as text when it can be written with operator<<.
+   * Only trivially copyable objects can be restored.
+   * \sa DataObject::SerializeContent() */
+  /** @ITKStartGrouping */
+  bool
+  SerializeContent(std::ostream & os) const override;
+  bool
+  DeserializeContent(std::istream & is) override;
+  /** @ITKEndGrouping */
+
 protected:
   SimpleDataObjectDecorator() = default;
   ~SimpleDataObjectDecorator() override = default;
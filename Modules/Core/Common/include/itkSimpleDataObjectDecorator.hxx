@@ -30,6 +30,9 @@
 
 #include "itkMath.h"
 
+#include <limits>
+#include <type_traits>
+
 namespace itk
 {
 /**
@@ -47,6 +50,63 @@ SimpleDataObjectDecorator<T>::Set(const T & val)
   }
 }
 
+namespace SimpleDataObjectDecoratorDetail
+{
+template <typename T, typename = void>
+struct IsStreamable : std::false_type
+{};
+
+template <typename T>
+struct IsStreamable<T, std::void_t<decltype(std::declval<std::ostream &>() << std::declval<const T &>())>>
+  : std::true_type
+{};
+} // namespace SimpleDataObjectDecoratorDetail
+
+template <typename T>
+bool
+SimpleDataObjectDecorator<T>::SerializeContent(std::ostream & os) const
+{
+  if constexpr (std::is_trivially_copyable_v<T>)
+  {
+    os.write(reinterpret_cast<const char *>(&m_Component), sizeof(T));
+    return static_cast<bool>(os);
+  }
+  else if constexpr (SimpleDataObjectDecoratorDetail::IsStreamable<T>::value)
+  {
+    const std::streamsize precision = os.precision(std::numeric_limits<double>::max_digits10);
+    os << m_Component << '\n';
+    os.precision(precision);
+    return static_cast<bool>(os);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+template <typename T>
+bool
+SimpleDataObjectDecorator<T>::DeserializeContent(std::istream & is)
+{
+  if constexpr (std::is_trivially_copyable_v<T>)
+  {
+    T component;
+    is.read(reinterpret_cast<char *>(&component), sizeof(T));
+    if (!is)
+    {
+      return false;
+    }
+    m_Component = component;
+    m_Initialized = true;
+    this->Modified();
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
 /**
  *
  */
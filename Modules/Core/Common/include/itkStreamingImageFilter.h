@@ -36,6 +36,13 @@ namespace itk
  * This filter will produce the entire output as one image, but the upstream
  * filters will do their processing in pieces.
  *
+ * When Pipelined is on, each piece is copied into the output on a background
+ * thread while the upstream pipeline computes the next piece. At most
+ * MaximumNumberOfPiecesInFlight pieces, in addition to the one being
+ * computed, are held in memory at the same time.
+ *
+ * \sa StreamingPieceQueue
+ *
  * \ingroup ITKSystemObjects
  * \ingroup DataProcessing
  * \ingroup ITKCommon
@@ -86,6 +93,21 @@ public:
    * will be executed this many times. */
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get whether the pieces are consumed on a background thread while
+   * the upstream pipeline computes the next piece. Off by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(Pipelined, bool);
+  itkGetConstMacro(Pipelined, bool);
+  itkBooleanMacro(Pipelined);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the maximum number of computed pieces waiting to be consumed
+   * when Pipelined is on. Defaults to 2. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(MaximumNumberOfPiecesInFlight, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(MaximumNumberOfPiecesInFlight, unsigned int);
+  /** @ITKEndGrouping */
+
   /** Get/Set the helper class for dividing the input into chunks. */
   /** @ITKStartGrouping */
   itkSetObjectMacro(RegionSplitter, SplitterType);
@@ -118,6 +140,8 @@ protected:
 private:
   unsigned int          m_NumberOfStreamDivisions{};
   RegionSplitterPointer m_RegionSplitter{};
+  bool                  m_Pipelined{ false };
+  unsigned int          m_MaximumNumberOfPiecesInFlight{ 2 };
 };
 } // end namespace itk
 
@@ -20,6 +20,7 @@
 #include "itkCommand.h"
 #include "itkImageAlgorithm.h"
 #include "itkImageRegionSplitterSlowDimension.h"
+#include "itkStreamingPieceQueue.h"
 
 namespace itk
 {
@@ -44,6 +45,8 @@ StreamingImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, In
   Superclass::PrintSelf(os, indent);
 
   os << indent << "Number of stream divisions: " << m_NumberOfStreamDivisions << std::endl;
+  itkPrintSelfBooleanMacro(Pipelined);
+  os << indent << "MaximumNumberOfPiecesInFlight: " << m_MaximumNumberOfPiecesInFlight << std::endl;
 
   itkPrintSelfObjectMacro(RegionSplitter);
 }
@@ -162,6 +165,31 @@ StreamingImageFilter<TInputImage, TOutputImage>::UpdateOutputData(DataObject * i
    * piece, and copy the results into the output image.
    */
   unsigned int piece = 0;
+  if (m_Pipelined && numDivisions > 1)
+  {
+    // Copy the pieces into the output in the background while the next ones
+    // are computed. The last piece is left to the loop below, which copies
+    // it without taking it from the input, so that the input ends up
+    // buffering it as when the pieces are not pipelined.
+    StreamingPieceQueue queue(m_MaximumNumberOfPiecesInFlight);
+    for (; piece + 1 < numDivisions && !this->GetAbortGenerateData(); ++piece)
+    {
+      InputImageRegionType streamRegion = outputRegion;
+      m_RegionSplitter->GetSplit(piece, numDivisions, streamRegion);
+
+      inputPtr->SetRequestedRegion(streamRegion);
+      inputPtr->PropagateRequestedRegion();
+      inputPtr->UpdateOutputData();
+
+      const InputImagePointer inputPiece = StreamingPieceQueue::TakePiece(inputPtr, streamRegion);
+      queue.Push([inputPiece, outputPtr, streamRegion] {
+        ImageAlgorithm::Copy(inputPiece.GetPointer(), outputPtr, streamRegion, streamRegion);
+      });
+
+      this->UpdateProgress(static_cast<float>(piece) / static_cast<float>(numDivisions));
+    }
+    queue.Wait();
+  }
   for (; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
   {
     InputImageRegionType streamRegion = outputRegion;
@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkStreamingPieceQueue_h
+#define itkStreamingPieceQueue_h
+
+#include "itkImageAlgorithm.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace itk
+{
+/** \class StreamingPieceQueue
+ * \brief Consumes the pieces of a streamed pipeline in the background.
+ *
+ * Streaming mappers (StreamingImageFilter, ImageFileWriter) update their
+ * input one piece at a time, then consume the piece by copying it into
+ * their output or by writing it to a file. StreamingPieceQueue runs the
+ * consumption of the pieces on a background thread, in the order in which
+ * they are pushed, so that the upstream pipeline computes piece N+1 while
+ * piece N is being written.
+ *
+ * At most MaximumNumberOfPiecesInFlight pieces are pushed but not yet
+ * consumed: Push() blocks until a piece is consumed when this limit is
+ * reached, which bounds the memory held by the pieces.
+ *
+ * An exception thrown while consuming a piece is rethrown by the next call
+ * to Push() or Wait(), after which the remaining pieces are discarded.
+ *
+ * \ingroup ITKSystemObjects
+ * \ingroup DataProcessing
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT StreamingPieceQueue
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(StreamingPieceQueue);
+
+  using ConsumerType = std::function<void()>;
+
+  explicit StreamingPieceQueue(unsigned int maximumNumberOfPiecesInFlight);
+
+  /** Waits for the pieces in flight, ignoring their exceptions. */
+  ~StreamingPieceQueue();
+
+  /** Queue the consumption of a piece, after waiting for a piece to be
+   * consumed when MaximumNumberOfPiecesInFlight are in flight. */
+  void
+  Push(ConsumerType consumer);
+
+  /** Wait for all the pieces to be consumed. */
+  void
+  Wait();
+
+  unsigned int
+  GetMaximumNumberOfPiecesInFlight() const
+  {
+    return m_MaximumNumberOfPiecesInFlight;
+  }
+
+  /** Take the piece of an image that has just been updated, so that it can
+   * be consumed while the upstream pipeline updates the next piece.
+   *
+   * When nothing else refers to its buffer and the buffered region is the
+   * requested piece, the buffer is taken from the image without a copy:
+   * the image is initialized, so that its source allocates a new buffer for
+   * the next piece. Otherwise (e.g. for grafted or in-place outputs, whose
+   * buffer may be overwritten, or when the source enlarged the region) the
+   * region of the piece is copied. */
+  template <typename TImage>
+  static typename TImage::Pointer
+  TakePiece(TImage * image, const typename TImage::RegionType & region)
+  {
+    auto piece = TImage::New();
+    piece->Graft(image);
+    // The image and the piece are the only references to the buffer.
+    if (image->GetBufferedRegion() == region && piece->GetPixelContainer()->GetReferenceCount() == 2)
+    {
+      image->Initialize();
+    }
+    else
+    {
+      piece = TImage::New();
+      piece->CopyInformation(image);
+      piece->SetBufferedRegion(region);
+      piece->Allocate();
+      ImageAlgorithm::Copy(image, piece.GetPointer(), region, region);
+    }
+    return piece;
+  }
+
+private:
+  void
+  ThreadExecute();
+
+  void
+  RethrowException();
+
+  const unsigned int m_MaximumNumberOfPiecesInFlight;
+
+  std::mutex               m_Mutex{};
+  std::condition_variable  m_PieceQueued{};
+  std::condition_variable  m_PieceConsumed{};
+  std::deque<ConsumerType> m_Pieces{};
+  unsigned int             m_NumberOfPiecesInFlight{ 0 };
+  std::exception_ptr       m_Exception{};
+  bool                     m_Stopping{ false };
+  std::thread              m_Thread{};
+};
+} // end namespace itk
+
+#endif
@@ -45,7 +45,12 @@ VectorImage<TPixel, VImageDimension>::Allocate(const bool UseValueInitialization
   this->ComputeOffsetTable();
   SizeValueType num = this->GetOffsetTable()[VImageDimension];
 
-  m_Buffer->Reserve(num * m_VectorLength, UseValueInitialization);
+  // For the allocators which follow the split of the region by the filters.
+  ImageIORegion bufferedRegion(VImageDimension);
+  ImageIORegionAdaptor<VImageDimension>::Convert(this->GetBufferedRegion(), bufferedRegion, IndexType{});
+  m_Buffer->SetImageRegion(bufferedRegion);
+
+  m_Buffer->Reserve(num * m_VectorLength, UseValueInitialization, this->GetBufferAllocator());
 }
 
 template <typename TPixel, unsigned int VImageDimension>
@@ -134,6 +139,55 @@ VectorImage<TPixel, VImageDimension>::Graft(const DataObject * data)
   this->Graft(imgData);
 }
 
+//----------------------------------------------------------------------------
+template <typename TPixel, unsigned int VImageDimension>
+bool
+VectorImage<TPixel, VImageDimension>::SerializeContent(std::ostream & os) const
+{
+  if constexpr (std::is_trivially_copyable_v<InternalPixelType>)
+  {
+    const SizeValueType numberOfBytes =
+      this->GetBufferedRegion().GetNumberOfPixels() * m_VectorLength * sizeof(InternalPixelType);
+    if (numberOfBytes > 0 && this->GetBufferPointer() == nullptr)
+    {
+      return false;
+    }
+    this->SerializeInformation(os, sizeof(InternalPixelType));
+    os.write(reinterpret_cast<const char *>(this->GetBufferPointer()), numberOfBytes);
+    return static_cast<bool>(os);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename TPixel, unsigned int VImageDimension>
+bool
+VectorImage<TPixel, VImageDimension>::DeserializeContent(std::istream & is)
+{
+  if constexpr (std::is_trivially_copyable_v<InternalPixelType>)
+  {
+    // The length of the vectors is that of the image written.
+    unsigned int vectorLength = 0;
+    if (!this->DeserializeInformation(is, sizeof(InternalPixelType), vectorLength))
+    {
+      return false;
+    }
+    this->SetVectorLength(vectorLength);
+    this->Allocate();
+    const SizeValueType numberOfBytes =
+      this->GetBufferedRegion().GetNumberOfPixels() * m_VectorLength * sizeof(InternalPixelType);
+    is.read(reinterpret_cast<char *>(this->GetBufferPointer()), numberOfBytes);
+    return static_cast<bool>(is);
+  }
+  else
+  {
+    return false;
+  }
+}
+
 //----------------------------------------------------------------------------
 template <typename TPixel, unsigned int VImageDimension>
 unsigned int
@@ -0,0 +1,270 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkConfigure.h"
+#include "itkIntTypes.h"
+#include "itkThreadSupport.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSingletonMacro.h"
+
+
+namespace itk
+{
+
+struct WorkStealingThreadPoolGlobals;
+
+/**
+ * \class WorkStealingThreadPool
+ * \brief Thread pool which balances the tasks of parallel loops by work
+ * stealing.
+ *
+ * Execute() runs a function for each index of a range of tasks, and returns
+ * when all of them are done. The range is put in the queue of the calling
+ * thread, and split in halves as it is executed: the upper half is queued
+ * while the lower one is processed, so that idle threads steal large parts
+ * of the remaining work from the front of the other queues.
+ *
+ * Each worker thread has its own queue, of a fixed capacity, guarded by its
+ * own mutex, so that submitting a loop neither allocates memory nor
+ * contends on a global lock. A thread which is not one of the workers
+ * shares a single queue with the other such threads.
+ *
+ * The calling thread does not block while the tasks are executed: it
+ * executes tasks, of its own loop or of others, until its loop is done.
+ * Parallel loops may therefore be nested, for instance by a filter which
+ * runs a parallel loop from within a work unit, without exhausting the
+ * threads of the pool.
+ *
+ * The pool is used by the WorkStealingMultiThreader. Initially it is started
+ * with GlobalDefaultNumberOfThreads worker threads.
+ *
+ * With NUMAAffinity on, the pool schedules the tasks statically instead:
+ * the tasks of a loop are assigned in contiguous blocks to the worker
+ * threads, task i of n to worker i * w / n of w, and a block is neither
+ * split nor stolen. Successive loops with the same number of tasks, such as
+ * the work units of successive filters over the same image, thus give each
+ * piece of an image to the same thread, which the worker threads are
+ * pinned to a CPU (on Linux) to keep on the same NUMA node. When the pixel
+ * buffers are first touched with the same split, e.g. by the
+ * FirstTouchImageBufferAllocator, each thread processes the memory of its
+ * own node. The calling thread, if it is not a worker, waits for the tasks
+ * instead of executing them. NUMAAffinity is initially on when the
+ * environment variable ITK_NUMA_AFFINITY is set to ON, TRUE or 1.
+ *
+ * \sa WorkStealingMultiThreader
+ * \sa ThreadPool
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT WorkStealingThreadPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WorkStealingThreadPool);
+
+  /** Standard class type aliases. */
+  using Self = WorkStealingThreadPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(WorkStealingThreadPool);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the WorkStealingThreadPool */
+  static Pointer
+  GetInstance();
+
+  /** Type of the function executed for each task, given the user data and
+   * the index of the task. */
+  using TaskFunctionType = void (*)(void * data, SizeValueType taskIndex);
+
+  /** Execute function(data, i) for each i in [0, numberOfTasks), in
+   * parallel, and return when all are done. The first exception thrown by
+   * a task is rethrown, after the other tasks are done; the tasks which
+   * have not started yet when it is thrown are skipped. */
+  void
+  Execute(SizeValueType numberOfTasks, TaskFunctionType function, void * data);
+
+  /** Execute function(i) for each i in [0, numberOfTasks). Example usage:
+\code
+pool->Execute(values.size(), [&values](SizeValueType i) { values[i] *= 2; });
+\endcode
+   */
+  template <typename TFunction>
+  void
+  Execute(SizeValueType numberOfTasks, TFunction && function)
+  {
+    using FunctionType = std::remove_reference_t<TFunction>;
+    this->Execute(
+      numberOfTasks,
+      [](void * data, SizeValueType taskIndex) { (*static_cast<FunctionType *>(data))(taskIndex); },
+      const_cast<void *>(static_cast<const void *>(&function)));
+  }
+
+  /** Can call this method if we want to add extra threads to the pool. The
+   * number of threads is limited to ITK_MAX_THREADS. */
+  void
+  AddThreads(ThreadIdType count);
+
+  /** Get the number of worker threads. */
+  ThreadIdType
+  GetMaximumNumberOfThreads() const;
+
+  /** Set/Get whether the tasks are statically assigned to the worker
+   * threads, which are pinned to CPUs. */
+  /** @ITKStartGrouping */
+  void
+  SetNUMAAffinity(bool numaAffinity);
+  bool
+  GetNUMAAffinity() const
+  {
+    return m_NUMAAffinity;
+  }
+  /** @ITKEndGrouping */
+
+  /** Get the index of the worker thread which executes task taskIndex of
+   * numberOfTasks when NUMAAffinity is on. */
+  ThreadIdType
+  GetWorkerOfTask(SizeValueType taskIndex, SizeValueType numberOfTasks) const;
+
+  /** Get the index of the worker thread calling this method, in [0,
+   * GetMaximumNumberOfThreads()), or -1 for a thread which is not a
+   * worker of the pool. */
+  static int
+  GetCurrentWorkerIndex();
+
+  /** Get the number of tasks which wait in the queues. */
+  SizeValueType
+  GetNumberOfQueuedTasks() const;
+
+protected:
+  WorkStealingThreadPool();
+
+  /** Stop the pool and release threads. To be called by the destructor and atfork. */
+  void
+  CleanUp();
+
+  ~WorkStealingThreadPool() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  static void
+  PrepareForFork();
+  static void
+  ResumeFromFork();
+
+private:
+  struct Job;
+  struct Task;
+  class TaskQueue;
+
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(WorkStealingThreadPoolGlobals, PimplGlobals);
+
+  /** Queue the task in the given queue, and wake up a sleeping thread.
+   * Returns false when the queue is full. */
+  bool
+  PushTask(unsigned int queueIndex, const Task & task);
+
+  /** Whether there may be a task which the thread of the given queue can
+   * execute. */
+  bool
+  HasTask(unsigned int queueIndex) const;
+
+  /** Take a task from the back of the given queue or, failing that, from
+   * the front of another one. */
+  bool
+  FindTask(unsigned int queueIndex, Task & task);
+
+  /** Execute the tasks of the range of the task, queueing its upper
+   * halves in the given queue. */
+  void
+  RunTask(unsigned int queueIndex, Task task);
+
+  /** Execute tasks until there is none left in any queue and, unless the
+   * given job is not null, until the job is done, then wait for more. */
+  void
+  WorkUntil(unsigned int queueIndex, const Job * job);
+
+  /** Queue the tasks of the job in contiguous blocks, one per worker, for
+   * NUMAAffinity. */
+  void
+  PushStaticTasks(Job & job, SizeValueType numberOfTasks);
+
+  /** Pin the worker thread of the given queue to a CPU when NUMAAffinity
+   * is on, or allow it to run on any CPU of the process otherwise. */
+  void
+  SetThreadAffinity(unsigned int queueIndex);
+
+  /** The continuously running thread function */
+  void
+  ThreadExecute(unsigned int queueIndex);
+
+  /** The queue of the threads which are not workers, followed by the queues
+   * of the workers. A queue is allocated before its worker is started, and
+   * kept until the pool is destroyed, so that the queues may be read
+   * without holding m_Mutex. */
+  std::unique_ptr<TaskQueue> m_Queues[ITK_MAX_THREADS + 1];
+  std::atomic<unsigned int>  m_NumberOfQueues{ 1 };
+
+  /** The number of queued tasks, except the static ones, which are counted
+   * by their queue. */
+  std::atomic<SizeValueType> m_NumberOfQueuedTasks{ 0 };
+  std::atomic<int>           m_NumberOfSleepingThreads{ 0 };
+
+  /** Threads with nothing to do wait on m_Condition, which is notified
+   * when a task is queued and when a job is done. */
+  mutable std::mutex      m_Mutex;
+  std::condition_variable m_Condition;
+
+  /** Vector to hold all thread handles.
+   * Thread handles are used to delete (join) the threads. */
+  std::vector<std::thread> m_Threads; // guarded by m_Mutex
+
+  /* Has destruction started? */
+  bool m_Stopping{ false }; // guarded by m_Mutex
+
+  std::atomic<bool> m_NUMAAffinity{ false };
+
+  /** The CPUs which the process may run on, to which the worker threads are
+   * pinned in order. */
+  std::vector<unsigned int> m_CPUs{};
+
+  static WorkStealingThreadPoolGlobals * m_PimplGlobals;
+};
+
+} // namespace itk
+#endif
@@ -0,0 +1,90 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAlignedImageBufferAllocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#if defined(_WIN32)
+#  include <malloc.h>
+#endif
+
+namespace itk
+{
+
+void *
+AlignedImageBufferAllocator::Allocate(SizeValueType numberOfBytes, bool zeroInitialize)
+{
+  void * buffer = AllocateAligned(numberOfBytes, m_Alignment);
+  if (buffer != nullptr && zeroInitialize)
+  {
+    std::memset(buffer, 0, numberOfBytes);
+  }
+  return buffer;
+}
+
+void
+AlignedImageBufferAllocator::Deallocate(void * buffer, SizeValueType)
+{
+  FreeAligned(buffer);
+}
+
+void
+AlignedImageBufferAllocator::SetAlignment(SizeValueType alignment)
+{
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+  {
+    itkExceptionMacro("The alignment must be a power of two, not " << alignment);
+  }
+  if (m_Alignment != alignment)
+  {
+    m_Alignment = alignment;
+    this->Modified();
+  }
+}
+
+void *
+AlignedImageBufferAllocator::AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  // Both allocation functions require at least the alignment of a pointer.
+  alignment = std::max<SizeValueType>(alignment, alignof(std::max_align_t));
+  // Allocate at least one byte, so that an empty buffer is not null.
+  numberOfBytes = std::max<SizeValueType>(numberOfBytes, 1);
+#if defined(_WIN32)
+  return _aligned_malloc(numberOfBytes, alignment);
+#else
+  void * buffer = nullptr;
+  if (posix_memalign(&buffer, alignment, numberOfBytes) != 0)
+  {
+    return nullptr;
+  }
+  return buffer;
+#endif
+}
+
+void
+AlignedImageBufferAllocator::FreeAligned(void * buffer)
+{
+#if defined(_WIN32)
+  _aligned_free(buffer);
+#else
+  std::free(buffer);
+#endif
+}
+} // end namespace itk
@@ -26,6 +26,7 @@
  *
  *=========================================================================*/
 #include "itkProcessObject.h"
+#include "itkImageBufferAllocator.h"
 #include "itkSingleton.h"
 
 namespace itk
@@ -123,6 +124,20 @@ DataObject::Initialize()
   //
 }
 
+//----------------------------------------------------------------------------
+void
+DataObject::SetBufferAllocator(ImageBufferAllocator * allocator)
+{
+  m_BufferAllocator = allocator;
+}
+
+//----------------------------------------------------------------------------
+ImageBufferAllocator *
+DataObject::GetBufferAllocator() const
+{
+  return m_BufferAllocator.GetPointer();
+}
+
 //----------------------------------------------------------------------------
 void
 DataObject::SetGlobalReleaseDataFlag(bool val)
@@ -273,6 +288,10 @@ DataObject::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "Release Data: " << (m_ReleaseDataFlag ? "On\n" : "Off\n");
 
+  os << indent << "Reuse Data: " << (m_ReuseDataFlag ? "On\n" : "Off\n");
+
+  itkPrintSelfObjectMacro(BufferAllocator);
+
   os << indent << "Data Released: " << (m_DataReleased ? "True\n" : "False\n");
 
   os << indent << "Global Release Data: " << (GetGlobalReleaseDataFlag() ? "On\n" : "Off\n");
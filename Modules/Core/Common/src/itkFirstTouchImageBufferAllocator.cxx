@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFirstTouchImageBufferAllocator.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace itk
+{
+
+void *
+FirstTouchImageBufferAllocator::Allocate(SizeValueType numberOfBytes, bool zeroInitialize)
+{
+  if (numberOfBytes < m_MinimumParallelBufferSize)
+  {
+    return Superclass::Allocate(numberOfBytes, zeroInitialize);
+  }
+
+  // Page aligned, so that no page is shared by two pieces.
+  constexpr SizeValueType pageSize = 4096;
+  auto * const            buffer =
+    static_cast<unsigned char *>(AllocateAligned(numberOfBytes, std::max(this->GetAlignment(), pageSize)));
+  if (buffer == nullptr)
+  {
+    return nullptr;
+  }
+
+  const auto          multiThreader = MultiThreaderBase::New();
+  const SizeValueType numberOfPieces = multiThreader->GetNumberOfWorkUnits();
+  const SizeValueType numberOfPages = (numberOfBytes + pageSize - 1) / pageSize;
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [buffer, numberOfBytes, numberOfPages, numberOfPieces, zeroInitialize](SizeValueType piece) {
+      const SizeValueType begin = std::min(numberOfBytes, numberOfPages * piece / numberOfPieces * pageSize);
+      const SizeValueType end = std::min(numberOfBytes, numberOfPages * (piece + 1) / numberOfPieces * pageSize);
+      if (zeroInitialize)
+      {
+        std::memset(buffer + begin, 0, end - begin);
+      }
+      else
+      {
+        for (SizeValueType page = begin; page < end; page += pageSize)
+        {
+          buffer[page] = 0;
+        }
+      }
+    },
+    nullptr);
+  return buffer;
+}
+
+void *
+FirstTouchImageBufferAllocator::AllocateForRegion(SizeValueType         numberOfBytes,
+                                                  const ImageIORegion & region,
+                                                  bool                  zeroInitialize)
+{
+  const SizeValueType numberOfPixels = region.GetNumberOfPixels();
+  if (numberOfBytes < m_MinimumParallelBufferSize || numberOfPixels == 0 || numberOfBytes % numberOfPixels != 0)
+  {
+    return this->Allocate(numberOfBytes, zeroInitialize);
+  }
+
+  constexpr SizeValueType pageSize = 4096;
+  auto * const            buffer =
+    static_cast<unsigned char *>(AllocateAligned(numberOfBytes, std::max(this->GetAlignment(), pageSize)));
+  if (buffer == nullptr)
+  {
+    return nullptr;
+  }
+
+  const unsigned int               dimension = region.GetImageDimension();
+  const SizeValueType              bytesPerPixel = numberOfBytes / numberOfPixels;
+  const ImageIORegion::IndexType & index = region.GetIndex();
+  const ImageIORegion::SizeType &  size = region.GetSize();
+
+  const auto multiThreader = MultiThreaderBase::New();
+  multiThreader->ParallelizeImageRegion(
+    dimension,
+    index.data(),
+    size.data(),
+    [=, &index, &size](const IndexValueType * pieceIndex, const SizeValueType * pieceSize) {
+      // The piece is made of runs of pixels which are contiguous in the
+      // buffer: its lines, merged along the dimensions it spans entirely.
+      SizeValueType runLength = pieceSize[0];
+      unsigned int  runDimension = 1;
+      while (runDimension < dimension && pieceSize[runDimension - 1] == size[runDimension - 1])
+      {
+        runLength *= pieceSize[runDimension];
+        ++runDimension;
+      }
+
+      std::vector<SizeValueType> position(dimension, 0);
+      while (true)
+      {
+        SizeValueType offset = 0;
+        SizeValueType stride = 1;
+        for (unsigned int d = 0; d < dimension; ++d)
+        {
+          offset += (static_cast<SizeValueType>(pieceIndex[d] - index[d]) + position[d]) * stride;
+          stride *= size[d];
+        }
+        const SizeValueType begin = offset * bytesPerPixel;
+        const SizeValueType end = begin + runLength * bytesPerPixel;
+        if (zeroInitialize)
+        {
+          std::memset(buffer + begin, 0, end - begin);
+        }
+        else
+        {
+          // Each page is touched by the run which holds its first byte.
+          for (SizeValueType page = (begin + pageSize - 1) / pageSize * pageSize; page < end; page += pageSize)
+          {
+            buffer[page] = 0;
+          }
+        }
+
+        unsigned int d = runDimension;
+        while (d < dimension && ++position[d] == pieceSize[d])
+        {
+          position[d] = 0;
+          ++d;
+        }
+        if (d >= dimension)
+        {
+          break;
+        }
+      }
+    },
+    nullptr);
+  return buffer;
+}
+
+void
+FirstTouchImageBufferAllocator::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MinimumParallelBufferSize: " << m_MinimumParallelBufferSize << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHugePageImageBufferAllocator.h"
+
+#include <cstring>
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace itk
+{
+
+void *
+HugePageImageBufferAllocator::Allocate(SizeValueType numberOfBytes, bool zeroInitialize)
+{
+  if (numberOfBytes < m_HugePageSize)
+  {
+    return Superclass::Allocate(numberOfBytes, zeroInitialize);
+  }
+
+  // Pad to whole huge pages, so that the advice does not extend to memory
+  // outside of the buffer.
+  const SizeValueType paddedNumberOfBytes = (numberOfBytes + m_HugePageSize - 1) & ~(m_HugePageSize - 1);
+  void *              buffer = AllocateAligned(paddedNumberOfBytes, m_HugePageSize);
+  if (buffer == nullptr)
+  {
+    return nullptr;
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // The advice is only a hint: the buffer is usable whether it is followed
+  // or not.
+  madvise(buffer, paddedNumberOfBytes, MADV_HUGEPAGE);
+#endif
+  if (zeroInitialize)
+  {
+    std::memset(buffer, 0, numberOfBytes);
+  }
+  return buffer;
+}
+
+void
+HugePageImageBufferAllocator::SetHugePageSize(SizeValueType hugePageSize)
+{
+  if (hugePageSize == 0 || (hugePageSize & (hugePageSize - 1)) != 0)
+  {
+    itkExceptionMacro("The huge page size must be a power of two, not " << hugePageSize);
+  }
+  if (m_HugePageSize != hugePageSize)
+  {
+    m_HugePageSize = hugePageSize;
+    this->Modified();
+  }
+}
+
+void
+HugePageImageBufferAllocator::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "HugePageSize: " << m_HugePageSize << std::endl;
+}
+} // end namespace itk
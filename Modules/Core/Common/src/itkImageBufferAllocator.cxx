@@ -0,0 +1,182 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocator.h"
+#include "itkAlignedImageBufferAllocator.h"
+#include "itkFirstTouchImageBufferAllocator.h"
+#include "itkHugePageImageBufferAllocator.h"
+#include "itkPoolImageBufferAllocator.h"
+#include "itkObjectFactoryBase.h"
+#include "itkSingleton.h"
+#include "itksys/SystemTools.hxx"
+
+#include <atomic>
+#include <mutex>
+
+namespace itk
+{
+
+struct ImageBufferAllocatorGlobals
+{
+  // The environment variable ITK_IMAGE_BUFFER_ALLOCATOR is only used when
+  // the global default allocator has not been set before it is first
+  // requested.
+  bool                          GlobalDefaultAllocatorIsInitialized{ false };
+  std::mutex                    GlobalDefaultAllocatorMutex;
+  ImageBufferAllocator::Pointer GlobalDefaultAllocator;
+  std::atomic<SizeValueType>    NumberOfAllocations{ 0 };
+  std::atomic<SizeValueType>    NumberOfDeallocations{ 0 };
+  std::atomic<SizeValueType>    NumberOfReuses{ 0 };
+  std::atomic<SizeValueType>    AllocatedBytes{ 0 };
+  std::atomic<SizeValueType>    BytesInUse{ 0 };
+  std::atomic<SizeValueType>    PeakBytesInUse{ 0 };
+};
+
+itkGetGlobalSimpleMacro(ImageBufferAllocator, ImageBufferAllocatorGlobals, PimplGlobals);
+ImageBufferAllocatorGlobals * ImageBufferAllocator::m_PimplGlobals;
+
+void *
+ImageBufferAllocator::AllocateForRegion(SizeValueType numberOfBytes, const ImageIORegion &, bool zeroInitialize)
+{
+  return this->Allocate(numberOfBytes, zeroInitialize);
+}
+
+void
+ImageBufferAllocator::SetGlobalDefaultAllocator(ImageBufferAllocator * allocator)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->GlobalDefaultAllocatorMutex);
+  m_PimplGlobals->GlobalDefaultAllocator = allocator;
+  m_PimplGlobals->GlobalDefaultAllocatorIsInitialized = true;
+}
+
+auto
+ImageBufferAllocator::GetGlobalDefaultAllocator() -> Pointer
+{
+  itkInitGlobalsMacro(PimplGlobals);
+
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->GlobalDefaultAllocatorMutex);
+  if (!m_PimplGlobals->GlobalDefaultAllocatorIsInitialized)
+  {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_IMAGE_BUFFER_ALLOCATOR", envVar) && !envVar.empty())
+    {
+      m_PimplGlobals->GlobalDefaultAllocator = CreateAllocator(envVar);
+      if (m_PimplGlobals->GlobalDefaultAllocator.IsNull())
+      {
+        itkGenericOutputMacro("Warning: ITK_IMAGE_BUFFER_ALLOCATOR names no image buffer allocator: " << envVar);
+      }
+    }
+    m_PimplGlobals->GlobalDefaultAllocatorIsInitialized = true;
+  }
+  return m_PimplGlobals->GlobalDefaultAllocator;
+}
+
+auto
+ImageBufferAllocator::CreateAllocator(const std::string & className) -> Pointer
+{
+  if (className == "AlignedImageBufferAllocator")
+  {
+    return AlignedImageBufferAllocator::New().GetPointer();
+  }
+  if (className == "HugePageImageBufferAllocator")
+  {
+    return HugePageImageBufferAllocator::New().GetPointer();
+  }
+  if (className == "FirstTouchImageBufferAllocator")
+  {
+    return FirstTouchImageBufferAllocator::New().GetPointer();
+  }
+  if (className == "PoolImageBufferAllocator")
+  {
+    return PoolImageBufferAllocator::New().GetPointer();
+  }
+  // A class provided by a factory.
+  const LightObject::Pointer object = ObjectFactoryBase::CreateInstance(className.c_str());
+  return dynamic_cast<ImageBufferAllocator *>(object.GetPointer());
+}
+
+auto
+ImageBufferAllocator::GetStatistics() -> Statistics
+{
+  itkInitGlobalsMacro(PimplGlobals);
+
+  Statistics statistics;
+  statistics.NumberOfAllocations = m_PimplGlobals->NumberOfAllocations;
+  statistics.NumberOfDeallocations = m_PimplGlobals->NumberOfDeallocations;
+  statistics.NumberOfReuses = m_PimplGlobals->NumberOfReuses;
+  statistics.AllocatedBytes = m_PimplGlobals->AllocatedBytes;
+  statistics.BytesInUse = m_PimplGlobals->BytesInUse;
+  statistics.PeakBytesInUse = m_PimplGlobals->PeakBytesInUse;
+  return statistics;
+}
+
+void
+ImageBufferAllocator::ResetPeakBytesInUse()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->PeakBytesInUse = m_PimplGlobals->BytesInUse.load();
+}
+
+void
+ImageBufferAllocator::RecordAllocation(SizeValueType numberOfBytes)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+
+  ++m_PimplGlobals->NumberOfAllocations;
+  m_PimplGlobals->AllocatedBytes += numberOfBytes;
+  const SizeValueType bytesInUse = (m_PimplGlobals->BytesInUse += numberOfBytes);
+  SizeValueType       peak = m_PimplGlobals->PeakBytesInUse;
+  while (peak < bytesInUse && !m_PimplGlobals->PeakBytesInUse.compare_exchange_weak(peak, bytesInUse))
+  {
+  }
+}
+
+void
+ImageBufferAllocator::RecordDeallocation(SizeValueType numberOfBytes)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+
+  ++m_PimplGlobals->NumberOfDeallocations;
+  m_PimplGlobals->BytesInUse -= numberOfBytes;
+}
+
+void
+ImageBufferAllocator::RecordReuse()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  ++m_PimplGlobals->NumberOfReuses;
+}
+
+void
+ImageBufferAllocator::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Alignment: " << this->GetAlignment() << std::endl;
+}
+
+std::ostream &
+operator<<(std::ostream & out, const ImageBufferAllocator::Statistics & statistics)
+{
+  return out << "NumberOfAllocations: " << statistics.NumberOfAllocations
+             << ", NumberOfDeallocations: " << statistics.NumberOfDeallocations
+             << ", NumberOfReuses: " << statistics.NumberOfReuses << ", AllocatedBytes: " << statistics.AllocatedBytes
+             << ", BytesInUse: " << statistics.BytesInUse << ", PeakBytesInUse: " << statistics.PeakBytesInUse;
+}
+} // end namespace itk
@@ -17,6 +17,8 @@
  *=========================================================================*/
 #include "itkMemoryProbe.h"
 
+#include <algorithm>
+
 namespace itk
 {
 MemoryProbe::MemoryProbe()
@@ -30,4 +32,54 @@ MemoryProbe::GetInstantValue() const
 {
   return static_cast<MemoryProbe::MemoryLoadType>(m_MemoryObserver.GetMemoryUsage());
 }
+
+void
+MemoryProbe::Start()
+{
+  ImageBufferAllocator::ResetPeakBytesInUse();
+  m_ImageBufferStatisticsAtStart = ImageBufferAllocator::GetStatistics();
+  Superclass::Start();
+}
+
+void
+MemoryProbe::Stop()
+{
+  if (this->GetNumberOfStops() == this->GetNumberOfStarts())
+  {
+    return;
+  }
+  Superclass::Stop();
+
+  const ImageBufferAllocator::Statistics statistics = ImageBufferAllocator::GetStatistics();
+  const ImageBufferAllocator::Statistics & atStart = m_ImageBufferStatisticsAtStart;
+  m_NumberOfImageBufferAllocations += statistics.NumberOfAllocations - atStart.NumberOfAllocations;
+  m_NumberOfImageBufferReuses += statistics.NumberOfReuses - atStart.NumberOfReuses;
+  m_ImageBufferAllocatedBytes += statistics.AllocatedBytes - atStart.AllocatedBytes;
+  if (statistics.PeakBytesInUse > atStart.BytesInUse)
+  {
+    m_ImageBufferPeakBytes = std::max(m_ImageBufferPeakBytes, statistics.PeakBytesInUse - atStart.BytesInUse);
+  }
+}
+
+void
+MemoryProbe::Reset()
+{
+  Superclass::Reset();
+
+  m_NumberOfImageBufferAllocations = 0;
+  m_NumberOfImageBufferReuses = 0;
+  m_ImageBufferAllocatedBytes = 0;
+  m_ImageBufferPeakBytes = 0;
+}
+
+void
+MemoryProbe::Print(std::ostream & os, Indent indent) const
+{
+  Superclass::Print(os, indent);
+
+  os << indent << "NumberOfImageBufferAllocations: " << m_NumberOfImageBufferAllocations << std::endl;
+  os << indent << "NumberOfImageBufferReuses: " << m_NumberOfImageBufferReuses << std::endl;
+  os << indent << "ImageBufferAllocatedBytes: " << m_ImageBufferAllocatedBytes << std::endl;
+  os << indent << "ImageBufferPeakBytes: " << m_ImageBufferPeakBytes << std::endl;
+}
 } // end namespace itk
@@ -31,6 +31,7 @@
 
 #if defined(ITK_USE_POOL_MULTI_THREADER)
 #  include "itkPoolMultiThreader.h"
+#  include "itkWorkStealingMultiThreader.h"
 #endif
 #include "itkNumericTraits.h"
 #include <mutex>
@@ -212,6 +213,10 @@ MultiThreaderBase::ThreaderTypeFromString(std::string threaderString)
   {
     return ThreaderEnum::Single;
   }
+  else if (threaderString == "WORKSTEALING")
+  {
+    return ThreaderEnum::WorkStealing;
+  }
   else
   {
     return ThreaderEnum::Unknown;
@@ -411,6 +416,12 @@ MultiThreaderBase::New()
 #endif
       case ThreaderEnum::Single:
         return SingleMultiThreader::New();
+      case ThreaderEnum::WorkStealing:
+#if defined(ITK_USE_POOL_MULTI_THREADER)
+        return WorkStealingMultiThreader::New();
+#else
+        itkGenericExceptionMacro("ITK has been built without WorkStealingMultiThreader support!");
+#endif
       default:
         itkGenericExceptionMacro("MultiThreaderBase::GetGlobalDefaultThreader returned Unknown!");
     }
@@ -610,6 +621,8 @@ operator<<(std::ostream & out, const MultiThreaderBaseEnums::Threader value)
         return "itk::MultiThreaderBaseEnums::Threader::TBB";
       case MultiThreaderBaseEnums::Threader::Single:
         return "itk::MultiThreaderBaseEnums::Threader::Single";
+      case MultiThreaderBaseEnums::Threader::WorkStealing:
+        return "itk::MultiThreaderBaseEnums::Threader::WorkStealing";
         //      TODO    case MultiThreaderBaseEnums::Threader::Last:
         //                    return "itk::MultiThreaderBaseEnums::Threader::Last";
       case MultiThreaderBaseEnums::Threader::Unknown:
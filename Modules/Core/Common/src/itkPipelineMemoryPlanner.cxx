@@ -0,0 +1,341 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineMemoryPlanner.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace itk
+{
+
+namespace
+{
+// Whether the data object would be generated again by
+// DataObject::UpdateOutputData().
+bool
+NeedsUpdate(const DataObject & dataObject)
+{
+  return dataObject.GetUpdateMTime() < dataObject.GetPipelineMTime() || dataObject.GetDataReleased() ||
+         const_cast<DataObject &>(dataObject).RequestedRegionIsOutsideOfTheBufferedRegion();
+}
+
+// Sets the ReuseDataFlag and the buffer allocator of data objects for the
+// lifetime of the scope, and restores their previous values after it.
+class DataObjectSettingsScope
+{
+public:
+  DataObjectSettingsScope() = default;
+
+  ~DataObjectSettingsScope()
+  {
+    for (const Settings & settings : m_PreviousSettings)
+    {
+      settings.Object->SetReuseDataFlag(settings.ReuseDataFlag);
+      settings.Object->SetBufferAllocator(settings.BufferAllocator);
+    }
+  }
+
+  ITK_DISALLOW_COPY_AND_MOVE(DataObjectSettingsScope);
+
+  void
+  SetReuseDataFlag(DataObject * dataObject, bool flag)
+  {
+    this->Save(dataObject);
+    dataObject->SetReuseDataFlag(flag);
+  }
+
+  void
+  SetBufferAllocator(DataObject * dataObject, ImageBufferAllocator * allocator)
+  {
+    this->Save(dataObject);
+    dataObject->SetBufferAllocator(allocator);
+  }
+
+private:
+  struct Settings
+  {
+    DataObject::Pointer           Object;
+    bool                          ReuseDataFlag;
+    ImageBufferAllocator::Pointer BufferAllocator;
+  };
+
+  // Saves the settings of the data object the first time it is changed.
+  void
+  Save(DataObject * dataObject)
+  {
+    if (m_SavedObjects.insert(dataObject).second)
+    {
+      m_PreviousSettings.push_back({ dataObject, dataObject->GetReuseDataFlag(), dataObject->GetBufferAllocator() });
+    }
+  }
+
+  std::set<const DataObject *> m_SavedObjects;
+  std::vector<Settings>        m_PreviousSettings;
+};
+
+// Lets the pool keep the buffers released during the lifetime of the scope,
+// and gives them back after it, so that the buffers of the outputs released
+// later are not pooled either.
+class PoolScope
+{
+public:
+  PoolScope(PoolImageBufferAllocator * pool, SizeValueType maximumPooledBytes)
+    : m_Pool(pool)
+  {
+    m_Pool->SetMaximumPooledBytes(maximumPooledBytes);
+  }
+
+  ~PoolScope()
+  {
+    m_Pool->SetMaximumPooledBytes(0);
+    m_Pool->ReleasePooledBuffers();
+  }
+
+  ITK_DISALLOW_COPY_AND_MOVE(PoolScope);
+
+private:
+  PoolImageBufferAllocator * m_Pool;
+};
+} // namespace
+
+PipelineMemoryPlanner::PipelineMemoryPlanner()
+  : m_Pool(PoolImageBufferAllocator::New())
+  , m_MaximumPooledBytes(m_Pool->GetMaximumPooledBytes())
+{
+  m_Pool->SetMaximumPooledBytes(0);
+}
+
+void
+PipelineMemoryPlanner::AddOutput(DataObject * output)
+{
+  if (output != nullptr && std::find(m_Outputs.cbegin(), m_Outputs.cend(), output) == m_Outputs.cend())
+  {
+    m_Outputs.emplace_back(output);
+    this->Modified();
+  }
+}
+
+void
+PipelineMemoryPlanner::ClearOutputs()
+{
+  m_Outputs.clear();
+  m_Steps.clear();
+  m_ReuseDataFlags.clear();
+  this->Modified();
+}
+
+std::vector<ProcessObject *>
+PipelineMemoryPlanner::GetExecutionOrder() const
+{
+  std::vector<ProcessObject *> filters;
+  for (const Step & step : m_Steps)
+  {
+    filters.push_back(step.Filter);
+  }
+  return filters;
+}
+
+void
+PipelineMemoryPlanner::Plan()
+{
+  m_Steps.clear();
+  m_ReuseDataFlags.clear();
+
+  // The filters upstream of the outputs, in depth-first post-order, so that
+  // each filter comes after the filters of its inputs.
+  std::set<const ProcessObject *> visitedFilters;
+  const auto                      visit = [this, &visitedFilters](const auto & self, DataObject * dataObject) {
+    const ProcessObject::Pointer filter = dataObject->GetSource();
+    if (filter.IsNull() || !visitedFilters.insert(filter).second)
+    {
+      return;
+    }
+    for (DataObject * input : filter->GetInputs())
+    {
+      if (input != nullptr)
+      {
+        self(self, input);
+      }
+    }
+    m_Steps.push_back({ filter, {}, false });
+  };
+  for (const DataObject::Pointer & output : m_Outputs)
+  {
+    visit(visit, output);
+  }
+
+  // The filters which use each data object.
+  std::map<DataObject *, std::vector<size_t>> usesOfDataObject;
+  for (size_t i = 0; i < m_Steps.size(); ++i)
+  {
+    for (DataObject * input : m_Steps[i].Filter->GetInputs())
+    {
+      if (input != nullptr)
+      {
+        usesOfDataObject[input].push_back(i);
+      }
+    }
+  }
+  const std::set<DataObject *> outputs(m_Outputs.cbegin(), m_Outputs.cend());
+  const auto isIntermediate = [&outputs](DataObject * dataObject) {
+    return outputs.count(dataObject) == 0 && dataObject->GetSource() != nullptr;
+  };
+
+  // The filters whose outputs are used by the filters executed after them,
+  // or kept, and need to be updated.
+  for (size_t i = m_Steps.size(); i-- > 0;)
+  {
+    Step & step = m_Steps[i];
+    for (DataObject * output : step.Filter->GetOutputs())
+    {
+      if (output == nullptr || !NeedsUpdate(*output))
+      {
+        continue;
+      }
+      const std::vector<size_t> & uses = usesOfDataObject[output];
+      step.IsNeeded |= outputs.count(output) != 0 ||
+                       std::any_of(uses.cbegin(), uses.cend(), [this](size_t use) { return m_Steps[use].IsNeeded; });
+    }
+  }
+
+  // The intermediate data objects are released after the last filter which
+  // uses them, or which generates them when no filter uses them.
+  for (size_t i = 0; i < m_Steps.size(); ++i)
+  {
+    for (DataObject * output : m_Steps[i].Filter->GetOutputs())
+    {
+      if (output == nullptr || !isIntermediate(output))
+      {
+        continue;
+      }
+      const std::vector<size_t> & uses = usesOfDataObject[output];
+      m_ReuseDataFlags[output] = uses.size() == 1;
+
+      size_t lastUse = i;
+      bool   isUsed = m_Steps[i].IsNeeded;
+      for (const size_t use : uses)
+      {
+        if (m_Steps[use].IsNeeded)
+        {
+          lastUse = std::max(lastUse, use);
+          isUsed = true;
+        }
+      }
+      if (isUsed)
+      {
+        m_Steps[lastUse].LastUses.emplace_back(output);
+      }
+    }
+  }
+
+  // The data objects kept, or not generated by the pipeline.
+  for (const auto & dataObjectAndUses : usesOfDataObject)
+  {
+    if (!isIntermediate(dataObjectAndUses.first))
+    {
+      m_ReuseDataFlags[dataObjectAndUses.first] = false;
+    }
+  }
+}
+
+void
+PipelineMemoryPlanner::Update()
+{
+  for (const DataObject::Pointer & output : m_Outputs)
+  {
+    output->UpdateOutputInformation();
+    output->PropagateRequestedRegion();
+  }
+  this->Plan();
+
+  // The data objects are only set up, and the pool only keeps buffers, for
+  // the execution, even when it fails.
+  const PoolScope         poolScope(m_Pool, m_MaximumPooledBytes);
+  DataObjectSettingsScope settingsScope;
+  for (const auto & dataObjectAndFlag : m_ReuseDataFlags)
+  {
+    settingsScope.SetReuseDataFlag(dataObjectAndFlag.first, dataObjectAndFlag.second);
+  }
+  if (m_RecycleBuffers)
+  {
+    const ImageBufferAllocator::Pointer allocator = ImageBufferAllocator::GetGlobalDefaultAllocator();
+    if (allocator.IsNotNull() && allocator != m_Pool && allocator != m_Pool->GetAllocator())
+    {
+      m_Pool->SetAllocator(allocator);
+    }
+    for (const Step & step : m_Steps)
+    {
+      for (DataObject * output : step.Filter->GetOutputs())
+      {
+        if (output != nullptr)
+        {
+          settingsScope.SetBufferAllocator(output, m_Pool);
+        }
+      }
+    }
+  }
+
+  const ImageBufferAllocator::Statistics initialStatistics = ImageBufferAllocator::GetStatistics();
+  ImageBufferAllocator::ResetPeakBytesInUse();
+  m_NumberOfExecutedFilters = 0;
+  m_NumberOfReleasedDataObjects = 0;
+
+  for (const Step & step : m_Steps)
+  {
+    if (!step.IsNeeded)
+    {
+      continue;
+    }
+    step.Filter->UpdateOutputData(nullptr);
+    ++m_NumberOfExecutedFilters;
+
+    for (const DataObject::Pointer & dataObject : step.LastUses)
+    {
+      if (!dataObject->GetDataReleased())
+      {
+        dataObject->ReleaseData();
+        ++m_NumberOfReleasedDataObjects;
+      }
+    }
+  }
+
+  const ImageBufferAllocator::Statistics statistics = ImageBufferAllocator::GetStatistics();
+  m_PeakBytes = statistics.PeakBytesInUse > initialStatistics.BytesInUse
+                  ? statistics.PeakBytesInUse - initialStatistics.BytesInUse
+                  : 0;
+  m_NumberOfRecycledBuffers = statistics.NumberOfReuses - initialStatistics.NumberOfReuses;
+}
+
+void
+PipelineMemoryPlanner::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfOutputs: " << m_Outputs.size() << std::endl;
+  os << indent << "NumberOfFilters: " << m_Steps.size() << std::endl;
+  itkPrintSelfObjectMacro(Pool);
+  os << indent << "MaximumPooledBytes: " << m_MaximumPooledBytes << std::endl;
+  itkPrintSelfBooleanMacro(RecycleBuffers);
+  os << indent << "NumberOfExecutedFilters: " << m_NumberOfExecutedFilters << std::endl;
+  os << indent << "NumberOfReleasedDataObjects: " << m_NumberOfReleasedDataObjects << std::endl;
+  os << indent << "NumberOfRecycledBuffers: " << m_NumberOfRecycledBuffers << std::endl;
+  os << indent << "PeakBytes: " << m_PeakBytes << std::endl;
+}
+
+} // end namespace itk
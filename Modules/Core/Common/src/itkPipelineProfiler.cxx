@@ -0,0 +1,389 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineProfiler.h"
+#include "itkImageBase.h"
+#include "itkImageBufferAllocator.h"
+#include "itkProcessObject.h"
+#include "itkSingleton.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#  include "itkWindows.h"
+#endif
+
+namespace itk
+{
+
+struct PipelineProfilerGlobals
+{
+  // The environment variable ITK_PIPELINE_PROFILE is only used when
+  // profiling has not been enabled or disabled before it is first queried.
+  std::once_flag                            EnabledIsInitialized;
+  std::atomic<bool>                         Enabled{ false };
+  std::string                               TraceFileName;
+  std::chrono::steady_clock::time_point     StartTime{ std::chrono::steady_clock::now() };
+  std::atomic<SizeValueType>                NumberOfThreads{ 0 };
+  std::mutex                                EventsMutex;
+  // A deque, so that the events stay in place while they are recorded.
+  std::deque<PipelineProfiler::EventRecord> Events;
+};
+
+itkGetGlobalSimpleMacro(PipelineProfiler, PipelineProfilerGlobals, PimplGlobals);
+PipelineProfilerGlobals * PipelineProfiler::m_PimplGlobals;
+
+namespace
+{
+thread_local PipelineProfiler::EventRecord * currentEvent = nullptr;
+
+double
+GetThreadCPUTime()
+{
+#if defined(_WIN32)
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+  {
+    return 0.0;
+  }
+  const auto toSeconds = [](const FILETIME & time) {
+    return (static_cast<double>(time.dwHighDateTime) * 4294967296.0 + time.dwLowDateTime) * 1.0e-7;
+  };
+  return toSeconds(kernelTime) + toSeconds(userTime);
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+  timespec time{};
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+  {
+    return 0.0;
+  }
+  return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1.0e-9;
+#else
+  // The CPU time of the process, when the one of the thread is unknown.
+  return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+std::string
+EscapeJSON(const std::string & text)
+{
+  std::ostringstream escaped;
+  for (const char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      escaped << '\\' << c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    }
+    else
+    {
+      escaped << c;
+    }
+  }
+  return escaped.str();
+}
+
+template <unsigned int VDimension>
+bool
+AppendRequestedRegion(const DataObject * output, std::ostringstream & regions, SizeValueType & numberOfPixels)
+{
+  const auto * image = dynamic_cast<const ImageBase<VDimension> *>(output);
+  if (image == nullptr)
+  {
+    return false;
+  }
+  const ImageRegion<VDimension> & region = image->GetRequestedRegion();
+  if (regions.tellp() > 0)
+  {
+    regions << ' ';
+  }
+  regions << region.GetIndex() << region.GetSize();
+  numberOfPixels += region.GetNumberOfPixels();
+  return true;
+}
+} // namespace
+
+double
+PipelineProfiler::EventRecord::GetLoadImbalance() const
+{
+  if (WorkUnits.empty())
+  {
+    return 1.0;
+  }
+  double total = 0.0;
+  double longest = 0.0;
+  for (const WorkUnitRecord & workUnit : WorkUnits)
+  {
+    total += workUnit.WallTime;
+    longest = std::max(longest, workUnit.WallTime);
+  }
+  return total > 0.0 ? longest * WorkUnits.size() / total : 1.0;
+}
+
+void
+PipelineProfiler::SetEnabled(bool enabled)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  std::call_once(m_PimplGlobals->EnabledIsInitialized, [] {});
+  m_PimplGlobals->Enabled = enabled;
+}
+
+bool
+PipelineProfiler::GetEnabled()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  std::call_once(m_PimplGlobals->EnabledIsInitialized, [] {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_PIPELINE_PROFILE", envVar) && !envVar.empty())
+    {
+      m_PimplGlobals->TraceFileName = envVar;
+      m_PimplGlobals->Enabled = true;
+      std::atexit([] { WriteChromeTrace(m_PimplGlobals->TraceFileName); });
+    }
+  });
+  return m_PimplGlobals->Enabled;
+}
+
+std::vector<PipelineProfiler::EventRecord>
+PipelineProfiler::GetEvents()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->EventsMutex);
+  return { m_PimplGlobals->Events.cbegin(), m_PimplGlobals->Events.cend() };
+}
+
+void
+PipelineProfiler::Clear()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->EventsMutex);
+  m_PimplGlobals->Events.clear();
+}
+
+void
+PipelineProfiler::WriteChromeTrace(std::ostream & os)
+{
+  const std::vector<EventRecord> events = GetEvents();
+  std::ostringstream             trace;
+
+  // The times of the trace are in microseconds.
+  const auto writeTimes = [&trace](double startTime, double wallTime) {
+    trace << R"("ts":)" << startTime * 1.0e6 << R"(,"dur":)" << wallTime * 1.0e6;
+  };
+
+  trace << std::fixed << std::setprecision(3) << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  const char * separator = "\n";
+  for (const EventRecord & event : events)
+  {
+    trace << separator << R"({"name":")" << EscapeJSON(event.ClassName)
+          << R"(","cat":"filter","ph":"X","pid":1,"tid":)" << event.ThreadIndex << ',';
+    writeTimes(event.StartTime, event.WallTime);
+    trace << R"(,"args":{"name":")" << EscapeJSON(event.ObjectName) << R"(","cpu_time_ms":)" << event.CPUTime * 1.0e3
+          << R"(,"work_units":)" << event.WorkUnits.size() << R"(,"load_imbalance":)" << event.GetLoadImbalance()
+          << R"(,"allocated_bytes":)" << event.AllocatedBytes << R"(,"requested_regions":")"
+          << EscapeJSON(event.RequestedRegions) << R"(","requested_pixels":)" << event.RequestedPixels << "}}";
+    separator = ",\n";
+
+    for (const WorkUnitRecord & workUnit : event.WorkUnits)
+    {
+      trace << separator << R"({"name":")" << EscapeJSON(event.ClassName)
+            << R"( work unit","cat":"work unit","ph":"X","pid":1,"tid":)" << workUnit.ThreadIndex << ',';
+      writeTimes(workUnit.StartTime, workUnit.WallTime);
+      trace << R"(,"args":{"cpu_time_ms":)" << workUnit.CPUTime * 1.0e3 << "}}";
+    }
+  }
+  trace << "\n]}" << std::endl;
+  os << trace.str();
+}
+
+bool
+PipelineProfiler::WriteChromeTrace(const std::string & fileName)
+{
+  std::ofstream file(fileName);
+  if (!file)
+  {
+    return false;
+  }
+  WriteChromeTrace(file);
+  return static_cast<bool>(file);
+}
+
+void
+PipelineProfiler::WriteReport(std::ostream & os)
+{
+  struct Summary
+  {
+    SizeValueType NumberOfEvents{ 0 };
+    double        WallTime{ 0.0 };
+    double        CPUTime{ 0.0 };
+    double        LoadImbalance{ 0.0 };
+    SizeValueType AllocatedBytes{ 0 };
+    SizeValueType RequestedPixels{ 0 };
+  };
+  std::map<std::string, Summary> summaries;
+  for (const EventRecord & event : GetEvents())
+  {
+    Summary & summary = summaries[event.ClassName];
+    ++summary.NumberOfEvents;
+    summary.WallTime += event.WallTime;
+    summary.CPUTime += event.CPUTime;
+    summary.LoadImbalance = std::max(summary.LoadImbalance, event.GetLoadImbalance());
+    summary.AllocatedBytes += event.AllocatedBytes;
+    summary.RequestedPixels += event.RequestedPixels;
+  }
+
+  std::ostringstream report;
+  report << std::left << std::setw(40) << "Filter" << std::right << std::setw(8) << "Calls" << std::setw(12)
+         << "Wall (s)" << std::setw(12) << "CPU (s)" << std::setw(12) << "Imbalance" << std::setw(16) << "Bytes"
+         << std::setw(16) << "Pixels" << std::endl;
+  for (const auto & [className, summary] : summaries)
+  {
+    report << std::left << std::setw(40) << className << std::right << std::setw(8) << summary.NumberOfEvents
+           << std::fixed << std::setprecision(4) << std::setw(12) << summary.WallTime << std::setw(12)
+           << summary.CPUTime << std::setprecision(2) << std::setw(12) << summary.LoadImbalance << std::setw(16)
+           << summary.AllocatedBytes << std::setw(16) << summary.RequestedPixels << std::endl;
+  }
+  os << report.str();
+}
+
+PipelineProfiler::EventRecord *
+PipelineProfiler::GetCurrentEvent()
+{
+  return currentEvent;
+}
+
+namespace
+{
+double
+GetTime(const std::chrono::steady_clock::time_point & startTime)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+SizeValueType
+GetThreadIndex(std::atomic<SizeValueType> & numberOfThreads)
+{
+  thread_local const SizeValueType threadIndex = numberOfThreads++;
+  return threadIndex;
+}
+} // namespace
+
+PipelineProfiler::EventScope::EventScope(ProcessObject * filter)
+{
+  if (!GetEnabled())
+  {
+    return;
+  }
+
+  EventRecord event;
+  event.ClassName = filter->GetNameOfClass();
+  event.ObjectName = filter->GetObjectName();
+  event.ThreadIndex = GetThreadIndex(m_PimplGlobals->NumberOfThreads);
+  m_EnclosingEvent = currentEvent;
+  event.Depth = m_EnclosingEvent ? m_EnclosingEvent->Depth + 1 : 0;
+
+  std::ostringstream regions;
+  for (const DataObject * output : filter->GetOutputs())
+  {
+    if (output != nullptr)
+    {
+      AppendRequestedRegion<1>(output, regions, event.RequestedPixels) ||
+        AppendRequestedRegion<2>(output, regions, event.RequestedPixels) ||
+        AppendRequestedRegion<3>(output, regions, event.RequestedPixels) ||
+        AppendRequestedRegion<4>(output, regions, event.RequestedPixels);
+    }
+  }
+  event.RequestedRegions = regions.str();
+
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->EventsMutex);
+    m_PimplGlobals->Events.push_back(std::move(event));
+    m_Event = &m_PimplGlobals->Events.back();
+  }
+  currentEvent = m_Event;
+  m_StartAllocatedBytes = ImageBufferAllocator::GetStatistics().AllocatedBytes;
+  m_StartCPUTime = GetThreadCPUTime();
+  m_Event->StartTime = GetTime(m_PimplGlobals->StartTime);
+}
+
+PipelineProfiler::EventScope::~EventScope()
+{
+  if (m_Event == nullptr)
+  {
+    return;
+  }
+
+  const double wallTime = GetTime(m_PimplGlobals->StartTime) - m_Event->StartTime;
+  const double cpuTime = GetThreadCPUTime() - m_StartCPUTime;
+  currentEvent = m_EnclosingEvent;
+
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->EventsMutex);
+  m_Event->WallTime = wallTime;
+  m_Event->CPUTime = cpuTime;
+  m_Event->AllocatedBytes = ImageBufferAllocator::GetStatistics().AllocatedBytes - m_StartAllocatedBytes;
+  // The work units executed by this thread are already in cpuTime.
+  for (const WorkUnitRecord & workUnit : m_Event->WorkUnits)
+  {
+    if (workUnit.ThreadIndex != m_Event->ThreadIndex)
+    {
+      m_Event->CPUTime += workUnit.CPUTime;
+    }
+  }
+}
+
+PipelineProfiler::WorkUnitScope::WorkUnitScope(EventRecord * event)
+  : m_Event(event)
+{
+  if (m_Event != nullptr)
+  {
+    m_StartCPUTime = GetThreadCPUTime();
+    m_StartTime = GetTime(m_PimplGlobals->StartTime);
+  }
+}
+
+PipelineProfiler::WorkUnitScope::~WorkUnitScope()
+{
+  if (m_Event == nullptr)
+  {
+    return;
+  }
+
+  WorkUnitRecord workUnit;
+  workUnit.StartTime = m_StartTime;
+  workUnit.WallTime = GetTime(m_PimplGlobals->StartTime) - m_StartTime;
+  workUnit.CPUTime = GetThreadCPUTime() - m_StartCPUTime;
+  workUnit.ThreadIndex = GetThreadIndex(m_PimplGlobals->NumberOfThreads);
+
+  const std::lock_guard<std::mutex> lockGuard(m_PimplGlobals->EventsMutex);
+  m_Event->WorkUnits.push_back(workUnit);
+}
+
+} // end namespace itk
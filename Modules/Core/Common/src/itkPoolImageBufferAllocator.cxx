@@ -0,0 +1,155 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPoolImageBufferAllocator.h"
+#include "itkAlignedImageBufferAllocator.h"
+
+#include <cstring>
+
+namespace itk
+{
+
+PoolImageBufferAllocator::PoolImageBufferAllocator()
+  : m_Allocator(AlignedImageBufferAllocator::New().GetPointer())
+{}
+
+PoolImageBufferAllocator::~PoolImageBufferAllocator()
+{
+  this->ReleasePooledBuffers();
+}
+
+void *
+PoolImageBufferAllocator::Allocate(SizeValueType numberOfBytes, bool zeroInitialize)
+{
+  const SizeValueType sizeClass = GetSizeClass(numberOfBytes);
+  void *              buffer = nullptr;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    const auto                        found = m_Pool.find(sizeClass);
+    if (found != m_Pool.end() && !found->second.empty())
+    {
+      buffer = found->second.back();
+      found->second.pop_back();
+      m_PooledBytes -= sizeClass;
+    }
+  }
+  if (buffer == nullptr)
+  {
+    return m_Allocator->Allocate(sizeClass, zeroInitialize);
+  }
+  Superclass::RecordReuse();
+  if (zeroInitialize)
+  {
+    std::memset(buffer, 0, numberOfBytes);
+  }
+  return buffer;
+}
+
+void
+PoolImageBufferAllocator::Deallocate(void * buffer, SizeValueType numberOfBytes)
+{
+  if (buffer == nullptr)
+  {
+    return;
+  }
+  const SizeValueType sizeClass = GetSizeClass(numberOfBytes);
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    if (m_PooledBytes + sizeClass <= m_MaximumPooledBytes)
+    {
+      m_Pool[sizeClass].push_back(buffer);
+      m_PooledBytes += sizeClass;
+      return;
+    }
+  }
+  m_Allocator->Deallocate(buffer, sizeClass);
+}
+
+void
+PoolImageBufferAllocator::SetAllocator(ImageBufferAllocator * allocator)
+{
+  if (allocator == nullptr)
+  {
+    itkExceptionMacro("The allocator of the pooled buffers must not be null.");
+  }
+  if (m_Allocator != allocator)
+  {
+    this->ReleasePooledBuffers();
+    m_Allocator = allocator;
+    this->Modified();
+  }
+}
+
+SizeValueType
+PoolImageBufferAllocator::GetPooledBytes() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  return m_PooledBytes;
+}
+
+void
+PoolImageBufferAllocator::ReleasePooledBuffers()
+{
+  std::map<SizeValueType, std::vector<void *>> pool;
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    pool.swap(m_Pool);
+    m_PooledBytes = 0;
+  }
+  for (const auto & [sizeClass, buffers] : pool)
+  {
+    for (void * buffer : buffers)
+    {
+      m_Allocator->Deallocate(buffer, sizeClass);
+    }
+  }
+}
+
+SizeValueType
+PoolImageBufferAllocator::GetSizeClass(SizeValueType numberOfBytes)
+{
+  constexpr SizeValueType smallestSizeClass = 64;
+  constexpr SizeValueType largestPowerOfTwoClass = 4096;
+  SizeValueType           powerOfTwo = smallestSizeClass;
+  while (powerOfTwo < numberOfBytes && powerOfTwo < largestPowerOfTwoClass)
+  {
+    powerOfTwo *= 2;
+  }
+  if (numberOfBytes <= powerOfTwo)
+  {
+    return powerOfTwo;
+  }
+  // Eight classes between the largest power of two not above the number of
+  // bytes and the next one.
+  while (powerOfTwo <= numberOfBytes / 2)
+  {
+    powerOfTwo *= 2;
+  }
+  const SizeValueType granularity = powerOfTwo / 8;
+  return (numberOfBytes + granularity - 1) / granularity * granularity;
+}
+
+void
+PoolImageBufferAllocator::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(Allocator);
+  os << indent << "MaximumPooledBytes: " << m_MaximumPooledBytes << std::endl;
+  os << indent << "PooledBytes: " << this->GetPooledBytes() << std::endl;
+}
+} // end namespace itk
@@ -32,6 +32,8 @@
 #include <sstream>
 #include <algorithm>
 #include "itkMultiThreaderBase.h"
+#include "itkPipelineProfiler.h"
+#include "itkProcessObjectResultCache.h"
 
 namespace itk
 {
@@ -1265,6 +1267,7 @@ ProcessObject::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "Progress: " << progressFixedToFloat(m_Progress) << std::endl;
   os << indent << "Multithreader: " << std::endl;
   m_MultiThreader->PrintSelf(os, indent.GetNextIndent());
+  itkPrintSelfObjectMacro(ResultCache);
 }
 
 
@@ -1551,6 +1554,31 @@ ProcessObject::GenerateOutputRequestedRegion(DataObject * output)
 }
 
 
+void
+ProcessObject::SetResultCache(ProcessObjectResultCache * cache)
+{
+  if (this->m_ResultCache != cache)
+  {
+    this->m_ResultCache = cache;
+    this->Modified();
+  }
+}
+
+
+ProcessObjectResultCache *
+ProcessObject::GetModifiableResultCache()
+{
+  return m_ResultCache.GetPointer();
+}
+
+
+const ProcessObjectResultCache *
+ProcessObject::GetResultCache() const
+{
+  return m_ResultCache.GetPointer();
+}
+
+
 void
 ProcessObject::SetMultiThreader(MultiThreaderBase * threader)
 {
@@ -1681,7 +1709,22 @@ ProcessObject::UpdateOutputData(DataObject * itkNotUsed(output))
 
   try
   {
-    this->GenerateData();
+    const PipelineProfiler::EventScope profilerScope(this);
+
+    // The outputs are restored from the result cache, when they are in it.
+    const std::string cacheKey = m_ResultCache ? m_ResultCache->ComputeKey(this) : std::string();
+    if (cacheKey.empty() || !m_ResultCache->Retrieve(cacheKey, this))
+    {
+      this->GenerateData();
+      if (!cacheKey.empty() && !m_AbortGenerateData)
+      {
+        m_ResultCache->Store(cacheKey, this);
+      }
+    }
+    else
+    {
+      this->UpdateProgress(1.0f);
+    }
   }
   catch (const ProcessAborted &)
   {
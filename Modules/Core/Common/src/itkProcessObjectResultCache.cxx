@@ -0,0 +1,371 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkProcessObjectResultCache.h"
+#include "itkProcessObject.h"
+#include "itksys/MD5.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <typeinfo>
+
+namespace itk
+{
+namespace
+{
+// Written at the beginning of the content of each entry.
+constexpr char EntryMagic[] = "ITKProcessObjectResultCache1";
+
+// Computes the MD5 digest of the characters written to it.
+class DigestStreamBuffer : public std::streambuf
+{
+public:
+  DigestStreamBuffer()
+    : m_MD5(itksysMD5_New())
+  {
+    itksysMD5_Initialize(m_MD5);
+  }
+
+  ~DigestStreamBuffer() override { itksysMD5_Delete(m_MD5); }
+
+  ITK_DISALLOW_COPY_AND_MOVE(DigestStreamBuffer);
+
+  std::string
+  GetHexDigest()
+  {
+    std::array<char, 32> digest;
+    itksysMD5_FinalizeHex(m_MD5, digest.data());
+    return std::string(digest.data(), digest.size());
+  }
+
+protected:
+  int_type
+  overflow(int_type c) override
+  {
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      const auto character = static_cast<unsigned char>(c);
+      itksysMD5_Append(m_MD5, &character, 1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize
+  xsputn(const char * s, std::streamsize n) override
+  {
+    constexpr std::streamsize maximumLength = std::numeric_limits<int>::max();
+    for (std::streamsize i = 0; i < n; i += maximumLength)
+    {
+      itksysMD5_Append(
+        m_MD5, reinterpret_cast<const unsigned char *>(s + i), static_cast<int>(std::min(maximumLength, n - i)));
+    }
+    return n;
+  }
+
+private:
+  itksysMD5 * m_MD5;
+};
+
+// Reads the content of an entry without copying it.
+class ContentStreamBuffer : public std::streambuf
+{
+public:
+  explicit ContentStreamBuffer(const std::string & content)
+  {
+    char * begin = const_cast<char *>(content.data());
+    this->setg(begin, begin, begin + content.size());
+  }
+};
+} // namespace
+
+
+void
+ProcessObjectResultCache::SetMaximumMemorySize(SizeValueType maximumMemorySize)
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_MaximumMemorySize == maximumMemorySize)
+    {
+      return;
+    }
+    m_MaximumMemorySize = maximumMemorySize;
+    this->EvictToMaximumMemorySize();
+  }
+  this->Modified();
+}
+
+SizeValueType
+ProcessObjectResultCache::GetMaximumMemorySize() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumMemorySize;
+}
+
+void
+ProcessObjectResultCache::SetCacheDirectory(const std::string & directory)
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_CacheDirectory == directory)
+    {
+      return;
+    }
+    m_CacheDirectory = directory;
+  }
+  this->Modified();
+}
+
+std::string
+ProcessObjectResultCache::GetCacheDirectory() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_CacheDirectory;
+}
+
+std::string
+ProcessObjectResultCache::ComputeKey(ProcessObject * processObject) const
+{
+  DigestStreamBuffer digest;
+  std::ostream       os(&digest);
+
+  os << typeid(*processObject).name() << '\n';
+  if (!processObject->SerializeParameters(os))
+  {
+    return {};
+  }
+
+  const ProcessObject::NameArray              names = processObject->GetInputNames();
+  const ProcessObject::DataObjectPointerArray inputs = processObject->GetInputs();
+  for (size_t i = 0; i < inputs.size(); ++i)
+  {
+    os << "Input " << names[i] << '\n';
+    const DataObject * input = inputs[i];
+    if (input == nullptr)
+    {
+      os << "null\n";
+    }
+    else
+    {
+      os << typeid(*input).name() << '\n';
+      if (!input->SerializeContent(os))
+      {
+        return {};
+      }
+    }
+  }
+  os.flush();
+  return digest.GetHexDigest();
+}
+
+bool
+ProcessObjectResultCache::Retrieve(const std::string & key, ProcessObject * processObject)
+{
+  ContentType content;
+  bool        readFromDisk = false;
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    const auto                        found = m_EntryOfKey.find(key);
+    if (found != m_EntryOfKey.end())
+    {
+      m_Entries.splice(m_Entries.begin(), m_Entries, found->second);
+      content = found->second->second;
+    }
+    else if (!m_CacheDirectory.empty())
+    {
+      std::ifstream file(this->GetFileName(key), std::ios::binary);
+      if (file)
+      {
+        std::ostringstream fileContent;
+        fileContent << file.rdbuf();
+        content = std::make_shared<const std::string>(fileContent.str());
+        readFromDisk = true;
+        this->Insert(key, content);
+      }
+    }
+  }
+
+  bool hit = false;
+  if (content != nullptr)
+  {
+    ContentStreamBuffer                         buffer(*content);
+    std::istream                                is(&buffer);
+    const ProcessObject::DataObjectPointerArray outputs = processObject->GetOutputs();
+
+    std::string   magic(sizeof(EntryMagic) - 1, '\0');
+    SizeValueType numberOfOutputs = 0;
+    is.read(magic.data(), magic.size());
+    is.read(reinterpret_cast<char *>(&numberOfOutputs), sizeof(numberOfOutputs));
+    hit = is && magic == EntryMagic && numberOfOutputs == outputs.size();
+    for (const auto & output : outputs)
+    {
+      hit = hit && output != nullptr && output->DeserializeContent(is) &&
+            !output->RequestedRegionIsOutsideOfTheBufferedRegion();
+    }
+  }
+
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  if (hit)
+  {
+    ++m_Statistics.NumberOfHits;
+    m_Statistics.NumberOfDiskHits += readFromDisk ? 1 : 0;
+  }
+  else
+  {
+    ++m_Statistics.NumberOfMisses;
+  }
+  return hit;
+}
+
+bool
+ProcessObjectResultCache::Store(const std::string & key, ProcessObject * processObject)
+{
+  const ProcessObject::DataObjectPointerArray outputs = processObject->GetOutputs();
+
+  std::ostringstream  os(std::ios::binary);
+  const SizeValueType numberOfOutputs = outputs.size();
+  os.write(EntryMagic, sizeof(EntryMagic) - 1);
+  os.write(reinterpret_cast<const char *>(&numberOfOutputs), sizeof(numberOfOutputs));
+  for (const auto & output : outputs)
+  {
+    if (output == nullptr || !output->SerializeContent(os))
+    {
+      return false;
+    }
+  }
+
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  this->Insert(key, std::make_shared<const std::string>(os.str()));
+  return true;
+}
+
+auto
+ProcessObjectResultCache::GetStatistics() const -> Statistics
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Statistics;
+}
+
+void
+ProcessObjectResultCache::ResetStatistics()
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Statistics.NumberOfHits = 0;
+  m_Statistics.NumberOfDiskHits = 0;
+  m_Statistics.NumberOfMisses = 0;
+  m_Statistics.NumberOfEvictions = 0;
+  m_Statistics.NumberOfSpills = 0;
+}
+
+void
+ProcessObjectResultCache::Clear()
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_EntryOfKey.clear();
+  m_Statistics.NumberOfEntries = 0;
+  m_Statistics.MemorySize = 0;
+}
+
+void
+ProcessObjectResultCache::Insert(const std::string & key, ContentType content)
+{
+  const auto found = m_EntryOfKey.find(key);
+  if (found != m_EntryOfKey.end())
+  {
+    m_Statistics.MemorySize -= found->second->second->size();
+    --m_Statistics.NumberOfEntries;
+    m_Entries.erase(found->second);
+    m_EntryOfKey.erase(found);
+  }
+  m_Statistics.MemorySize += content->size();
+  ++m_Statistics.NumberOfEntries;
+  m_Entries.emplace_front(key, std::move(content));
+  m_EntryOfKey[key] = m_Entries.begin();
+  this->EvictToMaximumMemorySize();
+}
+
+void
+ProcessObjectResultCache::EvictToMaximumMemorySize()
+{
+  while (m_Statistics.MemorySize > m_MaximumMemorySize)
+  {
+    const auto & [key, content] = m_Entries.back();
+    if (!m_CacheDirectory.empty())
+    {
+      const std::string fileName = this->GetFileName(key);
+      if (itksys::SystemTools::FileExists(fileName))
+      {
+        ++m_Statistics.NumberOfSpills;
+      }
+      else if (itksys::SystemTools::MakeDirectory(m_CacheDirectory))
+      {
+        // Written to a temporary file first, so that other caches sharing
+        // the directory never read an incomplete file.
+        const std::string temporaryFileName = fileName + ".tmp";
+        std::ofstream     file(temporaryFileName, std::ios::binary);
+        file.write(content->data(), content->size());
+        file.close();
+        if (file && std::rename(temporaryFileName.c_str(), fileName.c_str()) == 0)
+        {
+          ++m_Statistics.NumberOfSpills;
+        }
+        else
+        {
+          itksys::SystemTools::RemoveFile(temporaryFileName);
+        }
+      }
+    }
+    ++m_Statistics.NumberOfEvictions;
+    --m_Statistics.NumberOfEntries;
+    m_Statistics.MemorySize -= content->size();
+    m_EntryOfKey.erase(key);
+    m_Entries.pop_back();
+  }
+}
+
+std::string
+ProcessObjectResultCache::GetFileName(const std::string & key) const
+{
+  return m_CacheDirectory + '/' + key + ".itkcache";
+}
+
+void
+ProcessObjectResultCache::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  os << indent << "MaximumMemorySize: " << m_MaximumMemorySize << std::endl;
+  os << indent << "CacheDirectory: " << m_CacheDirectory << std::endl;
+  os << indent << "Statistics: " << m_Statistics << std::endl;
+}
+
+std::ostream &
+operator<<(std::ostream & out, const ProcessObjectResultCache::Statistics & statistics)
+{
+  return out << "NumberOfHits: " << statistics.NumberOfHits << ", NumberOfDiskHits: " << statistics.NumberOfDiskHits
+             << ", NumberOfMisses: " << statistics.NumberOfMisses
+             << ", NumberOfEvictions: " << statistics.NumberOfEvictions
+             << ", NumberOfSpills: " << statistics.NumberOfSpills << ", NumberOfEntries: " << statistics.NumberOfEntries
+             << ", MemorySize: " << statistics.MemorySize;
+}
+} // end namespace itk
@@ -0,0 +1,116 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkStreamingPieceQueue.h"
+#include <algorithm>
+
+namespace itk
+{
+
+StreamingPieceQueue::StreamingPieceQueue(unsigned int maximumNumberOfPiecesInFlight)
+  : m_MaximumNumberOfPiecesInFlight(std::max(1u, maximumNumberOfPiecesInFlight))
+{
+  m_Thread = std::thread(&StreamingPieceQueue::ThreadExecute, this);
+}
+
+StreamingPieceQueue::~StreamingPieceQueue()
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = true;
+  }
+  m_PieceQueued.notify_one();
+  m_Thread.join();
+}
+
+void
+StreamingPieceQueue::Push(ConsumerType consumer)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_PieceConsumed.wait(lock, [this] {
+      return m_NumberOfPiecesInFlight < m_MaximumNumberOfPiecesInFlight || m_Exception != nullptr;
+    });
+    this->RethrowException();
+    m_Pieces.push_back(std::move(consumer));
+    ++m_NumberOfPiecesInFlight;
+  }
+  m_PieceQueued.notify_one();
+}
+
+void
+StreamingPieceQueue::Wait()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_PieceConsumed.wait(lock, [this] { return m_NumberOfPiecesInFlight == 0 || m_Exception != nullptr; });
+  this->RethrowException();
+}
+
+void
+StreamingPieceQueue::RethrowException()
+{
+  // Called with the mutex locked. The exception is only reported once.
+  if (m_Exception != nullptr)
+  {
+    std::exception_ptr exception = nullptr;
+    std::swap(exception, m_Exception);
+    std::rethrow_exception(exception);
+  }
+}
+
+void
+StreamingPieceQueue::ThreadExecute()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_PieceQueued.wait(lock, [this] { return !m_Pieces.empty() || m_Stopping; });
+    if (m_Pieces.empty())
+    {
+      // Stopping, all the pieces have been consumed.
+      return;
+    }
+    ConsumerType consumer = std::move(m_Pieces.front());
+    m_Pieces.pop_front();
+
+    lock.unlock();
+    std::exception_ptr exception = nullptr;
+    try
+    {
+      consumer();
+    }
+    catch (...)
+    {
+      exception = std::current_exception();
+    }
+    // Release the piece held by the consumer before reporting it consumed.
+    consumer = nullptr;
+    lock.lock();
+
+    --m_NumberOfPiecesInFlight;
+    if (exception != nullptr)
+    {
+      // The following pieces are discarded.
+      m_Exception = exception;
+      m_NumberOfPiecesInFlight -= static_cast<unsigned int>(m_Pieces.size());
+      m_Pieces.clear();
+    }
+    m_PieceConsumed.notify_all();
+  }
+}
+
+} // namespace itk
@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingMultiThreader.h"
+#include "itkProcessObject.h"
+#include "itkImageSourceCommon.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
+
+namespace itk
+{
+
+WorkStealingMultiThreader::WorkStealingMultiThreader()
+  : m_ThreadPool(WorkStealingThreadPool::GetInstance())
+{
+  ThreadIdType defaultThreads = std::max(1u, GetGlobalDefaultNumberOfThreads());
+  if (defaultThreads > 1) // one work unit for only one thread
+  {
+    defaultThreads *= 4;
+  }
+  m_NumberOfWorkUnits = std::min<ThreadIdType>(ITK_MAX_THREADS, defaultThreads);
+  m_MaximumNumberOfThreads = m_ThreadPool->GetMaximumNumberOfThreads();
+}
+
+WorkStealingMultiThreader::~WorkStealingMultiThreader() = default;
+
+void
+WorkStealingMultiThreader::SetSingleMethod(ThreadFunctionType f, void * data)
+{
+  m_SingleMethod = std::move(f);
+  m_SingleData = data;
+}
+
+void
+WorkStealingMultiThreader::SetMaximumNumberOfThreads(ThreadIdType numberOfThreads)
+{
+  Superclass::SetMaximumNumberOfThreads(numberOfThreads);
+  const ThreadIdType threadCount = m_ThreadPool->GetMaximumNumberOfThreads();
+  if (threadCount < m_MaximumNumberOfThreads)
+  {
+    m_ThreadPool->AddThreads(m_MaximumNumberOfThreads - threadCount);
+  }
+  m_MaximumNumberOfThreads = m_ThreadPool->GetMaximumNumberOfThreads();
+}
+
+void
+WorkStealingMultiThreader::SingleMethodExecute()
+{
+  if (!m_SingleMethod)
+  {
+    itkExceptionStringMacro("No single method set!");
+  }
+
+  // obey the global maximum number of threads limit
+  m_NumberOfWorkUnits = std::min(this->GetGlobalMaximumNumberOfThreads(), m_NumberOfWorkUnits);
+
+  m_ThreadPool->Execute(m_NumberOfWorkUnits, [this](SizeValueType workUnit) {
+    WorkUnitInfo workUnitInfo;
+    workUnitInfo.WorkUnitID = static_cast<ThreadIdType>(workUnit);
+    workUnitInfo.NumberOfWorkUnits = m_NumberOfWorkUnits;
+    workUnitInfo.UserData = m_SingleData;
+    m_SingleMethod(&workUnitInfo);
+  });
+}
+
+void
+WorkStealingMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
+                                            SizeValueType             lastIndexPlus1,
+                                            ArrayThreadingFunctorType aFunc,
+                                            ProcessObject *           filter)
+{
+  if (!this->GetUpdateProgress())
+  {
+    filter = nullptr;
+  }
+
+  if (firstIndex + 1 < lastIndexPlus1)
+  {
+    ProgressReporter progressStartEnd(filter, 0, 1);
+
+    const SizeValueType count = lastIndexPlus1 - firstIndex;
+    const SizeValueType chunkSize = (count + m_NumberOfWorkUnits - 1) / m_NumberOfWorkUnits;
+    const SizeValueType numberOfChunks = (count + chunkSize - 1) / chunkSize;
+
+    m_ThreadPool->Execute(numberOfChunks, [&](SizeValueType chunk) {
+      TotalProgressReporter progress(filter, count, 100);
+      progress.CheckAbortGenerateData();
+
+      const SizeValueType start = firstIndex + chunk * chunkSize;
+      const SizeValueType end = std::min(start + chunkSize, lastIndexPlus1);
+      for (SizeValueType ii = start; ii < end; ++ii)
+      {
+        aFunc(ii);
+      }
+
+      progress.Completed(end - start);
+    });
+  }
+  else if (firstIndex + 1 == lastIndexPlus1)
+  {
+    aFunc(firstIndex);
+  }
+  // else nothing needs to be executed
+}
+
+void
+WorkStealingMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
+                                                  const IndexValueType index[],
+                                                  const SizeValueType  size[],
+                                                  ThreadingFunctorType funcP,
+                                                  ProcessObject *      filter)
+{
+  if (!this->GetUpdateProgress())
+  {
+    filter = nullptr;
+  }
+  ProgressReporter progressStartEnd(filter, 0, 1);
+
+  if (m_NumberOfWorkUnits == 1) // no multi-threading wanted
+  {
+    funcP(index, size); // process whole region
+    return;
+  }
+
+  ImageIORegion region(dimension);
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    region.SetIndex(d, index[d]);
+    region.SetSize(d, size[d]);
+  }
+  const SizeValueType totalCount = region.GetNumberOfPixels();
+  if (totalCount <= 1)
+  {
+    funcP(index, size); // process whole region
+    return;
+  }
+
+  const ImageRegionSplitterBase * splitter = ImageSourceCommon::GetGlobalDefaultSplitter();
+  const ThreadIdType              splitCount = splitter->GetNumberOfSplits(region, m_NumberOfWorkUnits);
+  itkAssertOrThrowMacro(splitCount <= m_NumberOfWorkUnits, "Split count is greater than number of work units!");
+
+  m_ThreadPool->Execute(splitCount, [&](SizeValueType split) {
+    TotalProgressReporter progress(filter, totalCount, 100);
+    progress.CheckAbortGenerateData();
+
+    ImageIORegion iRegion = region;
+    splitter->GetSplit(static_cast<ThreadIdType>(split), splitCount, iRegion);
+    funcP(&iRegion.GetIndex()[0], &iRegion.GetSize()[0]);
+
+    progress.Completed(iRegion.GetNumberOfPixels());
+  });
+}
+
+void
+WorkStealingMultiThreader::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(ThreadPool);
+}
+
+} // namespace itk
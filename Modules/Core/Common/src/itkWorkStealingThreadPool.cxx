@@ -0,0 +1,608 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingThreadPool.h"
+#include "itkMultiThreaderBase.h"
+#include "itkSingleton.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+
+namespace itk
+{
+
+namespace
+{
+// The index of the queue of the current thread: 0 for the threads which are
+// not workers of the pool.
+thread_local unsigned int currentQueueIndex = 0;
+
+// How many times a thread which finds no task yields before it sleeps.
+constexpr unsigned int numberOfYieldsBeforeSleeping = 64;
+} // namespace
+
+struct WorkStealingThreadPoolGlobals
+{
+  WorkStealingThreadPoolGlobals() = default;
+
+  // To allow singleton creation of WorkStealingThreadPool.
+  std::once_flag m_ThreadPoolOnceFlag;
+
+  // The singleton instance of WorkStealingThreadPool.
+  WorkStealingThreadPool::Pointer m_ThreadPoolInstance;
+};
+
+/** The tasks of one call to Execute(), whose state lives on the stack of the
+ * calling thread until all of them are done. */
+struct WorkStealingThreadPool::Job
+{
+  Job(TaskFunctionType function, void * data, SizeValueType numberOfTasks)
+    : Function(function)
+    , Data(data)
+    , NumberOfPendingTasks(numberOfTasks)
+  {}
+
+  const TaskFunctionType     Function;
+  void * const               Data;
+  std::atomic<SizeValueType> NumberOfPendingTasks;
+  std::atomic<bool>          Failed{ false };
+  std::mutex                 ExceptionMutex;
+  std::exception_ptr         Exception;
+};
+
+/** The tasks of a job with an index in [Begin, End). Static tasks, queued
+ * for NUMAAffinity, are neither split nor stolen. */
+struct WorkStealingThreadPool::Task
+{
+  Job *         m_Job;
+  SizeValueType m_Begin;
+  SizeValueType m_End;
+  bool          m_Static{ false };
+};
+
+/** A double-ended queue of tasks, of a fixed capacity. Its owner pushes and
+ * pops tasks at the back, other threads steal them from the front. */
+class alignas(64) WorkStealingThreadPool::TaskQueue
+{
+public:
+  bool
+  PushBack(const Task & task)
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    const unsigned int                size = m_Size.load(std::memory_order_relaxed);
+    if (size == Capacity)
+    {
+      return false;
+    }
+    m_Tasks[(m_Front + size) % Capacity] = task;
+    m_Size.store(size + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool
+  PopBack(Task & task)
+  {
+    return this->Pop(task, true);
+  }
+
+  bool
+  PopFront(Task & task)
+  {
+    return this->Pop(task, false);
+  }
+
+  // The number of static tasks queued, which only the owner may execute.
+  std::atomic<SizeValueType> m_NumberOfStaticTasks{ 0 };
+
+private:
+  bool
+  Pop(Task & task, bool back)
+  {
+    // Empty queues are skipped without locking them.
+    if (m_Size.load(std::memory_order_relaxed) == 0)
+    {
+      return false;
+    }
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    const unsigned int                size = m_Size.load(std::memory_order_relaxed);
+    if (size == 0)
+    {
+      return false;
+    }
+    if (back)
+    {
+      task = m_Tasks[(m_Front + size - 1) % Capacity];
+    }
+    else
+    {
+      if (m_Tasks[m_Front].m_Static)
+      {
+        return false;
+      }
+      task = m_Tasks[m_Front];
+      m_Front = (m_Front + 1) % Capacity;
+    }
+    m_Size.store(size - 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Enough for the halves of the ranges of many nested jobs. When the queue
+  // is full, ranges are executed without being split further.
+  static constexpr unsigned int Capacity = 256;
+
+  std::mutex                  m_Mutex;
+  std::atomic<unsigned int>   m_Size{ 0 };
+  unsigned int                m_Front{ 0 };
+  std::array<Task, Capacity> m_Tasks;
+};
+
+itkGetGlobalSimpleMacro(WorkStealingThreadPool, WorkStealingThreadPoolGlobals, PimplGlobals);
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::New()
+{
+  return Self::GetInstance();
+}
+
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  // Create a singleton WorkStealingThreadPool.
+  std::call_once(m_PimplGlobals->m_ThreadPoolOnceFlag, []() {
+    m_PimplGlobals->m_ThreadPoolInstance = ObjectFactory<Self>::Create();
+    if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+    {
+      new WorkStealingThreadPool(); // constructor sets m_PimplGlobals->m_ThreadPoolInstance
+    }
+#if defined(ITK_USE_PTHREADS)
+    pthread_atfork(WorkStealingThreadPool::PrepareForFork,
+                   WorkStealingThreadPool::ResumeFromFork,
+                   WorkStealingThreadPool::ResumeFromFork);
+#endif
+  });
+
+  return m_PimplGlobals->m_ThreadPoolInstance;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool()
+{
+  m_PimplGlobals->m_ThreadPoolInstance = this;        // keep the singleton alive
+  m_PimplGlobals->m_ThreadPoolInstance->UnRegister(); // Remove extra reference
+  m_Queues[0] = std::make_unique<TaskQueue>();
+
+#if defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+  {
+    for (unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (CPU_ISSET(cpu, &cpuSet))
+      {
+        m_CPUs.push_back(cpu);
+      }
+    }
+  }
+#endif
+  std::string envVar;
+  if (itksys::SystemTools::GetEnv("ITK_NUMA_AFFINITY", envVar))
+  {
+    envVar = itksys::SystemTools::UpperCase(envVar);
+    m_NUMAAffinity = (envVar == "ON" || envVar == "TRUE" || envVar == "1");
+  }
+
+  this->AddThreads(MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  this->CleanUp();
+}
+
+void
+WorkStealingThreadPool::AddThreads(ThreadIdType count)
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  count = std::min<ThreadIdType>(count, ITK_MAX_THREADS - m_Threads.size());
+  m_Threads.reserve(m_Threads.size() + count);
+  for (ThreadIdType i = 0; i < count; ++i)
+  {
+    const auto queueIndex = static_cast<unsigned int>(m_Threads.size() + 1);
+    if (m_Queues[queueIndex] == nullptr)
+    {
+      m_Queues[queueIndex] = std::make_unique<TaskQueue>();
+    }
+    if (m_NumberOfQueues.load() <= queueIndex)
+    {
+      m_NumberOfQueues.store(queueIndex + 1);
+    }
+    m_Threads.emplace_back(&WorkStealingThreadPool::ThreadExecute, this, queueIndex);
+    if (m_NUMAAffinity)
+    {
+      this->SetThreadAffinity(queueIndex);
+    }
+  }
+}
+
+ThreadIdType
+WorkStealingThreadPool::GetMaximumNumberOfThreads() const
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  return static_cast<ThreadIdType>(m_Threads.size());
+}
+
+SizeValueType
+WorkStealingThreadPool::GetNumberOfQueuedTasks() const
+{
+  SizeValueType      numberOfQueuedTasks = m_NumberOfQueuedTasks;
+  const unsigned int numberOfQueues = m_NumberOfQueues;
+  for (unsigned int i = 0; i < numberOfQueues; ++i)
+  {
+    numberOfQueuedTasks += m_Queues[i]->m_NumberOfStaticTasks;
+  }
+  return numberOfQueuedTasks;
+}
+
+void
+WorkStealingThreadPool::SetNUMAAffinity(bool numaAffinity)
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  if (m_NUMAAffinity != numaAffinity)
+  {
+    m_NUMAAffinity = numaAffinity;
+    for (unsigned int queueIndex = 1; queueIndex <= m_Threads.size(); ++queueIndex)
+    {
+      this->SetThreadAffinity(queueIndex);
+    }
+    this->Modified();
+  }
+}
+
+void
+WorkStealingThreadPool::SetThreadAffinity(unsigned int queueIndex)
+{
+  // m_Mutex must be already held here!
+#if defined(__linux__)
+  if (m_CPUs.empty())
+  {
+    return;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  if (m_NUMAAffinity)
+  {
+    // Consecutive workers, which process consecutive pieces of the images,
+    // on consecutive CPUs, which tend to be on the same node.
+    CPU_SET(m_CPUs[(queueIndex - 1) % m_CPUs.size()], &cpuSet);
+  }
+  else
+  {
+    for (const unsigned int cpu : m_CPUs)
+    {
+      CPU_SET(cpu, &cpuSet);
+    }
+  }
+  pthread_setaffinity_np(m_Threads[queueIndex - 1].native_handle(), sizeof(cpuSet), &cpuSet);
+#else
+  (void)queueIndex;
+#endif
+}
+
+ThreadIdType
+WorkStealingThreadPool::GetWorkerOfTask(SizeValueType taskIndex, SizeValueType numberOfTasks) const
+{
+  const SizeValueType numberOfWorkers = m_NumberOfQueues - 1;
+  return static_cast<ThreadIdType>(taskIndex * numberOfWorkers / numberOfTasks);
+}
+
+int
+WorkStealingThreadPool::GetCurrentWorkerIndex()
+{
+  return static_cast<int>(currentQueueIndex) - 1;
+}
+
+void
+WorkStealingThreadPool::Execute(SizeValueType numberOfTasks, TaskFunctionType function, void * data)
+{
+  if (numberOfTasks == 0)
+  {
+    return;
+  }
+  if (numberOfTasks == 1 && !m_NUMAAffinity)
+  {
+    function(data, 0);
+    return;
+  }
+
+  Job                job(function, data, numberOfTasks);
+  const unsigned int queueIndex = currentQueueIndex;
+  if (m_NUMAAffinity)
+  {
+    this->PushStaticTasks(job, numberOfTasks);
+    if (queueIndex == 0)
+    {
+      // Not a worker: the tasks are left to the workers they are assigned to.
+      std::unique_lock<std::mutex> mutexHolder(m_Mutex);
+      m_Condition.wait(mutexHolder, [&job] { return job.NumberOfPendingTasks == 0; });
+    }
+    else
+    {
+      this->WorkUntil(queueIndex, &job);
+    }
+  }
+  else
+  {
+    this->RunTask(queueIndex, Task{ &job, 0, numberOfTasks });
+    this->WorkUntil(queueIndex, &job);
+  }
+
+  if (job.Exception != nullptr)
+  {
+    std::rethrow_exception(job.Exception);
+  }
+}
+
+void
+WorkStealingThreadPool::PushStaticTasks(Job & job, SizeValueType numberOfTasks)
+{
+  // Worker w executes the tasks i for which i * w / n == w, that is from
+  // ceil(w * n / W) to ceil((w + 1) * n / W).
+  const SizeValueType numberOfWorkers = m_NumberOfQueues - 1;
+  for (SizeValueType worker = 0; worker < numberOfWorkers; ++worker)
+  {
+    const SizeValueType begin = (worker * numberOfTasks + numberOfWorkers - 1) / numberOfWorkers;
+    const SizeValueType end = ((worker + 1) * numberOfTasks + numberOfWorkers - 1) / numberOfWorkers;
+    if (begin < end)
+    {
+      const Task task{ &job, begin, end, true };
+      if (!this->PushTask(static_cast<unsigned int>(worker + 1), task))
+      {
+        // The queue of the worker is full.
+        this->RunTask(currentQueueIndex, task);
+      }
+    }
+  }
+}
+
+bool
+WorkStealingThreadPool::PushTask(unsigned int queueIndex, const Task & task)
+{
+  // Counted before it is queued, so that the count is never less than the
+  // number of queued tasks.
+  std::atomic<SizeValueType> & count =
+    task.m_Static ? m_Queues[queueIndex]->m_NumberOfStaticTasks : m_NumberOfQueuedTasks;
+  ++count;
+  if (!m_Queues[queueIndex]->PushBack(task))
+  {
+    --count;
+    return false;
+  }
+  // A sleeping thread increments m_NumberOfSleepingThreads before it checks
+  // the counts of the tasks, so either it sees the task, or it is seen
+  // here. Only the owner of the queue may execute a static task, so all
+  // the sleeping threads are woken up for it.
+  if (m_NumberOfSleepingThreads > 0)
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    if (task.m_Static)
+    {
+      m_Condition.notify_all();
+    }
+    else
+    {
+      m_Condition.notify_one();
+    }
+  }
+  return true;
+}
+
+bool
+WorkStealingThreadPool::HasTask(unsigned int queueIndex) const
+{
+  return m_NumberOfQueuedTasks > 0 || m_Queues[queueIndex]->m_NumberOfStaticTasks > 0;
+}
+
+bool
+WorkStealingThreadPool::FindTask(unsigned int queueIndex, Task & task)
+{
+  if (!this->HasTask(queueIndex))
+  {
+    return false;
+  }
+  if (m_Queues[queueIndex]->PopBack(task))
+  {
+    if (task.m_Static)
+    {
+      --m_Queues[queueIndex]->m_NumberOfStaticTasks;
+    }
+    else
+    {
+      --m_NumberOfQueuedTasks;
+    }
+    return true;
+  }
+  const unsigned int numberOfQueues = m_NumberOfQueues;
+  for (unsigned int i = 1; i < numberOfQueues; ++i)
+  {
+    if (m_Queues[(queueIndex + i) % numberOfQueues]->PopFront(task))
+    {
+      --m_NumberOfQueuedTasks;
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+WorkStealingThreadPool::RunTask(unsigned int queueIndex, Task task)
+{
+  Job * const job = task.m_Job;
+
+  // Queue the upper halves, to be stolen by idle threads, down to a single
+  // task, or until the queue is full.
+  while (!task.m_Static && task.m_End - task.m_Begin > 1)
+  {
+    const SizeValueType middle = task.m_Begin + (task.m_End - task.m_Begin) / 2;
+    if (!this->PushTask(queueIndex, Task{ job, middle, task.m_End }))
+    {
+      break;
+    }
+    task.m_End = middle;
+  }
+
+  for (SizeValueType i = task.m_Begin; i < task.m_End; ++i)
+  {
+    if (job->Failed.load(std::memory_order_relaxed))
+    {
+      break;
+    }
+    try
+    {
+      job->Function(job->Data, i);
+    }
+    catch (...)
+    {
+      const std::lock_guard<std::mutex> lockGuard(job->ExceptionMutex);
+      if (job->Exception == nullptr)
+      {
+        job->Exception = std::current_exception();
+      }
+      job->Failed = true;
+    }
+  }
+
+  // The job may be destroyed by its caller as soon as its last tasks are
+  // counted as done.
+  const SizeValueType numberOfTasks = task.m_End - task.m_Begin;
+  if (job->NumberOfPendingTasks.fetch_sub(numberOfTasks) == numberOfTasks)
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    m_Condition.notify_all();
+  }
+}
+
+void
+WorkStealingThreadPool::WorkUntil(unsigned int queueIndex, const Job * job)
+{
+  unsigned int numberOfYields = 0;
+  while (job == nullptr || job->NumberOfPendingTasks > 0)
+  {
+    Task task;
+    if (this->FindTask(queueIndex, task))
+    {
+      this->RunTask(queueIndex, task);
+      numberOfYields = 0;
+      continue;
+    }
+    if (numberOfYields < numberOfYieldsBeforeSleeping)
+    {
+      ++numberOfYields;
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> mutexHolder(m_Mutex);
+    if (job == nullptr && m_Stopping)
+    {
+      return;
+    }
+    ++m_NumberOfSleepingThreads;
+    m_Condition.wait(mutexHolder, [this, queueIndex, job] {
+      return this->HasTask(queueIndex) || (job == nullptr ? m_Stopping : job->NumberOfPendingTasks == 0);
+    });
+    --m_NumberOfSleepingThreads;
+    if (job != nullptr && job->NumberOfPendingTasks == 0 && m_NumberOfQueuedTasks > 0)
+    {
+      // This thread may have been woken up for a task it leaves behind.
+      m_Condition.notify_one();
+    }
+    numberOfYields = 0;
+  }
+}
+
+void
+WorkStealingThreadPool::ThreadExecute(unsigned int queueIndex)
+{
+  currentQueueIndex = queueIndex;
+  this->WorkUntil(queueIndex, nullptr);
+}
+
+void
+WorkStealingThreadPool::CleanUp()
+{
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    m_Stopping = true;
+  }
+  m_Condition.notify_all();
+
+  // The threads finish the queued tasks before they stop.
+  for (auto & thread : m_Threads)
+  {
+    if (thread.joinable())
+    {
+      thread.join();
+    }
+  }
+}
+
+void
+WorkStealingThreadPool::PrepareForFork()
+{
+  m_PimplGlobals->m_ThreadPoolInstance->CleanUp();
+}
+
+void
+WorkStealingThreadPool::ResumeFromFork()
+{
+  WorkStealingThreadPool * instance = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
+  ThreadIdType             threadCount = 0;
+  {
+    const std::lock_guard<std::mutex> lockGuard(instance->m_Mutex);
+    threadCount = static_cast<ThreadIdType>(instance->m_Threads.size());
+    instance->m_Threads.clear();
+    instance->m_Stopping = false;
+  }
+  instance->AddThreads(threadCount);
+}
+
+void
+WorkStealingThreadPool::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumNumberOfThreads: " << this->GetMaximumNumberOfThreads() << std::endl;
+  os << indent << "NumberOfQueuedTasks: " << this->GetNumberOfQueuedTasks() << std::endl;
+  os << indent << "NUMAAffinity: " << (m_NUMAAffinity ? "On" : "Off") << std::endl;
+}
+
+WorkStealingThreadPoolGlobals * WorkStealingThreadPool::m_PimplGlobals;
+
+} // namespace itk
@@ -0,0 +1,266 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the row-major layout of Image with the bricked layout of
+// BrickedImage on 3D neighborhood operations: a grayscale dilation by a box
+// of radius 1, and a separable Gaussian smoothing of radius 3 along each
+// dimension. The same code, written in terms of the region and neighborhood
+// ranges of each layout, processes both images, split in pieces by the
+// multi-threader. The best time of the iterations is reported, and the
+// outputs of both layouts are checked to be equal.
+//
+// The benchmark is built into ITKCommon2TestDriver but, like the ones of the
+// PerformanceBenchmarking remote module, not registered as a test; the
+// ranges of both layouts are compared by itkBrickedImageGTest. Run it as
+//   ITKCommon2TestDriver itkBrickedImageBenchmark size iterations
+// e.g. 1024 3 for images of 1024^3 pixels, 3 executions of each operation.
+
+#include "itkBrickedImageNeighborhoodRange.h"
+#include "itkBrickedImageRegionRange.h"
+#include "itkImage.h"
+#include "itkImageNeighborhoodOffsets.h"
+#include "itkImageRegionRange.h"
+#include "itkIndexRange.h"
+#include "itkMultiThreaderBase.h"
+#include "itkShapedImageNeighborhoodRange.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using BrickedImageType = itk::BrickedImage<float, Dimension>;
+using RegionType = ImageType::RegionType;
+using OffsetType = ImageType::OffsetType;
+
+// The ranges of each layout.
+template <typename TImage>
+struct Layout
+{
+  template <typename T>
+  using RegionRange = itk::ImageRegionRange<T>;
+  template <typename T>
+  using NeighborhoodRange = itk::ShapedImageNeighborhoodRange<T>;
+};
+
+template <>
+struct Layout<BrickedImageType>
+{
+  template <typename T>
+  using RegionRange = itk::BrickedImageRegionRange<T>;
+  template <typename T>
+  using NeighborhoodRange = itk::BrickedImageNeighborhoodRange<T>;
+};
+
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const RegionType & region)
+{
+  auto image = TImage::New();
+  image->SetRegions(region);
+  image->Allocate();
+  return image;
+}
+
+// Sets the output pixels of a piece of the region to a function of the
+// neighborhood of the input pixels.
+template <typename TImage, typename TFunction>
+void
+ApplyToNeighborhoods(const TImage &                  input,
+                     TImage &                        output,
+                     const std::vector<OffsetType> & offsets,
+                     const RegionType &              piece,
+                     TFunction                       function)
+{
+  typename Layout<TImage>::template NeighborhoodRange<const TImage> neighborhood(input, piece.GetIndex(), offsets);
+  const typename Layout<TImage>::template RegionRange<TImage>       outputRange(output, piece);
+
+  auto outputIt = outputRange.begin();
+  for (const auto & index : itk::ImageRegionIndexRange<Dimension>(piece))
+  {
+    neighborhood.SetLocation(index);
+    *outputIt = function(neighborhood);
+    ++outputIt;
+  }
+}
+
+template <typename TImage>
+void
+Dilate(const TImage & input, TImage & output)
+{
+  const auto offsets = itk::GenerateRectangularImageNeighborhoodOffsets(ImageType::SizeType::Filled(1));
+  itk::MultiThreaderBase::New()->ParallelizeImageRegion<Dimension>(
+    input.GetBufferedRegion(),
+    [&](const RegionType & piece) {
+      ApplyToNeighborhoods(input, output, offsets, piece, [](const auto & neighborhood) {
+        float maximum = std::numeric_limits<float>::lowest();
+        for (const float pixel : neighborhood)
+        {
+          maximum = std::max(maximum, pixel);
+        }
+        return maximum;
+      });
+    },
+    nullptr);
+}
+
+template <typename TImage>
+void
+Smooth(const TImage & input, TImage & output)
+{
+  constexpr int      radius = 3;
+  constexpr double   sigma = 1.0;
+  std::vector<float> weights;
+  for (int i = -radius; i <= radius; ++i)
+  {
+    weights.push_back(static_cast<float>(std::exp(-0.5 * i * i / (sigma * sigma))));
+  }
+  const float sum = std::accumulate(weights.cbegin(), weights.cend(), 0.0f);
+  for (float & weight : weights)
+  {
+    weight /= sum;
+  }
+
+  // One pass along each dimension, alternating between output and temporary.
+  const RegionType & region = input.GetBufferedRegion();
+  const auto         temporary = MakeImage<TImage>(region);
+  const TImage *     passInput = &input;
+  TImage *           passOutputs[Dimension] = { &output, temporary, &output };
+  for (unsigned int dimension = 0; dimension < Dimension; ++dimension)
+  {
+    std::vector<OffsetType> offsets;
+    for (int i = -radius; i <= radius; ++i)
+    {
+      OffsetType offset{};
+      offset[dimension] = i;
+      offsets.push_back(offset);
+    }
+    TImage * passOutput = passOutputs[dimension];
+    itk::MultiThreaderBase::New()->ParallelizeImageRegion<Dimension>(
+      region,
+      [&](const RegionType & piece) {
+        ApplyToNeighborhoods(*passInput, *passOutput, offsets, piece, [&weights](const auto & neighborhood) {
+          float value = 0.0f;
+          auto  it = neighborhood.cbegin();
+          for (const float weight : weights)
+          {
+            value += weight * static_cast<float>(*it);
+            ++it;
+          }
+          return value;
+        });
+      },
+      nullptr);
+    passInput = passOutput;
+  }
+}
+
+// Executes the operation iterations times, and returns the best time.
+template <typename TImage, typename TOperation>
+double
+Benchmark(const std::string &            label,
+          TOperation                     operation,
+          const TImage &                 input,
+          TImage &                       output,
+          unsigned int                   iterations,
+          itk::TimeProbesCollectorBase & collector)
+{
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    collector.Start(label.c_str());
+    operation(input, output);
+    collector.Stop(label.c_str());
+  }
+  const double seconds = collector.GetProbe(label.c_str()).GetMinimum();
+  std::cout << std::left << std::setw(24) << label << std::right << std::setw(10) << std::fixed
+            << std::setprecision(3) << seconds << " s" << std::setw(10) << std::setprecision(1)
+            << input.GetBufferedRegion().GetNumberOfPixels() / seconds / 1.0e6 << " Mpixels/s" << std::endl;
+  return seconds;
+}
+
+bool
+OutputsAreEqual(const ImageType & image, const BrickedImageType & brickedImage)
+{
+  const itk::ImageRegionRange<const ImageType>               range(image, image.GetBufferedRegion());
+  const itk::BrickedImageRegionRange<const BrickedImageType> brickedRange(brickedImage, image.GetBufferedRegion());
+  return std::equal(range.cbegin(), range.cend(), brickedRange.cbegin(), brickedRange.cend());
+}
+} // namespace
+
+int
+itkBrickedImageBenchmark(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " size iterations" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const itk::SizeValueType size = std::stoi(argv[1]);
+  const unsigned int       iterations = std::stoi(argv[2]);
+  const RegionType         region(ImageType::SizeType::Filled(size));
+
+  // A pseudo-random input, in both layouts.
+  const auto                             input = MakeImage<ImageType>(region);
+  const itk::ImageRegionRange<ImageType> inputRange(*input);
+  unsigned int                           state = 1;
+  std::generate(inputRange.begin(), inputRange.end(), [&state] {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float>(state >> 16);
+  });
+  const auto brickedInput = MakeImage<BrickedImageType>(region);
+  std::copy(
+    inputRange.cbegin(), inputRange.cend(), itk::BrickedImageRegionRange<BrickedImageType>(*brickedInput).begin());
+
+  const auto                   output = MakeImage<ImageType>(region);
+  const auto                   brickedOutput = MakeImage<BrickedImageType>(region);
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+
+  const auto dilate = [](const auto & in, auto & out) { Dilate(in, out); };
+  const double dilateTime = Benchmark("Image dilate", dilate, *input, *output, iterations, collector);
+  const double brickedDilateTime =
+    Benchmark("BrickedImage dilate", dilate, *brickedInput, *brickedOutput, iterations, collector);
+  ok &= OutputsAreEqual(*output, *brickedOutput);
+
+  const auto smooth = [](const auto & in, auto & out) { Smooth(in, out); };
+  const double smoothTime = Benchmark("Image Gaussian", smooth, *input, *output, iterations, collector);
+  const double brickedSmoothTime =
+    Benchmark("BrickedImage Gaussian", smooth, *brickedInput, *brickedOutput, iterations, collector);
+  ok &= OutputsAreEqual(*output, *brickedOutput);
+
+  std::cout << "Speedup of the bricked layout: dilate " << std::setprecision(2) << dilateTime / brickedDilateTime
+            << ", Gaussian " << smoothTime / brickedSmoothTime << std::endl;
+
+  if (!ok)
+  {
+    std::cerr << "The outputs of the two layouts differ." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
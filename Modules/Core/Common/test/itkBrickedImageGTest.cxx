@@ -0,0 +1,183 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBrickedImageNeighborhoodRange.h"
+#include "itkBrickedImageRegionRange.h"
+#include "itkImage.h"
+#include "itkImageNeighborhoodOffsets.h"
+#include "itkImageRegionRange.h"
+#include "itkIndexRange.h"
+#include "itkShapedImageNeighborhoodRange.h"
+#include "itkGTest.h"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+
+namespace
+{
+using ImageType = itk::Image<int, 3>;
+using BrickedImageType = itk::BrickedImage<int, 3, 4>;
+
+// A buffered region which is not a whole number of bricks, and does not
+// start at the origin.
+const ImageType::RegionType bufferedRegion({ { 2, -1, 5 } }, { { 13, 10, 9 } });
+
+ImageType::Pointer
+MakeImage()
+{
+  auto image = ImageType::New();
+  image->SetRegions(bufferedRegion);
+  image->Allocate();
+  const itk::ImageRegionRange<ImageType> range(*image);
+  std::iota(range.begin(), range.end(), 1);
+  return image;
+}
+
+BrickedImageType::Pointer
+MakeBrickedImage(const ImageType & image)
+{
+  auto brickedImage = BrickedImageType::New();
+  brickedImage->SetRegions(image.GetBufferedRegion());
+  brickedImage->Allocate(true);
+  const itk::ImageRegionRange<const ImageType> range(image);
+  std::copy(range.cbegin(), range.cend(), itk::BrickedImageRegionRange<BrickedImageType>(*brickedImage).begin());
+  return brickedImage;
+}
+} // namespace
+
+
+TEST(BrickedImage, CheckBasicObjectMethods)
+{
+  auto image = BrickedImageType::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(image, BrickedImage, ImageBase);
+
+  static_assert(BrickedImageType::PixelsPerBrick == 64);
+  image->SetRegions(bufferedRegion);
+  image->Allocate();
+  EXPECT_EQ(image->GetNumberOfBricks(), BrickedImageType::SizeType({ { 4, 3, 3 } }));
+  EXPECT_EQ(image->GetPixelContainer()->Size(), 4u * 3u * 3u * 64u);
+
+  image->Initialize();
+  EXPECT_EQ(image->GetBufferedRegion().GetNumberOfPixels(), 0u);
+  EXPECT_EQ(image->GetPixelContainer()->Size(), 0u);
+}
+
+
+TEST(BrickedImage, MapsEachPixelToItsBrick)
+{
+  auto image = BrickedImageType::New();
+  image->SetRegions(bufferedRegion);
+  image->Allocate();
+
+  // Distinct offsets within the buffer, and the pixels of a brick contiguous.
+  std::set<itk::OffsetValueType> offsets;
+  for (const auto & index : itk::ImageRegionIndexRange<3>(bufferedRegion))
+  {
+    const itk::OffsetValueType offset = image->ComputeBrickOffset(index);
+    EXPECT_GE(offset, 0);
+    EXPECT_LT(offset, static_cast<itk::OffsetValueType>(image->GetPixelContainer()->Size()));
+    offsets.insert(offset);
+  }
+  EXPECT_EQ(offsets.size(), bufferedRegion.GetNumberOfPixels());
+
+  const BrickedImageType::RegionType firstBrick(bufferedRegion.GetIndex(), { { 4, 4, 4 } });
+  for (const auto & index : itk::ImageRegionIndexRange<3>(firstBrick))
+  {
+    EXPECT_LT(image->ComputeBrickOffset(index), 64);
+  }
+
+  image->FillBuffer(0);
+  const BrickedImageType::IndexType index{ { 7, 3, 10 } };
+  image->SetPixel(index, 42);
+  EXPECT_EQ(image->GetPixel(index), 42);
+  EXPECT_EQ(image->GetBufferPointer()[image->ComputeBrickOffset(index)], 42);
+}
+
+
+TEST(BrickedImage, RegionRangeMatchesImageRegionRange)
+{
+  const auto image = MakeImage();
+  const auto brickedImage = MakeBrickedImage(*image);
+
+  for (const auto & index : itk::ImageRegionIndexRange<3>(bufferedRegion))
+  {
+    ASSERT_EQ(brickedImage->GetPixel(index), image->GetPixel(index));
+  }
+
+  // A region within the buffered one, forwards and backwards.
+  const ImageType::RegionType region({ { 3, 2, 6 } }, { { 7, 5, 3 } });
+  const itk::ImageRegionRange<const ImageType>               imageRange(*image, region);
+  const itk::BrickedImageRegionRange<const BrickedImageType> brickedRange(*brickedImage, region);
+  EXPECT_EQ(brickedRange.size(), region.GetNumberOfPixels());
+  EXPECT_TRUE(std::equal(brickedRange.cbegin(), brickedRange.cend(), imageRange.cbegin(), imageRange.cend()));
+  EXPECT_TRUE(std::equal(brickedRange.rbegin(), brickedRange.rend(), imageRange.rbegin(), imageRange.rend()));
+
+  const itk::BrickedImageRegionRange<const BrickedImageType> emptyRange(*brickedImage,
+                                                                        ImageType::RegionType(region.GetIndex(), {}));
+  EXPECT_TRUE(emptyRange.empty());
+  EXPECT_EQ(emptyRange.begin(), emptyRange.end());
+}
+
+
+TEST(BrickedImage, NeighborhoodRangeMatchesShapedImageNeighborhoodRange)
+{
+  const auto image = MakeImage();
+  const auto brickedImage = MakeBrickedImage(*image);
+
+  const auto offsets = itk::GenerateRectangularImageNeighborhoodOffsets(ImageType::SizeType{ { 1, 1, 1 } });
+  const ImageType::IndexType                                 location = bufferedRegion.GetIndex();
+  itk::ShapedImageNeighborhoodRange<const ImageType>         imageRange(*image, location, offsets);
+  itk::BrickedImageNeighborhoodRange<const BrickedImageType> brickedRange(*brickedImage, location, offsets);
+  unsigned int                                               numberOfLocationsWithinBricks = 0;
+
+  // All the locations of the buffered region, and around it.
+  const ImageType::RegionType locations({ { 1, -2, 4 } }, { { 15, 12, 11 } });
+  for (const auto & index : itk::ImageRegionIndexRange<3>(locations))
+  {
+    imageRange.SetLocation(index);
+    brickedRange.SetLocation(index);
+    numberOfLocationsWithinBricks += brickedRange.IsWithinBrick() ? 1 : 0;
+    ASSERT_EQ(brickedRange.size(), imageRange.size());
+    for (size_t n = 0; n < imageRange.size(); ++n)
+    {
+      ASSERT_EQ(brickedRange[n], imageRange[n]) << index << " " << offsets[n];
+    }
+  }
+
+  // The inner 2x2x2 pixels of the bricks, except the partial bricks at the
+  // end: 3x2x2 bricks.
+  EXPECT_EQ(numberOfLocationsWithinBricks, (3u * 2u * 2u) * (2u * 2u * 2u));
+
+  // Writing through the range.
+  itk::BrickedImageNeighborhoodRange<BrickedImageType> writableRange(*brickedImage, { { 4, 1, 7 } }, offsets);
+  std::fill(writableRange.begin(), writableRange.end(), -1);
+  EXPECT_EQ(brickedImage->GetPixel({ { 3, 0, 6 } }), -1);
+  EXPECT_EQ(brickedImage->GetPixel({ { 5, 2, 8 } }), -1);
+}
+
+
+TEST(BrickedImage, Graft)
+{
+  const auto image = MakeBrickedImage(*MakeImage());
+  auto       grafted = BrickedImageType::New();
+  grafted->Graft(image);
+  EXPECT_EQ(grafted->GetBufferedRegion(), image->GetBufferedRegion());
+  EXPECT_EQ(grafted->GetBufferPointer(), image->GetBufferPointer());
+  EXPECT_EQ(grafted->GetPixel({ { 9, 4, 8 } }), image->GetPixel({ { 9, 4, 8 } }));
+}
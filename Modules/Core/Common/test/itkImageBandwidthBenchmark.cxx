@@ -0,0 +1,174 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Measures the memory bandwidth of pixel-wise filters, in the manner of the
+// STREAM benchmark: copy (CastImageFilter), scale (MultiplyImageFilter by a
+// constant), add (AddImageFilter) and triad (a + s * b) over images too large
+// for the caches. Each kernel is run with the default multi-threader and
+// allocator, then with the NUMA configuration: the WorkStealing
+// multi-threader with NUMA affinity, which executes each piece of an image
+// region in the same thread from one filter to the next, and the
+// FirstTouchImageBufferAllocator, which places the pages of each piece in
+// the memory of that thread. The best bandwidth of the iterations is
+// reported, counting the bytes read and written by each kernel, and the
+// outputs are checked.
+//
+// The benchmark is built into ITKCommon2TestDriver but, like the ones of the
+// PerformanceBenchmarking remote module, not registered as a test; the NUMA
+// configuration is tested by itkImageBufferAllocatorGTest. Run it as
+//   ITKCommon2TestDriver itkImageBandwidthBenchmark size iterations
+// e.g. 256 10 for images of 256^3 pixels, 10 executions of each kernel.
+
+#include "itkAddImageFilter.h"
+#include "itkBinaryGeneratorImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkFirstTouchImageBufferAllocator.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkWorkStealingMultiThreader.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+ImageType::Pointer
+MakeImage(itk::SizeValueType size, float value)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  image->FillBuffer(value);
+  return image;
+}
+
+bool
+HasValue(const ImageType * image, float value)
+{
+  const float *            buffer = image->GetBufferPointer();
+  const itk::SizeValueType numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  return std::all_of(buffer, buffer + numberOfPixels, [value](float pixel) { return pixel == value; });
+}
+
+using FilterType = itk::InPlaceImageFilter<ImageType, ImageType>;
+
+// Executes the filter iterations times, and reports the best bandwidth for
+// the given number of bytes read and written per pixel.
+bool
+Benchmark(const std::string &            label,
+          FilterType *                   filter,
+          unsigned int                   bytesPerPixel,
+          float                          expectedValue,
+          unsigned int                   iterations,
+          itk::TimeProbesCollectorBase & collector)
+{
+  filter->InPlaceOff();
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    filter->Modified();
+    collector.Start(label.c_str());
+    filter->Update();
+    collector.Stop(label.c_str());
+  }
+
+  const ImageType * output = filter->GetOutput();
+  const double      bytes = static_cast<double>(bytesPerPixel) * output->GetBufferedRegion().GetNumberOfPixels();
+  const double      seconds = collector.GetProbe(label.c_str()).GetMinimum();
+  const bool        ok = HasValue(output, expectedValue);
+  std::cout << std::left << std::setw(32) << label << std::right << std::setw(10) << std::fixed
+            << std::setprecision(2) << bytes / seconds / 1.0e9 << " GB/s";
+  std::cout << (ok ? "" : "  (wrong output)") << std::endl;
+  return ok;
+}
+
+bool
+BenchmarkKernels(const std::string & configuration, itk::SizeValueType size, unsigned int iterations)
+{
+  // The images are allocated with the configuration under test.
+  const auto a = MakeImage(size, 1.0f);
+  const auto b = MakeImage(size, 2.0f);
+  constexpr float scalar = 3.0f;
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+
+  auto copy = itk::CastImageFilter<ImageType, ImageType>::New();
+  copy->SetInput(a);
+  ok &= Benchmark(configuration + " copy", copy, 2 * sizeof(float), 1.0f, iterations, collector);
+
+  auto scale = itk::MultiplyImageFilter<ImageType, ImageType, ImageType>::New();
+  scale->SetInput1(b);
+  scale->SetConstant2(scalar);
+  ok &= Benchmark(configuration + " scale", scale, 2 * sizeof(float), 6.0f, iterations, collector);
+
+  auto add = itk::AddImageFilter<ImageType, ImageType, ImageType>::New();
+  add->SetInput1(a);
+  add->SetInput2(b);
+  ok &= Benchmark(configuration + " add", add, 3 * sizeof(float), 3.0f, iterations, collector);
+
+  auto triad = itk::BinaryGeneratorImageFilter<ImageType, ImageType, ImageType>::New();
+  triad->SetInput1(a);
+  triad->SetInput2(b);
+  triad->SetFunctor([scalar](const float & p, const float & q) { return p + scalar * q; });
+  ok &= Benchmark(configuration + " triad", triad, 3 * sizeof(float), 7.0f, iterations, collector);
+
+  return ok;
+}
+} // namespace
+
+int
+itkImageBandwidthBenchmark(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " size iterations" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const itk::SizeValueType size = std::stoi(argv[1]);
+  const unsigned int       iterations = std::stoi(argv[2]);
+
+  bool ok = BenchmarkKernels("default", size, iterations);
+
+  // The NUMA configuration, restored afterwards.
+  const auto threaderType = itk::MultiThreaderBase::GetGlobalDefaultThreader();
+  const auto allocator = itk::ImageBufferAllocator::GetGlobalDefaultAllocator();
+  const auto pool = itk::WorkStealingThreadPool::GetInstance();
+  const bool numaAffinity = pool->GetNUMAAffinity();
+
+  itk::MultiThreaderBase::SetGlobalDefaultThreader(itk::MultiThreaderBase::ThreaderEnum::WorkStealing);
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(itk::FirstTouchImageBufferAllocator::New());
+  pool->SetNUMAAffinity(true);
+  ok &= BenchmarkKernels("NUMA", size, iterations);
+
+  pool->SetNUMAAffinity(numaAffinity);
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(allocator);
+  itk::MultiThreaderBase::SetGlobalDefaultThreader(threaderType);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,307 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAlignedImageBufferAllocator.h"
+#include "itkFirstTouchImageBufferAllocator.h"
+#include "itkHugePageImageBufferAllocator.h"
+#include "itkPoolImageBufferAllocator.h"
+#include "itkGTest.h"
+#include "itkImage.h"
+#include "itkImageBufferRange.h"
+#include "itkImageRegionIterator.h"
+#include "itkMemoryProbe.h"
+#include "itkVectorImage.h"
+#include "itkWorkStealingMultiThreader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+// Allocates an image with the allocator, checks that its buffer is aligned
+// and zero initialized, and that its pixels can be written.
+void
+ExpectAllocatesImages(itk::ImageBufferAllocator * allocator)
+{
+  for (const itk::SizeValueType size : { 1, 17, 100 })
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType::Filled(size));
+    image->GetPixelContainer()->SetAllocator(allocator);
+    image->AllocateInitialized();
+
+    const auto address = reinterpret_cast<std::uintptr_t>(image->GetBufferPointer());
+    EXPECT_EQ(address % allocator->GetAlignment(), 0u) << allocator->GetNameOfClass();
+
+    auto range = itk::MakeImageBufferRange(image.GetPointer());
+    EXPECT_TRUE(std::all_of(range.cbegin(), range.cend(), [](float pixel) { return pixel == 0.0f; }));
+    std::fill(range.begin(), range.end(), 1.5f);
+    EXPECT_EQ(image->GetPixel(ImageType::IndexType::Filled(size - 1)), 1.5f);
+  }
+}
+} // namespace
+
+
+TEST(ImageBufferAllocator, CheckBasicObjectMethods)
+{
+  auto aligned = itk::AlignedImageBufferAllocator::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(aligned, AlignedImageBufferAllocator, ImageBufferAllocator);
+  auto hugePage = itk::HugePageImageBufferAllocator::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(hugePage, HugePageImageBufferAllocator, AlignedImageBufferAllocator);
+  auto firstTouch = itk::FirstTouchImageBufferAllocator::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(firstTouch, FirstTouchImageBufferAllocator, AlignedImageBufferAllocator);
+  auto pool = itk::PoolImageBufferAllocator::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(pool, PoolImageBufferAllocator, ImageBufferAllocator);
+
+  EXPECT_EQ(aligned->GetAlignment(), 64u);
+  EXPECT_THROW(aligned->SetAlignment(48), itk::ExceptionObject);
+  EXPECT_THROW(hugePage->SetHugePageSize(3 << 20), itk::ExceptionObject);
+  EXPECT_THROW(pool->SetAllocator(nullptr), itk::ExceptionObject);
+}
+
+
+TEST(ImageBufferAllocator, AllocatesAlignedInitializedImages)
+{
+  auto aligned = itk::AlignedImageBufferAllocator::New();
+  ExpectAllocatesImages(aligned);
+  aligned->SetAlignment(256);
+  ExpectAllocatesImages(aligned);
+
+  // Small huge pages and parallel sizes, so that the images use them.
+  auto hugePage = itk::HugePageImageBufferAllocator::New();
+  hugePage->SetHugePageSize(64 << 10);
+  ExpectAllocatesImages(hugePage);
+
+  auto firstTouch = itk::FirstTouchImageBufferAllocator::New();
+  firstTouch->SetMinimumParallelBufferSize(64 << 10);
+  ExpectAllocatesImages(firstTouch);
+
+  auto pool = itk::PoolImageBufferAllocator::New();
+  ExpectAllocatesImages(pool);
+  ExpectAllocatesImages(pool);
+  pool->SetAllocator(firstTouch);
+  ExpectAllocatesImages(pool);
+}
+
+
+TEST(ImageBufferAllocator, FirstTouchFollowsTheSplitOfImageRegions)
+{
+  auto firstTouch = itk::FirstTouchImageBufferAllocator::New();
+  firstTouch->SetMinimumParallelBufferSize(0);
+  ExpectAllocatesImages(firstTouch);
+
+  // The region of the image is passed on to the allocator.
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType({ { 3, -2, 5 } }, { { 37, 5, 11 } }));
+  image->GetPixelContainer()->SetAllocator(firstTouch);
+  image->Allocate();
+  const itk::ImageIORegion & imageRegion = image->GetPixelContainer()->GetImageRegion();
+  ASSERT_EQ(imageRegion.GetImageDimension(), 3u);
+  EXPECT_EQ(imageRegion.GetNumberOfPixels(), image->GetBufferedRegion().GetNumberOfPixels());
+  EXPECT_EQ(imageRegion.GetSize(0), 37u);
+
+  auto vectorImage = itk::VectorImage<double, 2>::New();
+  vectorImage->SetRegions(itk::Size<2>{ { 53, 29 } });
+  vectorImage->SetVectorLength(3);
+  vectorImage->GetPixelContainer()->SetAllocator(firstTouch);
+  vectorImage->AllocateInitialized();
+  const double * const buffer = vectorImage->GetBufferPointer();
+  EXPECT_TRUE(std::all_of(buffer, buffer + 53 * 29 * 3, [](double value) { return value == 0.0; }));
+
+  // Regions of any dimension, and regions which do not match the buffer.
+  for (const unsigned int dimension : { 1u, 2u, 4u })
+  {
+    itk::ImageIORegion region(dimension);
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      region.SetSize(d, 7 + 3 * d);
+    }
+    const itk::SizeValueType numberOfPixels = region.GetNumberOfPixels();
+    for (const itk::SizeValueType numberOfBytes : { numberOfPixels * 8, numberOfPixels * 8 + 1 })
+    {
+      auto * const memory = static_cast<unsigned char *>(firstTouch->AllocateForRegion(numberOfBytes, region, true));
+      ASSERT_NE(memory, nullptr);
+      EXPECT_TRUE(std::all_of(memory, memory + numberOfBytes, [](unsigned char byte) { return byte == 0; }));
+      firstTouch->Deallocate(memory, numberOfBytes);
+    }
+  }
+}
+
+
+TEST(ImageBufferAllocator, ProcessesImagesInTheNUMAConfiguration)
+{
+  // The WorkStealing thread pool with NUMA affinity and the first-touch
+  // allocator as global default, restored afterwards.
+  const auto allocator = itk::ImageBufferAllocator::GetGlobalDefaultAllocator();
+  const auto pool = itk::WorkStealingThreadPool::GetInstance();
+  const bool numaAffinity = pool->GetNUMAAffinity();
+  auto       firstTouch = itk::FirstTouchImageBufferAllocator::New();
+  firstTouch->SetMinimumParallelBufferSize(0);
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(firstTouch);
+  pool->SetNUMAAffinity(true);
+
+  const auto makeImage = [](float value) {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 29, 17, 13 } });
+    image->Allocate();
+    image->FillBuffer(value);
+    return image;
+  };
+  const auto a = makeImage(1.0f);
+  const auto b = makeImage(2.0f);
+  const auto triad = makeImage(0.0f);
+
+  // A triad, split as the filters split their output region.
+  const itk::MultiThreaderBase::Pointer threader = itk::WorkStealingMultiThreader::New();
+  threader->SetNumberOfWorkUnits(5);
+  threader->ParallelizeImageRegion<3>(
+    triad->GetBufferedRegion(),
+    [&](const ImageType::RegionType & region) {
+      itk::ImageRegionConstIterator<ImageType> itA(a, region);
+      itk::ImageRegionConstIterator<ImageType> itB(b, region);
+      for (itk::ImageRegionIterator<ImageType> it(triad, region); !it.IsAtEnd(); ++it, ++itA, ++itB)
+      {
+        it.Set(itA.Get() + 3.0f * itB.Get());
+      }
+    },
+    nullptr);
+
+  auto range = itk::MakeImageBufferRange(triad.GetPointer());
+  EXPECT_TRUE(std::all_of(range.cbegin(), range.cend(), [](float pixel) { return pixel == 7.0f; }));
+
+  pool->SetNUMAAffinity(numaAffinity);
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(allocator);
+}
+
+
+TEST(ImageBufferAllocator, ConstructsAndDestroysElements)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, std::string>;
+
+  for (const itk::ImageBufferAllocator::Pointer & allocator :
+       { itk::ImageBufferAllocator::Pointer(itk::AlignedImageBufferAllocator::New()),
+         itk::ImageBufferAllocator::Pointer(itk::PoolImageBufferAllocator::New()) })
+  {
+    auto container = ContainerType::New();
+    container->SetAllocator(allocator);
+    container->Reserve(100, true);
+    for (itk::SizeValueType i = 0; i < 100; ++i)
+    {
+      EXPECT_TRUE((*container)[i].empty());
+      (*container)[i] = "element number " + std::to_string(i);
+    }
+
+    // The elements are copied to the larger buffer.
+    container->Reserve(1000);
+    EXPECT_EQ((*container)[99], "element number 99");
+    container->Squeeze();
+    container->Initialize();
+  }
+}
+
+
+TEST(ImageBufferAllocator, PoolReusesReleasedBuffers)
+{
+  EXPECT_EQ(itk::PoolImageBufferAllocator::GetSizeClass(1), 64u);
+  EXPECT_EQ(itk::PoolImageBufferAllocator::GetSizeClass(100), 128u);
+  EXPECT_EQ(itk::PoolImageBufferAllocator::GetSizeClass(4096), 4096u);
+  EXPECT_EQ(itk::PoolImageBufferAllocator::GetSizeClass(4097), 4608u);
+  EXPECT_EQ(itk::PoolImageBufferAllocator::GetSizeClass(1 << 20), itk::SizeValueType{ 1 } << 20);
+  EXPECT_EQ(itk::PoolImageBufferAllocator::GetSizeClass((1 << 20) + 1), itk::SizeValueType{ 9 } << 17);
+
+  auto pool = itk::PoolImageBufferAllocator::New();
+
+  const auto allocate = [&pool](itk::SizeValueType size) {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType::Filled(size));
+    image->GetPixelContainer()->SetAllocator(pool);
+    image->Allocate();
+    return image;
+  };
+
+  const auto    statistics = itk::ImageBufferAllocator::GetStatistics();
+  const float * buffer = allocate(32)->GetBufferPointer();
+  const auto    pooledBytes = pool->GetPooledBytes();
+  EXPECT_GE(pooledBytes, 32u * 32u * 32u * sizeof(float));
+  ImageType::Pointer image = allocate(32);
+  EXPECT_EQ(image->GetBufferPointer(), buffer);
+  EXPECT_EQ(pool->GetPooledBytes(), 0u);
+  EXPECT_EQ(itk::ImageBufferAllocator::GetStatistics().NumberOfReuses, statistics.NumberOfReuses + 1);
+
+  // A buffer of another size class is not reused, and the pool holds at most
+  // its maximum.
+  EXPECT_NE(allocate(31)->GetBufferPointer(), buffer);
+  EXPECT_GT(pool->GetPooledBytes(), 0u);
+  pool->ReleasePooledBuffers();
+  EXPECT_EQ(pool->GetPooledBytes(), 0u);
+  pool->SetMaximumPooledBytes(pooledBytes - 1);
+  image = nullptr;
+  EXPECT_EQ(pool->GetPooledBytes(), 0u);
+}
+
+
+TEST(ImageBufferAllocator, UsesGlobalDefaultAllocator)
+{
+  EXPECT_TRUE(itk::ImageBufferAllocator::CreateAllocator("PoolImageBufferAllocator").IsNotNull());
+  EXPECT_TRUE(itk::ImageBufferAllocator::CreateAllocator("NoSuchImageBufferAllocator").IsNull());
+
+  const itk::ImageBufferAllocator::Pointer previous = itk::ImageBufferAllocator::GetGlobalDefaultAllocator();
+  auto                                     pool = itk::PoolImageBufferAllocator::New();
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(pool);
+  EXPECT_EQ(itk::ImageBufferAllocator::GetGlobalDefaultAllocator(), pool.GetPointer());
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(8));
+  image->Allocate();
+  image->Initialize();
+  EXPECT_GT(pool->GetPooledBytes(), 0u);
+
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(previous);
+}
+
+
+TEST(ImageBufferAllocator, MemoryProbeCountsImageBuffers)
+{
+  constexpr itk::SizeValueType numberOfBytes = 20 * 20 * 20 * sizeof(float);
+
+  itk::MemoryProbe probe;
+  probe.Start();
+  {
+    // Allocated with new[], as no allocator is set.
+    auto image1 = ImageType::New();
+    image1->SetRegions(ImageType::SizeType::Filled(20));
+    image1->Allocate();
+    auto image2 = ImageType::New();
+    image2->SetRegions(ImageType::SizeType::Filled(20));
+    image2->GetPixelContainer()->SetAllocator(itk::AlignedImageBufferAllocator::New());
+    image2->Allocate();
+  }
+  probe.Stop();
+
+  EXPECT_EQ(probe.GetNumberOfImageBufferAllocations(), 2u);
+  EXPECT_EQ(probe.GetImageBufferAllocatedBytes(), 2 * numberOfBytes);
+  EXPECT_EQ(probe.GetImageBufferPeakBytes(), 2 * numberOfBytes);
+  EXPECT_EQ(probe.GetNumberOfImageBufferReuses(), 0u);
+
+  probe.Reset();
+  EXPECT_EQ(probe.GetNumberOfImageBufferAllocations(), 0u);
+  EXPECT_EQ(probe.GetImageBufferPeakBytes(), 0u);
+}
@@ -157,6 +157,7 @@ itkMultiThreaderBaseTest(int argc, char * argv[])
     itk::MultiThreaderBaseEnums::Threader::Pool,
     itk::MultiThreaderBaseEnums::Threader::TBB,
     itk::MultiThreaderBaseEnums::Threader::Single,
+    itk::MultiThreaderBaseEnums::Threader::WorkStealing,
     //            itk::MultiThreaderBaseEnums::Threader::Last,
     itk::MultiThreaderBaseEnums::Threader::Unknown
   };
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the overhead of the multi-threaders: the time taken by
+// ParallelizeArray and ParallelizeImageRegion for work so small that it is
+// dominated by the cost of distributing it, and by ParallelizeArray calls
+// nested in the work units of another ParallelizeArray, for the Platform,
+// Pool, TBB (when available) and WorkStealing multi-threaders. Each call is
+// checked to have processed every index or pixel exactly once.
+//
+// The benchmark is built into ITKCommon2TestDriver but, like the ones of the
+// PerformanceBenchmarking remote module, not registered as a test;
+// itkWorkStealingMultiThreaderGTest tests the WorkStealing multi-threader.
+// Run it as
+//   ITKCommon2TestDriver itkMultiThreaderOverheadBenchmark iterations [numberOfWorkUnits]
+// e.g. 10000 iterations of each kind of call, with the default number of
+// work units of each multi-threader.
+
+#include "itkPlatformMultiThreader.h"
+#include "itkPoolMultiThreader.h"
+#include "itkWorkStealingMultiThreader.h"
+#ifdef ITK_USE_TBB
+#  include "itkTBBMultiThreader.h"
+#endif
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <atomic>
+#include <vector>
+
+namespace
+{
+bool
+Benchmark(const char *                   name,
+          itk::MultiThreaderBase *       threader,
+          itk::ThreadIdType              numberOfWorkUnits,
+          unsigned int                   iterations,
+          bool                           nested,
+          itk::TimeProbesCollectorBase & collector)
+{
+  if (numberOfWorkUnits > 0)
+  {
+    threader->SetNumberOfWorkUnits(numberOfWorkUnits);
+  }
+  const std::string label =
+    std::string(name) + " (" + std::to_string(threader->GetNumberOfWorkUnits()) + " work units)";
+  bool ok = true;
+
+  // One increment per index, so that the work is negligible.
+  constexpr itk::SizeValueType  arraySize = 256;
+  std::vector<std::atomic<int>> counts(arraySize);
+  const std::string             arrayProbe = label + " ParallelizeArray";
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    collector.Start(arrayProbe.c_str());
+    threader->ParallelizeArray(0, arraySize, [&counts](itk::SizeValueType ii) { ++counts[ii]; }, nullptr);
+    collector.Stop(arrayProbe.c_str());
+  }
+  for (const auto & count : counts)
+  {
+    ok &= (count == static_cast<int>(iterations));
+  }
+
+  constexpr itk::IndexValueType   index[2] = { 0, 0 };
+  constexpr itk::SizeValueType    size[2] = { 64, 64 };
+  std::atomic<itk::SizeValueType> numberOfPixels{ 0 };
+  const std::string               regionProbe = label + " ParallelizeImageRegion";
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    collector.Start(regionProbe.c_str());
+    threader->ParallelizeImageRegion(
+      2,
+      index,
+      size,
+      [&numberOfPixels](const itk::IndexValueType *, const itk::SizeValueType * regionSize) {
+        numberOfPixels += regionSize[0] * regionSize[1];
+      },
+      nullptr);
+    collector.Stop(regionProbe.c_str());
+  }
+  ok &= (numberOfPixels == iterations * size[0] * size[1]);
+
+  if (nested)
+  {
+    // The threader runs parallel loops from within its own work units, as a
+    // filter using another filter in its work units would.
+    constexpr itk::SizeValueType    outerSize = 16;
+    std::atomic<itk::SizeValueType> numberOfIndices{ 0 };
+    const std::string               nestedProbe = label + " nested ParallelizeArray";
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+      collector.Start(nestedProbe.c_str());
+      threader->ParallelizeArray(
+        0,
+        outerSize,
+        [threader, &numberOfIndices](itk::SizeValueType) {
+          threader->ParallelizeArray(
+            0, outerSize, [&numberOfIndices](itk::SizeValueType) { ++numberOfIndices; }, nullptr);
+        },
+        nullptr);
+      collector.Stop(nestedProbe.c_str());
+    }
+    ok &= (numberOfIndices == iterations * outerSize * outerSize);
+  }
+
+  if (!ok)
+  {
+    std::cerr << "Error: " << label << " did not process every index exactly once" << std::endl;
+  }
+  return ok;
+}
+} // namespace
+
+int
+itkMultiThreaderOverheadBenchmark(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " iterations [numberOfWorkUnits]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const unsigned int      iterations = std::stoi(argv[1]);
+  const itk::ThreadIdType numberOfWorkUnits = argc > 2 ? std::stoi(argv[2]) : 0;
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+
+  // Nested parallel loops are not benchmarked with the Pool multi-threader,
+  // whose waiting work units may keep the nested ones from being executed,
+  // nor with the Platform one, which spawns threads for each loop.
+  ok &= Benchmark(
+    "Platform", itk::PlatformMultiThreader::New().GetPointer(), numberOfWorkUnits, iterations, false, collector);
+  ok &= Benchmark("Pool", itk::PoolMultiThreader::New().GetPointer(), numberOfWorkUnits, iterations, false, collector);
+#ifdef ITK_USE_TBB
+  ok &= Benchmark("TBB", itk::TBBMultiThreader::New().GetPointer(), numberOfWorkUnits, iterations, true, collector);
+#endif
+  ok &= Benchmark(
+    "WorkStealing", itk::WorkStealingMultiThreader::New().GetPointer(), numberOfWorkUnits, iterations, true, collector);
+
+  collector.Report(std::cout);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
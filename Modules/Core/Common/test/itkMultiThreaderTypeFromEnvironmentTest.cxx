@@ -74,6 +74,7 @@ itkMultiThreaderTypeFromEnvironmentTest(int argc, char * argv[])
     ThreaderEnum::TBB,
 #endif // ITK_USE_TBB
     ThreaderEnum::Single,
+    ThreaderEnum::WorkStealing,
   };
   for (auto thType : threadersToTest)
   {
@@ -85,7 +86,7 @@ itkMultiThreaderTypeFromEnvironmentTest(int argc, char * argv[])
   // 1. insert it into threadersToTest set
   // 2. add tests to Modules/Core/Common/test/CMakeLists.txt similarly to tests for other multi-threaders
   // 3. rewrite the condition below to use whatever is really the last threader type
-  itkAssertOrThrowMacro(ThreaderEnum::Single == ThreaderEnum::Last,
+  itkAssertOrThrowMacro(ThreaderEnum::WorkStealing == ThreaderEnum::Last,
                         "All multi-threader implementation have to be tested!");
 
   if (success)
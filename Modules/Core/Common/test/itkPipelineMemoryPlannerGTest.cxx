@@ -0,0 +1,250 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineMemoryPlanner.h"
+#include "itkImageRegionRange.h"
+#include "itkPoolImageBufferAllocator.h"
+#include "itkImageSource.h"
+#include "itkInPlaceImageFilter.h"
+#include "itkGTest.h"
+
+#include <algorithm>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+constexpr itk::SizeValueType imageBytes = 32 * 32 * 32 * sizeof(float);
+
+// Generates an image of ones, counting its executions.
+class OnesSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(OnesSource);
+
+  using Self = OnesSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(OnesSource);
+
+  unsigned int                       NumberOfExecutions{ 0 };
+  itk::ImageBufferAllocator::Pointer GlobalDefaultAllocator{};
+  itk::ImageBufferAllocator::Pointer BufferAllocator{};
+
+protected:
+  OnesSource() = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    Superclass::GenerateOutputInformation();
+    this->GetOutput()->SetLargestPossibleRegion(ImageType::RegionType(ImageType::SizeType::Filled(32)));
+  }
+
+  void
+  GenerateData() override
+  {
+    ++NumberOfExecutions;
+    GlobalDefaultAllocator = itk::ImageBufferAllocator::GetGlobalDefaultAllocator();
+    BufferAllocator = this->GetOutput()->GetBufferAllocator();
+    Superclass::GenerateData();
+  }
+
+  void
+  DynamicThreadedGenerateData(const ImageType::RegionType & region) override
+  {
+    const itk::ImageRegionRange<ImageType> range(*this->GetOutput(), region);
+    std::fill(range.begin(), range.end(), 1.0f);
+  }
+};
+
+// Adds its inputs and a constant, in place when it has one input.
+class AddFilter : public itk::InPlaceImageFilter<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AddFilter);
+
+  using Self = AddFilter;
+  using Superclass = itk::InPlaceImageFilter<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(AddFilter);
+
+  static Pointer
+  New(const ImageType * input, float constant, const ImageType * secondInput = nullptr)
+  {
+    auto filter = New();
+    filter->SetInput(0, input);
+    if (secondInput)
+    {
+      filter->SetInput(1, secondInput);
+    }
+    filter->m_Constant = constant;
+    return filter;
+  }
+
+protected:
+  AddFilter() = default;
+
+  void
+  DynamicThreadedGenerateData(const ImageType::RegionType & region) override
+  {
+    const itk::ImageRegionRange<ImageType> outputRange(*this->GetOutput(), region);
+    std::vector<float>                     values(outputRange.size(), m_Constant);
+    for (itk::ProcessObject::DataObjectPointerArraySizeType i = 0; i < this->GetNumberOfIndexedInputs(); ++i)
+    {
+      const itk::ImageRegionRange<const ImageType> inputRange(*this->GetInput(i), region);
+      std::transform(values.cbegin(), values.cend(), inputRange.cbegin(), values.begin(), std::plus<>());
+    }
+    std::copy(values.cbegin(), values.cend(), outputRange.begin());
+  }
+
+private:
+  float m_Constant{ 0.0f };
+};
+
+bool
+IsFilledWith(const ImageType & image, float value)
+{
+  const itk::ImageRegionRange<const ImageType> range(image);
+  return !range.empty() &&
+         std::all_of(range.cbegin(), range.cend(), [value](float pixel) { return pixel == value; });
+}
+} // namespace
+
+
+TEST(PipelineMemoryPlanner, CheckBasicObjectMethods)
+{
+  const auto planner = itk::PipelineMemoryPlanner::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(planner, PipelineMemoryPlanner, Object);
+  EXPECT_TRUE(planner->GetRecycleBuffers());
+  planner->Update();
+  EXPECT_EQ(planner->GetNumberOfExecutedFilters(), 0u);
+}
+
+
+TEST(PipelineMemoryPlanner, ReleasesIntermediateDataAfterItsLastUse)
+{
+  // A chain of filters which do not run in place.
+  const auto                       source = OnesSource::New();
+  std::vector<AddFilter::Pointer> filters;
+  const ImageType *                input = source->GetOutput();
+  for (int i = 0; i < 5; ++i)
+  {
+    filters.push_back(AddFilter::New(input, 1.0f));
+    filters.back()->InPlaceOff();
+    input = filters.back()->GetOutput();
+  }
+
+  const auto planner = itk::PipelineMemoryPlanner::New();
+  planner->AddOutput(filters.back()->GetOutput());
+  planner->Update();
+
+  EXPECT_EQ(planner->GetExecutionOrder().size(), 6u);
+  EXPECT_EQ(planner->GetExecutionOrder().front(), source.GetPointer());
+  EXPECT_EQ(planner->GetNumberOfExecutedFilters(), 6u);
+  EXPECT_EQ(planner->GetNumberOfReleasedDataObjects(), 5u);
+  EXPECT_TRUE(IsFilledWith(*filters.back()->GetOutput(), 6.0f));
+  EXPECT_TRUE(source->GetOutput()->GetDataReleased());
+  EXPECT_TRUE(filters[3]->GetOutput()->GetDataReleased());
+
+  // At most an input and an output at a time, the other buffers recycled.
+  EXPECT_LE(planner->GetPeakBytes(), 2 * imageBytes);
+  EXPECT_GE(planner->GetNumberOfRecycledBuffers(), 3u);
+
+  // Nothing to execute again.
+  planner->Update();
+  EXPECT_EQ(planner->GetNumberOfExecutedFilters(), 0u);
+  EXPECT_EQ(source->NumberOfExecutions, 1u);
+  EXPECT_TRUE(IsFilledWith(*filters.back()->GetOutput(), 6.0f));
+}
+
+
+TEST(PipelineMemoryPlanner, DoesNotOverwriteSharedOrKeptData)
+{
+  // The output of the source is used by two in-place filters, whose outputs
+  // are added, and the output of the first is kept.
+  const auto source = OnesSource::New();
+  const auto first = AddFilter::New(source->GetOutput(), 1.0f);
+  const auto second = AddFilter::New(source->GetOutput(), 2.0f);
+  const auto third = AddFilter::New(first->GetOutput(), 3.0f);
+  const auto sum = AddFilter::New(second->GetOutput(), 0.0f, third->GetOutput());
+
+  const auto planner = itk::PipelineMemoryPlanner::New();
+  planner->AddOutput(sum->GetOutput());
+  planner->AddOutput(first->GetOutput());
+  planner->Update();
+
+  EXPECT_EQ(source->NumberOfExecutions, 1u);
+  EXPECT_TRUE(IsFilledWith(*first->GetOutput(), 2.0f));
+  EXPECT_TRUE(IsFilledWith(*sum->GetOutput(), 3.0f + 5.0f));
+  EXPECT_TRUE(source->GetOutput()->GetDataReleased());
+
+  // Only the filters downstream of a modified one are executed.
+  third->Modified();
+  planner->Update();
+  EXPECT_EQ(source->NumberOfExecutions, 2u);
+  EXPECT_TRUE(IsFilledWith(*sum->GetOutput(), 3.0f + 5.0f));
+}
+
+
+TEST(PipelineMemoryPlanner, RestoresTheDataObjectsAfterTheExecution)
+{
+  const auto source = OnesSource::New();
+  const auto first = AddFilter::New(source->GetOutput(), 1.0f);
+  const auto second = AddFilter::New(source->GetOutput(), 2.0f);
+  const auto sum = AddFilter::New(first->GetOutput(), 0.0f, second->GetOutput());
+
+  const itk::ImageBufferAllocator::Pointer globalDefaultAllocator =
+    itk::ImageBufferAllocator::GetGlobalDefaultAllocator();
+
+  const auto planner = itk::PipelineMemoryPlanner::New();
+  planner->AddOutput(sum->GetOutput());
+  planner->Update();
+  EXPECT_TRUE(IsFilledWith(*sum->GetOutput(), 2.0f + 3.0f));
+
+  // The pool only allocated the outputs of the filters.
+  EXPECT_EQ(source->GlobalDefaultAllocator, globalDefaultAllocator);
+  EXPECT_EQ(itk::ImageBufferAllocator::GetGlobalDefaultAllocator(), globalDefaultAllocator);
+
+  // The kept output does not refer to the pool, which keeps no buffer.
+  const auto pool = dynamic_cast<itk::PoolImageBufferAllocator *>(source->BufferAllocator.GetPointer());
+  ASSERT_NE(pool, nullptr);
+  EXPECT_NE(sum->GetOutput()->GetPixelContainer()->GetModifiableAllocator(), pool);
+  EXPECT_EQ(pool->GetPooledBytes(), 0u);
+
+  for (itk::ProcessObject * filter : planner->GetExecutionOrder())
+  {
+    for (const itk::DataObject * output : filter->GetOutputs())
+    {
+      EXPECT_TRUE(output->GetReuseDataFlag());
+      EXPECT_EQ(output->GetBufferAllocator(), nullptr);
+    }
+  }
+
+  // Restoring them did not modify them.
+  planner->Update();
+  EXPECT_EQ(planner->GetNumberOfExecutedFilters(), 0u);
+
+  // The buffer of the kept output is not pooled when it is released.
+  sum->GetOutput()->ReleaseData();
+  EXPECT_EQ(pool->GetPooledBytes(), 0u);
+}
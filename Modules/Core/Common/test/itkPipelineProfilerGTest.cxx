@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineProfiler.h"
+#include "itkImageRegionRange.h"
+#include "itkImageSource.h"
+#include "itkGTest.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+
+// Fills its output with a constant, with the dynamic or the classic
+// multi-threading, and, when it has an inner source, from the output of
+// the inner source, updated as a mini-pipeline.
+class FillSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FillSource);
+
+  using Self = FillSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(FillSource);
+
+  using Superclass::SetDynamicMultiThreading;
+
+  void
+  SetInnerSource(FillSource * innerSource)
+  {
+    m_InnerSource = innerSource;
+  }
+
+protected:
+  FillSource() = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    Superclass::GenerateOutputInformation();
+    this->GetOutput()->SetLargestPossibleRegion(ImageType::RegionType(ImageType::SizeType{ { 64, 32 } }));
+  }
+
+  void
+  GenerateData() override
+  {
+    if (m_InnerSource)
+    {
+      m_InnerSource->Update();
+    }
+    Superclass::GenerateData();
+  }
+
+  void
+  DynamicThreadedGenerateData(const ImageType::RegionType & region) override
+  {
+    const itk::ImageRegionRange<ImageType> range(*this->GetOutput(), region);
+    std::fill(range.begin(), range.end(), 1.0f);
+  }
+
+  void
+  ThreadedGenerateData(const ImageType::RegionType & region, itk::ThreadIdType) override
+  {
+    this->DynamicThreadedGenerateData(region);
+  }
+
+private:
+  Pointer m_InnerSource;
+};
+
+// Enables the profiler for the lifetime of the fixture.
+class PipelineProfilerFixture : public ::testing::Test
+{
+protected:
+  void
+  SetUp() override
+  {
+    itk::PipelineProfiler::SetEnabled(true);
+    itk::PipelineProfiler::Clear();
+  }
+
+  void
+  TearDown() override
+  {
+    itk::PipelineProfiler::SetEnabled(false);
+    itk::PipelineProfiler::Clear();
+  }
+};
+} // namespace
+
+
+TEST(PipelineProfiler, RecordsNothingWhenDisabled)
+{
+  itk::PipelineProfiler::SetEnabled(false);
+  itk::PipelineProfiler::Clear();
+  EXPECT_FALSE(itk::PipelineProfiler::GetEnabled());
+
+  FillSource::New()->Update();
+  EXPECT_TRUE(itk::PipelineProfiler::GetEvents().empty());
+  EXPECT_EQ(itk::PipelineProfiler::GetCurrentEvent(), nullptr);
+}
+
+
+TEST_F(PipelineProfilerFixture, RecordsEventsAndWorkUnits)
+{
+  for (const bool dynamicMultiThreading : { true, false })
+  {
+    itk::PipelineProfiler::Clear();
+    auto source = FillSource::New();
+    source->SetObjectName("source");
+    source->SetDynamicMultiThreading(dynamicMultiThreading);
+    source->SetNumberOfWorkUnits(4);
+    source->Update();
+
+    const auto events = itk::PipelineProfiler::GetEvents();
+    ASSERT_EQ(events.size(), 1u);
+    const itk::PipelineProfiler::EventRecord & event = events.front();
+    EXPECT_EQ(event.ClassName, "FillSource");
+    EXPECT_EQ(event.ObjectName, "source");
+    EXPECT_EQ(event.Depth, 0u);
+    EXPECT_GE(event.WallTime, 0.0);
+    EXPECT_GE(event.CPUTime, 0.0);
+    EXPECT_EQ(event.RequestedPixels, 64u * 32u);
+    EXPECT_EQ(event.RequestedRegions, "[0, 0][64, 32]");
+    EXPECT_GE(event.AllocatedBytes, 64u * 32u * sizeof(float));
+    EXPECT_FALSE(event.WorkUnits.empty());
+    EXPECT_GE(event.GetLoadImbalance(), 1.0);
+    for (const itk::PipelineProfiler::WorkUnitRecord & workUnit : event.WorkUnits)
+    {
+      EXPECT_GE(workUnit.StartTime, event.StartTime);
+      EXPECT_LE(workUnit.StartTime + workUnit.WallTime, event.StartTime + event.WallTime);
+    }
+  }
+  EXPECT_EQ(itk::PipelineProfiler::GetCurrentEvent(), nullptr);
+}
+
+
+TEST_F(PipelineProfilerFixture, NestsMiniPipelines)
+{
+  auto inner = FillSource::New();
+  auto outer = FillSource::New();
+  outer->SetInnerSource(inner);
+  outer->Update();
+
+  const auto events = itk::PipelineProfiler::GetEvents();
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(events[0].Depth, 0u);
+  EXPECT_EQ(events[1].Depth, 1u);
+  EXPECT_GE(events[1].StartTime, events[0].StartTime);
+  EXPECT_LE(events[1].StartTime + events[1].WallTime, events[0].StartTime + events[0].WallTime);
+}
+
+
+TEST_F(PipelineProfilerFixture, WritesChromeTraceAndReport)
+{
+  auto source = FillSource::New();
+  source->SetObjectName("a \"quoted\" name");
+  source->Update();
+  const auto events = itk::PipelineProfiler::GetEvents();
+  ASSERT_EQ(events.size(), 1u);
+
+  std::ostringstream trace;
+  itk::PipelineProfiler::WriteChromeTrace(trace);
+  const std::string json = trace.str();
+  EXPECT_EQ(json.find(R"({"displayTimeUnit":"ms","traceEvents":[)"), 0u);
+  EXPECT_NE(json.find(R"({"name":"FillSource","cat":"filter","ph":"X")"), std::string::npos);
+  EXPECT_NE(json.find(R"("name":"a \"quoted\" name")"), std::string::npos);
+  EXPECT_NE(json.find(R"("requested_pixels":2048)"), std::string::npos);
+  EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+  const auto numberOfTraceEvents = static_cast<size_t>(std::count(json.cbegin(), json.cend(), '\n')) - 2;
+  EXPECT_EQ(numberOfTraceEvents, 1 + events.front().WorkUnits.size());
+
+  std::ostringstream report;
+  itk::PipelineProfiler::WriteReport(report);
+  EXPECT_EQ(report.str().find("Filter"), 0u);
+  EXPECT_NE(report.str().find("FillSource"), std::string::npos);
+}
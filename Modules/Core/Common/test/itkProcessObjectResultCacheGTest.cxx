@@ -0,0 +1,313 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkProcessObjectResultCache.h"
+#include "itkImageToImageFilter.h"
+#include "itkSimpleDataObjectDecorator.h"
+#include "itkVectorImage.h"
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+ImageType::Pointer
+MakeImage(float value)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 16, 8, 4 } });
+  image->SetSpacing(itk::MakeVector(0.5, 1.0, 2.0));
+  image->Allocate();
+  image->FillBuffer(value);
+  return image;
+}
+
+// Adds an offset to the pixels, counting its executions.
+class CountingAddFilter : public itk::ImageToImageFilter<ImageType, ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(CountingAddFilter);
+
+  using Self = CountingAddFilter;
+  using Superclass = itk::ImageToImageFilter<ImageType, ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(CountingAddFilter);
+
+  itkSetMacro(Offset, float);
+
+  static unsigned int NumberOfExecutions;
+
+  bool
+  SerializeParameters(std::ostream & os) const override
+  {
+    os.write(reinterpret_cast<const char *>(&m_Offset), sizeof(m_Offset));
+    return true;
+  }
+
+protected:
+  CountingAddFilter() = default;
+
+  void
+  GenerateData() override
+  {
+    ++NumberOfExecutions;
+    this->AllocateOutputs();
+    const ImageType * input = this->GetInput();
+    ImageType *       output = this->GetOutput();
+    const float *     inputBuffer = input->GetBufferPointer();
+    std::transform(inputBuffer,
+                   inputBuffer + output->GetBufferedRegion().GetNumberOfPixels(),
+                   output->GetBufferPointer(),
+                   [this](float p) { return p + m_Offset; });
+  }
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Offset: " << m_Offset << std::endl;
+  }
+
+private:
+  float m_Offset{ 0.0f };
+};
+
+unsigned int CountingAddFilter::NumberOfExecutions = 0;
+
+// Does not write its parameters, so that it is not cached.
+class UncachedAddFilter : public CountingAddFilter
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(UncachedAddFilter);
+
+  using Self = UncachedAddFilter;
+  using Superclass = CountingAddFilter;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(UncachedAddFilter);
+
+  bool
+  SerializeParameters(std::ostream &) const override
+  {
+    return false;
+  }
+
+protected:
+  UncachedAddFilter() = default;
+};
+
+// Executes a new filter with the cache, and returns the first output pixel.
+template <typename TFilter = CountingAddFilter>
+float
+Execute(itk::ProcessObjectResultCache * cache, const ImageType * input, float offset)
+{
+  auto filter = TFilter::New();
+  filter->SetInput(input);
+  filter->SetOffset(offset);
+  filter->SetResultCache(cache);
+  filter->Update();
+  const ImageType * output = filter->GetOutput();
+  EXPECT_EQ(output->GetBufferedRegion(), input->GetBufferedRegion());
+  EXPECT_EQ(output->GetSpacing(), input->GetSpacing());
+  return output->GetBufferPointer()[0];
+}
+} // namespace
+
+
+TEST(ProcessObjectResultCache, CheckBasicObjectMethods)
+{
+  auto cache = itk::ProcessObjectResultCache::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(cache, ProcessObjectResultCache, Object);
+
+  EXPECT_EQ(cache->GetMaximumMemorySize(), itk::SizeValueType{ 1 } << 30);
+  EXPECT_EQ(cache->GetCacheDirectory(), "");
+  EXPECT_EQ(cache->GetStatistics().NumberOfEntries, 0u);
+}
+
+
+TEST(ProcessObjectResultCache, SerializesImageContent)
+{
+  const auto image = MakeImage(3.0f);
+  image->GetBufferPointer()[5] = 7.0f;
+
+  std::stringstream stream;
+  ASSERT_TRUE(image->SerializeContent(stream));
+
+  auto restored = ImageType::New();
+  ASSERT_TRUE(restored->DeserializeContent(stream));
+  EXPECT_EQ(restored->GetLargestPossibleRegion(), image->GetLargestPossibleRegion());
+  EXPECT_EQ(restored->GetBufferedRegion(), image->GetBufferedRegion());
+  EXPECT_EQ(restored->GetSpacing(), image->GetSpacing());
+  EXPECT_EQ(restored->GetDirection(), image->GetDirection());
+  EXPECT_TRUE(std::equal(image->GetBufferPointer(),
+                         image->GetBufferPointer() + image->GetBufferedRegion().GetNumberOfPixels(),
+                         restored->GetBufferPointer()));
+
+  // The pixel type of the content must match.
+  stream.clear();
+  stream.seekg(0);
+  const auto shortImage = itk::Image<short, 3>::New();
+  EXPECT_FALSE(shortImage->DeserializeContent(stream));
+
+  using VectorImageType = itk::VectorImage<float, 2>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(VectorImageType::SizeType{ { 4, 3 } });
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+  std::iota(vectorImage->GetBufferPointer(), vectorImage->GetBufferPointer() + 4 * 3 * 3, 0.0f);
+
+  std::stringstream vectorStream;
+  ASSERT_TRUE(vectorImage->SerializeContent(vectorStream));
+  auto restoredVectorImage = VectorImageType::New();
+  ASSERT_TRUE(restoredVectorImage->DeserializeContent(vectorStream));
+  EXPECT_EQ(restoredVectorImage->GetNumberOfComponentsPerPixel(), 3u);
+  EXPECT_EQ(restoredVectorImage->GetBufferPointer()[35], 35.0f);
+
+  // Decorated values.
+  auto decorator = itk::SimpleDataObjectDecorator<double>::New();
+  decorator->Set(0.25);
+  std::stringstream decoratorStream;
+  ASSERT_TRUE(decorator->SerializeContent(decoratorStream));
+  auto restoredDecorator = itk::SimpleDataObjectDecorator<double>::New();
+  ASSERT_TRUE(restoredDecorator->DeserializeContent(decoratorStream));
+  EXPECT_EQ(restoredDecorator->Get(), 0.25);
+}
+
+
+TEST(ProcessObjectResultCache, ReturnsOutputsComputedBefore)
+{
+  const auto input = MakeImage(1.0f);
+  auto       cache = itk::ProcessObjectResultCache::New();
+  CountingAddFilter::NumberOfExecutions = 0;
+
+  EXPECT_EQ(Execute(cache, input, 2.0f), 3.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 1u);
+
+  // Another instance of the filter, with the same parameters and input.
+  EXPECT_EQ(Execute(cache, input, 2.0f), 3.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 1u);
+
+  // Another parameter.
+  EXPECT_EQ(Execute(cache, input, 5.0f), 6.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 2u);
+
+  // Another content of the input, in the same image.
+  input->GetBufferPointer()[0] = 10.0f;
+  input->Modified();
+  EXPECT_EQ(Execute(cache, input, 2.0f), 12.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 3u);
+
+  // The same content in another image.
+  const auto copy = MakeImage(1.0f);
+  copy->GetBufferPointer()[0] = 10.0f;
+  EXPECT_EQ(Execute(cache, copy, 2.0f), 12.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 3u);
+
+  const auto statistics = cache->GetStatistics();
+  EXPECT_EQ(statistics.NumberOfHits, 2u);
+  EXPECT_EQ(statistics.NumberOfMisses, 3u);
+  EXPECT_EQ(statistics.NumberOfEntries, 3u);
+  EXPECT_EQ(statistics.NumberOfEvictions, 0u);
+  EXPECT_GT(statistics.MemorySize, 3 * 16 * 8 * 4 * sizeof(float));
+
+  cache->ResetStatistics();
+  EXPECT_EQ(cache->GetStatistics().NumberOfHits, 0u);
+  EXPECT_EQ(cache->GetStatistics().NumberOfEntries, 3u);
+  cache->Clear();
+  EXPECT_EQ(cache->GetStatistics().NumberOfEntries, 0u);
+  EXPECT_EQ(cache->GetStatistics().MemorySize, 0u);
+}
+
+
+TEST(ProcessObjectResultCache, EvictsLeastRecentlyUsedEntries)
+{
+  const auto input = MakeImage(1.0f);
+  auto       cache = itk::ProcessObjectResultCache::New();
+  CountingAddFilter::NumberOfExecutions = 0;
+
+  // Room for two entries.
+  Execute(cache, input, 1.0f);
+  cache->SetMaximumMemorySize(2 * cache->GetStatistics().MemorySize + 100);
+  Execute(cache, input, 2.0f);
+  Execute(cache, input, 1.0f);
+  Execute(cache, input, 3.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 3u);
+  EXPECT_EQ(cache->GetStatistics().NumberOfEvictions, 1u);
+  EXPECT_EQ(cache->GetStatistics().NumberOfEntries, 2u);
+
+  // The entry of 2 was the least recently used one.
+  Execute(cache, input, 1.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 3u);
+  Execute(cache, input, 2.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 4u);
+}
+
+
+TEST(ProcessObjectResultCache, SpillsEvictedEntriesToTheCacheDirectory)
+{
+  const std::string directory = "ProcessObjectResultCacheGTest";
+  itksys::SystemTools::RemoveADirectory(directory);
+
+  const auto input = MakeImage(1.0f);
+  auto       cache = itk::ProcessObjectResultCache::New();
+  cache->SetCacheDirectory(directory);
+  CountingAddFilter::NumberOfExecutions = 0;
+
+  Execute(cache, input, 1.0f);
+  cache->SetMaximumMemorySize(cache->GetStatistics().MemorySize + 100);
+  EXPECT_EQ(Execute(cache, input, 2.0f), 3.0f);
+  EXPECT_EQ(cache->GetStatistics().NumberOfSpills, 1u);
+
+  // Read back from the directory, evicting the other entry.
+  EXPECT_EQ(Execute(cache, input, 1.0f), 2.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 2u);
+  EXPECT_EQ(cache->GetStatistics().NumberOfDiskHits, 1u);
+  EXPECT_EQ(cache->GetStatistics().NumberOfSpills, 2u);
+
+  // The files are shared with other caches.
+  auto otherCache = itk::ProcessObjectResultCache::New();
+  otherCache->SetCacheDirectory(directory);
+  EXPECT_EQ(Execute(otherCache, input, 2.0f), 3.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 2u);
+  EXPECT_EQ(otherCache->GetStatistics().NumberOfDiskHits, 1u);
+
+  itksys::SystemTools::RemoveADirectory(directory);
+}
+
+
+TEST(ProcessObjectResultCache, OnlyCachesTheFiltersWhichSerializeTheirParameters)
+{
+  const auto input = MakeImage(1.0f);
+  auto       cache = itk::ProcessObjectResultCache::New();
+  CountingAddFilter::NumberOfExecutions = 0;
+
+  EXPECT_EQ(Execute<UncachedAddFilter>(cache, input, 2.0f), 3.0f);
+  EXPECT_EQ(Execute<UncachedAddFilter>(cache, input, 2.0f), 3.0f);
+  EXPECT_EQ(CountingAddFilter::NumberOfExecutions, 2u);
+  EXPECT_EQ(cache->ComputeKey(UncachedAddFilter::New()), "");
+  EXPECT_EQ(cache->GetStatistics().NumberOfMisses, 0u);
+  EXPECT_EQ(cache->GetStatistics().NumberOfEntries, 0u);
+}
@@ -0,0 +1,207 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkStreamingImageFilter.h"
+#include "itkStreamingPieceQueue.h"
+#include "itkImageSource.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkGTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using ImageType = itk::Image<int, 3>;
+
+// Generates, one requested region at a time, an image whose pixels are a
+// function of their index.
+class IndexImageSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexImageSource);
+
+  using Self = IndexImageSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(IndexImageSource);
+
+  static int
+  ValueAt(const ImageType::IndexType & index)
+  {
+    return static_cast<int>(index[0] + 100 * index[1] + 10000 * index[2]);
+  }
+
+  unsigned int
+  GetNumberOfExecutions() const
+  {
+    return m_NumberOfExecutions;
+  }
+
+protected:
+  IndexImageSource() = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    this->GetOutput()->SetLargestPossibleRegion(ImageType::RegionType(ImageType::SizeType{ { 13, 11, 17 } }));
+  }
+
+  void
+  BeforeThreadedGenerateData() override
+  {
+    ++m_NumberOfExecutions;
+  }
+
+  void
+  DynamicThreadedGenerateData(const ImageType::RegionType & region) override
+  {
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(this->GetOutput(), region); !it.IsAtEnd(); ++it)
+    {
+      it.Set(ValueAt(it.GetIndex()));
+    }
+  }
+
+private:
+  unsigned int m_NumberOfExecutions{ 0 };
+};
+
+bool
+HasIndexValues(const ImageType * image)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != IndexImageSource::ValueAt(it.GetIndex()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+TEST(StreamingImageFilter, PipelinedStreamingMatchesSequentialStreaming)
+{
+  using FilterType = itk::StreamingImageFilter<ImageType, ImageType>;
+  for (const unsigned int maximumNumberOfPiecesInFlight : { 1, 2, 5 })
+  {
+    const auto source = IndexImageSource::New();
+    const auto filter = FilterType::New();
+    filter->SetInput(source->GetOutput());
+    filter->SetNumberOfStreamDivisions(7);
+    filter->PipelinedOn();
+    filter->SetMaximumNumberOfPiecesInFlight(maximumNumberOfPiecesInFlight);
+    EXPECT_TRUE(filter->GetPipelined());
+    EXPECT_EQ(filter->GetMaximumNumberOfPiecesInFlight(), maximumNumberOfPiecesInFlight);
+
+    filter->Update();
+
+    const ImageType * output = filter->GetOutput();
+    EXPECT_EQ(output->GetBufferedRegion(), source->GetOutput()->GetLargestPossibleRegion());
+    EXPECT_TRUE(HasIndexValues(output));
+    const unsigned int numberOfPieces = filter->GetRegionSplitter()->GetNumberOfSplits(output->GetBufferedRegion(), 7);
+    EXPECT_GT(numberOfPieces, 2u);
+    EXPECT_EQ(source->GetNumberOfExecutions(), numberOfPieces);
+
+    // The input is left holding the last piece, as when not pipelined.
+    ImageType::RegionType lastPiece = output->GetBufferedRegion();
+    filter->GetRegionSplitter()->GetSplit(numberOfPieces - 1, numberOfPieces, lastPiece);
+    EXPECT_EQ(source->GetOutput()->GetBufferedRegion(), lastPiece);
+    EXPECT_TRUE(HasIndexValues(source->GetOutput()));
+  }
+}
+
+
+TEST(StreamingImageFilter, PipelinedStreamingCopiesSharedBuffers)
+{
+  // An image without a source buffers its largest possible region, which
+  // must not be taken from it.
+  const auto source = IndexImageSource::New();
+  source->Update();
+  const ImageType::Pointer image = source->GetOutput();
+  image->DisconnectPipeline();
+
+  const auto filter = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  filter->SetInput(image);
+  filter->SetNumberOfStreamDivisions(4);
+  filter->SetPipelined(true);
+  filter->Update();
+
+  EXPECT_TRUE(HasIndexValues(filter->GetOutput()));
+  EXPECT_EQ(filter->GetOutput()->GetBufferedRegion(), image->GetLargestPossibleRegion());
+  EXPECT_EQ(image->GetBufferedRegion(), image->GetLargestPossibleRegion());
+  EXPECT_TRUE(HasIndexValues(image));
+}
+
+
+TEST(StreamingPieceQueue, ConsumesPiecesInOrderWithBoundedPiecesInFlight)
+{
+  constexpr unsigned int numberOfPieces = 20;
+  constexpr unsigned int maximumNumberOfPiecesInFlight = 3;
+
+  std::vector<unsigned int> consumed;
+  std::atomic<unsigned int> numberOfConsumed{ 0 };
+  unsigned int              maximumObservedInFlight = 0;
+  {
+    itk::StreamingPieceQueue queue(maximumNumberOfPiecesInFlight);
+    EXPECT_EQ(queue.GetMaximumNumberOfPiecesInFlight(), maximumNumberOfPiecesInFlight);
+    for (unsigned int piece = 0; piece < numberOfPieces; ++piece)
+    {
+      queue.Push([piece, &consumed, &numberOfConsumed] {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        consumed.push_back(piece);
+        ++numberOfConsumed;
+      });
+      maximumObservedInFlight = std::max(maximumObservedInFlight, piece + 1 - numberOfConsumed);
+    }
+    queue.Wait();
+  }
+
+  EXPECT_LE(maximumObservedInFlight, maximumNumberOfPiecesInFlight);
+  ASSERT_EQ(consumed.size(), numberOfPieces);
+  for (unsigned int piece = 0; piece < numberOfPieces; ++piece)
+  {
+    EXPECT_EQ(consumed[piece], piece);
+  }
+}
+
+
+TEST(StreamingPieceQueue, RethrowsExceptionsOfConsumers)
+{
+  itk::StreamingPieceQueue queue(2);
+  queue.Push([] { throw std::runtime_error("piece 0"); });
+  EXPECT_THROW(
+    {
+      queue.Push([] {});
+      queue.Push([] {});
+      queue.Wait();
+    },
+    std::runtime_error);
+
+  // The queue remains usable.
+  bool consumed = false;
+  queue.Push([&consumed] { consumed = true; });
+  queue.Wait();
+  EXPECT_TRUE(consumed);
+}
@@ -0,0 +1,290 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingMultiThreader.h"
+#include "itkGTest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Counts how many times each index of [0, size) is processed.
+class IndexCounts
+{
+public:
+  explicit IndexCounts(itk::SizeValueType size)
+    : m_Counts(size)
+  {}
+
+  void
+  Increment(itk::SizeValueType index)
+  {
+    ++m_Counts[index];
+  }
+
+  bool
+  AreAll(int expectedCount) const
+  {
+    for (const auto & count : m_Counts)
+    {
+      if (count != expectedCount)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  std::vector<std::atomic<int>> m_Counts;
+};
+
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+CountWorkUnit(void * arg)
+{
+  const auto * workUnitInfo = static_cast<itk::MultiThreaderBase::WorkUnitInfo *>(arg);
+  EXPECT_EQ(workUnitInfo->NumberOfWorkUnits, 7u);
+  static_cast<IndexCounts *>(workUnitInfo->UserData)->Increment(workUnitInfo->WorkUnitID);
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+}
+} // namespace
+
+
+TEST(WorkStealingMultiThreader, CheckBasicObjectMethods)
+{
+  auto threader = itk::WorkStealingMultiThreader::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(threader, WorkStealingMultiThreader, MultiThreaderBase);
+
+  const auto pool = itk::WorkStealingThreadPool::GetInstance();
+  EXPECT_EQ(pool, itk::WorkStealingThreadPool::New());
+  EXPECT_GE(pool->GetMaximumNumberOfThreads(), 1u);
+  EXPECT_EQ(itk::MultiThreaderBase::ThreaderTypeFromString("WorkStealing"),
+            itk::MultiThreaderBase::ThreaderEnum::WorkStealing);
+}
+
+
+TEST(WorkStealingMultiThreader, ExecutesEachTaskOnce)
+{
+  const auto pool = itk::WorkStealingThreadPool::GetInstance();
+  for (const itk::SizeValueType numberOfTasks : { 0, 1, 2, 3, 100, 1000 })
+  {
+    IndexCounts counts(numberOfTasks);
+    pool->Execute(numberOfTasks, [&counts](itk::SizeValueType i) { counts.Increment(i); });
+    EXPECT_TRUE(counts.AreAll(1)) << numberOfTasks << " tasks";
+  }
+  EXPECT_EQ(pool->GetNumberOfQueuedTasks(), 0u);
+}
+
+
+TEST(WorkStealingMultiThreader, ParallelizesArraysAndRegions)
+{
+  auto threader = itk::WorkStealingMultiThreader::New();
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 3, 16 })
+  {
+    threader->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+    IndexCounts counts(1029);
+    threader->ParallelizeArray(1, 1029, [&counts](itk::SizeValueType i) { counts.Increment(i); }, nullptr);
+    counts.Increment(0);
+    EXPECT_TRUE(counts.AreAll(1)) << numberOfWorkUnits << " work units";
+
+    const itk::IndexValueType index[3] = { -5, 2, 7 };
+    const itk::SizeValueType  size[3] = { 11, 13, 17 };
+    IndexCounts               pixelCounts(size[0] * size[1] * size[2]);
+    threader->ParallelizeImageRegion(
+      3,
+      index,
+      size,
+      [&](const itk::IndexValueType * regionIndex, const itk::SizeValueType * regionSize) {
+        for (itk::SizeValueType z = 0; z < regionSize[2]; ++z)
+        {
+          for (itk::SizeValueType y = 0; y < regionSize[1]; ++y)
+          {
+            for (itk::SizeValueType x = 0; x < regionSize[0]; ++x)
+            {
+              const itk::SizeValueType i = x + regionIndex[0] - index[0];
+              const itk::SizeValueType j = y + regionIndex[1] - index[1];
+              const itk::SizeValueType k = z + regionIndex[2] - index[2];
+              pixelCounts.Increment(i + size[0] * (j + size[1] * k));
+            }
+          }
+        }
+      },
+      nullptr);
+    EXPECT_TRUE(pixelCounts.AreAll(1)) << numberOfWorkUnits << " work units";
+  }
+}
+
+
+TEST(WorkStealingMultiThreader, ExecutesSingleMethod)
+{
+  auto threader = itk::WorkStealingMultiThreader::New();
+  threader->SetNumberOfWorkUnits(7);
+
+  IndexCounts counts(7);
+  threader->SetSingleMethod(CountWorkUnit, &counts);
+  threader->SingleMethodExecute();
+  EXPECT_TRUE(counts.AreAll(1));
+}
+
+
+TEST(WorkStealingMultiThreader, ExecutesNestedLoops)
+{
+  // More nested loops than threads would deadlock a pool whose threads
+  // block while waiting for their nested loops.
+  auto threader = itk::WorkStealingMultiThreader::New();
+  threader->SetNumberOfWorkUnits(8);
+
+  IndexCounts counts(8 * 8 * 8);
+  threader->ParallelizeArray(
+    0,
+    8,
+    [&](itk::SizeValueType i) {
+      threader->ParallelizeArray(
+        0,
+        8,
+        [&](itk::SizeValueType j) {
+          threader->ParallelizeArray(
+            0, 8, [&](itk::SizeValueType k) { counts.Increment(k + 8 * (j + 8 * i)); }, nullptr);
+        },
+        nullptr);
+    },
+    nullptr);
+  EXPECT_TRUE(counts.AreAll(1));
+}
+
+
+TEST(WorkStealingMultiThreader, ExecutesLoopsOfConcurrentCallers)
+{
+  const auto pool = itk::WorkStealingThreadPool::GetInstance();
+
+  constexpr unsigned int   numberOfCallers = 4;
+  constexpr unsigned int   numberOfLoops = 50;
+  std::vector<IndexCounts> counts;
+  for (unsigned int c = 0; c < numberOfCallers; ++c)
+  {
+    counts.emplace_back(333);
+  }
+  std::vector<std::thread> callers;
+  for (unsigned int c = 0; c < numberOfCallers; ++c)
+  {
+    callers.emplace_back([&pool, &counts, c] {
+      for (unsigned int l = 0; l < numberOfLoops; ++l)
+      {
+        pool->Execute(333, [&counts, c](itk::SizeValueType i) { counts[c].Increment(i); });
+      }
+    });
+  }
+  for (auto & caller : callers)
+  {
+    caller.join();
+  }
+  for (const auto & callerCounts : counts)
+  {
+    EXPECT_TRUE(callerCounts.AreAll(numberOfLoops));
+  }
+}
+
+
+TEST(WorkStealingMultiThreader, AssignsTasksToTheSameThreadsWithNUMAAffinity)
+{
+  const auto pool = itk::WorkStealingThreadPool::GetInstance();
+  if (pool->GetMaximumNumberOfThreads() < 3)
+  {
+    pool->AddThreads(3 - pool->GetMaximumNumberOfThreads());
+  }
+  const itk::ThreadIdType numberOfThreads = pool->GetMaximumNumberOfThreads();
+  EXPECT_EQ(itk::WorkStealingThreadPool::GetCurrentWorkerIndex(), -1);
+
+  pool->SetNUMAAffinity(true);
+  EXPECT_TRUE(pool->GetNUMAAffinity());
+  for (const itk::SizeValueType numberOfTasks : { 1, 2, 5, 16, 37 })
+  {
+    // Contiguous blocks of tasks, for all the threads when there are enough.
+    itk::ThreadIdType previousWorker = 0;
+    for (itk::SizeValueType i = 0; i < numberOfTasks; ++i)
+    {
+      const itk::ThreadIdType worker = pool->GetWorkerOfTask(i, numberOfTasks);
+      EXPECT_LT(worker, numberOfThreads);
+      EXPECT_LE(previousWorker, worker);
+      previousWorker = worker;
+    }
+    if (numberOfTasks >= numberOfThreads)
+    {
+      EXPECT_EQ(previousWorker, numberOfThreads - 1);
+    }
+
+    // Successive loops execute each task in the thread it is assigned to.
+    for (unsigned int loop = 0; loop < 3; ++loop)
+    {
+      std::vector<int> workers(numberOfTasks, -1);
+      pool->Execute(numberOfTasks, [&workers](itk::SizeValueType i) {
+        workers[i] = itk::WorkStealingThreadPool::GetCurrentWorkerIndex();
+      });
+      for (itk::SizeValueType i = 0; i < numberOfTasks; ++i)
+      {
+        EXPECT_EQ(workers[i], static_cast<int>(pool->GetWorkerOfTask(i, numberOfTasks)))
+          << i << " of " << numberOfTasks << " tasks";
+      }
+    }
+  }
+
+  // Nested loops and multi-threaders work as without affinity.
+  auto threader = itk::WorkStealingMultiThreader::New();
+  threader->SetNumberOfWorkUnits(8);
+  IndexCounts counts(8 * 8);
+  threader->ParallelizeArray(
+    0,
+    8,
+    [&](itk::SizeValueType i) {
+      threader->ParallelizeArray(0, 8, [&](itk::SizeValueType j) { counts.Increment(j + 8 * i); }, nullptr);
+    },
+    nullptr);
+  EXPECT_TRUE(counts.AreAll(1));
+  EXPECT_EQ(pool->GetNumberOfQueuedTasks(), 0u);
+
+  pool->SetNUMAAffinity(false);
+  EXPECT_FALSE(pool->GetNUMAAffinity());
+}
+
+
+TEST(WorkStealingMultiThreader, RethrowsExceptions)
+{
+  const auto pool = itk::WorkStealingThreadPool::GetInstance();
+  EXPECT_THROW(pool->Execute(100,
+                             [](itk::SizeValueType i) {
+                               if (i == 37)
+                               {
+                                 throw std::runtime_error("task 37");
+                               }
+                             }),
+               std::runtime_error);
+
+  // The pool remains usable.
+  IndexCounts counts(100);
+  pool->Execute(100, [&counts](itk::SizeValueType i) { counts.Increment(i); });
+  EXPECT_TRUE(counts.AreAll(1));
+
+  auto threader = itk::WorkStealingMultiThreader::New();
+  EXPECT_THROW(threader->ParallelizeArray(
+                 0, 10, [](itk::SizeValueType) { itkGenericExceptionMacro("work unit failure"); }, nullptr),
+               itk::ExceptionObject);
+}
@@ -22,6 +22,9 @@
 #include "itkFiniteDifferenceImageFilter.h"
 #include "itkMultiThreaderBase.h"
 
+#include <utility>
+#include <vector>
+
 namespace itk
 {
 /**
@@ -62,6 +65,22 @@ namespace itk
  * subclass it to a specific instance that supplies a function and Halt()
  * method.
  *
+ * \par Active blocks
+ * When UseActiveBlocks is on, the requested region of the output is divided
+ * into blocks of ActiveBlockSize pixels along each dimension, and the change
+ * is only calculated in the active blocks. All the blocks are active at the
+ * first iteration. The update of a block is applied only when its largest
+ * change, that is the largest absolute value of the components of the
+ * update times the time step, is greater than ActiveBlockTolerance; the
+ * block, and the blocks within the radius of the difference function of it,
+ * are then active at the next iteration. The other blocks are skipped until
+ * one of their neighbors changes again, so that the output differs from the
+ * dense iteration by at most the tolerance per pixel and per iteration,
+ * provided the update of a pixel depends only on its neighborhood in the
+ * output. With the default tolerance of zero, only the blocks which would
+ * not change are skipped. Once no block is active, the remaining iterations
+ * do nothing, with a time step of zero.
+ *
  * \ingroup ImageFilters
  * \sa FiniteDifferenceImageFilter
  * \ingroup ITKFiniteDifference
@@ -102,6 +121,35 @@ public:
   /** The container type for the update buffer. */
   using UpdateBufferType = OutputImageType;
 
+  /** Set/Get whether the change is only calculated in the active blocks of
+   * the output. Off by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseActiveBlocks, bool);
+  itkGetConstMacro(UseActiveBlocks, bool);
+  itkBooleanMacro(UseActiveBlocks);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the number of pixels of the active blocks along each
+   * dimension. 16 by default. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(ActiveBlockSize, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(ActiveBlockSize, SizeValueType);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the largest change of a block below which its update is not
+   * applied. Zero by default. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(ActiveBlockTolerance, double, 0.0, NumericTraits<double>::max());
+  itkGetConstMacro(ActiveBlockTolerance, double);
+  /** @ITKEndGrouping */
+
+  /** Get the number of blocks in which the change was calculated, and the
+   * number of blocks whose update was applied, at the last iteration. */
+  /** @ITKStartGrouping */
+  itkGetConstMacro(NumberOfActiveBlocks, SizeValueType);
+  itkGetConstMacro(NumberOfChangedBlocks, SizeValueType);
+  /** @ITKEndGrouping */
+
   itkConceptMacro(OutputTimesDoubleCheck, (Concept::MultiplyOperator<PixelType, double>));
   itkConceptMacro(OutputAdditiveOperatorsCheck, (Concept::AdditiveOperators<PixelType>));
   itkConceptMacro(OutputAdditiveAndAssignOperatorsCheck, (Concept::AdditiveAndAssignOperators<PixelType>));
@@ -175,6 +223,28 @@ private:
     BooleanStdVectorType ValidTimeStepList;
   };
 
+  /** Divide the requested region of the output into blocks, all active. */
+  void
+  InitializeActiveBlocks();
+
+  /** The region of the output of a block. */
+  ThreadRegionType
+  GetBlockRegion(SizeValueType block) const;
+
+  /** The range of the active blocks processed by a work unit. */
+  std::pair<SizeValueType, SizeValueType>
+  GetActiveBlockRange(ThreadIdType workUnitID, ThreadIdType workUnitCount) const;
+
+  /** The largest absolute value of the components of the update over a
+   * region. */
+  double
+  ComputeLargestUpdate(const ThreadRegionType & region) const;
+
+  /** Activate the blocks which changed at the last iteration, and their
+   * neighbors. */
+  void
+  UpdateActiveBlocks();
+
   /** This callback method uses ImageSource::SplitRequestedRegion to acquire an
    * output region that it passes to ThreadedApplyUpdate for processing. */
   static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
@@ -187,6 +257,21 @@ private:
 
   /** The buffer that holds the updates for an iteration of the algorithm. */
   typename UpdateBufferType::Pointer m_UpdateBuffer{};
+
+  bool          m_UseActiveBlocks{ false };
+  SizeValueType m_ActiveBlockSize{ 16 };
+  double        m_ActiveBlockTolerance{ 0.0 };
+  SizeValueType m_NumberOfActiveBlocks{ 0 };
+  SizeValueType m_NumberOfChangedBlocks{ 0 };
+
+  /** The region divided into blocks, their size and number along each
+   * dimension, the active blocks, and the largest absolute value of the
+   * components of the update of each of them. */
+  ThreadRegionType           m_BlockedRegion{};
+  Size<ImageDimension>       m_BlockSize{};
+  Size<ImageDimension>       m_NumberOfBlocks{};
+  std::vector<SizeValueType> m_ActiveBlocks{};
+  std::vector<double>        m_ActiveBlockUpdates{};
 };
 } // end namespace itk
 
@@ -18,11 +18,16 @@
 #ifndef itkDenseFiniteDifferenceImageFilter_hxx
 #define itkDenseFiniteDifferenceImageFilter_hxx
 
+#include "itkDefaultConvertPixelTraits.h"
 #include "itkImageRegionIterator.h"
+#include "itkIndexRange.h"
 #include "itkNumericTraits.h"
 #include "itkNeighborhoodAlgorithm.h"
 
+#include <algorithm>
+#include <cmath>
 #include <functional> // For equal_to.
+#include <numeric>
 
 
 namespace itk
@@ -84,9 +89,35 @@ DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::ApplyUpdate(const T
 
   str.Filter = this;
   str.TimeStep = dt;
+
+  if (m_UseActiveBlocks)
+  {
+    // Only the update of the blocks which change is applied.
+    const double               absoluteTimeStep = std::abs(static_cast<double>(dt));
+    std::vector<SizeValueType> changedBlocks;
+    for (size_t i = 0; i < m_ActiveBlocks.size(); ++i)
+    {
+      if (m_ActiveBlockUpdates[i] * absoluteTimeStep > m_ActiveBlockTolerance)
+      {
+        changedBlocks.push_back(m_ActiveBlocks[i]);
+      }
+    }
+    m_ActiveBlocks = std::move(changedBlocks);
+    m_NumberOfChangedBlocks = m_ActiveBlocks.size();
+  }
+  if (m_UseActiveBlocks && m_ActiveBlocks.empty())
+  {
+    return;
+  }
+
   this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
   this->GetMultiThreader()->SetSingleMethodAndExecute(this->ApplyUpdateThreaderCallback, &str);
 
+  if (m_UseActiveBlocks)
+  {
+    this->UpdateActiveBlocks();
+  }
+
   // Explicitly call Modified on GetOutput here
   // since ThreadedApplyUpdate changes this buffer
   // through iterators which do not increment the
@@ -103,6 +134,17 @@ DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::ApplyUpdateThreader
 
   auto * str = (DenseFDThreadStruct *)((static_cast<MultiThreaderBase::WorkUnitInfo *>(arg))->UserData);
 
+  if (str->Filter->m_UseActiveBlocks)
+  {
+    const auto range = str->Filter->GetActiveBlockRange(workUnitID, workUnitCount);
+    for (SizeValueType i = range.first; i < range.second; ++i)
+    {
+      str->Filter->ThreadedApplyUpdate(
+        str->TimeStep, str->Filter->GetBlockRegion(str->Filter->m_ActiveBlocks[i]), workUnitID);
+    }
+    return ITK_THREAD_RETURN_DEFAULT_VALUE;
+  }
+
   // Execute the actual method with appropriate output region
   // first find out how many pieces extent can be split into.
   // Using the SplitRequestedRegion method from itk::ImageSource.
@@ -127,6 +169,25 @@ DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::CalculateChange() -
   str.Filter = this;
   str.TimeStep = TimeStepType{}; // Not used during the
   // calculate change step.
+
+  if (!m_UseActiveBlocks)
+  {
+    m_BlockedRegion = ThreadRegionType();
+  }
+  else if (this->GetElapsedIterations() == 0 || m_BlockedRegion != this->GetOutput()->GetRequestedRegion())
+  {
+    this->InitializeActiveBlocks();
+  }
+  m_NumberOfActiveBlocks = m_ActiveBlocks.size();
+  m_ActiveBlockUpdates.assign(m_ActiveBlocks.size(), 0.0);
+
+  if (m_UseActiveBlocks && m_ActiveBlocks.empty())
+  {
+    // Nothing changes any more: there is no time step to resolve, and the
+    // update buffer is not used.
+    return TimeStepType{};
+  }
+
   this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
   this->GetMultiThreader()->SetSingleMethod(this->CalculateChangeThreaderCallback, &str);
 
@@ -165,6 +226,22 @@ DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::CalculateChangeThre
 
   auto * str = (DenseFDThreadStruct *)((static_cast<MultiThreaderBase::WorkUnitInfo *>(arg))->UserData);
 
+  if (str->Filter->m_UseActiveBlocks)
+  {
+    // The time step of the work unit is the smallest one of its blocks.
+    const auto range = str->Filter->GetActiveBlockRange(workUnitID, workUnitCount);
+    for (SizeValueType i = range.first; i < range.second; ++i)
+    {
+      const ThreadRegionType blockRegion = str->Filter->GetBlockRegion(str->Filter->m_ActiveBlocks[i]);
+      const TimeStepType     timeStep = str->Filter->ThreadedCalculateChange(blockRegion, workUnitID);
+      str->TimeStepList[workUnitID] =
+        str->ValidTimeStepList[workUnitID] ? std::min(str->TimeStepList[workUnitID], timeStep) : timeStep;
+      str->ValidTimeStepList[workUnitID] = true;
+      str->Filter->m_ActiveBlockUpdates[i] = str->Filter->ComputeLargestUpdate(blockRegion);
+    }
+    return ITK_THREAD_RETURN_DEFAULT_VALUE;
+  }
+
   // Execute the actual method with appropriate output region
   // first find out how many pieces extent can be split into.
   // Using the SplitRequestedRegion method from itk::ImageSource.
@@ -181,6 +258,118 @@ DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::CalculateChangeThre
   return ITK_THREAD_RETURN_DEFAULT_VALUE;
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::InitializeActiveBlocks()
+{
+  m_BlockedRegion = this->GetOutput()->GetRequestedRegion();
+  m_BlockSize.Fill(m_ActiveBlockSize);
+  SizeValueType numberOfBlocks = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    m_NumberOfBlocks[i] = (m_BlockedRegion.GetSize(i) + m_BlockSize[i] - 1) / m_BlockSize[i];
+    numberOfBlocks *= m_NumberOfBlocks[i];
+  }
+  m_ActiveBlocks.resize(numberOfBlocks);
+  std::iota(m_ActiveBlocks.begin(), m_ActiveBlocks.end(), SizeValueType{ 0 });
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::GetBlockRegion(SizeValueType block) const
+  -> ThreadRegionType
+{
+  ThreadRegionType region;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    const SizeValueType offset = (block % m_NumberOfBlocks[i]) * m_BlockSize[i];
+    block /= m_NumberOfBlocks[i];
+    region.SetIndex(i, m_BlockedRegion.GetIndex(i) + static_cast<IndexValueType>(offset));
+    region.SetSize(i, std::min(m_BlockSize[i], m_BlockedRegion.GetSize(i) - offset));
+  }
+  return region;
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::GetActiveBlockRange(ThreadIdType workUnitID,
+                                                                                  ThreadIdType workUnitCount) const
+  -> std::pair<SizeValueType, SizeValueType>
+{
+  const SizeValueType numberOfActiveBlocks = m_ActiveBlocks.size();
+  return { numberOfActiveBlocks * workUnitID / workUnitCount, numberOfActiveBlocks * (workUnitID + 1) / workUnitCount };
+}
+
+template <typename TInputImage, typename TOutputImage>
+double
+DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::ComputeLargestUpdate(
+  const ThreadRegionType & region) const
+{
+  double largestUpdate = 0.0;
+  for (ImageRegionConstIterator<UpdateBufferType> u(m_UpdateBuffer, region); !u.IsAtEnd(); ++u)
+  {
+    const PixelType &  update = u.Value();
+    const unsigned int numberOfComponents = NumericTraits<PixelType>::GetLength(update);
+    for (unsigned int i = 0; i < numberOfComponents; ++i)
+    {
+      const auto component = DefaultConvertPixelTraits<PixelType>::GetNthComponent(i, update);
+      largestUpdate = std::max(largestUpdate, std::abs(static_cast<double>(component)));
+    }
+  }
+  return largestUpdate;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::UpdateActiveBlocks()
+{
+  // The change of a block is seen by the blocks which are within the radius
+  // of the difference function of it.
+  const auto                        radius = this->GetDifferenceFunction()->GetRadius();
+  const ImageRegion<ImageDimension> blocks(m_NumberOfBlocks);
+  Offset<ImageDimension>            reach;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    reach[i] = static_cast<OffsetValueType>((radius[i] + m_BlockSize[i] - 1) / m_BlockSize[i]);
+  }
+
+  std::vector<bool> isActive(blocks.GetNumberOfPixels(), false);
+  for (const SizeValueType block : m_ActiveBlocks)
+  {
+    Index<ImageDimension> blockIndex;
+    SizeValueType         remainder = block;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      blockIndex[i] = static_cast<IndexValueType>(remainder % m_NumberOfBlocks[i]);
+      remainder /= m_NumberOfBlocks[i];
+    }
+    ImageRegion<ImageDimension> neighbors(blockIndex - reach, Size<ImageDimension>());
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      neighbors.SetSize(i, static_cast<SizeValueType>(2 * reach[i] + 1));
+    }
+    neighbors.Crop(blocks);
+    for (const auto & neighborIndex : ImageRegionIndexRange<ImageDimension>(neighbors))
+    {
+      SizeValueType neighbor = 0;
+      for (unsigned int i = ImageDimension; i-- > 0;)
+      {
+        neighbor = neighbor * m_NumberOfBlocks[i] + static_cast<SizeValueType>(neighborIndex[i]);
+      }
+      isActive[neighbor] = true;
+    }
+  }
+
+  m_ActiveBlocks.clear();
+  for (SizeValueType block = 0; block < isActive.size(); ++block)
+  {
+    if (isActive[block])
+    {
+      m_ActiveBlocks.push_back(block);
+    }
+  }
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::ThreadedApplyUpdate(
@@ -277,6 +466,12 @@ void
 DenseFiniteDifferenceImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfBooleanMacro(UseActiveBlocks);
+  os << indent << "ActiveBlockSize: " << m_ActiveBlockSize << std::endl;
+  os << indent << "ActiveBlockTolerance: " << m_ActiveBlockTolerance << std::endl;
+  os << indent << "NumberOfActiveBlocks: " << m_NumberOfActiveBlocks << std::endl;
+  os << indent << "NumberOfChangedBlocks: " << m_NumberOfChangedBlocks << std::endl;
 }
 } // end namespace itk
 
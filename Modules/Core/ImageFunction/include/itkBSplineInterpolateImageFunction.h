@@ -163,6 +163,41 @@ public:
     return this->EvaluateAtContinuousIndexInternal(x, m_ThreadedEvaluateIndex[threadId], m_ThreadedWeights[threadId]);
   }
 
+  using typename Superclass::ContinuousIndexVectorType;
+
+  /** Evaluate the function along a line of ContinuousIndex positions,
+   * allocating the working space once for the whole line. */
+  void
+  EvaluateAtContinuousIndexLine(const ContinuousIndexType &       start,
+                                const ContinuousIndexVectorType & step,
+                                SizeValueType                     begin,
+                                SizeValueType                     end,
+                                OutputType *                      values) const override
+  {
+    vnl_matrix<long>   evaluateIndex(ImageDimension, (m_SplineOrder + 1));
+    vnl_matrix<double> weights(ImageDimension, (m_SplineOrder + 1));
+    for (SizeValueType i = begin; i < end; ++i)
+    {
+      values[i - begin] = this->EvaluateAtContinuousIndexInternal(
+        Superclass::GetContinuousIndexOfLine(start, step, i), evaluateIndex, weights);
+    }
+  }
+
+  /** Evaluate the function at an array of ContinuousIndex positions,
+   * allocating the working space once for all of them. */
+  void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              SizeValueType               count,
+                              OutputType *                values) const override
+  {
+    vnl_matrix<long>   evaluateIndex(ImageDimension, (m_SplineOrder + 1));
+    vnl_matrix<double> weights(ImageDimension, (m_SplineOrder + 1));
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      values[i] = this->EvaluateAtContinuousIndexInternal(indices[i], evaluateIndex, weights);
+    }
+  }
+
   CovariantVectorType
   EvaluateDerivative(const PointType & point) const
   {
@@ -81,6 +81,9 @@ public:
   /** ContinuousIndex type alias support */
   using typename Superclass::ContinuousIndexType;
 
+  /** Type of the step between consecutive continuous indices of a line. */
+  using ContinuousIndexVectorType = Vector<TCoordinate, Self::ImageDimension>;
+
   /** RealType type alias support */
   using RealType = typename NumericTraits<typename TInputImage::PixelType>::RealType;
 
@@ -113,6 +116,64 @@ public:
   OutputType
   EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override = 0;
 
+  /** Interpolate the image along a line of continuous indices
+   *
+   * Writes to values[i - begin] the interpolated image intensity at the
+   * continuous index start + i * step, for i from begin to end - 1, as a
+   * scanline of a linear resampling maps to. Positions are counted from
+   * start, so that evaluating a line in pieces gives the same values as in
+   * one call. No bounds checking is done: all the indices are assumed to
+   * lie within the image buffer.
+   *
+   * The default calls EvaluateAtContinuousIndex() for each index.
+   * Subclasses override it to avoid a virtual call per index, and to share
+   * work between the indices of the line. */
+  virtual void
+  EvaluateAtContinuousIndexLine(const ContinuousIndexType &       start,
+                                const ContinuousIndexVectorType & step,
+                                SizeValueType                     begin,
+                                SizeValueType                     end,
+                                OutputType *                      values) const
+  {
+    for (SizeValueType i = begin; i < end; ++i)
+    {
+      values[i - begin] = this->EvaluateAtContinuousIndex(Self::GetContinuousIndexOfLine(start, step, i));
+    }
+  }
+
+  /** Interpolate the image at an array of continuous indices
+   *
+   * Writes to values[i] the interpolated image intensity at indices[i], for
+   * i from 0 to count - 1. No bounds checking is done: all the indices are
+   * assumed to lie within the image buffer.
+   *
+   * The default calls EvaluateAtContinuousIndex() for each index. */
+  virtual void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices, SizeValueType count, OutputType * values) const
+  {
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      values[i] = this->EvaluateAtContinuousIndex(indices[i]);
+    }
+  }
+
+  /** The continuous index start + i * step, of the line evaluated by
+   * EvaluateAtContinuousIndexLine(). Callers testing the indices of a line
+   * against the buffer should compute them with this method, so that they
+   * are the same as those interpolated. */
+  static ContinuousIndexType
+  GetContinuousIndexOfLine(const ContinuousIndexType &       start,
+                           const ContinuousIndexVectorType & step,
+                           SizeValueType                     i)
+  {
+    ContinuousIndexType index;
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      index[j] = start[j] + static_cast<TCoordinate>(i) * step[j];
+    }
+    return index;
+  }
+
   /** Interpolate the image at an index position.
    *
    * Simply returns the image value at the
@@ -104,6 +104,37 @@ public:
     return this->EvaluateOptimized(Dispatch<ImageDimension>(), index);
   }
 
+  using typename Superclass::ContinuousIndexVectorType;
+
+  /** Evaluate the function along a line of ContinuousIndex positions,
+   * without a virtual call per position. */
+  void
+  EvaluateAtContinuousIndexLine(const ContinuousIndexType &       start,
+                                const ContinuousIndexVectorType & step,
+                                SizeValueType                     begin,
+                                SizeValueType                     end,
+                                OutputType *                      values) const override
+  {
+    for (SizeValueType i = begin; i < end; ++i)
+    {
+      values[i - begin] =
+        this->EvaluateOptimized(Dispatch<ImageDimension>(), Superclass::GetContinuousIndexOfLine(start, step, i));
+    }
+  }
+
+  /** Evaluate the function at an array of ContinuousIndex positions,
+   * without a virtual call per position. */
+  void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              SizeValueType               count,
+                              OutputType *                values) const override
+  {
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      values[i] = this->EvaluateOptimized(Dispatch<ImageDimension>(), indices[i]);
+    }
+  }
+
   SizeType
   GetRadius() const override
   {
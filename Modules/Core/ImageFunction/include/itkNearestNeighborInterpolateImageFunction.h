@@ -89,6 +89,42 @@ public:
     return static_cast<OutputType>(this->GetInputImage()->GetPixel(nindex));
   }
 
+  using typename Superclass::ContinuousIndexVectorType;
+
+  /** Evaluate the function along a line of ContinuousIndex positions,
+   * without a virtual call per position. */
+  void
+  EvaluateAtContinuousIndexLine(const ContinuousIndexType &       start,
+                                const ContinuousIndexVectorType & step,
+                                SizeValueType                     begin,
+                                SizeValueType                     end,
+                                OutputType *                      values) const override
+  {
+    const InputImageType * const image = this->GetInputImage();
+    IndexType                    nindex;
+    for (SizeValueType i = begin; i < end; ++i)
+    {
+      this->ConvertContinuousIndexToNearestIndex(Superclass::GetContinuousIndexOfLine(start, step, i), nindex);
+      values[i - begin] = static_cast<OutputType>(image->GetPixel(nindex));
+    }
+  }
+
+  /** Evaluate the function at an array of ContinuousIndex positions,
+   * without a virtual call per position. */
+  void
+  EvaluateAtContinuousIndices(const ContinuousIndexType * indices,
+                              SizeValueType               count,
+                              OutputType *                values) const override
+  {
+    const InputImageType * const image = this->GetInputImage();
+    IndexType                    nindex;
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      this->ConvertContinuousIndexToNearestIndex(indices[i], nindex);
+      values[i] = static_cast<OutputType>(image->GetPixel(nindex));
+    }
+  }
+
   SizeType
   GetRadius() const override
   {
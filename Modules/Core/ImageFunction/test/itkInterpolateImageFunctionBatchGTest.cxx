@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkGTest.h"
+#include "itkImage.h"
+#include "itkImageBufferRange.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+ImageType::Pointer
+MakeImage()
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType({ { -2, 0, 3 } }, { { 13, 11, 7 } }));
+  image->Allocate();
+  std::mt19937                          generator(1);
+  std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+  for (float & pixel : itk::MakeImageBufferRange(image.GetPointer()))
+  {
+    pixel = distribution(generator);
+  }
+  return image;
+}
+
+// Checks that the batch evaluations give exactly the values of
+// EvaluateAtContinuousIndex, along a line evaluated in two pieces, and at
+// the indices of that line.
+template <typename TInterpolator>
+void
+ExpectBatchEqualsSingleEvaluations(TInterpolator * interpolator)
+{
+  using ContinuousIndexType = typename TInterpolator::ContinuousIndexType;
+  using OutputType = typename TInterpolator::OutputType;
+
+  interpolator->SetInputImage(MakeImage());
+
+  ContinuousIndexType start;
+  start[0] = -1.7;
+  start[1] = 9.3;
+  start[2] = 3.25;
+  typename TInterpolator::ContinuousIndexVectorType step;
+  step[0] = 0.37;
+  step[1] = -0.29;
+  step[2] = 0.11;
+
+  constexpr itk::SizeValueType begin = 3;
+  constexpr itk::SizeValueType middle = 11;
+  constexpr itk::SizeValueType end = 29;
+
+  std::vector<OutputType>          values(end - begin);
+  std::vector<ContinuousIndexType> indices;
+  interpolator->EvaluateAtContinuousIndexLine(start, step, begin, middle, values.data());
+  interpolator->EvaluateAtContinuousIndexLine(start, step, middle, end, values.data() + (middle - begin));
+  for (itk::SizeValueType i = begin; i < end; ++i)
+  {
+    const ContinuousIndexType index = TInterpolator::GetContinuousIndexOfLine(start, step, i);
+    ASSERT_TRUE(interpolator->IsInsideBuffer(index));
+    EXPECT_EQ(values[i - begin], interpolator->EvaluateAtContinuousIndex(index)) << "at " << index;
+    indices.push_back(index);
+  }
+
+  std::vector<OutputType> indexValues(indices.size());
+  interpolator->EvaluateAtContinuousIndices(indices.data(), indices.size(), indexValues.data());
+  EXPECT_EQ(indexValues, values);
+}
+} // namespace
+
+TEST(InterpolateImageFunctionBatch, Linear)
+{
+  auto interpolator = itk::LinearInterpolateImageFunction<ImageType>::New();
+  ExpectBatchEqualsSingleEvaluations(interpolator.GetPointer());
+}
+
+TEST(InterpolateImageFunctionBatch, NearestNeighbor)
+{
+  auto interpolator = itk::NearestNeighborInterpolateImageFunction<ImageType>::New();
+  ExpectBatchEqualsSingleEvaluations(interpolator.GetPointer());
+}
+
+TEST(InterpolateImageFunctionBatch, BSpline)
+{
+  auto interpolator = itk::BSplineInterpolateImageFunction<ImageType>::New();
+  for (const unsigned int order : { 0, 1, 3, 5 })
+  {
+    interpolator->SetSplineOrder(order);
+    ExpectBatchEqualsSingleEvaluations(interpolator.GetPointer());
+  }
+}
@@ -399,6 +399,20 @@ public:
   virtual void
   FlattenTransformQueue();
 
+  /**
+   * Flatten the transform queue, then replace each run of adjacent linear
+   * transforms, whose optimization flags are the same, by a single
+   * AffineTransform, so that TransformPoint() calls one transform per run
+   * instead of one per linear transform. The matrix and offset of the
+   * MatrixOffsetTransformBase transforms are used, and those of the other
+   * linear transforms, such as TranslationTransform, are computed from the
+   * transformed points of the origin and of the unit vectors. The merged
+   * transforms are removed from the queue, and their parameters are no
+   * longer those of the composite transform.
+   */
+  virtual void
+  MergeLinearTransforms();
+
   /**
    * Compute the Jacobian with respect to the parameters for the composite
    * transform using Jacobian rule. See comments in the implementation.
@@ -467,6 +481,13 @@ protected:
   TransformsToOptimizeFlagsType m_TransformsToOptimizeFlags{};
 
 private:
+  using MatrixType = Matrix<TParametersValueType, VDimension, VDimension>;
+
+  /** Get the matrix and offset of a linear transform. Returns false for the
+   * other transforms. */
+  static bool
+  GetLinearMatrixAndOffset(const TransformType & transform, MatrixType & matrix, OutputVectorType & offset);
+
   mutable ModifiedTimeType m_PreviousTransformsToOptimizeUpdateTime{};
 };
 
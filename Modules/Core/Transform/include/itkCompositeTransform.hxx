@@ -19,6 +19,7 @@
 #define itkCompositeTransform_hxx
 
 
+#include "itkAffineTransform.h"
 #include "itkPrintHelper.h"
 namespace itk
 {
@@ -942,6 +943,93 @@ CompositeTransform<TParametersValueType, VDimension>::FlattenTransformQueue()
 }
 
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+CompositeTransform<TParametersValueType, VDimension>::MergeLinearTransforms()
+{
+  this->FlattenTransformQueue();
+
+  TransformQueueType            transformQueue;
+  TransformsToOptimizeFlagsType transformsToOptimizeFlags;
+
+  const SizeValueType numberOfTransforms = this->GetNumberOfTransforms();
+  for (SizeValueType m = 0; m < numberOfTransforms;)
+  {
+    // Compose the run of linear transforms which starts at m. Each
+    // transform of the run is applied before the previous ones.
+    MatrixType       runMatrix;
+    OutputVectorType runOffset{};
+    runMatrix.SetIdentity();
+
+    MatrixType       matrix;
+    OutputVectorType offset;
+    SizeValueType    end = m;
+    while (end < numberOfTransforms &&
+           this->m_TransformsToOptimizeFlags[end] == this->m_TransformsToOptimizeFlags[m] &&
+           GetLinearMatrixAndOffset(*this->m_TransformQueue[end], matrix, offset))
+    {
+      runOffset += runMatrix * offset;
+      runMatrix = runMatrix * matrix;
+      ++end;
+    }
+
+    if (end - m > 1)
+    {
+      auto affineTransform = AffineTransform<TParametersValueType, VDimension>::New();
+      affineTransform->SetMatrix(runMatrix);
+      affineTransform->SetOffset(runOffset);
+      transformQueue.push_back(affineTransform.GetPointer());
+      transformsToOptimizeFlags.push_back(this->m_TransformsToOptimizeFlags[m]);
+      m = end;
+    }
+    else
+    {
+      transformQueue.push_back(this->m_TransformQueue[m]);
+      transformsToOptimizeFlags.push_back(this->m_TransformsToOptimizeFlags[m]);
+      ++m;
+    }
+  }
+
+  this->m_TransformQueue = transformQueue;
+  this->m_TransformsToOptimizeFlags = transformsToOptimizeFlags;
+  this->Modified();
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+bool
+CompositeTransform<TParametersValueType, VDimension>::GetLinearMatrixAndOffset(const TransformType & transform,
+                                                                               MatrixType &          matrix,
+                                                                               OutputVectorType &    offset)
+{
+  if (const auto * matrixOffsetTransform =
+        dynamic_cast<const MatrixOffsetTransformBase<TParametersValueType, VDimension, VDimension> *>(&transform))
+  {
+    matrix = matrixOffsetTransform->GetMatrix();
+    offset = matrixOffsetTransform->GetOffset();
+    return true;
+  }
+  if (transform.GetTransformCategory() != TransformCategoryEnum::Linear)
+  {
+    return false;
+  }
+
+  const InputPointType origin{};
+  offset = transform.TransformPoint(origin) - OutputPointType{};
+  for (unsigned int j = 0; j < VDimension; ++j)
+  {
+    InputPointType unitPoint{};
+    unitPoint[j] = 1.0;
+    const OutputVectorType column = transform.TransformPoint(unitPoint) - OutputPointType{} - offset;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      matrix[i][j] = column[i];
+    }
+  }
+  return true;
+}
+
+
 template <typename TParametersValueType, unsigned int VDimension>
 void
 CompositeTransform<TParametersValueType, VDimension>::PrintSelf(std::ostream & os, Indent indent) const
@@ -21,8 +21,10 @@
 #include "itkTransform.h"
 #include "itkMatrix.h"
 #include "itkPointSet.h"
+#include "itkSize.h"
 #include <deque>
 #include <cmath>
+#include <vector>
 #include "vnl/vnl_matrix_fixed.h"
 #include "vnl/vnl_matrix.h"
 #include "vnl/vnl_vector.h"
@@ -31,6 +33,29 @@
 
 namespace itk
 {
+/** \class KernelTransformEnums
+ * \brief Contains all enum classes used by KernelTransform class.
+ * \ingroup ITKTransform
+ */
+class KernelTransformEnums
+{
+public:
+  /**
+   * \ingroup ITKTransform
+   * Solver of the linear system of the coefficients of the spline.
+   */
+  enum class Solver : uint8_t
+  {
+    SVD = 0,
+    QR = 1,
+    Cholesky = 2,
+    SparseLU = 3
+  };
+};
+// Define how to print enumeration
+extern ITKTransform_EXPORT std::ostream &
+                           operator<<(std::ostream & out, const KernelTransformEnums::Solver value);
+
 /**
  * \class KernelTransform
  * Intended to be a base class for elastic body spline and thin plate spline.
@@ -50,6 +75,23 @@ namespace itk
  * landmarks to approximating the landmarks.  This part of the
  * formulation is based on \cite sprengel1996.
  *
+ * The coefficients of the spline are the solution of a dense linear system,
+ * solved by default with a singular value decomposition. A QR decomposition
+ * is several times faster for the usual, well-posed, sets of landmarks. The
+ * kernels whose matrix K is positive definite, like the one of
+ * WendlandSplineKernelTransform, can use a Cholesky decomposition of K
+ * instead. The kernels with a compact support, which report it with
+ * GetKernelSupportRadius(), only evaluate the kernel between the landmarks
+ * closer than its support radius, found with a grid of buckets, and can use
+ * a sparse LU decomposition, which then avoids the cubic cost of the solve.
+ *
+ * When the InterpolationTolerance is positive, ComputeWMatrix() also samples
+ * the deformation contribution of the landmarks on a regular grid over the
+ * InterpolationDomain, refined until the interpolation error estimated at
+ * the centers of its cells is within the tolerance, so that TransformPoint()
+ * interpolates it linearly inside the domain, at a cost independent of the
+ * number of landmarks. The points outside the domain are transformed
+ * exactly.
  *
  * \ingroup ITKTransform
  */
@@ -234,6 +276,55 @@ public:
   itkSetClampMacro(Stiffness, double, 0.0, NumericTraits<double>::max());
   itkGetConstMacro(Stiffness, double);
   /** @ITKEndGrouping */
+
+  using SolverEnum = KernelTransformEnums::Solver;
+
+  /** Set/Get the solver of the linear system of the coefficients of the
+   * spline, used by the next ComputeWMatrix(). SVD by default. The Cholesky
+   * solver requires the matrix K of the kernel to be positive definite. */
+  /** @ITKStartGrouping */
+  itkSetEnumMacro(Solver, SolverEnum);
+  itkGetConstMacro(Solver, SolverEnum);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the tolerance on the error of the interpolation of the
+   * deformation, used by the next ComputeWMatrix(). Zero, the default,
+   * transforms all the points exactly. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(InterpolationTolerance, double, 0.0, NumericTraits<double>::max());
+  itkGetConstMacro(InterpolationTolerance, double);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the maximum number of nodes of the interpolation grid. When the
+   * tolerance cannot be reached with that many nodes, the points are
+   * transformed exactly. */
+  /** @ITKStartGrouping */
+  itkSetMacro(MaximumNumberOfInterpolationNodes, SizeValueType);
+  itkGetConstMacro(MaximumNumberOfInterpolationNodes, SizeValueType);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the corners of the box where the deformation is interpolated.
+   * When the maximum is not greater than the minimum along any dimension, as
+   * by default, the bounding box of the source landmarks is used. */
+  /** @ITKStartGrouping */
+  itkSetMacro(InterpolationDomainMinimum, InputPointType);
+  itkGetConstReferenceMacro(InterpolationDomainMinimum, InputPointType);
+  itkSetMacro(InterpolationDomainMaximum, InputPointType);
+  itkGetConstReferenceMacro(InterpolationDomainMaximum, InputPointType);
+  /** @ITKEndGrouping */
+
+  /** Get the interpolation error estimated by the last ComputeWMatrix(), or
+   * zero when the points are transformed exactly. */
+  itkGetConstMacro(InterpolationError, double);
+
+  /** Get the number of nodes of the interpolation grid computed by the last
+   * ComputeWMatrix(), or zero when the points are transformed exactly. */
+  SizeValueType
+  GetNumberOfInterpolationNodes() const
+  {
+    return static_cast<SizeValueType>(m_InterpolationGridValues.size());
+  }
+
 protected:
   KernelTransform();
   ~KernelTransform() override = default;
@@ -300,6 +391,21 @@ protected:
   virtual void
   ComputeDeformationContribution(const InputPointType & thisPoint, OutputPointType & result) const;
 
+  /** Get the radius of the support of the kernel, beyond which G is zero,
+   * or zero when the support of the kernel is not compact, as by default. */
+  virtual double
+  GetKernelSupportRadius() const
+  {
+    return 0.0;
+  }
+
+  /** Call function(identifier, thisPoint - landmark) for each source
+   * landmark closer to the point than the support radius of the kernel. Only
+   * valid for the kernels with a compact support, after ComputeWMatrix(). */
+  template <typename TFunction>
+  void
+  ForEachLandmarkWithinSupport(const InputPointType & thisPoint, TFunction && function) const;
+
   /** Compute K matrix. */
   void
   ComputeK();
@@ -378,6 +484,58 @@ protected:
 
   /** The list of target landmarks, denoted 'q'. */
   PointSetPointer m_TargetLandmarks{};
+
+private:
+  /** Call function(i, j, G) for the blocks of the upper triangle of K,
+   * diagonal included, which are not zero. */
+  template <typename TFunction>
+  void
+  ForEachKBlock(TFunction && function);
+
+  /** Solve for W with a Cholesky decomposition of K. */
+  void
+  ComputeWMatrixWithCholesky();
+
+  /** Solve for W with a sparse LU decomposition of L. */
+  void
+  ComputeWMatrixWithSparseLU();
+
+  /** Sort the source landmarks into a grid of buckets, for the kernels with
+   * a compact support. */
+  void
+  ComputeLandmarkGrid();
+
+  /** Sample the deformation contribution on the interpolation grid. */
+  void
+  ComputeInterpolationGrid();
+
+  /** Add the deformation contribution interpolated at the point to result,
+   * and return true, when the point is inside the interpolation grid. */
+  bool
+  InterpolateDeformationContribution(const InputPointType & thisPoint, OutputPointType & result) const;
+
+  SolverEnum m_Solver{ SolverEnum::SVD };
+
+  /** The grid of buckets of the source landmarks, in compressed sparse row
+   * format: the landmarks of the bucket b are in [offsets[b], offsets[b+1]). */
+  InputPointType               m_LandmarkGridOrigin{};
+  double                       m_LandmarkGridSpacing{};
+  Size<VDimension>             m_LandmarkGridSize{};
+  std::vector<SizeValueType>   m_LandmarkGridOffsets{};
+  std::vector<PointIdentifier> m_LandmarkGridIdentifiers{};
+  std::vector<InputPointType>  m_LandmarkGridPoints{};
+
+  double         m_InterpolationTolerance{ 0.0 };
+  SizeValueType  m_MaximumNumberOfInterpolationNodes{ SizeValueType{ 1 } << 20 };
+  InputPointType m_InterpolationDomainMinimum{};
+  InputPointType m_InterpolationDomainMaximum{};
+  double         m_InterpolationError{ 0.0 };
+
+  /** The deformation contribution at the nodes of the interpolation grid. */
+  InputPointType                m_InterpolationGridOrigin{};
+  double                        m_InterpolationGridSpacing{};
+  Size<VDimension>              m_InterpolationGridSize{};
+  std::vector<OutputVectorType> m_InterpolationGridValues{};
 };
 } // end namespace itk
 
@@ -18,6 +18,15 @@
 #ifndef itkKernelTransform_hxx
 #define itkKernelTransform_hxx
 
+#include "itkMultiThreaderBase.h"
+#include "vnl/algo/vnl_cholesky.h"
+#include "vnl/algo/vnl_qr.h"
+#include "vnl/algo/vnl_sparse_lu.h"
+#include "vnl/vnl_sparse_matrix.h"
+
+#include <algorithm>
+#include <numeric>
+
 namespace itk
 {
 
@@ -99,6 +108,22 @@ KernelTransform<TParametersValueType, VDimension>::ComputeDeformationContributio
 
   GMatrixType Gmatrix;
 
+  if (this->GetKernelSupportRadius() > 0.0)
+  {
+    const auto addContribution = [this, &result, &Gmatrix](PointIdentifier lnd, const InputVectorType & s) {
+      this->ComputeG(s, Gmatrix);
+      for (unsigned int dim = 0; dim < VDimension; ++dim)
+      {
+        for (unsigned int odim = 0; odim < VDimension; ++odim)
+        {
+          result[odim] += Gmatrix(dim, odim) * m_DMatrix(dim, lnd);
+        }
+      }
+    };
+    this->ForEachLandmarkWithinSupport(thisPoint, addContribution);
+    return;
+  }
+
   for (unsigned int lnd = 0; lnd < numberOfLandmarks; ++lnd)
   {
     this->ComputeG(thisPoint - sp->Value(), Gmatrix);
@@ -142,13 +167,145 @@ void
 KernelTransform<TParametersValueType, VDimension>::ComputeWMatrix()
 {
   using SVDSolverType = vnl_svd<TParametersValueType>;
+  using QRSolverType = vnl_qr<TParametersValueType>;
 
-  this->ComputeL();
-  this->ComputeY();
-  const SVDSolverType svd(this->m_LMatrix, 1e-8);
-  this->m_WMatrix = svd.solve(this->m_YMatrix);
+  this->ComputeLandmarkGrid();
+
+  switch (m_Solver)
+  {
+    case SolverEnum::QR:
+      this->ComputeL();
+      this->ComputeY();
+      this->m_WMatrix = QRSolverType(this->m_LMatrix).solve(this->m_YMatrix);
+      break;
+    case SolverEnum::Cholesky:
+      this->ComputeWMatrixWithCholesky();
+      break;
+    case SolverEnum::SparseLU:
+      this->ComputeWMatrixWithSparseLU();
+      break;
+    case SolverEnum::SVD:
+    default:
+    {
+      this->ComputeL();
+      this->ComputeY();
+      const SVDSolverType svd(this->m_LMatrix, 1e-8);
+      this->m_WMatrix = svd.solve(this->m_YMatrix);
+    }
+  }
 
   this->ReorganizeW();
+  this->ComputeInterpolationGrid();
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+KernelTransform<TParametersValueType, VDimension>::ComputeWMatrixWithCholesky()
+{
+  // Solve [K P; P^T 0] [d; a] = [y; 0] through the Schur complement of K:
+  // (P^T K^-1 P) a = P^T K^-1 y, and d = K^-1 (y - P a).
+  this->ComputeP();
+  this->ComputeK();
+  this->ComputeY();
+
+  const unsigned int numberOfRows = this->m_KMatrix.rows();
+  const unsigned int numberOfAffineParameters = this->m_PMatrix.columns();
+
+  vnl_matrix<double> K(numberOfRows, numberOfRows);
+  std::copy(this->m_KMatrix.begin(), this->m_KMatrix.end(), K.begin());
+  const vnl_cholesky cholesky(K, vnl_cholesky::quiet);
+  if (cholesky.rank_deficiency() != 0)
+  {
+    itkExceptionMacro("The matrix K of the kernel is not positive definite, use another solver.");
+  }
+
+  vnl_matrix<double> X(numberOfRows, numberOfAffineParameters);
+  vnl_vector<double> column(numberOfRows);
+  for (unsigned int j = 0; j < numberOfAffineParameters; ++j)
+  {
+    for (unsigned int i = 0; i < numberOfRows; ++i)
+    {
+      column[i] = this->m_PMatrix(i, j);
+    }
+    X.set_column(j, cholesky.solve(column));
+  }
+  for (unsigned int i = 0; i < numberOfRows; ++i)
+  {
+    column[i] = this->m_YMatrix(i, 0);
+  }
+  const vnl_vector<double> z = cholesky.solve(column);
+
+  vnl_matrix<double> P(numberOfRows, numberOfAffineParameters);
+  std::copy(this->m_PMatrix.begin(), this->m_PMatrix.end(), P.begin());
+  const vnl_vector<double> a = vnl_svd<double>(P.transpose() * X, 1e-8).solve(P.transpose() * z);
+  const vnl_vector<double> d = z - X * a;
+
+  this->m_WMatrix.set_size(numberOfRows + numberOfAffineParameters, 1);
+  for (unsigned int i = 0; i < numberOfRows; ++i)
+  {
+    this->m_WMatrix(i, 0) = d[i];
+  }
+  for (unsigned int i = 0; i < numberOfAffineParameters; ++i)
+  {
+    this->m_WMatrix(numberOfRows + i, 0) = a[i];
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+KernelTransform<TParametersValueType, VDimension>::ComputeWMatrixWithSparseLU()
+{
+  this->ComputeD();
+  this->ComputeP();
+  this->ComputeY();
+
+  const unsigned int numberOfRows = this->m_PMatrix.rows();
+  const unsigned int numberOfAffineParameters = this->m_PMatrix.columns();
+
+  vnl_sparse_matrix<double> L(numberOfRows + numberOfAffineParameters, numberOfRows + numberOfAffineParameters);
+  this->ForEachKBlock([&L](unsigned int i, unsigned int j, const GMatrixType & G) {
+    for (unsigned int r = 0; r < VDimension; ++r)
+    {
+      for (unsigned int c = 0; c < VDimension; ++c)
+      {
+        if (G(r, c) != TParametersValueType{})
+        {
+          L(i * VDimension + r, j * VDimension + c) = G(r, c);
+          if (i != j)
+          {
+            L(j * VDimension + r, i * VDimension + c) = G(r, c);
+          }
+        }
+      }
+    }
+  });
+  for (unsigned int i = 0; i < numberOfRows; ++i)
+  {
+    for (unsigned int j = 0; j < numberOfAffineParameters; ++j)
+    {
+      if (this->m_PMatrix(i, j) != TParametersValueType{})
+      {
+        L(i, numberOfRows + j) = this->m_PMatrix(i, j);
+        L(numberOfRows + j, i) = this->m_PMatrix(i, j);
+      }
+    }
+  }
+
+  vnl_vector<double> y(numberOfRows + numberOfAffineParameters);
+  for (unsigned int i = 0; i < y.size(); ++i)
+  {
+    y[i] = this->m_YMatrix(i, 0);
+  }
+  vnl_sparse_lu            lu(L);
+  const vnl_vector<double> w = lu.solve(y);
+
+  this->m_WMatrix.set_size(w.size(), 1);
+  for (unsigned int i = 0; i < w.size(); ++i)
+  {
+    this->m_WMatrix(i, 0) = w[i];
+  }
 }
 
 
@@ -188,38 +345,59 @@ KernelTransform<TParametersValueType, VDimension>::ComputeK()
 
   this->m_KMatrix.fill(0.0);
 
+  // K matrix is symmetric, so only evaluate the upper triangle and
+  // store the values in bot the upper and lower triangle
+  this->ForEachKBlock([this](unsigned int i, unsigned int j, const GMatrixType & G) {
+    for (unsigned int r = 0; r < VDimension; ++r)
+    {
+      for (unsigned int c = 0; c < VDimension; ++c)
+      {
+        this->m_KMatrix(i * VDimension + r, j * VDimension + c) = G(r, c);
+        this->m_KMatrix(j * VDimension + r, i * VDimension + c) = G(r, c);
+      }
+    }
+  });
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+template <typename TFunction>
+void
+KernelTransform<TParametersValueType, VDimension>::ForEachKBlock(TFunction && function)
+{
   PointsIterator       p1 = this->m_SourceLandmarks->GetPoints()->Begin();
   const PointsIterator end = this->m_SourceLandmarks->GetPoints()->End();
+  const bool           hasCompactSupport = this->GetKernelSupportRadius() > 0.0;
 
-  GMatrixType G;
-  // K matrix is symmetric, so only evaluate the upper triangle and
-  // store the values in bot the upper and lower triangle
+  GMatrixType  G;
   unsigned int i = 0;
   while (p1 != end)
   {
-    PointsIterator p2 = p1; // start at the diagonal element
-    unsigned int   j = i;
-
-    // Compute the block diagonal element, i.e. kernel for pi->pi
+    // The block diagonal element, i.e. kernel for pi->pi
     G = this->ComputeReflexiveG(p1);
-    const vnl_matrix_ref<TParametersValueType> G_reference_alias{
-      G.as_ref()
-    }; // different interfaces require different representations of values.
-    this->m_KMatrix.update(
-      G_reference_alias, i * VDimension, i * VDimension); // update only accepts `const vnl_matrix<T> &`
-    ++p2;
-    ++j;
-
-    // Compute the upper (and copy into lower) triangular part of K
-    while (p2 != end)
-    {
-      const InputVectorType s = p1.Value() - p2.Value();
-      this->ComputeG(s, G);
-      // write value in upper and lower triangle of matrix
-      this->m_KMatrix.update(G_reference_alias, i * VDimension, j * VDimension);
-      this->m_KMatrix.update(G_reference_alias, j * VDimension, i * VDimension);
-      ++p2;
-      ++j;
+    function(i, i, G);
+
+    if (hasCompactSupport)
+    {
+      const auto addBlock = [this, i, &G, &function](PointIdentifier j, const InputVectorType & s) {
+        if (j > i)
+        {
+          this->ComputeG(s, G);
+          function(i, static_cast<unsigned int>(j), G);
+        }
+      };
+      this->ForEachLandmarkWithinSupport(p1.Value(), addBlock);
+    }
+    else
+    {
+      PointsIterator p2 = p1;
+      unsigned int   j = i;
+      for (++p2, ++j; p2 != end; ++p2, ++j)
+      {
+        const InputVectorType s = p1.Value() - p2.Value();
+        this->ComputeG(s, G);
+        function(i, j, G);
+      }
     }
     ++p1;
     ++i;
@@ -227,6 +405,338 @@ KernelTransform<TParametersValueType, VDimension>::ComputeK()
 }
 
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+KernelTransform<TParametersValueType, VDimension>::ComputeLandmarkGrid()
+{
+  m_LandmarkGridOffsets.clear();
+  m_LandmarkGridIdentifiers.clear();
+  m_LandmarkGridPoints.clear();
+
+  const double          radius = this->GetKernelSupportRadius();
+  const PointIdentifier numberOfLandmarks = this->m_SourceLandmarks->GetNumberOfPoints();
+  if (radius <= 0.0 || numberOfLandmarks == 0)
+  {
+    return;
+  }
+
+  const PointsContainer & points = *this->m_SourceLandmarks->GetPoints();
+  InputPointType          maximum = points.Begin().Value();
+  m_LandmarkGridOrigin = maximum;
+  for (PointsConstIterator it = points.Begin(); it != points.End(); ++it)
+  {
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      m_LandmarkGridOrigin[d] = std::min(m_LandmarkGridOrigin[d], it.Value()[d]);
+      maximum[d] = std::max(maximum[d], it.Value()[d]);
+    }
+  }
+
+  // Buckets as large as the support, but not many more than the landmarks.
+  m_LandmarkGridSpacing = radius;
+  for (;;)
+  {
+    double numberOfBuckets = 1.0;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      m_LandmarkGridSize[d] =
+        static_cast<SizeValueType>(std::floor((maximum[d] - m_LandmarkGridOrigin[d]) / m_LandmarkGridSpacing)) + 1;
+      numberOfBuckets *= m_LandmarkGridSize[d];
+    }
+    if (numberOfBuckets <= 4.0 * numberOfLandmarks + 64.0)
+    {
+      break;
+    }
+    m_LandmarkGridSpacing *= 2.0;
+  }
+
+  const auto bucketOf = [this](const InputPointType & point) {
+    SizeValueType bucket = 0;
+    for (unsigned int d = VDimension; d-- > 0;)
+    {
+      const auto index = static_cast<SizeValueType>((point[d] - m_LandmarkGridOrigin[d]) / m_LandmarkGridSpacing);
+      bucket = bucket * m_LandmarkGridSize[d] + std::min(index, m_LandmarkGridSize[d] - 1);
+    }
+    return bucket;
+  };
+
+  // Counting sort of the landmarks by bucket.
+  m_LandmarkGridOffsets.assign(m_LandmarkGridSize.CalculateProductOfElements() + 1, 0);
+  for (PointsConstIterator it = points.Begin(); it != points.End(); ++it)
+  {
+    ++m_LandmarkGridOffsets[bucketOf(it.Value()) + 1];
+  }
+  std::partial_sum(m_LandmarkGridOffsets.cbegin(), m_LandmarkGridOffsets.cend(), m_LandmarkGridOffsets.begin());
+  std::vector<SizeValueType> next(m_LandmarkGridOffsets.cbegin(), m_LandmarkGridOffsets.cend() - 1);
+  m_LandmarkGridIdentifiers.resize(numberOfLandmarks);
+  m_LandmarkGridPoints.resize(numberOfLandmarks);
+  PointIdentifier identifier = 0;
+  for (PointsConstIterator it = points.Begin(); it != points.End(); ++it, ++identifier)
+  {
+    const SizeValueType position = next[bucketOf(it.Value())]++;
+    m_LandmarkGridIdentifiers[position] = identifier;
+    m_LandmarkGridPoints[position] = it.Value();
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+template <typename TFunction>
+void
+KernelTransform<TParametersValueType, VDimension>::ForEachLandmarkWithinSupport(const InputPointType & thisPoint,
+                                                                                TFunction &&           function) const
+{
+  if (m_LandmarkGridOffsets.empty())
+  {
+    return;
+  }
+  const double radius = this->GetKernelSupportRadius();
+
+  // The range of buckets intersecting the support around the point.
+  IndexValueType lower[VDimension];
+  IndexValueType upper[VDimension];
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    const double position = (thisPoint[d] - m_LandmarkGridOrigin[d]) / m_LandmarkGridSpacing;
+    const double extent = radius / m_LandmarkGridSpacing;
+    lower[d] = std::max(static_cast<IndexValueType>(std::floor(position - extent)), IndexValueType{ 0 });
+    upper[d] = std::min(static_cast<IndexValueType>(std::floor(position + extent)),
+                        static_cast<IndexValueType>(m_LandmarkGridSize[d]) - 1);
+    if (lower[d] > upper[d])
+    {
+      return;
+    }
+  }
+
+  const double   squaredRadius = radius * radius;
+  IndexValueType index[VDimension];
+  std::copy_n(lower, VDimension, index);
+  for (;;)
+  {
+    SizeValueType bucket = 0;
+    for (unsigned int d = VDimension; d-- > 0;)
+    {
+      bucket = bucket * m_LandmarkGridSize[d] + static_cast<SizeValueType>(index[d]);
+    }
+    for (SizeValueType k = m_LandmarkGridOffsets[bucket]; k < m_LandmarkGridOffsets[bucket + 1]; ++k)
+    {
+      const InputVectorType s = thisPoint - m_LandmarkGridPoints[k];
+      if (s.GetSquaredNorm() < squaredRadius)
+      {
+        function(m_LandmarkGridIdentifiers[k], s);
+      }
+    }
+
+    unsigned int d = 0;
+    while (d < VDimension && index[d] == upper[d])
+    {
+      index[d] = lower[d];
+      ++d;
+    }
+    if (d == VDimension)
+    {
+      return;
+    }
+    ++index[d];
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+KernelTransform<TParametersValueType, VDimension>::ComputeInterpolationGrid()
+{
+  m_InterpolationGridValues.clear();
+  m_InterpolationError = 0.0;
+  if (m_InterpolationTolerance <= 0.0 || this->m_SourceLandmarks->GetNumberOfPoints() == 0)
+  {
+    return;
+  }
+
+  InputPointType minimum = m_InterpolationDomainMinimum;
+  InputPointType maximum = m_InterpolationDomainMaximum;
+  bool           isDomainSet = true;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    isDomainSet &= maximum[d] > minimum[d];
+  }
+  if (!isDomainSet)
+  {
+    const PointsContainer & points = *this->m_SourceLandmarks->GetPoints();
+    minimum = points.Begin().Value();
+    maximum = minimum;
+    for (PointsConstIterator it = points.Begin(); it != points.End(); ++it)
+    {
+      for (unsigned int d = 0; d < VDimension; ++d)
+      {
+        minimum[d] = std::min(minimum[d], it.Value()[d]);
+        maximum[d] = std::max(maximum[d], it.Value()[d]);
+      }
+    }
+  }
+  double extent = 0.0;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    extent = std::max(extent, static_cast<double>(maximum[d] - minimum[d]));
+  }
+  if (extent <= 0.0)
+  {
+    return;
+  }
+
+  // The nodes and the cells are evaluated in batches, in parallel.
+  constexpr SizeValueType batchSize = 256;
+  const auto              multiThreader = MultiThreaderBase::New();
+  const auto              nodeIndex = [](SizeValueType k, const Size<VDimension> & size, unsigned int d) {
+    for (unsigned int i = 0; i < d; ++i)
+    {
+      k /= size[i];
+    }
+    return k % size[d];
+  };
+
+  m_InterpolationGridOrigin = minimum;
+  m_InterpolationGridSpacing = extent / 4.0;
+  for (;;)
+  {
+    double numberOfNodes = 1.0;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      m_InterpolationGridSize[d] =
+        static_cast<SizeValueType>(std::max(std::ceil((maximum[d] - minimum[d]) / m_InterpolationGridSpacing), 1.0)) +
+        1;
+      numberOfNodes *= m_InterpolationGridSize[d];
+    }
+    if (numberOfNodes > static_cast<double>(m_MaximumNumberOfInterpolationNodes))
+    {
+      itkWarningMacro("The interpolation tolerance cannot be reached with "
+                      << m_MaximumNumberOfInterpolationNodes << " nodes, the points are transformed exactly.");
+      m_InterpolationGridValues.clear();
+      m_InterpolationError = 0.0;
+      return;
+    }
+
+    const auto nodes = static_cast<SizeValueType>(numberOfNodes);
+    m_InterpolationGridValues.resize(nodes);
+    multiThreader->ParallelizeArray(
+      0,
+      (nodes + batchSize - 1) / batchSize,
+      [this, nodes, &nodeIndex](SizeValueType batch) {
+        for (SizeValueType k = batch * batchSize; k < std::min(nodes, (batch + 1) * batchSize); ++k)
+        {
+          InputPointType node;
+          for (unsigned int d = 0; d < VDimension; ++d)
+          {
+            node[d] = m_InterpolationGridOrigin[d] +
+                      m_InterpolationGridSpacing * static_cast<double>(nodeIndex(k, m_InterpolationGridSize, d));
+          }
+          OutputPointType contribution{};
+          this->ComputeDeformationContribution(node, contribution);
+          for (unsigned int d = 0; d < VDimension; ++d)
+          {
+            m_InterpolationGridValues[k][d] = contribution[d];
+          }
+        }
+      },
+      nullptr);
+
+    // The interpolation error is the largest at the centers of the cells.
+    Size<VDimension> cellsSize;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      cellsSize[d] = m_InterpolationGridSize[d] - 1;
+    }
+    const SizeValueType numberOfCells = cellsSize.CalculateProductOfElements();
+    const SizeValueType numberOfBatches = (numberOfCells + batchSize - 1) / batchSize;
+    std::vector<double> batchErrors(numberOfBatches, 0.0);
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBatches,
+      [this, numberOfCells, &cellsSize, &nodeIndex, &batchErrors](SizeValueType batch) {
+        for (SizeValueType k = batch * batchSize; k < std::min(numberOfCells, (batch + 1) * batchSize); ++k)
+        {
+          InputPointType center;
+          for (unsigned int d = 0; d < VDimension; ++d)
+          {
+            center[d] = m_InterpolationGridOrigin[d] +
+                        m_InterpolationGridSpacing * (static_cast<double>(nodeIndex(k, cellsSize, d)) + 0.5);
+          }
+          OutputPointType exact{};
+          OutputPointType interpolated{};
+          this->ComputeDeformationContribution(center, exact);
+          this->InterpolateDeformationContribution(center, interpolated);
+          batchErrors[batch] =
+            std::max(batchErrors[batch], static_cast<double>(exact.EuclideanDistanceTo(interpolated)));
+        }
+      },
+      nullptr);
+    m_InterpolationError = batchErrors.empty() ? 0.0 : *std::max_element(batchErrors.cbegin(), batchErrors.cend());
+
+    if (m_InterpolationError <= m_InterpolationTolerance)
+    {
+      return;
+    }
+    m_InterpolationGridSpacing /= 2.0;
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int VDimension>
+bool
+KernelTransform<TParametersValueType, VDimension>::InterpolateDeformationContribution(const InputPointType & thisPoint,
+                                                                                      OutputPointType & result) const
+{
+  if (m_InterpolationGridValues.empty())
+  {
+    return false;
+  }
+
+  // The node at the lower corner of the cell, its offset in the grid, and the
+  // weight of the upper corner along each dimension.
+  SizeValueType offset = 0;
+  SizeValueType strides[VDimension];
+  double        weights[VDimension];
+  SizeValueType stride = 1;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    const double position = (thisPoint[d] - m_InterpolationGridOrigin[d]) / m_InterpolationGridSpacing;
+    if (!(position >= 0.0 && position <= static_cast<double>(m_InterpolationGridSize[d] - 1)))
+    {
+      return false;
+    }
+    const SizeValueType index =
+      std::min(static_cast<SizeValueType>(position), static_cast<SizeValueType>(m_InterpolationGridSize[d] - 2));
+    weights[d] = position - static_cast<double>(index);
+    strides[d] = stride;
+    offset += index * stride;
+    stride *= m_InterpolationGridSize[d];
+  }
+
+  for (unsigned int corner = 0; corner < (1u << VDimension); ++corner)
+  {
+    double        weight = 1.0;
+    SizeValueType cornerOffset = offset;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      if (corner & (1u << d))
+      {
+        weight *= weights[d];
+        cornerOffset += strides[d];
+      }
+      else
+      {
+        weight *= 1.0 - weights[d];
+      }
+    }
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      result[d] += weight * m_InterpolationGridValues[cornerOffset][d];
+    }
+  }
+  return true;
+}
+
+
 template <typename TParametersValueType, unsigned int VDimension>
 void
 KernelTransform<TParametersValueType, VDimension>::ComputeP()
@@ -324,7 +834,10 @@ KernelTransform<TParametersValueType, VDimension>::TransformPoint(const InputPoi
 
 
   // TODO:  It is unclear if the following line is needed.
-  this->ComputeDeformationContribution(thisPoint, result);
+  if (!this->InterpolateDeformationContribution(thisPoint, result))
+  {
+    this->ComputeDeformationContribution(thisPoint, result);
+  }
 
   // Add the rotational part of the Affine component
   for (unsigned int j = 0; j < VDimension; ++j)
@@ -523,6 +1036,14 @@ KernelTransform<TParametersValueType, VDimension>::PrintSelf(std::ostream & os,
     this->m_Displacements->Print(os, indent.GetNextIndent());
   }
   os << indent << "Stiffness: " << this->m_Stiffness << std::endl;
+  os << indent << "Solver: " << m_Solver << std::endl;
+  os << indent << "LandmarkGridSize: " << m_LandmarkGridSize << std::endl;
+  os << indent << "InterpolationTolerance: " << m_InterpolationTolerance << std::endl;
+  os << indent << "MaximumNumberOfInterpolationNodes: " << m_MaximumNumberOfInterpolationNodes << std::endl;
+  os << indent << "InterpolationDomainMinimum: " << m_InterpolationDomainMinimum << std::endl;
+  os << indent << "InterpolationDomainMaximum: " << m_InterpolationDomainMaximum << std::endl;
+  os << indent << "InterpolationError: " << m_InterpolationError << std::endl;
+  os << indent << "NumberOfInterpolationNodes: " << m_InterpolationGridValues.size() << std::endl;
 }
 
 } // end namespace itk
@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWendlandSplineKernelTransform_h
+#define itkWendlandSplineKernelTransform_h
+
+#include "itkKernelTransform.h"
+
+namespace itk
+{
+/** \class WendlandSplineKernelTransform
+ * This class defines a spline transformation whose kernel is the compactly
+ * supported radial basis function of Wendland, of continuity C2, which is
+ * positive definite up to three dimensions:
+ * \f[ \phi(r) = (1 - r/\rho)_+^4 (4 r/\rho + 1) \f]
+ * where \f$ \rho \f$ is the SupportRadius.
+ *
+ * Each landmark only deforms the space within the support radius around it,
+ * so that the transformation of a point only sums the landmarks of its
+ * neighborhood, and the matrix K is sparse and positive definite: the
+ * Cholesky and SparseLU solvers of KernelTransform apply. The support radius
+ * should include several landmarks around each landmark, or the deformation
+ * between them is close to the affine part only.
+ *
+ * \ingroup ITKTransform
+ */
+template <typename TParametersValueType, unsigned int VDimension = 3>
+class ITK_TEMPLATE_EXPORT WendlandSplineKernelTransform : public KernelTransform<TParametersValueType, VDimension>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WendlandSplineKernelTransform);
+
+  /** Standard class type aliases. */
+  using Self = WendlandSplineKernelTransform;
+  using Superclass = KernelTransform<TParametersValueType, VDimension>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** New macro for creation of through a Smart Pointer */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(WendlandSplineKernelTransform);
+
+  /** Scalar type. */
+  using typename Superclass::ScalarType;
+
+  /** Parameters type. */
+  using typename Superclass::ParametersType;
+  using typename Superclass::FixedParametersType;
+
+  /** Jacobian Type */
+  using typename Superclass::JacobianType;
+  using typename Superclass::JacobianPositionType;
+  using typename Superclass::InverseJacobianPositionType;
+
+  /** Dimension of the domain space. */
+  static constexpr unsigned int SpaceDimension = Superclass::SpaceDimension;
+
+  /** These (rather redundant) type alias are needed because type alias are not inherited */
+  using typename Superclass::InputPointType;
+  using typename Superclass::OutputPointType;
+  using typename Superclass::InputVectorType;
+  using typename Superclass::OutputVectorType;
+  using typename Superclass::InputCovariantVectorType;
+  using typename Superclass::OutputCovariantVectorType;
+  using typename Superclass::PointsIterator;
+  using typename Superclass::PointIdentifier;
+
+  /** Set/Get the radius of the support of the kernel, in physical units.
+   * Takes effect at the next ComputeWMatrix(). */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(SupportRadius, double, NumericTraits<double>::min(), NumericTraits<double>::max());
+  itkGetConstMacro(SupportRadius, double);
+  /** @ITKEndGrouping */
+
+protected:
+  WendlandSplineKernelTransform() = default;
+  ~WendlandSplineKernelTransform() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** These (rather redundant) type alias are needed because type alias are not inherited. */
+  using typename Superclass::GMatrixType;
+
+  /** Compute G(x)
+   * For the Wendland spline, this is:
+   * \f$ G(x) = \phi(r(x))*I \f$
+   * where r(x) is the Euclidean norm of x and I the identity matrix. */
+  void
+  ComputeG(const InputVectorType & x, GMatrixType & gmatrix) const override;
+
+  /** The kernel is one at the landmark itself, in addition to the stiffness. */
+  const GMatrixType & ComputeReflexiveG(PointsIterator) const override;
+
+  /** Compute the contribution of the landmarks weighted by the kernel function
+      to the global deformation of the space  */
+  void
+  ComputeDeformationContribution(const InputPointType & thisPoint, OutputPointType & result) const override;
+
+  double
+  GetKernelSupportRadius() const override
+  {
+    return m_SupportRadius;
+  }
+
+private:
+  /** Evaluate the radial basis function at the distance r. */
+  TParametersValueType
+  Phi(TParametersValueType r) const;
+
+  double m_SupportRadius{ 1.0 };
+};
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkWendlandSplineKernelTransform.hxx"
+#endif
+
+#endif // itkWendlandSplineKernelTransform_h
@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWendlandSplineKernelTransform_hxx
+#define itkWendlandSplineKernelTransform_hxx
+
+namespace itk
+{
+template <typename TParametersValueType, unsigned int VDimension>
+TParametersValueType
+WendlandSplineKernelTransform<TParametersValueType, VDimension>::Phi(TParametersValueType r) const
+{
+  const auto q = static_cast<TParametersValueType>(r / m_SupportRadius);
+  if (q >= TParametersValueType{ 1 })
+  {
+    return TParametersValueType{};
+  }
+  const TParametersValueType s = TParametersValueType{ 1 } - q;
+  return s * s * s * s * (TParametersValueType{ 4 } * q + TParametersValueType{ 1 });
+}
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+WendlandSplineKernelTransform<TParametersValueType, VDimension>::ComputeG(const InputVectorType & x,
+                                                                          GMatrixType &           gmatrix) const
+{
+  const TParametersValueType phi = this->Phi(x.GetNorm());
+
+  gmatrix.fill(TParametersValueType{});
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    gmatrix[i][i] = phi;
+  }
+}
+
+template <typename TParametersValueType, unsigned int VDimension>
+auto
+WendlandSplineKernelTransform<TParametersValueType, VDimension>::ComputeReflexiveG(PointsIterator) const
+  -> const GMatrixType &
+{
+  this->m_GMatrix.fill(TParametersValueType{});
+  this->m_GMatrix.fill_diagonal(TParametersValueType{ 1 } + static_cast<TParametersValueType>(this->m_Stiffness));
+
+  return this->m_GMatrix;
+}
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+WendlandSplineKernelTransform<TParametersValueType, VDimension>::ComputeDeformationContribution(
+  const InputPointType & thisPoint,
+  OutputPointType &      result) const
+{
+  this->ForEachLandmarkWithinSupport(thisPoint, [this, &result](PointIdentifier lnd, const InputVectorType & position) {
+    const TParametersValueType phi = this->Phi(position.GetNorm());
+
+    for (unsigned int odim = 0; odim < VDimension; ++odim)
+    {
+      result[odim] += phi * this->m_DMatrix(odim, lnd);
+    }
+  });
+}
+
+template <typename TParametersValueType, unsigned int VDimension>
+void
+WendlandSplineKernelTransform<TParametersValueType, VDimension>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "SupportRadius: " << m_SupportRadius << std::endl;
+}
+} // namespace itk
+#endif
@@ -0,0 +1,42 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkKernelTransform.h"
+
+namespace itk
+{
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const KernelTransformEnums::Solver value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case KernelTransformEnums::Solver::SVD:
+        return "itk::KernelTransformEnums::Solver::SVD";
+      case KernelTransformEnums::Solver::QR:
+        return "itk::KernelTransformEnums::Solver::QR";
+      case KernelTransformEnums::Solver::Cholesky:
+        return "itk::KernelTransformEnums::Solver::Cholesky";
+      case KernelTransformEnums::Solver::SparseLU:
+        return "itk::KernelTransformEnums::Solver::SparseLU";
+      default:
+        return "INVALID VALUE FOR itk::KernelTransformEnums::Solver";
+    }
+  }();
+}
+} // end namespace itk
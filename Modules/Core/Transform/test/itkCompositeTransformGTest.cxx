@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkCompositeTransform.h"
+
+#include "itkBSplineTransform.h"
+#include "itkEuler3DTransform.h"
+#include "itkScaleTransform.h"
+#include "itkTranslationTransform.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+
+namespace
+{
+constexpr unsigned int Dimension{ 3 };
+using CompositeTransformType = itk::CompositeTransform<double, Dimension>;
+using PointType = CompositeTransformType::InputPointType;
+
+// Returns a translation, followed by a rigid transform, an affine transform,
+// a B-spline transform, and a scaling, as applied to the points.
+CompositeTransformType::Pointer
+CreateCompositeTransform()
+{
+  const auto translation = itk::TranslationTransform<double, Dimension>::New();
+  translation->Translate(itk::MakeVector(1.0, -2.0, 3.0));
+
+  const auto rigid = itk::Euler3DTransform<double>::New();
+  rigid->SetRotation(0.1, -0.2, 0.3);
+  rigid->SetCenter(itk::MakePoint(10.0, 20.0, 30.0));
+  rigid->SetTranslation(itk::MakeVector(-4.0, 5.0, 6.0));
+
+  const auto affine = itk::AffineTransform<double, Dimension>::New();
+  affine->Scale(itk::MakeVector(1.1, 0.9, 1.2));
+  affine->Shear(0, 1, 0.1);
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  const auto bspline = BSplineTransformType::New();
+  bspline->SetTransformDomainPhysicalDimensions(itk::MakeVector(100.0, 100.0, 100.0));
+  bspline->SetTransformDomainMeshSize(BSplineTransformType::MeshSizeType::Filled(2));
+  auto parameters = bspline->GetParameters();
+  for (unsigned int i = 0; i < parameters.size(); ++i)
+  {
+    parameters[i] = std::sin(static_cast<double>(i));
+  }
+  bspline->SetParametersByValue(parameters);
+
+  const auto scale = itk::ScaleTransform<double, Dimension>::New();
+  scale->SetScale(itk::MakeVector(0.8, 1.0, 1.25));
+
+  // The last transform added is applied first.
+  const auto transform = CompositeTransformType::New();
+  transform->AddTransform(scale);
+  transform->AddTransform(bspline);
+  transform->AddTransform(affine);
+  transform->AddTransform(rigid);
+  transform->AddTransform(translation);
+  return transform;
+}
+
+void
+ExpectSameTransformedPoints(const CompositeTransformType & transform, const CompositeTransformType & expected)
+{
+  std::mt19937                           generator(1);
+  std::uniform_real_distribution<double> distribution(0.0, 100.0);
+  for (int i = 0; i < 100; ++i)
+  {
+    const auto point = itk::MakePoint(distribution(generator), distribution(generator), distribution(generator));
+    const auto transformedPoint = transform.TransformPoint(point);
+    const auto expectedPoint = expected.TransformPoint(point);
+    for (unsigned int j = 0; j < Dimension; ++j)
+    {
+      EXPECT_NEAR(transformedPoint[j], expectedPoint[j], 1e-9) << "at " << point;
+    }
+  }
+}
+} // namespace
+
+
+TEST(CompositeTransform, MergeLinearTransformsOfNestedComposites)
+{
+  const auto expected = CreateCompositeTransform();
+
+  // The B-spline transform is in a nested composite transform, with the
+  // linear transforms around it.
+  const auto nested = CompositeTransformType::New();
+  nested->AddTransform(expected->GetNthTransform(1));
+  nested->AddTransform(expected->GetNthTransform(2));
+  const auto transform = CompositeTransformType::New();
+  transform->AddTransform(expected->GetNthTransform(0));
+  transform->AddTransform(nested);
+  for (unsigned int i = 3; i < 5; ++i)
+  {
+    transform->AddTransform(expected->GetNthTransform(i));
+  }
+
+  transform->MergeLinearTransforms();
+  ASSERT_EQ(transform->GetNumberOfTransforms(), 3u);
+  EXPECT_EQ(transform->GetNthTransform(0), expected->GetNthTransform(0));
+  EXPECT_EQ(transform->GetNthTransform(1), expected->GetNthTransform(1));
+  EXPECT_EQ(transform->GetNthTransform(2)->GetNameOfClass(), std::string("AffineTransform"));
+  ExpectSameTransformedPoints(*transform, *expected);
+
+  // Nothing left to merge.
+  const auto mTime = transform->GetMTime();
+  transform->MergeLinearTransforms();
+  EXPECT_EQ(transform->GetNumberOfTransforms(), 3u);
+  EXPECT_GT(transform->GetMTime(), mTime);
+}
+
+
+TEST(CompositeTransform, MergeLinearTransformsKeepsOptimizationFlags)
+{
+  const auto expected = CreateCompositeTransform();
+  const auto transform = CreateCompositeTransform();
+  const auto affine = transform->GetNthTransform(2);
+  transform->SetAllTransformsToOptimizeOff();
+  transform->SetNthTransformToOptimizeOn(2);
+
+  // The affine transform to optimize is not merged with the rigid transform
+  // and the translation, which are merged into an affine transform.
+  transform->MergeLinearTransforms();
+  ASSERT_EQ(transform->GetNumberOfTransforms(), 4u);
+  EXPECT_EQ(transform->GetNthTransform(2), affine);
+  EXPECT_TRUE(transform->GetNthTransformToOptimize(2));
+  EXPECT_FALSE(transform->GetNthTransformToOptimize(3));
+  EXPECT_EQ(transform->GetNthTransform(3)->GetNameOfClass(), std::string("AffineTransform"));
+  EXPECT_EQ(transform->GetNumberOfParameters(), affine->GetNumberOfParameters());
+  ExpectSameTransformedPoints(*transform, *expected);
+}
@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the time the kernel transforms take to compute their coefficients
+// from random 3D landmarks with the solvers of KernelTransform, and to
+// transform random points, exactly and interpolated, for the thin plate
+// spline and for the compactly supported Wendland spline, and reports the
+// maximum differences between the points they transform.
+//
+// The benchmark is built into ITKTransformTestDriver but, like the ones of
+// the PerformanceBenchmarking remote module, not registered as a test;
+// itkKernelTransformGTest tests the solvers and the interpolation. Run it as
+//   ITKTransformTestDriver itkKernelTransformBenchmark numberOfLandmarks [numberOfPoints]
+// e.g. 2000 landmarks and 100000 points.
+
+#include "itkThinPlateSplineKernelTransform.h"
+#include "itkWendlandSplineKernelTransform.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using KernelTransformType = itk::KernelTransform<double, Dimension>;
+using PointType = KernelTransformType::InputPointType;
+using SolverEnum = itk::KernelTransformEnums::Solver;
+
+std::vector<PointType>
+GenerateRandomPoints(unsigned int numberOfPoints, unsigned int seed)
+{
+  std::mt19937                           generator(seed);
+  std::uniform_real_distribution<double> distribution(0.0, 100.0);
+  std::vector<PointType>                 points(numberOfPoints);
+  for (PointType & point : points)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      point[d] = distribution(generator);
+    }
+  }
+  return points;
+}
+
+void
+SetLandmarks(KernelTransformType & transform, const std::vector<PointType> & sourcePoints)
+{
+  const auto sourceLandmarks = KernelTransformType::PointSetType::New();
+  const auto targetLandmarks = KernelTransformType::PointSetType::New();
+  for (unsigned int i = 0; i < sourcePoints.size(); ++i)
+  {
+    PointType target = sourcePoints[i];
+    target[0] += 3.0 * std::sin(target[1] / 20.0);
+    target[1] += 2.0 * std::cos(target[2] / 15.0);
+    sourceLandmarks->SetPoint(i, sourcePoints[i]);
+    targetLandmarks->SetPoint(i, target);
+  }
+  transform.SetSourceLandmarks(sourceLandmarks);
+  transform.SetTargetLandmarks(targetLandmarks);
+}
+
+void
+ComputeWMatrix(itk::TimeProbesCollectorBase & collector, const std::string & name, KernelTransformType & transform)
+{
+  collector.Start(name.c_str());
+  transform.ComputeWMatrix();
+  collector.Stop(name.c_str());
+}
+
+std::vector<PointType>
+TransformPoints(itk::TimeProbesCollectorBase &  collector,
+                const std::string &             name,
+                const KernelTransformType &     transform,
+                const std::vector<PointType> & points)
+{
+  std::vector<PointType> transformedPoints(points.size());
+  collector.Start(name.c_str());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    transformedPoints[i] = transform.TransformPoint(points[i]);
+  }
+  collector.Stop(name.c_str());
+  return transformedPoints;
+}
+
+double
+MaximumDistance(const std::vector<PointType> & points1, const std::vector<PointType> & points2)
+{
+  double distance = 0.0;
+  for (size_t i = 0; i < points1.size(); ++i)
+  {
+    distance = std::max(distance, points1[i].EuclideanDistanceTo(points2[i]));
+  }
+  return distance;
+}
+} // namespace
+
+int
+itkKernelTransformBenchmark(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " numberOfLandmarks [numberOfPoints]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const unsigned int numberOfLandmarks = std::stoi(argv[1]);
+  const unsigned int numberOfPoints = argc > 2 ? std::stoi(argv[2]) : 100000;
+
+  const std::vector<PointType> landmarks = GenerateRandomPoints(numberOfLandmarks, 1);
+  const std::vector<PointType> points = GenerateRandomPoints(numberOfPoints, 2);
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+  const auto                   check = [&ok](const std::string & label, double difference, double tolerance) {
+    std::cout << label << " maximum difference: " << difference << std::endl;
+    if (!(difference <= tolerance))
+    {
+      std::cerr << "Error: " << label << " differ by more than " << tolerance << std::endl;
+      ok = false;
+    }
+  };
+
+  // Thin plate spline.
+  using ThinPlateSplineType = itk::ThinPlateSplineKernelTransform<double, Dimension>;
+  const auto svd = ThinPlateSplineType::New();
+  SetLandmarks(*svd, landmarks);
+  ComputeWMatrix(collector, "TPS solve SVD", *svd);
+  const std::vector<PointType> exact = TransformPoints(collector, "TPS transform exact", *svd, points);
+
+  const auto qr = ThinPlateSplineType::New();
+  qr->SetSolver(SolverEnum::QR);
+  SetLandmarks(*qr, landmarks);
+  ComputeWMatrix(collector, "TPS solve QR", *qr);
+  check("TPS QR and SVD", MaximumDistance(exact, TransformPoints(collector, "TPS transform exact", *qr, points)), 1e-4);
+
+  constexpr double tolerance = 0.1;
+  const auto       interpolated = ThinPlateSplineType::New();
+  interpolated->SetSolver(SolverEnum::QR);
+  interpolated->SetInterpolationTolerance(tolerance);
+  SetLandmarks(*interpolated, landmarks);
+  ComputeWMatrix(collector, "TPS solve QR and interpolate", *interpolated);
+  std::cout << "TPS interpolation nodes: " << interpolated->GetNumberOfInterpolationNodes()
+            << ", estimated error: " << interpolated->GetInterpolationError() << std::endl;
+  check("TPS interpolated and exact",
+        MaximumDistance(exact, TransformPoints(collector, "TPS transform interpolated", *interpolated, points)),
+        2.0 * tolerance);
+
+  // Wendland spline, with about 50 landmarks within the support of each one.
+  using WendlandSplineType = itk::WendlandSplineKernelTransform<double, Dimension>;
+  const double supportRadius = 100.0 * std::cbrt(50.0 / (4.19 * numberOfLandmarks));
+  std::vector<PointType> wendlandPoints[2];
+  for (const SolverEnum solver : { SolverEnum::Cholesky, SolverEnum::SparseLU })
+  {
+    std::ostringstream name;
+    name << "Wendland solve " << (solver == SolverEnum::Cholesky ? "Cholesky" : "SparseLU");
+    const auto wendland = WendlandSplineType::New();
+    wendland->SetSupportRadius(supportRadius);
+    wendland->SetSolver(solver);
+    SetLandmarks(*wendland, landmarks);
+    ComputeWMatrix(collector, name.str(), *wendland);
+    wendlandPoints[solver == SolverEnum::SparseLU] =
+      TransformPoints(collector, "Wendland transform exact", *wendland, points);
+  }
+  check("Wendland SparseLU and Cholesky", MaximumDistance(wendlandPoints[0], wendlandPoints[1]), 1e-4);
+
+  collector.Report(std::cout);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
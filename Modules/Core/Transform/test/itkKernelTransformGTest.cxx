@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkKernelTransform.h"
+
+#include "itkThinPlateSplineKernelTransform.h"
+#include "itkWendlandSplineKernelTransform.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+
+namespace
+{
+constexpr unsigned int Dimension{ 3 };
+using KernelTransformType = itk::KernelTransform<double, Dimension>;
+using PointType = KernelTransformType::InputPointType;
+using SolverEnum = itk::KernelTransformEnums::Solver;
+
+// Returns points drawn uniformly in [0, 100]^3.
+std::vector<PointType>
+GenerateRandomPoints(unsigned int numberOfPoints, unsigned int seed)
+{
+  std::mt19937                           randomNumberEngine(seed);
+  std::uniform_real_distribution<double> distribution(0.0, 100.0);
+  std::vector<PointType>                 points(numberOfPoints);
+  for (PointType & point : points)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      point[d] = distribution(randomNumberEngine);
+    }
+  }
+  return points;
+}
+
+// Sets the landmarks of the transform, with the target landmarks displaced
+// smoothly from the source ones, and computes its coefficients.
+void
+InitializeTransform(KernelTransformType & transform, const std::vector<PointType> & sourcePoints)
+{
+  const auto sourceLandmarks = KernelTransformType::PointSetType::New();
+  const auto targetLandmarks = KernelTransformType::PointSetType::New();
+  for (unsigned int i = 0; i < sourcePoints.size(); ++i)
+  {
+    const PointType & source = sourcePoints[i];
+    PointType         target = source;
+    target[0] += 3.0 * std::sin(source[1] / 20.0);
+    target[1] += 2.0 * std::cos(source[2] / 15.0);
+    target[2] += 0.05 * source[0];
+    sourceLandmarks->SetPoint(i, source);
+    targetLandmarks->SetPoint(i, target);
+  }
+  transform.SetSourceLandmarks(sourceLandmarks);
+  transform.SetTargetLandmarks(targetLandmarks);
+  transform.ComputeWMatrix();
+}
+
+// Returns the largest distance between the points transformed by the two
+// transforms.
+double
+MaximumDistance(const KernelTransformType & transform1,
+                const KernelTransformType & transform2,
+                const std::vector<PointType> &  points)
+{
+  double maximumDistance = 0.0;
+  for (const PointType & point : points)
+  {
+    maximumDistance =
+      std::max(maximumDistance, transform1.TransformPoint(point).EuclideanDistanceTo(transform2.TransformPoint(point)));
+  }
+  return maximumDistance;
+}
+} // namespace
+
+
+TEST(KernelTransform, SolversAgreeWithSVD)
+{
+  using TransformType = itk::ThinPlateSplineKernelTransform<double, Dimension>;
+  const std::vector<PointType> landmarks = GenerateRandomPoints(40, 1);
+  const std::vector<PointType> points = GenerateRandomPoints(100, 2);
+
+  const auto reference = TransformType::New();
+  EXPECT_EQ(reference->GetSolver(), SolverEnum::SVD);
+  InitializeTransform(*reference, landmarks);
+
+  for (const SolverEnum solver : { SolverEnum::QR, SolverEnum::SparseLU })
+  {
+    const auto transform = TransformType::New();
+    transform->SetSolver(solver);
+    InitializeTransform(*transform, landmarks);
+    EXPECT_LT(MaximumDistance(*reference, *transform, points), 1e-6) << solver;
+  }
+
+  // The matrix K of the thin plate spline is not positive definite.
+  const auto transform = TransformType::New();
+  transform->SetSolver(SolverEnum::Cholesky);
+  EXPECT_THROW(InitializeTransform(*transform, landmarks), itk::ExceptionObject);
+}
+
+
+TEST(KernelTransform, WendlandSplineHasCompactSupport)
+{
+  using TransformType = itk::WendlandSplineKernelTransform<double, Dimension>;
+  const std::vector<PointType> landmarks = GenerateRandomPoints(200, 3);
+  const std::vector<PointType> points = GenerateRandomPoints(100, 4);
+
+  const auto reference = TransformType::New();
+  reference->SetSupportRadius(40.0);
+  InitializeTransform(*reference, landmarks);
+
+  // The spline interpolates the landmarks.
+  const auto & targetLandmarks = *reference->GetTargetLandmarks()->GetPoints();
+  for (unsigned int i = 0; i < landmarks.size(); ++i)
+  {
+    EXPECT_LT(reference->TransformPoint(landmarks[i]).EuclideanDistanceTo(targetLandmarks.ElementAt(i)), 1e-6);
+  }
+
+  for (const SolverEnum solver : { SolverEnum::QR, SolverEnum::Cholesky, SolverEnum::SparseLU })
+  {
+    const auto transform = TransformType::New();
+    transform->SetSupportRadius(40.0);
+    transform->SetSolver(solver);
+    InitializeTransform(*transform, landmarks);
+    EXPECT_LT(MaximumDistance(*reference, *transform, points), 1e-6) << solver;
+  }
+
+  // Far from the landmarks, only the affine part remains.
+  const PointType far = itk::MakePoint(1000.0, 1000.0, 1000.0);
+  const PointType farther = itk::MakePoint(2000.0, 1000.0, 1000.0);
+  const auto      farDisplacement = reference->TransformPoint(far) - far;
+  const auto      fartherDisplacement = reference->TransformPoint(farther) - farther;
+  const auto      affineDisplacement = reference->TransformPoint(far + (far - farther)) - (far + (far - farther));
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    EXPECT_NEAR(2.0 * farDisplacement[d], fartherDisplacement[d] + affineDisplacement[d], 1e-6);
+  }
+}
+
+
+TEST(KernelTransform, InterpolatesWithinTolerance)
+{
+  using TransformType = itk::ThinPlateSplineKernelTransform<double, Dimension>;
+  const std::vector<PointType> landmarks = GenerateRandomPoints(100, 5);
+  const std::vector<PointType> points = GenerateRandomPoints(1000, 6);
+
+  const auto reference = TransformType::New();
+  InitializeTransform(*reference, landmarks);
+  EXPECT_EQ(reference->GetNumberOfInterpolationNodes(), 0u);
+  EXPECT_EQ(reference->GetInterpolationError(), 0.0);
+
+  constexpr double tolerance = 0.1;
+  const auto       transform = TransformType::New();
+  transform->SetInterpolationTolerance(tolerance);
+  transform->SetInterpolationDomainMinimum(itk::MakePoint(0.0, 0.0, 0.0));
+  transform->SetInterpolationDomainMaximum(itk::MakePoint(100.0, 100.0, 100.0));
+  InitializeTransform(*transform, landmarks);
+  EXPECT_GT(transform->GetNumberOfInterpolationNodes(), 0u);
+  EXPECT_LE(transform->GetInterpolationError(), tolerance);
+  EXPECT_LT(MaximumDistance(*reference, *transform, points), 2.0 * tolerance);
+
+  // Outside of the domain, the points are transformed exactly.
+  const std::vector<PointType> outsidePoints{ itk::MakePoint(-10.0, 50.0, 50.0), itk::MakePoint(50.0, 150.0, 50.0) };
+  EXPECT_EQ(MaximumDistance(*reference, *transform, outsidePoints), 0.0);
+
+  // Without enough nodes, all the points are transformed exactly.
+  transform->SetMaximumNumberOfInterpolationNodes(8);
+  transform->ComputeWMatrix();
+  EXPECT_EQ(transform->GetNumberOfInterpolationNodes(), 0u);
+  EXPECT_LT(MaximumDistance(*reference, *transform, points), 1e-9);
+}
@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkCurvatureFlowImageFilter.h"
+
+#include "itkImage.h"
+#include "itkImageBufferRange.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+using FilterType = itk::CurvatureFlowImageFilter<ImageType, ImageType>;
+
+// A square, whose corners are rounded by the curvature flow, in a constant
+// background, which is not changed.
+ImageType::Pointer
+CreateSquareImage()
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 96, 80 } });
+  image->AllocateInitialized();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto index = it.GetIndex();
+    if (index[0] >= 30 && index[0] < 50 && index[1] >= 20 && index[1] < 40)
+    {
+      it.Set(100.0f);
+    }
+  }
+  return image;
+}
+
+ImageType::Pointer
+Smooth(const ImageType * input, FilterType * filter)
+{
+  filter->SetInput(input);
+  filter->SetNumberOfIterations(20);
+  filter->SetTimeStep(0.1);
+  filter->Update();
+  const ImageType::Pointer output = filter->GetOutput();
+  output->DisconnectPipeline();
+  return output;
+}
+} // namespace
+
+
+TEST(CurvatureFlowImageFilter, ActiveBlocksMatchDenseIteration)
+{
+  const ImageType::Pointer input = CreateSquareImage();
+  const ImageType::Pointer expected = Smooth(input, FilterType::New());
+
+  const auto filter = FilterType::New();
+  EXPECT_FALSE(filter->GetUseActiveBlocks());
+  filter->UseActiveBlocksOn();
+  filter->SetActiveBlockSize(8);
+  const ImageType::Pointer output = Smooth(input, filter);
+
+  // 12 x 10 blocks, of which only those around the corners of the square
+  // change.
+  EXPECT_LT(filter->GetNumberOfActiveBlocks(), 12u * 10u / 2);
+  EXPECT_GT(filter->GetNumberOfChangedBlocks(), 0u);
+  EXPECT_LE(filter->GetNumberOfChangedBlocks(), filter->GetNumberOfActiveBlocks());
+
+  const auto outputRange = itk::MakeImageBufferRange(output.GetPointer());
+  const auto expectedRange = itk::MakeImageBufferRange(expected.GetPointer());
+  EXPECT_TRUE(std::equal(outputRange.cbegin(), outputRange.cend(), expectedRange.cbegin(), expectedRange.cend()));
+}
+
+
+TEST(CurvatureFlowImageFilter, ActiveBlocksMatchDenseIterationUpToTolerance)
+{
+  const ImageType::Pointer input = CreateSquareImage();
+  const ImageType::Pointer expected = Smooth(input, FilterType::New());
+
+  constexpr double tolerance{ 0.01 };
+  const auto       filter = FilterType::New();
+  filter->UseActiveBlocksOn();
+  filter->SetActiveBlockSize(4);
+  filter->SetActiveBlockTolerance(tolerance);
+  const ImageType::Pointer output = Smooth(input, filter);
+
+  // The blocks whose change fell below the tolerance are not updated.
+  EXPECT_LT(filter->GetNumberOfActiveBlocks(), 24u * 20u / 4);
+  EXPECT_LT(filter->GetNumberOfChangedBlocks(), filter->GetNumberOfActiveBlocks());
+
+  const auto outputRange = itk::MakeImageBufferRange(output.GetPointer());
+  const auto expectedRange = itk::MakeImageBufferRange(expected.GetPointer());
+  for (auto outputIt = outputRange.cbegin(), expectedIt = expectedRange.cbegin(); outputIt != outputRange.cend();
+       ++outputIt, ++expectedIt)
+  {
+    EXPECT_LE(std::abs(*outputIt - *expectedIt), 20 * tolerance);
+  }
+}
+
+
+TEST(CurvatureFlowImageFilter, ActiveBlocksOfConstantImage)
+{
+  // No block changes at the first iteration, so that none is active at the
+  // next ones.
+  const auto input = ImageType::New();
+  input->SetRegions(ImageType::SizeType{ { 32, 24 } });
+  input->Allocate();
+  input->FillBuffer(5.0f);
+
+  const auto filter = FilterType::New();
+  filter->UseActiveBlocksOn();
+  filter->SetActiveBlockSize(8);
+  filter->SetInput(input);
+  filter->SetNumberOfIterations(3);
+  filter->SetTimeStep(0.1);
+  ASSERT_NO_THROW(filter->Update());
+
+  EXPECT_EQ(filter->GetElapsedIterations(), 3u);
+  EXPECT_EQ(filter->GetNumberOfActiveBlocks(), 0u);
+  EXPECT_EQ(filter->GetNumberOfChangedBlocks(), 0u);
+  const auto outputRange = itk::MakeImageBufferRange(filter->GetOutput());
+  EXPECT_TRUE(std::all_of(outputRange.cbegin(), outputRange.cend(), [](float pixel) { return pixel == 5.0f; }));
+}
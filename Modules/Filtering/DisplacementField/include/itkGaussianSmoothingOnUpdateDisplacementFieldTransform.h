@@ -21,6 +21,7 @@
 #include "itkDisplacementFieldTransform.h"
 
 #include "itkGaussianOperator.h"
+#include "itkMultiThreaderBase.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
 
 namespace itk
@@ -39,6 +40,13 @@ namespace itk
  * To free the memory allocated and cached in \c GaussianSmoothDisplacementField
  * on demand, see \c FreeGaussianSmoothingTempField.
  *
+ * When UseRecursiveGaussianSmoothing is on, the fields are smoothed in
+ * place by the recursive filters of Young and van Vliet, with the boundary
+ * conditions of Triggs and Sdika, along each dimension, instead of being
+ * convolved with the GaussianOperator. The cost of the recursive filters
+ * does not depend on the variance, and they do not allocate images. They
+ * approximate the Gaussian for standard deviations of at least 1/sqrt(2)
+ * pixel; the smaller variances are still smoothed with the operator.
  *
  * \ingroup ITKDisplacementField
  */
@@ -87,6 +95,14 @@ public:
   itkSetMacro(GaussianSmoothingVarianceForTheTotalField, ScalarType);
   itkGetConstReferenceMacro(GaussianSmoothingVarianceForTheTotalField, ScalarType);
   /** @ITKEndGrouping */
+  /** Set/Get whether the fields are smoothed by recursive Gaussian
+   * filters. Off by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseRecursiveGaussianSmoothing, bool);
+  itkGetConstMacro(UseRecursiveGaussianSmoothing, bool);
+  itkBooleanMacro(UseRecursiveGaussianSmoothing);
+  /** @ITKEndGrouping */
+
   /** Update the transform's parameters by the values in \c update.
    * We assume \c update is of the same length as Parameters. Throw
    * exception otherwise.
@@ -115,10 +131,16 @@ protected:
   [[nodiscard]] LightObject::Pointer
   InternalClone() const override;
 
+  /** Smooth the displacement field in-place with recursive Gaussian filters
+   * along each dimension. */
+  void
+  RecursiveGaussianSmoothDisplacementField(DisplacementFieldType * field, ScalarType variance);
+
   /** Used in GaussianSmoothDisplacementField as variance for the
    * GaussianOperator */
   ScalarType m_GaussianSmoothingVarianceForTheUpdateField{};
   ScalarType m_GaussianSmoothingVarianceForTheTotalField{};
+  bool       m_UseRecursiveGaussianSmoothing{ false };
 
   /** Type of Gaussian Operator used during smoothing. Define here
    * so we can use a member var during the operation. */
@@ -126,6 +148,15 @@ protected:
   using GaussianSmoothingSmootherType =
     VectorNeighborhoodOperatorImageFilter<DisplacementFieldType, DisplacementFieldType>;
   GaussianSmoothingOperatorType m_GaussianSmoothingOperator{};
+
+private:
+  /** An image of the displacements in a buffer, of the same size as the
+   * displacement field, which is not copied. */
+  DisplacementFieldPointer
+  ImportDisplacementField(DisplacementVectorType * buffer) const;
+
+  /** Multithreader of the recursive filters, created on demand. */
+  MultiThreaderBase::Pointer m_RecursiveSmoothingMultiThreader{};
 };
 
 } // end namespace itk
@@ -24,11 +24,16 @@
 #include "itkImageAlgorithm.h"
 #include "itkImageDuplicator.h"
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkImportImageFilter.h"
+#include "itkImageRegionRange.h"
+#include "itkIndexRange.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
 #include "itkPrintHelper.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace itk
 {
 
@@ -47,12 +52,6 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
 {
   const DisplacementFieldPointer displacementField = this->GetModifiableDisplacementField();
 
-  const typename DisplacementFieldType::RegionType & bufferedRegion = displacementField->GetBufferedRegion();
-  const SizeValueType                                numberOfPixels = bufferedRegion.GetNumberOfPixels();
-
-  using ImporterType = ImportImageFilter<DisplacementVectorType, VDimension>;
-  const bool importFilterWillReleaseMemory = false;
-
   //
   // Smooth the update field
   //
@@ -69,22 +68,16 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
     auto * updateFieldPointer =
       reinterpret_cast<DisplacementVectorType *>(const_cast<DerivativeType &>(update).data_block());
 
-    auto importer = ImporterType::New();
-    importer->SetImportPointer(updateFieldPointer, numberOfPixels, importFilterWillReleaseMemory);
-    importer->SetRegion(displacementField->GetBufferedRegion());
-    importer->SetOrigin(displacementField->GetOrigin());
-    importer->SetSpacing(displacementField->GetSpacing());
-    importer->SetDirection(displacementField->GetDirection());
-
-    const DisplacementFieldPointer updateField = importer->GetOutput();
-    updateField->Update();
-    updateField->DisconnectPipeline();
+    const DisplacementFieldPointer updateField = this->ImportDisplacementField(updateFieldPointer);
 
     const DisplacementFieldPointer smoothedField =
       this->GaussianSmoothDisplacementField(updateField, this->m_GaussianSmoothingVarianceForTheUpdateField);
 
-    ImageAlgorithm::Copy<DisplacementFieldType, DisplacementFieldType>(
-      smoothedField, updateField, smoothedField->GetBufferedRegion(), updateField->GetBufferedRegion());
+    if (smoothedField != updateField)
+    {
+      ImageAlgorithm::Copy<DisplacementFieldType, DisplacementFieldType>(
+        smoothedField, updateField, smoothedField->GetBufferedRegion(), updateField->GetBufferedRegion());
+    }
   }
 
   //
@@ -106,25 +99,38 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
   {
     itkDebugMacro("Smooothing the total field.");
 
-    auto importer = ImporterType::New();
-    importer->SetImportPointer(displacementField->GetBufferPointer(), numberOfPixels, importFilterWillReleaseMemory);
-    importer->SetRegion(displacementField->GetBufferedRegion());
-    importer->SetOrigin(displacementField->GetOrigin());
-    importer->SetSpacing(displacementField->GetSpacing());
-    importer->SetDirection(displacementField->GetDirection());
-
-    const DisplacementFieldPointer totalField = importer->GetOutput();
-    totalField->Update();
-    totalField->DisconnectPipeline();
+    const DisplacementFieldPointer totalField = this->ImportDisplacementField(displacementField->GetBufferPointer());
 
     const DisplacementFieldPointer totalSmoothField =
       this->GaussianSmoothDisplacementField(totalField, this->m_GaussianSmoothingVarianceForTheTotalField);
 
-    ImageAlgorithm::Copy<DisplacementFieldType, DisplacementFieldType>(
-      totalSmoothField, totalField, totalSmoothField->GetBufferedRegion(), totalField->GetBufferedRegion());
+    if (totalSmoothField != totalField)
+    {
+      ImageAlgorithm::Copy<DisplacementFieldType, DisplacementFieldType>(
+        totalSmoothField, totalField, totalSmoothField->GetBufferedRegion(), totalField->GetBufferedRegion());
+    }
   }
 }
 
+template <typename TParametersValueType, unsigned int VDimension>
+auto
+GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimension>::ImportDisplacementField(
+  DisplacementVectorType * buffer) const -> DisplacementFieldPointer
+{
+  const DisplacementFieldType * displacementField = this->GetDisplacementField();
+
+  auto pixelContainer = DisplacementFieldType::PixelContainer::New();
+  pixelContainer->SetImportPointer(buffer, displacementField->GetBufferedRegion().GetNumberOfPixels(), false);
+
+  auto field = DisplacementFieldType::New();
+  field->SetRegions(displacementField->GetBufferedRegion());
+  field->SetOrigin(displacementField->GetOrigin());
+  field->SetSpacing(displacementField->GetSpacing());
+  field->SetDirection(displacementField->GetDirection());
+  field->SetPixelContainer(pixelContainer);
+  return field;
+}
+
 template <typename TParametersValueType, unsigned int VDimension>
 auto
 GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimension>::GaussianSmoothDisplacementField(
@@ -136,6 +142,26 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
     return field;
   }
 
+  if (this->m_UseRecursiveGaussianSmoothing && variance >= 0.5)
+  {
+    this->RecursiveGaussianSmoothDisplacementField(field, variance);
+
+    // make sure boundary does not move
+    constexpr DisplacementVectorType                 zeroVector{};
+    const typename DisplacementFieldType::RegionType region = field->GetBufferedRegion();
+    for (unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension)
+    {
+      auto face = region;
+      face.SetSize(dimension, 1);
+      const ImageRegionRange<DisplacementFieldType> lowerFace(*field, face);
+      std::fill(lowerFace.begin(), lowerFace.end(), zeroVector);
+      face.SetIndex(dimension, region.GetUpperIndex()[dimension]);
+      const ImageRegionRange<DisplacementFieldType> upperFace(*field, face);
+      std::fill(upperFace.begin(), upperFace.end(), zeroVector);
+    }
+    return field;
+  }
+
   using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
   auto duplicator = DuplicatorType::New();
   duplicator->SetInputImage(field);
@@ -196,7 +222,7 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
     for (unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension)
     {
       if (index[dimension] == startIndex[dimension] ||
-          index[dimension] == static_cast<IndexValueType>(size[dimension]) - startIndex[dimension] - 1)
+          index[dimension] == startIndex[dimension] + static_cast<IndexValueType>(size[dimension]) - 1)
       {
         isOnBoundary = true;
         break;
@@ -215,6 +241,121 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
   return field;
 }
 
+template <typename TParametersValueType, unsigned int VDimension>
+void
+GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimension>::
+  RecursiveGaussianSmoothDisplacementField(DisplacementFieldType * field, ScalarType variance)
+{
+  // Coefficients of the recursive filters of Young and van Vliet, with the
+  // initialization of the anticausal pass of Triggs and Sdika, as in
+  // RecursiveLineYvvGaussianImageFilter.
+  const double sigma = std::sqrt(static_cast<double>(variance));
+  const double q =
+    sigma >= 3.556 ? 0.9804 * (sigma - 3.556) + 2.5091 : 0.0561 * sigma * sigma + 0.5784 * sigma - 0.2568;
+
+  constexpr double m0 = 1.16680;
+  constexpr double m1 = 1.10783;
+  constexpr double m2 = 1.40586;
+  const double     scale = (m0 + q) * (m1 * m1 + m2 * m2 + 2 * m1 * q + q * q);
+
+  const double b1 = q * (2 * m0 * m1 + m1 * m1 + m2 * m2 + (2 * m0 + 4 * m1) * q + 3 * q * q) / scale;
+  const double b2 = -q * q * (m0 + 2 * m1 + 3 * q) / scale;
+  const double b3 = q * q * q / scale;
+  const double baseB = m0 * (m1 * m1 + m2 * m2) / scale;
+  const double b = baseB * baseB;
+
+  const double mNormalization = (1 + b1 - b2 + b3) * (1 - b1 - b2 - b3) * (1 + b2 + (b1 - b3) * b3);
+  const double mMatrix[3][3] = {
+    { (-b3 * b1 + 1 - b3 * b3 - b2) / mNormalization,
+      (b3 + b1) * (b2 + b3 * b1) / mNormalization,
+      b3 * (b1 + b3 * b2) / mNormalization },
+    { (b1 + b3 * b2) / mNormalization,
+      (1 - b2) * (b2 + b3 * b1) / mNormalization,
+      -b3 * (b3 * b1 + b3 * b3 + b2 - 1) / mNormalization },
+    { (b3 * b1 + b2 + b1 * b1 - b2 * b2) / mNormalization,
+      (b1 * b2 + b3 * b2 * b2 - b1 * b3 * b3 - b3 * b3 * b3 - b3 * b2 + b3) / mNormalization,
+      b3 * (b1 + b3 * b2) / mNormalization }
+  };
+  const double steadyStateGain = 1.0 / (1 - b1 - b2 - b3);
+
+  if (this->m_RecursiveSmoothingMultiThreader.IsNull())
+  {
+    this->m_RecursiveSmoothingMultiThreader = MultiThreaderBase::New();
+  }
+
+  const typename DisplacementFieldType::RegionType region = field->GetBufferedRegion();
+  DisplacementVectorType * const                   buffer = field->GetBufferPointer();
+
+  for (unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension)
+  {
+    const SizeValueType length = region.GetSize(dimension);
+    if (length < 3)
+    {
+      continue;
+    }
+    const OffsetValueType stride = field->GetOffsetTable()[dimension];
+
+    // Each line along the dimension starts at an index of this region.
+    auto linesRegion = region;
+    linesRegion.SetSize(dimension, 1);
+
+    this->m_RecursiveSmoothingMultiThreader->template ParallelizeImageRegion<VDimension>(
+      linesRegion,
+      [&](const typename DisplacementFieldType::RegionType & lines) {
+        std::vector<DisplacementVectorType> line(length);
+        for (const auto & index : ImageRegionIndexRange<VDimension>(lines))
+        {
+          DisplacementVectorType * const lineStart = buffer + field->ComputeOffset(index);
+          for (SizeValueType i = 0; i < length; ++i)
+          {
+            line[i] = lineStart[i * stride];
+          }
+          const DisplacementVectorType lastInput = line[length - 1];
+
+          // Causal pass, with the first value extended beyond the border.
+          DisplacementVectorType y1 = line[0] * steadyStateGain;
+          DisplacementVectorType y2 = y1;
+          DisplacementVectorType y3 = y1;
+          for (SizeValueType i = 0; i < length; ++i)
+          {
+            line[i] += y1 * b1 + y2 * b2 + y3 * b3;
+            y3 = y2;
+            y2 = y1;
+            y1 = line[i];
+          }
+
+          // Anticausal pass, initialized from the last value extended beyond
+          // the border.
+          const DisplacementVectorType up = lastInput * steadyStateGain;
+          const DisplacementVectorType vp = up * steadyStateGain;
+          DisplacementVectorType       v[3] = { vp, vp, vp };
+          for (unsigned int k = 0; k < 3; ++k)
+          {
+            for (unsigned int i = 0; i < 3; ++i)
+            {
+              v[k] += (line[length - 1 - i] - up) * mMatrix[k][i];
+            }
+            v[k] *= b;
+          }
+          line[length - 1] = v[0];
+          for (SizeValueType i = length - 1; i-- > 0;)
+          {
+            line[i] = line[i] * b + v[0] * b1 + v[1] * b2 + v[2] * b3;
+            v[2] = v[1];
+            v[1] = v[0];
+            v[0] = line[i];
+          }
+
+          for (SizeValueType i = 0; i < length; ++i)
+          {
+            lineStart[i * stride] = line[i];
+          }
+        }
+      },
+      nullptr);
+  }
+}
+
 template <typename TParametersValueType, unsigned int VDimension>
 LightObject::Pointer
 GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimension>::InternalClone() const
@@ -231,6 +372,7 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
   // set fields not in the fixed parameters.
   rval->SetGaussianSmoothingVarianceForTheUpdateField(this->GetGaussianSmoothingVarianceForTheUpdateField());
   rval->SetGaussianSmoothingVarianceForTheTotalField(this->GetGaussianSmoothingVarianceForTheTotalField());
+  rval->SetUseRecursiveGaussianSmoothing(this->GetUseRecursiveGaussianSmoothing());
 
   rval->SetFixedParameters(this->GetFixedParameters());
   rval->SetParameters(this->GetParameters());
@@ -249,6 +391,7 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, VDimen
     os, indent, "GaussianSmoothingVarianceForTheUpdateField", m_GaussianSmoothingVarianceForTheUpdateField);
   print_helper::PrintNumericTrait(
     os, indent, "GaussianSmoothingVarianceForTheTotalField", m_GaussianSmoothingVarianceForTheTotalField);
+  itkPrintSelfBooleanMacro(UseRecursiveGaussianSmoothing);
   os << indent << "GaussianSmoothingOperator: " << m_GaussianSmoothingOperator << std::endl;
 }
 } // namespace itk
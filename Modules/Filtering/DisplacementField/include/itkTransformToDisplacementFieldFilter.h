@@ -43,6 +43,19 @@ namespace itk
  * This filter is implemented as a multithreaded filter.  It provides a
  * ThreadedGenerateData() method for its implementation.
  *
+ * The output may be used by a DisplacementFieldTransform in place of the
+ * transform, for instance of a CompositeTransform, so that resampling
+ * through it looks up a single displacement per point. When
+ * EstimateInterpolationError is on, the filter estimates the error of the
+ * linear interpolation of the displacements between the pixels: it is the
+ * largest distance, at the centers of the cells of 2^N pixels, between the
+ * displacement of the transform and the mean displacement of the pixels of
+ * the cell. It is only an estimate, not a bound: the error is sampled at
+ * the centers of the cells, where it is typically the largest for
+ * transforms which are smooth at the scale of the spacing, and may be
+ * larger elsewhere for the others. The spacing of the output may then be
+ * decreased until the estimate is small enough.
+ *
  * \author Marius Staring, Leiden University Medical Center, The Netherlands.
  *
  * This class was taken from the Insight Journal paper:
@@ -157,6 +170,19 @@ public:
   itkBooleanMacro(UseReferenceImage);
   itkGetConstMacro(UseReferenceImage, bool);
   /** @ITKEndGrouping */
+  /** Turn on/off the estimation of the error of the linear interpolation of
+   * the output. Off by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(EstimateInterpolationError, bool);
+  itkBooleanMacro(EstimateInterpolationError);
+  itkGetConstMacro(EstimateInterpolationError, bool);
+  /** @ITKEndGrouping */
+
+  /** Get the estimate of the largest error of the linear interpolation of
+   * the output, in physical units, sampled at the centers of its cells, when
+   * EstimateInterpolationError is on. */
+  itkGetConstMacro(EstimatedInterpolationError, double);
+
   static constexpr unsigned int PixelDimension = PixelType::Dimension;
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<ImageDimension, PixelDimension>));
 
@@ -185,6 +211,11 @@ protected:
   void
   LinearThreadedGenerateData(const OutputImageRegionType & outputRegionForThread);
 
+  /** Estimates the error of the linear interpolation of the output, when
+   * EstimateInterpolationError is on. */
+  void
+  AfterThreadedGenerateData() override;
+
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
@@ -196,6 +227,8 @@ private:
   OriginType    m_OutputOrigin{};     // output image origin
   DirectionType m_OutputDirection{};  // output image direction cosines
   bool          m_UseReferenceImage{ false };
+  bool          m_EstimateInterpolationError{ false };
+  double        m_EstimatedInterpolationError{ 0.0 };
 };
 } // end namespace itk
 
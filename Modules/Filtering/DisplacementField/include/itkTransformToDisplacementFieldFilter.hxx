@@ -22,6 +22,10 @@
 #include "itkIdentityTransform.h"
 #include "itkTotalProgressReporter.h"
 #include "itkImageScanlineIterator.h"
+#include "itkIndexRange.h"
+
+#include <algorithm>
+#include <mutex>
 
 namespace itk
 {
@@ -67,6 +71,8 @@ TransformToDisplacementFieldFilter<TOutputImage, TParametersValueType>::PrintSel
   {
     os << "Off" << std::endl;
   }
+  itkPrintSelfBooleanMacro(EstimateInterpolationError);
+  os << indent << "EstimatedInterpolationError: " << this->m_EstimatedInterpolationError << std::endl;
 }
 
 
@@ -270,6 +276,85 @@ TransformToDisplacementFieldFilter<TOutputImage, TParametersValueType>::LinearTh
   }
 }
 
+
+template <typename TOutputImage, typename TParametersValueType>
+void
+TransformToDisplacementFieldFilter<TOutputImage, TParametersValueType>::AfterThreadedGenerateData()
+{
+  this->m_EstimatedInterpolationError = 0.0;
+  if (!this->m_EstimateInterpolationError)
+  {
+    return;
+  }
+
+  const OutputImageType * output = this->GetOutput();
+  const TransformType *   transform = this->GetInput()->Get();
+
+  // The cells are indexed by their first pixel. A dimension of a single
+  // pixel is not interpolated.
+  const OutputImageRegionType & requestedRegion = output->GetRequestedRegion();
+  OutputImageRegionType         cells = requestedRegion;
+  unsigned int                  numberOfCorners = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    if (requestedRegion.GetSize(i) > 1)
+    {
+      cells.SetSize(i, requestedRegion.GetSize(i) - 1);
+      numberOfCorners *= 2;
+    }
+  }
+
+  std::mutex mutex;
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    cells,
+    [this, output, transform, &requestedRegion, numberOfCorners, &mutex](const OutputImageRegionType & region) {
+      double maximumError = 0.0;
+      for (const IndexType & index : ImageRegionIndexRange<ImageDimension>(region))
+      {
+        // The linear interpolation at the center of the cell is the mean of
+        // its pixels.
+        Vector<double, ImageDimension> interpolatedDisplacement{};
+        for (unsigned int corner = 0; corner < numberOfCorners; ++corner)
+        {
+          IndexType    cornerIndex = index;
+          unsigned int bit = 0;
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+            if (requestedRegion.GetSize(i) > 1)
+            {
+              cornerIndex[i] += (corner >> bit++) & 1;
+            }
+          }
+          const PixelType & displacement = output->GetPixel(cornerIndex);
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+            interpolatedDisplacement[i] += displacement[i] / static_cast<double>(numberOfCorners);
+          }
+        }
+
+        ContinuousIndex<double, ImageDimension> center(index);
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+          if (requestedRegion.GetSize(i) > 1)
+          {
+            center[i] += 0.5;
+          }
+        }
+        const PointType point = output->template TransformContinuousIndexToPhysicalPoint<double>(center);
+        const auto      displacement = transform->TransformPoint(point) - point;
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+          interpolatedDisplacement[i] -= displacement[i];
+        }
+        maximumError = std::max(maximumError, interpolatedDisplacement.GetNorm());
+      }
+
+      const std::lock_guard<std::mutex> lock(mutex);
+      this->m_EstimatedInterpolationError = std::max(this->m_EstimatedInterpolationError, maximumError);
+    },
+    nullptr);
+}
+
 } // end namespace itk
 
 #endif
@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the time GaussianSmoothingOnUpdateDisplacementFieldTransform
+// takes to smooth a 3D update field with the GaussianOperator and with the
+// recursive filters, for variances of 1, 4 and 16 pixels squared, and
+// reports the maximum difference between their displacements, which range
+// from -1 to 1 before smoothing.
+//
+// The benchmark is built into ITKDisplacementFieldTestDriver but, like the
+// ones of the PerformanceBenchmarking remote module, not registered as a
+// test; the recursive smoothing is checked against the GaussianOperator by
+// itkGaussianSmoothingOnUpdateDisplacementFieldTransformGTest. Run it as
+//   ITKDisplacementFieldTestDriver itkGaussianSmoothingOnUpdateDisplacementFieldTransformBenchmark
+//     size [iterations]
+// e.g. a size of 256 benchmarks 256^3 fields.
+
+#include "itkGaussianSmoothingOnUpdateDisplacementFieldTransform.h"
+#include "itkImageBufferRange.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+using TransformType = itk::GaussianSmoothingOnUpdateDisplacementFieldTransform<float, 3>;
+using FieldType = TransformType::DisplacementFieldType;
+
+FieldType::Pointer
+MakeZeroField(itk::SizeValueType size)
+{
+  auto field = FieldType::New();
+  field->SetRegions(FieldType::SizeType::Filled(size));
+  field->AllocateInitialized();
+  return field;
+}
+
+float
+MaximumDifference(const FieldType * field1, const FieldType * field2)
+{
+  const auto range1 = itk::MakeImageBufferRange(field1);
+  const auto range2 = itk::MakeImageBufferRange(field2);
+  float      difference = 0.0f;
+  for (auto it1 = range1.cbegin(), it2 = range2.cbegin(); it1 != range1.cend(); ++it1, ++it2)
+  {
+    difference = std::max(difference, static_cast<float>((*it1 - *it2).GetNorm()));
+  }
+  return difference;
+}
+} // namespace
+
+int
+itkGaussianSmoothingOnUpdateDisplacementFieldTransformBenchmark(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " size [iterations]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto         size = static_cast<itk::SizeValueType>(std::stoul(argv[1]));
+  const unsigned int iterations = argc > 2 ? std::stoi(argv[2]) : 1;
+
+  // Displacements from -1 to 1, as the update.
+  const FieldType::Pointer updateField = MakeZeroField(size);
+  std::mt19937                          generator(1);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  for (auto & displacement : itk::MakeImageBufferRange(updateField.GetPointer()))
+  {
+    for (auto & component : displacement)
+    {
+      component = distribution(generator);
+    }
+  }
+  const TransformType::DerivativeType initialUpdate(&updateField->GetBufferPointer()[0][0],
+                                                    3 * updateField->GetBufferedRegion().GetNumberOfPixels());
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+  for (const double variance : { 1.0, 4.0, 16.0 })
+  {
+    const std::string label = "variance " + std::to_string(static_cast<int>(variance));
+
+    FieldType::Pointer fields[2];
+    for (const bool recursive : { false, true })
+    {
+      auto transform = TransformType::New();
+      transform->SetGaussianSmoothingVarianceForTheUpdateField(variance);
+      transform->SetGaussianSmoothingVarianceForTheTotalField(0.0);
+      transform->SetUseRecursiveGaussianSmoothing(recursive);
+
+      const std::string name = label + (recursive ? " recursive" : " operator");
+      for (unsigned int i = 0; i < iterations; ++i)
+      {
+        fields[recursive] = MakeZeroField(size);
+        transform->SetDisplacementField(fields[recursive]);
+        TransformType::DerivativeType update(initialUpdate);
+        collector.Start(name.c_str());
+        transform->UpdateTransformParameters(update, 1.0);
+        collector.Stop(name.c_str());
+      }
+    }
+
+    const float difference = MaximumDifference(fields[true], fields[false]);
+    std::cout << label << " maximum difference of the recursive to the operator smoothing: " << difference
+              << std::endl;
+    // The recursive filters approximate the Gaussian less closely for the
+    // small variances.
+    if (difference > 0.1f)
+    {
+      std::cerr << "Error: " << label << " recursive and operator smoothing differ" << std::endl;
+      ok = false;
+    }
+  }
+
+  collector.Report(std::cout);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkGaussianSmoothingOnUpdateDisplacementFieldTransform.h"
+
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+constexpr unsigned int Dimension{ 2 };
+using TransformType = itk::GaussianSmoothingOnUpdateDisplacementFieldTransform<double, Dimension>;
+using FieldType = TransformType::DisplacementFieldType;
+
+const FieldType::RegionType fieldRegion({ { 2, -3 } }, { { 40, 30 } });
+
+// The update, smooth and distinct along each component, whose wavelengths
+// are a few times the standard deviations of the smoothing.
+TransformType::OutputVectorType
+UpdateAt(const FieldType::IndexType & index)
+{
+  constexpr double twoPi = 2.0 * itk::Math::pi;
+  const double     x = index[0] - fieldRegion.GetIndex(0);
+  const double     y = index[1] - fieldRegion.GetIndex(1);
+  TransformType::OutputVectorType update;
+  update[0] = 2.0 + std::sin(twoPi * x / 40.0) * std::cos(twoPi * y / 60.0);
+  update[1] = -1.5 + 0.5 * std::cos(twoPi * (x + y) / 35.0);
+  return update;
+}
+
+// Returns the field of a transform whose update field is smoothed.
+FieldType::Pointer
+SmoothUpdateField(double variance, bool useRecursiveGaussianSmoothing)
+{
+  auto field = FieldType::New();
+  field->SetRegions(fieldRegion);
+  field->AllocateInitialized();
+
+  auto transform = TransformType::New();
+  transform->SetGaussianSmoothingVarianceForTheUpdateField(variance);
+  transform->SetGaussianSmoothingVarianceForTheTotalField(0.0);
+  transform->SetUseRecursiveGaussianSmoothing(useRecursiveGaussianSmoothing);
+  transform->SetDisplacementField(field);
+
+  TransformType::DerivativeType update(transform->GetNumberOfParameters());
+  for (itk::ImageRegionConstIteratorWithIndex<FieldType> it(field, fieldRegion); !it.IsAtEnd(); ++it)
+  {
+    const itk::OffsetValueType offset = field->ComputeOffset(it.GetIndex());
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      update[offset * Dimension + d] = UpdateAt(it.GetIndex())[d];
+    }
+  }
+  transform->UpdateTransformParameters(update, 1.0);
+  return field;
+}
+} // namespace
+
+
+TEST(GaussianSmoothingOnUpdateDisplacementFieldTransform, RecursiveSmoothingApproximatesOperator)
+{
+  for (const double variance : { 0.25, 4.0, 9.0 })
+  {
+    const FieldType::Pointer operatorField = SmoothUpdateField(variance, false);
+    const FieldType::Pointer recursiveField = SmoothUpdateField(variance, true);
+
+    // Relative to the smoothed displacements: the recursive filters of Young
+    // and van Vliet attenuate these wavelengths slightly more than the
+    // discrete Gaussian kernel, by about 1.5% of the displacements at most.
+    const double tolerance = variance < 0.5 ? 1e-12 : 0.02;
+    double       largestSmoothing = 0.0;
+    for (itk::ImageRegionConstIteratorWithIndex<FieldType> it(recursiveField, fieldRegion); !it.IsAtEnd(); ++it)
+    {
+      const FieldType::IndexType index = it.GetIndex();
+      bool                       isOnBoundary = false;
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        isOnBoundary |= index[d] == fieldRegion.GetIndex(d) || index[d] == fieldRegion.GetUpperIndex()[d];
+      }
+      if (isOnBoundary)
+      {
+        EXPECT_EQ(it.Get().GetNorm(), 0.0) << index;
+        continue;
+      }
+      const FieldType::PixelType & expected = operatorField->GetPixel(index);
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        EXPECT_NEAR(it.Get()[d], expected[d], tolerance * std::abs(expected[d])) << index << " component " << d;
+      }
+      largestSmoothing = std::max(largestSmoothing, (expected - UpdateAt(index)).GetNorm());
+    }
+
+    // The smoothing changed the update noticeably.
+    if (variance > 0.5)
+    {
+      EXPECT_GT(largestSmoothing, 0.05) << "variance " << variance;
+    }
+  }
+}
+
+
+TEST(GaussianSmoothingOnUpdateDisplacementFieldTransform, CloneKeepsRecursiveSmoothing)
+{
+  auto transform = TransformType::New();
+  EXPECT_FALSE(transform->GetUseRecursiveGaussianSmoothing());
+  transform->UseRecursiveGaussianSmoothingOn();
+
+  auto field = FieldType::New();
+  field->SetRegions(FieldType::SizeType::Filled(8));
+  field->AllocateInitialized();
+  transform->SetDisplacementField(field);
+
+  const TransformType::Pointer clone = transform->Clone();
+  EXPECT_TRUE(clone->GetUseRecursiveGaussianSmoothing());
+}
@@ -0,0 +1,118 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkTransformToDisplacementFieldFilter.h"
+
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkDisplacementFieldTransform.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+
+namespace
+{
+constexpr unsigned int Dimension{ 2 };
+using TransformType = itk::Transform<double, Dimension, Dimension>;
+using FieldType = itk::Image<itk::Vector<double, Dimension>, Dimension>;
+using FilterType = itk::TransformToDisplacementFieldFilter<FieldType, double>;
+
+// Returns an affine transform, applied after a B-spline transform.
+itk::CompositeTransform<double, Dimension>::Pointer
+CreateCompositeTransform()
+{
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  const auto bspline = BSplineTransformType::New();
+  bspline->SetTransformDomainPhysicalDimensions(itk::MakeVector(64.0, 64.0));
+  bspline->SetTransformDomainMeshSize(BSplineTransformType::MeshSizeType::Filled(4));
+  auto parameters = bspline->GetParameters();
+  for (unsigned int i = 0; i < parameters.size(); ++i)
+  {
+    parameters[i] = 2.0 * std::sin(static_cast<double>(i));
+  }
+  bspline->SetParametersByValue(parameters);
+
+  const auto affine = itk::AffineTransform<double, Dimension>::New();
+  affine->Rotate2D(0.2);
+  affine->Translate(itk::MakeVector(3.0, -1.0));
+
+  const auto transform = itk::CompositeTransform<double, Dimension>::New();
+  transform->AddTransform(affine);
+  transform->AddTransform(bspline);
+  return transform;
+}
+
+FilterType::Pointer
+CreateFilter(const TransformType * transform, double spacing)
+{
+  const auto filter = FilterType::New();
+  filter->SetTransform(transform);
+  filter->SetOutputSpacing(itk::MakeVector(spacing, spacing));
+  filter->SetSize(FieldType::SizeType::Filled(static_cast<itk::SizeValueType>(std::lround(64.0 / spacing)) + 1));
+  filter->EstimateInterpolationErrorOn();
+  filter->Update();
+  return filter;
+}
+} // namespace
+
+
+TEST(TransformToDisplacementFieldFilter, EstimatesInterpolationError)
+{
+  const auto transform = CreateCompositeTransform();
+  const auto filter = CreateFilter(transform, 4.0);
+  const auto finerFilter = CreateFilter(transform, 2.0);
+
+  const double estimatedError = filter->GetEstimatedInterpolationError();
+  EXPECT_GT(estimatedError, 0.0);
+  EXPECT_LT(finerFilter->GetEstimatedInterpolationError(), estimatedError);
+
+  // The displacement field transform matches the transform at the centers of
+  // the cells, where the error is sampled, up to the estimated error.
+  const auto displacementFieldTransform = itk::DisplacementFieldTransform<double, Dimension>::New();
+  displacementFieldTransform->SetDisplacementField(filter->GetOutput());
+  for (double x = 2.0; x < 64.0; x += 4.0)
+  {
+    for (double y = 2.0; y < 64.0; y += 4.0)
+    {
+      const auto point = itk::MakePoint(x, y);
+      const auto error = displacementFieldTransform->TransformPoint(point) - transform->TransformPoint(point);
+      EXPECT_LE(error.GetNorm(), estimatedError + 1e-9) << "at " << point;
+    }
+  }
+}
+
+
+TEST(TransformToDisplacementFieldFilter, InterpolatesLinearTransformsExactly)
+{
+  const auto transform = itk::AffineTransform<double, Dimension>::New();
+  transform->Rotate2D(0.3);
+  transform->Scale(1.2);
+
+  const auto filter = FilterType::New();
+  EXPECT_FALSE(filter->GetEstimateInterpolationError());
+  filter->SetTransform(transform);
+  filter->SetSize(FieldType::SizeType{ { 8, 1 } });
+  filter->Update();
+  EXPECT_EQ(filter->GetEstimatedInterpolationError(), 0.0);
+
+  EXPECT_NEAR(CreateFilter(transform, 4.0)->GetEstimatedInterpolationError(), 0.0, 1e-9);
+}
@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkTotalProgressReporter.h"
 
 
 #include <functional>
@@ -45,6 +46,13 @@ namespace itk
  * the pipeline. The SetConstant() and GetConstant() methods are provided as shortcuts
  * to set or get the constant value without manipulating the decorator.
  *
+ * A functor object may additionally provide a batch overload,
+ * `void operator()(const Input1 *, const Input2 *, Output *, SizeValueType n) const`,
+ * computing n contiguous output pixels at once. When all images are
+ * itk::Image objects, the filter passes whole scanlines to that overload
+ * so that the loop can be vectorized by the compiler.
+ *
+ * \sa Functor::BatchTraits
  * \sa UnaryGeneratorImageFilter
  * \sa BinaryFunctorImageFilter
  *
@@ -256,6 +264,19 @@ protected:
   GenerateOutputInformation() override;
 
 private:
+  /** Batch execution path, used when the functor provides an overload of
+   * operator() which processes a whole scanline of contiguous pixels at a
+   * time, and all images store their scanlines contiguously.
+   * \sa Functor::BatchTraits */
+  template <typename TFunctor>
+  void
+  DynamicThreadedGenerateDataWithBatchFunctor(const TFunctor &              functor,
+                                              const TInputImage1 *          inputPtr1,
+                                              const TInputImage2 *          inputPtr2,
+                                              TOutputImage *                outputPtr,
+                                              const OutputImageRegionType & outputRegionForThread,
+                                              TotalProgressReporter &       progress);
+
   std::function<void(const OutputImageRegionType &)> m_DynamicThreadedGenerateDataFunction{};
 };
 } // end namespace itk
@@ -18,9 +18,12 @@
 #ifndef itkBinaryGeneratorImageFilter_hxx
 #define itkBinaryGeneratorImageFilter_hxx
 
+#include "itkFunctorBatchTraits.h"
 #include "itkImageScanlineIterator.h"
 #include "itkTotalProgressReporter.h"
 
+#include <vector>
+
 
 namespace itk
 {
@@ -186,6 +189,13 @@ BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::DynamicThr
 
   TotalProgressReporter progress(this, outputPtr->GetRequestedRegion().GetNumberOfPixels());
 
+  if constexpr (Functor::BatchTraits::UseBinaryBatch<TFunctor, TInputImage1, TInputImage2, TOutputImage>)
+  {
+    this->DynamicThreadedGenerateDataWithBatchFunctor(
+      functor, inputPtr1, inputPtr2, outputPtr, outputRegionForThread, progress);
+    return;
+  }
+
   if (inputPtr1 && inputPtr2)
   {
     ImageScanlineConstIterator inputIt1(inputPtr1, outputRegionForThread);
@@ -253,6 +263,74 @@ BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::DynamicThr
     itkGenericExceptionMacro("At most one of the inputs can be a constant.");
   }
 }
+
+template <typename TInputImage1, typename TInputImage2, typename TOutputImage>
+template <typename TFunctor>
+void
+BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::DynamicThreadedGenerateDataWithBatchFunctor(
+  const TFunctor &              functor,
+  const TInputImage1 *          inputPtr1,
+  const TInputImage2 *          inputPtr2,
+  TOutputImage *                outputPtr,
+  const OutputImageRegionType & outputRegionForThread,
+  TotalProgressReporter &       progress)
+{
+  const SizeValueType lineLength = outputRegionForThread.GetSize()[0];
+
+  ImageScanlineIterator outputIt(outputPtr, outputRegionForThread);
+
+  if (inputPtr1 && inputPtr2)
+  {
+    ImageScanlineConstIterator inputIt1(inputPtr1, outputRegionForThread);
+    ImageScanlineConstIterator inputIt2(inputPtr2, outputRegionForThread);
+
+    while (!inputIt1.IsAtEnd())
+    {
+      functor(&inputIt1.Value(), &inputIt2.Value(), &outputIt.Value(), lineLength);
+
+      inputIt1.NextLine();
+      inputIt2.NextLine();
+      outputIt.NextLine();
+      progress.Completed(lineLength);
+    }
+  }
+  else if (inputPtr1)
+  {
+    ImageScanlineConstIterator inputIt1(inputPtr1, outputRegionForThread);
+
+    // The constant is replicated over one scanline so that it can be passed
+    // to the batch functor like an image line.
+    const std::vector<Input2ImagePixelType> input2Line(lineLength, this->GetConstant2());
+
+    while (!inputIt1.IsAtEnd())
+    {
+      functor(&inputIt1.Value(), input2Line.data(), &outputIt.Value(), lineLength);
+
+      inputIt1.NextLine();
+      outputIt.NextLine();
+      progress.Completed(lineLength);
+    }
+  }
+  else if (inputPtr2)
+  {
+    ImageScanlineConstIterator inputIt2(inputPtr2, outputRegionForThread);
+
+    const std::vector<Input1ImagePixelType> input1Line(lineLength, this->GetConstant1());
+
+    while (!inputIt2.IsAtEnd())
+    {
+      functor(input1Line.data(), &inputIt2.Value(), &outputIt.Value(), lineLength);
+
+      inputIt2.NextLine();
+      outputIt.NextLine();
+      progress.Completed(lineLength);
+    }
+  }
+  else
+  {
+    itkGenericExceptionMacro("At most one of the inputs can be a constant.");
+  }
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,94 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFunctorBatchTraits_h
+#define itkFunctorBatchTraits_h
+
+#include "itkImage.h"
+
+#include <type_traits>
+#include <utility>
+
+// Meta programming helpers used by the generator image filters to detect
+// functors which provide a batch (scanline) overload of operator().
+//
+// A unary functor opts in by providing
+//   void operator()(const TInput * in, TOutput * out, SizeValueType n) const;
+// and a binary functor by providing
+//   void operator()(const TInput1 * in1, const TInput2 * in2, TOutput * out, SizeValueType n) const;
+// in addition to the per-pixel operator(). The batch overload must compute
+// out[i] exactly as the per-pixel overload would for every i < n, and must
+// tolerate `out` aliasing one of the inputs (in-place execution).
+namespace itk::Functor::BatchTraits
+{
+
+/** True when the pixels of a scanline of TImage are stored contiguously in
+ * the buffer, and the buffer holds values of TImage::PixelType. */
+template <typename TImage>
+constexpr bool IsContiguousScanlineImage =
+  std::is_same_v<std::remove_const_t<TImage>, Image<typename TImage::PixelType, TImage::ImageDimension>>;
+
+template <typename TFunctor, typename TInput, typename TOutput, typename = void>
+struct HasUnaryBatchOperator : std::false_type
+{};
+
+template <typename TFunctor, typename TInput, typename TOutput>
+struct HasUnaryBatchOperator<TFunctor,
+                             TInput,
+                             TOutput,
+                             std::void_t<decltype(std::declval<const TFunctor &>()(
+                               std::declval<const TInput *>(), std::declval<TOutput *>(), SizeValueType{}))>>
+  : std::true_type
+{};
+
+template <typename TFunctor, typename TInput1, typename TInput2, typename TOutput, typename = void>
+struct HasBinaryBatchOperator : std::false_type
+{};
+
+template <typename TFunctor, typename TInput1, typename TInput2, typename TOutput>
+struct HasBinaryBatchOperator<TFunctor,
+                              TInput1,
+                              TInput2,
+                              TOutput,
+                              std::void_t<decltype(std::declval<const TFunctor &>()(std::declval<const TInput1 *>(),
+                                                                                    std::declval<const TInput2 *>(),
+                                                                                    std::declval<TOutput *>(),
+                                                                                    SizeValueType{}))>>
+  : std::true_type
+{};
+
+/** True when UnaryGeneratorImageFilter may feed whole scanlines of
+ * TInputImage and TOutputImage to the batch overload of TFunctor. */
+template <typename TFunctor, typename TInputImage, typename TOutputImage>
+constexpr bool UseUnaryBatch =
+  IsContiguousScanlineImage<TInputImage> && IsContiguousScanlineImage<TOutputImage> &&
+  TInputImage::ImageDimension == TOutputImage::ImageDimension &&
+  HasUnaryBatchOperator<TFunctor, typename TInputImage::PixelType, typename TOutputImage::PixelType>::value;
+
+/** True when BinaryGeneratorImageFilter may feed whole scanlines of the
+ * input and output images to the batch overload of TFunctor. */
+template <typename TFunctor, typename TInputImage1, typename TInputImage2, typename TOutputImage>
+constexpr bool UseBinaryBatch = IsContiguousScanlineImage<TInputImage1> && IsContiguousScanlineImage<TInputImage2> &&
+                                IsContiguousScanlineImage<TOutputImage> &&
+                                HasBinaryBatchOperator<TFunctor,
+                                                       typename TInputImage1::PixelType,
+                                                       typename TInputImage2::PixelType,
+                                                       typename TOutputImage::PixelType>::value;
+
+} // namespace itk::Functor::BatchTraits
+
+#endif
@@ -0,0 +1,308 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFusedFunctorImageFilter_h
+#define itkFusedFunctorImageFilter_h
+
+#include "itkUnaryGeneratorImageFilter.h"
+#include "itkFunctorBatchTraits.h"
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+
+namespace itk
+{
+namespace Functor
+{
+/** \class Composition
+ * \brief Functor applying a sequence of functors, each one to the result of
+ * the previous one.
+ *
+ * The first functor is given the pixels of the input images, and each of the
+ * following functors the result of the previous one: Composition<F, G, H>
+ * computes h(g(f(p))) for a pixel p, or h(g(f(p1, p2))) for the pixels of two
+ * images.
+ *
+ * The composition provides the batch overloads of operator() used by the
+ * generator image filters on contiguous scanlines (see
+ * Functor::BatchTraits). They pass the scanlines through the functors in
+ * chunks of ChunkSize pixels, holding the intermediate results in buffers
+ * small enough to stay in the cache, and use the batch overloads of the
+ * composed functors when they provide them. Intermediate results which are
+ * not trivially copyable are not buffered: the remaining functors are then
+ * applied pixel by pixel.
+ *
+ * \sa Compose()
+ * \sa FusedFunctorImageFilter
+ * \ingroup ITKImageFilterBase
+ */
+template <typename TFirstFunctor, typename... TFunctors>
+class ITK_TEMPLATE_EXPORT Composition
+{
+public:
+  /** Number of pixels passed through the functors at once by the batch
+   * overloads. */
+  static constexpr SizeValueType ChunkSize = 256;
+
+  static constexpr unsigned int NumberOfFunctors = 1 + sizeof...(TFunctors);
+
+  Composition() = default;
+
+  explicit Composition(const TFirstFunctor & firstFunctor, const TFunctors &... functors)
+    : m_Functors(firstFunctor, functors...)
+  {}
+
+  /** Per-pixel overload, for as many input pixels as the first functor
+   * takes. */
+  template <typename... TInputs,
+            typename = std::enable_if_t<std::is_invocable_v<const TFirstFunctor &, const TInputs &...>>>
+  auto
+  operator()(const TInputs &... inputs) const
+  {
+    return this->ApplyFrom<1>(std::get<0>(m_Functors)(inputs...));
+  }
+
+  /** Batch overload for a unary first functor. */
+  template <typename TInput,
+            typename TOutput,
+            typename = std::enable_if_t<std::is_invocable_v<const TFirstFunctor &, const TInput &>>>
+  void
+  operator()(const TInput * input, TOutput * output, SizeValueType n) const
+  {
+    for (SizeValueType i = 0; i < n; i += ChunkSize)
+    {
+      this->ApplyChunkFrom<0>(input + i, output + i, std::min(ChunkSize, n - i));
+    }
+  }
+
+  /** Batch overload for a binary first functor. */
+  template <typename TInput1,
+            typename TInput2,
+            typename TOutput,
+            typename = std::enable_if_t<std::is_invocable_v<const TFirstFunctor &, const TInput1 &, const TInput2 &>>>
+  void
+  operator()(const TInput1 * input1, const TInput2 * input2, TOutput * output, SizeValueType n) const
+  {
+    using ResultType = std::decay_t<std::invoke_result_t<const TFirstFunctor &, const TInput1 &, const TInput2 &>>;
+    const TFirstFunctor & functor = std::get<0>(m_Functors);
+
+    if constexpr (NumberOfFunctors == 1)
+    {
+      ApplyBinaryBatch(functor, input1, input2, output, n);
+    }
+    else if constexpr (IsBufferable<ResultType>)
+    {
+      for (SizeValueType i = 0; i < n; i += ChunkSize)
+      {
+        const SizeValueType               chunkSize = std::min(ChunkSize, n - i);
+        std::array<ResultType, ChunkSize> results;
+        ApplyBinaryBatch(functor, input1 + i, input2 + i, results.data(), chunkSize);
+        this->ApplyChunkFrom<1>(results.data(), output + i, chunkSize);
+      }
+    }
+    else
+    {
+      for (SizeValueType i = 0; i < n; ++i)
+      {
+        output[i] = (*this)(input1[i], input2[i]);
+      }
+    }
+  }
+
+private:
+  template <typename TValue>
+  static constexpr bool IsBufferable = std::is_trivially_copyable_v<TValue> && std::is_default_constructible_v<TValue>;
+
+  template <std::size_t VIndex, typename TValue>
+  auto
+  ApplyFrom(const TValue & value) const
+  {
+    if constexpr (VIndex == NumberOfFunctors)
+    {
+      return value;
+    }
+    else
+    {
+      return this->ApplyFrom<VIndex + 1>(std::get<VIndex>(m_Functors)(value));
+    }
+  }
+
+  // Passes a chunk of values through the functors from the one of index
+  // VIndex on.
+  template <std::size_t VIndex, typename TValue, typename TOutput>
+  void
+  ApplyChunkFrom(const TValue * values, TOutput * output, SizeValueType n) const
+  {
+    using FunctorType = std::tuple_element_t<VIndex, std::tuple<TFirstFunctor, TFunctors...>>;
+    using ResultType = std::decay_t<std::invoke_result_t<const FunctorType &, const TValue &>>;
+    const FunctorType & functor = std::get<VIndex>(m_Functors);
+
+    if constexpr (VIndex + 1 == NumberOfFunctors)
+    {
+      ApplyUnaryBatch(functor, values, output, n);
+    }
+    else if constexpr (IsBufferable<ResultType>)
+    {
+      std::array<ResultType, ChunkSize> results;
+      ApplyUnaryBatch(functor, values, results.data(), n);
+      this->ApplyChunkFrom<VIndex + 1>(results.data(), output, n);
+    }
+    else
+    {
+      for (SizeValueType i = 0; i < n; ++i)
+      {
+        output[i] = this->ApplyFrom<VIndex + 1>(functor(values[i]));
+      }
+    }
+  }
+
+  template <typename TFunctor, typename TInput, typename TOutput>
+  static void
+  ApplyUnaryBatch(const TFunctor & functor, const TInput * input, TOutput * output, SizeValueType n)
+  {
+    if constexpr (BatchTraits::HasUnaryBatchOperator<TFunctor, TInput, TOutput>::value)
+    {
+      functor(input, output, n);
+    }
+    else
+    {
+      for (SizeValueType i = 0; i < n; ++i)
+      {
+        output[i] = functor(input[i]);
+      }
+    }
+  }
+
+  template <typename TFunctor, typename TInput1, typename TInput2, typename TOutput>
+  static void
+  ApplyBinaryBatch(const TFunctor & functor,
+                   const TInput1 *  input1,
+                   const TInput2 *  input2,
+                   TOutput *        output,
+                   SizeValueType    n)
+  {
+    if constexpr (BatchTraits::HasBinaryBatchOperator<TFunctor, TInput1, TInput2, TOutput>::value)
+    {
+      functor(input1, input2, output, n);
+    }
+    else
+    {
+      for (SizeValueType i = 0; i < n; ++i)
+      {
+        output[i] = functor(input1[i], input2[i]);
+      }
+    }
+  }
+
+  std::tuple<TFirstFunctor, TFunctors...> m_Functors{};
+};
+
+/** Compose functors, or function pointers, in the order in which they are
+ * applied to a pixel. */
+template <typename... TFunctors>
+Composition<std::decay_t<TFunctors>...>
+Compose(const TFunctors &... functors)
+{
+  return Composition<std::decay_t<TFunctors>...>(functors...);
+}
+} // end namespace Functor
+
+
+/** \class FusedFunctorImageFilter
+ * \brief Applies a chain of pixel-wise operations in a single pass over the
+ * image.
+ *
+ * A chain of pixel-wise filters, such as Cast, ShiftScale, Clamp and
+ * BinaryThreshold, allocates and writes an intermediate image at every
+ * stage, and reads it back at the next one. FusedFunctorImageFilter is given
+ * the functors of the stages instead, and applies all of them to each pixel
+ * as it is read, so that only the output image is allocated and the memory
+ * traffic of the chain is that of a single pixel-wise filter:
+ *
+ * \code
+ * auto filter = FusedFunctorImageFilter<InputImageType, OutputImageType>::New();
+ * filter->SetInput(reader->GetOutput());
+ * filter->SetFunctors(
+ *   [](InputPixelType p) { return static_cast<float>(p); },
+ *   [shift, scale](float p) { return (p + shift) * scale; },
+ *   clampFunctor,
+ *   [](float p) { return p > threshold ? OutputPixelType{ 1 } : OutputPixelType{ 0 }; });
+ * \endcode
+ *
+ * The output is the same as that of the chain of UnaryGeneratorImageFilter
+ * of the functors, whose regions all match since the stages are pixel-wise.
+ * The functors are composed at compile time by Functor::Composition, which
+ * passes contiguous scanlines through the stages in cache-sized chunks.
+ * A chain starting with an operation on two images is fused by giving a
+ * Functor::Compose() of its functors to BinaryGeneratorImageFilter.
+ *
+ * \sa Functor::Composition
+ * \sa UnaryGeneratorImageFilter
+ * \ingroup ITKImageFilterBase MultiThreaded
+ */
+template <typename TInputImage, typename TOutputImage = TInputImage>
+class ITK_TEMPLATE_EXPORT FusedFunctorImageFilter : public UnaryGeneratorImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FusedFunctorImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = FusedFunctorImageFilter;
+  using Superclass = UnaryGeneratorImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(FusedFunctorImageFilter);
+
+#if !defined(ITK_WRAPPING_PARSER)
+  /** Set the functors of the fused stages, in the order in which they are
+   * applied to each pixel. */
+  template <typename... TFunctors>
+  void
+  SetFunctors(const TFunctors &... functors)
+  {
+    static_assert(sizeof...(TFunctors) > 0, "At least one functor must be given.");
+    m_NumberOfStages = sizeof...(TFunctors);
+    this->SetFunctor(Functor::Compose(functors...));
+  }
+#endif // !defined( ITK_WRAPPING_PARSER )
+
+  /** Number of functors given to the last call to SetFunctors(). */
+  itkGetConstMacro(NumberOfStages, unsigned int);
+
+protected:
+  FusedFunctorImageFilter() = default;
+  ~FusedFunctorImageFilter() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "NumberOfStages: " << m_NumberOfStages << std::endl;
+  }
+
+private:
+  unsigned int m_NumberOfStages{ 0 };
+};
+} // end namespace itk
+
+#endif
@@ -44,6 +44,13 @@ namespace itk
  * UnaryGeneratorImageFilter can be used to promote a 2D image to a 3D
  * image, etc.
  *
+ * A functor object may additionally provide a batch overload,
+ * `void operator()(const Input *, Output *, SizeValueType n) const`,
+ * computing n contiguous output pixels at once. When both images are
+ * itk::Image objects, the filter passes whole scanlines to that overload
+ * so that the loop can be vectorized by the compiler.
+ *
+ * \sa Functor::BatchTraits
  * \sa UnaryFunctorImageFilter
  * \sa BinaryGeneratorImageFilter TernaryGeneratorImageFilter
  *
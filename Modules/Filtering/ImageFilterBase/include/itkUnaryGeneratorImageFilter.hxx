@@ -18,6 +18,7 @@
 #ifndef itkUnaryGeneratorImageFilter_hxx
 #define itkUnaryGeneratorImageFilter_hxx
 
+#include "itkFunctorBatchTraits.h"
 #include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 #include "itkTotalProgressReporter.h"
@@ -97,17 +98,32 @@ UnaryGeneratorImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateDat
   ImageScanlineConstIterator inputIt(inputPtr, inputRegionForThread);
   ImageScanlineIterator      outputIt(outputPtr, outputRegionForThread);
 
-  while (!inputIt.IsAtEnd())
+  if constexpr (Functor::BatchTraits::UseUnaryBatch<TFunctor, TInputImage, TOutputImage>)
   {
-    while (!inputIt.IsAtEndOfLine())
+    // The pixels of each scanline are contiguous in both buffers, so the
+    // whole line is handed to the batch overload of the functor.
+    while (!inputIt.IsAtEnd())
     {
-      outputIt.Set(functor(inputIt.Get()));
-      ++inputIt;
-      ++outputIt;
+      functor(&inputIt.Value(), &outputIt.Value(), regionSize[0]);
+      progress.Completed(regionSize[0]);
+      inputIt.NextLine();
+      outputIt.NextLine();
+    }
+  }
+  else
+  {
+    while (!inputIt.IsAtEnd())
+    {
+      while (!inputIt.IsAtEndOfLine())
+      {
+        outputIt.Set(functor(inputIt.Get()));
+        ++inputIt;
+        ++outputIt;
+      }
+      progress.Completed(regionSize[0]);
+      inputIt.NextLine();
+      outputIt.NextLine();
     }
-    progress.Completed(regionSize[0]);
-    inputIt.NextLine();
-    outputIt.NextLine();
   }
 }
 } // end namespace itk
@@ -0,0 +1,264 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFusedFunctorImageFilter.h"
+#include "itkBinaryGeneratorImageFilter.h"
+#include "itkArithmeticOpsFunctors.h"
+#include "itkClampImageFilter.h"
+#include "itkImageBufferAllocator.h"
+#include "itkImageRegionIterator.h"
+#include "itkGTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace
+{
+using InputImageType = itk::Image<short, 3>;
+using OutputImageType = itk::Image<unsigned char, 3>;
+
+// Scanlines longer than a chunk of Functor::Composition, so that they are
+// split in several chunks.
+InputImageType::Pointer
+CreateRampImage()
+{
+  auto image = InputImageType::New();
+  image->SetRegions(InputImageType::SizeType{ { 600, 5, 3 } });
+  image->Allocate();
+
+  short value = -900;
+  for (itk::ImageRegionIterator<InputImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = static_cast<short>(value < 900 ? value + 1 : -900);
+  }
+  return image;
+}
+
+// The stages of a Cast, ShiftScale, Clamp, BinaryThreshold chain.
+float
+Cast(short pixel)
+{
+  return static_cast<float>(pixel);
+}
+
+float
+ShiftScale(float pixel)
+{
+  return (pixel + 100.0f) * 0.5f;
+}
+
+itk::Functor::Clamp<float>
+MakeClamp()
+{
+  itk::Functor::Clamp<float> clamp;
+  clamp.SetBounds(-200.0f, 200.0f);
+  return clamp;
+}
+
+unsigned char
+Threshold(float pixel)
+{
+  return pixel > 150.0f || pixel < -150.0f ? 255 : 0;
+}
+
+// Scales pixels by two, counting the calls to its batch overload.
+struct CountingBatchScale
+{
+  std::atomic<unsigned int> * m_BatchCalls{ nullptr };
+
+  float
+  operator()(const float & p) const
+  {
+    return 2.0f * p;
+  }
+
+  void
+  operator()(const float * input, float * output, itk::SizeValueType n) const
+  {
+    ++(*m_BatchCalls);
+    EXPECT_LE(n, itk::Functor::Composition<CountingBatchScale>::ChunkSize);
+    for (itk::SizeValueType i = 0; i < n; ++i)
+    {
+      output[i] = (*this)(input[i]);
+    }
+  }
+};
+
+template <typename TImage>
+bool
+ImagesAreEqual(const TImage * image1, const TImage * image2)
+{
+  itk::ImageRegionConstIterator<TImage> it1(image1, image1->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TImage> it2(image2, image1->GetBufferedRegion());
+  for (; !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    if (it1.Get() != it2.Get())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+TEST(FusedFunctorImageFilter, CheckBasicObjectMethods)
+{
+  using FilterType = itk::FusedFunctorImageFilter<InputImageType, OutputImageType>;
+  auto filter = FilterType::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(filter, FusedFunctorImageFilter, UnaryGeneratorImageFilter);
+
+  EXPECT_EQ(filter->GetNumberOfStages(), 0u);
+  filter->SetFunctors(Cast, ShiftScale, MakeClamp(), Threshold);
+  EXPECT_EQ(filter->GetNumberOfStages(), 4u);
+}
+
+
+TEST(FusedFunctorImageFilter, MatchesChainOfFilters)
+{
+  const auto input = CreateRampImage();
+
+  // The chain of filters, each one allocating its output.
+  using FloatImageType = itk::Image<float, 3>;
+  auto cast = itk::UnaryGeneratorImageFilter<InputImageType, FloatImageType>::New();
+  cast->SetInput(input);
+  cast->SetFunctor(Cast);
+  auto shiftScale = itk::UnaryGeneratorImageFilter<FloatImageType, FloatImageType>::New();
+  shiftScale->SetInput(cast->GetOutput());
+  shiftScale->SetFunctor(ShiftScale);
+  auto clamp = itk::UnaryGeneratorImageFilter<FloatImageType, FloatImageType>::New();
+  clamp->SetInput(shiftScale->GetOutput());
+  clamp->SetFunctor(MakeClamp());
+  auto threshold = itk::UnaryGeneratorImageFilter<FloatImageType, OutputImageType>::New();
+  threshold->SetInput(clamp->GetOutput());
+  threshold->SetFunctor(Threshold);
+
+  const auto chainAllocations = itk::ImageBufferAllocator::GetStatistics().NumberOfAllocations;
+  threshold->Update();
+  EXPECT_EQ(itk::ImageBufferAllocator::GetStatistics().NumberOfAllocations - chainAllocations, 4u);
+
+  // The fused filter only allocates its output.
+  auto fused = itk::FusedFunctorImageFilter<InputImageType, OutputImageType>::New();
+  fused->SetInput(input);
+  fused->SetFunctors(Cast, ShiftScale, MakeClamp(), Threshold);
+
+  const auto fusedAllocations = itk::ImageBufferAllocator::GetStatistics().NumberOfAllocations;
+  fused->Update();
+  EXPECT_EQ(itk::ImageBufferAllocator::GetStatistics().NumberOfAllocations - fusedAllocations, 1u);
+
+  EXPECT_EQ(fused->GetOutput()->GetBufferedRegion(), threshold->GetOutput()->GetBufferedRegion());
+  EXPECT_TRUE(ImagesAreEqual<OutputImageType>(fused->GetOutput(), threshold->GetOutput()));
+
+  // A requested region whose scanlines start in the middle of the buffer.
+  auto partial = itk::FusedFunctorImageFilter<InputImageType, OutputImageType>::New();
+  partial->SetInput(input);
+  partial->SetFunctors(Cast, ShiftScale, MakeClamp(), Threshold);
+  const OutputImageType::RegionType requestedRegion({ { 3, 1, 1 } }, { { 590, 3, 2 } });
+  partial->GetOutput()->SetRequestedRegion(requestedRegion);
+  partial->Update();
+  EXPECT_EQ(partial->GetOutput()->GetBufferedRegion(), requestedRegion);
+  EXPECT_TRUE(ImagesAreEqual<OutputImageType>(partial->GetOutput(), threshold->GetOutput()));
+}
+
+
+TEST(FusedFunctorImageFilter, UsesBatchOverloadsOfTheStages)
+{
+  using ImageType = itk::Image<float, 3>;
+  auto input = ImageType::New();
+  input->SetRegions(ImageType::SizeType{ { 1000, 2, 2 } });
+  input->Allocate();
+  input->FillBuffer(1.5f);
+
+  std::atomic<unsigned int> batchCalls{ 0 };
+  CountingBatchScale        scale;
+  scale.m_BatchCalls = &batchCalls;
+
+  auto fused = itk::FusedFunctorImageFilter<ImageType>::New();
+  fused->SetInput(input);
+  fused->SetFunctors(scale, [](float p) { return p + 1.0f; }, scale);
+  fused->Update();
+
+  // Each scanline of 1000 pixels is split in four chunks, each of which is
+  // passed to both batch overloads.
+  EXPECT_EQ(batchCalls, 2u * 4u * 2u * 2u);
+  const float * output = fused->GetOutput()->GetBufferPointer();
+  EXPECT_TRUE(std::all_of(output, output + 4000, [](float p) { return p == 8.0f; }));
+}
+
+
+TEST(FusedFunctorImageFilter, FusesBinaryOperations)
+{
+  using ImageType = itk::Image<float, 3>;
+  auto input1 = ImageType::New();
+  input1->SetRegions(ImageType::SizeType{ { 300, 4, 2 } });
+  input1->Allocate();
+  input1->FillBuffer(3.0f);
+  auto input2 = ImageType::New();
+  input2->SetRegions(input1->GetBufferedRegion());
+  input2->Allocate();
+  input2->FillBuffer(-5.0f);
+
+  using FilterType = itk::BinaryGeneratorImageFilter<ImageType, ImageType, OutputImageType>;
+  auto filter = FilterType::New();
+  filter->SetInput1(input1);
+  filter->SetInput2(input2);
+  filter->SetFunctor(itk::Functor::Compose(
+    itk::Functor::Add2<float>(), [](float p) { return p * p; }, [](float p) { return static_cast<unsigned char>(p); }));
+  filter->Update();
+
+  const unsigned char * output = filter->GetOutput()->GetBufferPointer();
+  EXPECT_TRUE(std::all_of(output, output + 300 * 4 * 2, [](unsigned char p) { return p == 4; }));
+
+  // A constant second input.
+  filter->SetConstant2(1.0f);
+  filter->Update();
+  output = filter->GetOutput()->GetBufferPointer();
+  EXPECT_TRUE(std::all_of(output, output + 300 * 4 * 2, [](unsigned char p) { return p == 16; }));
+}
+
+
+TEST(FunctorComposition, AppliesFunctorsInOrder)
+{
+  const auto composition = itk::Functor::Compose(ShiftScale, MakeClamp(), Threshold);
+  static_assert(decltype(composition)::NumberOfFunctors == 3);
+  EXPECT_EQ(composition(300.0f), 255);
+  EXPECT_EQ(composition(100.0f), 0);
+
+  // Intermediate values which cannot be buffered are passed pixel by pixel.
+  const auto unbuffered = itk::Functor::Compose([](float p) { return std::vector<float>{ p, 2.0f * p }; },
+                                                [](const std::vector<float> & v) { return v[0] + v[1]; });
+  std::vector<float> input(700);
+  std::vector<float> output(700);
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    input[i] = static_cast<float>(i);
+  }
+  unbuffered(input.data(), output.data(), input.size());
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    EXPECT_EQ(output[i], 3.0f * input[i]);
+  }
+
+  // In-place execution.
+  const auto inPlace = itk::Functor::Compose([](float p) { return p + 1.0f; }, [](float p) { return 2.0f * p; });
+  inPlace(input.data(), input.data(), input.size());
+  EXPECT_EQ(input[0], 2.0f);
+  EXPECT_EQ(input[699], 1400.0f);
+}
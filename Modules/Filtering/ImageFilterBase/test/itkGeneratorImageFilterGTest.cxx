@@ -21,6 +21,10 @@
 #include "itkTernaryGeneratorImageFilter.h"
 #include "itkImage.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkVectorImage.h"
+
+#include <atomic>
 
 #include "itkGTest.h"
 
@@ -91,9 +95,190 @@ struct Utilities
 };
 
 
+
+// Functor providing both the per-pixel and the batch overloads of
+// operator(). Each batch call is counted, so that the tests can check
+// which execution path was taken by the filter.
+struct CountingBatchFunctor
+{
+  std::atomic<unsigned int> * m_BatchCalls{ nullptr };
+
+  float
+  operator()(const float & p) const
+  {
+    return 2.0f * p + 1.0f;
+  }
+
+  float
+  operator()(const float & p1, const float & p2) const
+  {
+    return p1 - 3.0f * p2;
+  }
+
+  void
+  operator()(const float * input, float * output, itk::SizeValueType n) const
+  {
+    ++(*m_BatchCalls);
+    for (itk::SizeValueType i = 0; i < n; ++i)
+    {
+      output[i] = (*this)(input[i]);
+    }
+  }
+
+  void
+  operator()(const float * input1, const float * input2, float * output, itk::SizeValueType n) const
+  {
+    ++(*m_BatchCalls);
+    for (itk::SizeValueType i = 0; i < n; ++i)
+    {
+      output[i] = (*this)(input1[i], input2[i]);
+    }
+  }
+};
+
+
+template <typename TImage>
+typename TImage::Pointer
+CreateRampImage()
+{
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 7, 5, 3 } });
+  image->Allocate();
+
+  float value = 0.0f;
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value += 0.5f;
+  }
+  return image;
+}
+
 } // namespace
 
 
+TEST(GeneratorImageFilterBatchTraits, Detection)
+{
+  using ImageType = itk::Image<float, 3>;
+  using VectorImageType = itk::VectorImage<float, 3>;
+  using namespace itk::Functor::BatchTraits;
+
+  static_assert(IsContiguousScanlineImage<ImageType>);
+  static_assert(IsContiguousScanlineImage<const ImageType>);
+  static_assert(!IsContiguousScanlineImage<VectorImageType>);
+
+  static_assert(HasUnaryBatchOperator<CountingBatchFunctor, float, float>::value);
+  static_assert(HasBinaryBatchOperator<CountingBatchFunctor, float, float, float>::value);
+  static_assert(!HasUnaryBatchOperator<float (*)(const float &), float, float>::value);
+  static_assert(!HasBinaryBatchOperator<std::function<float(float, float)>, float, float, float>::value);
+
+  static_assert(UseUnaryBatch<CountingBatchFunctor, ImageType, ImageType>);
+  static_assert(!UseUnaryBatch<CountingBatchFunctor, VectorImageType, ImageType>);
+  static_assert(!UseUnaryBatch<CountingBatchFunctor, itk::Image<float, 2>, ImageType>);
+  static_assert(!UseUnaryBatch<float (*)(const float &), ImageType, ImageType>);
+  static_assert(UseBinaryBatch<CountingBatchFunctor, ImageType, ImageType, ImageType>);
+  static_assert(!UseBinaryBatch<std::function<float(float, float)>, ImageType, ImageType, ImageType>);
+}
+
+
+TEST(UnaryGeneratorImageFilter, BatchFunctor)
+{
+  using ImageType = itk::Image<float, 3>;
+
+  const auto image = CreateRampImage<ImageType>();
+
+  std::atomic<unsigned int> batchCalls{ 0 };
+  CountingBatchFunctor      functor;
+  functor.m_BatchCalls = &batchCalls;
+
+  using FilterType = itk::UnaryGeneratorImageFilter<ImageType, ImageType>;
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetFunctor(functor);
+
+  // Restrict the output to a sub-region, so that the scanlines do not start
+  // at the beginning of the buffer.
+  const ImageType::RegionType requestedRegion({ { 1, 1, 1 } }, { { 4, 3, 2 } });
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  ASSERT_NO_THROW(filter->Update());
+
+  EXPECT_EQ(batchCalls.load(), 3u * 2u);
+
+  const ImageType * output = filter->GetOutput();
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(output, requestedRegion); !it.IsAtEnd(); ++it)
+  {
+    EXPECT_EQ(it.Get(), functor(image->GetPixel(it.GetIndex()))) << it.GetIndex();
+  }
+}
+
+
+TEST(BinaryGeneratorImageFilter, BatchFunctor)
+{
+  using ImageType = itk::Image<float, 3>;
+
+  const auto image1 = CreateRampImage<ImageType>();
+  const auto image2 = CreateRampImage<ImageType>();
+  image2->FillBuffer(0.25f);
+  const ImageType::IndexType idx{ { 6, 4, 2 } };
+  image2->SetPixel(idx, 2.0f);
+
+  std::atomic<unsigned int> batchCalls{ 0 };
+  CountingBatchFunctor      functor;
+  functor.m_BatchCalls = &batchCalls;
+
+  using FilterType = itk::BinaryGeneratorImageFilter<ImageType, ImageType, ImageType>;
+
+  // Two images
+  auto filter = FilterType::New();
+  filter->SetInput1(image1);
+  filter->SetInput2(image2);
+  filter->SetFunctor(functor);
+  ASSERT_NO_THROW(filter->Update());
+  EXPECT_EQ(batchCalls.load(), 5u * 3u);
+  EXPECT_EQ(filter->GetOutput()->GetPixel(idx), functor(image1->GetPixel(idx), 2.0f));
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(filter->GetOutput(), image1->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    EXPECT_EQ(it.Get(), functor(image1->GetPixel(it.GetIndex()), image2->GetPixel(it.GetIndex())));
+  }
+
+  // Constant as second operand
+  batchCalls = 0;
+  filter = FilterType::New();
+  filter->SetInput1(image1);
+  filter->SetConstant2(4.0f);
+  filter->SetFunctor(functor);
+  ASSERT_NO_THROW(filter->Update());
+  EXPECT_EQ(batchCalls.load(), 5u * 3u);
+  EXPECT_EQ(filter->GetOutput()->GetPixel(idx), functor(image1->GetPixel(idx), 4.0f));
+
+  // Constant as first operand
+  batchCalls = 0;
+  filter = FilterType::New();
+  filter->SetConstant1(4.0f);
+  filter->SetInput2(image1);
+  filter->SetFunctor(functor);
+  ASSERT_NO_THROW(filter->Update());
+  EXPECT_EQ(batchCalls.load(), 5u * 3u);
+  EXPECT_EQ(filter->GetOutput()->GetPixel(idx), functor(4.0f, image1->GetPixel(idx)));
+
+  // In place
+  batchCalls = 0;
+  const auto    image3 = CreateRampImage<ImageType>();
+  const float * image3Buffer = image3->GetBufferPointer();
+  filter = FilterType::New();
+  filter->SetInput1(image3);
+  filter->SetInput2(image2);
+  filter->SetFunctor(functor);
+  filter->InPlaceOn();
+  ASSERT_NO_THROW(filter->Update());
+  EXPECT_EQ(batchCalls.load(), 5u * 3u);
+  EXPECT_EQ(filter->GetOutput()->GetBufferPointer(), image3Buffer);
+  EXPECT_EQ(filter->GetOutput()->GetPixel(idx), functor(image1->GetPixel(idx), 2.0f));
+}
+
+
 TEST(UnaryGeneratorImageFilter, SetGetBasic)
 {
 
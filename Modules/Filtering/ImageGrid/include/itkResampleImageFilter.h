@@ -28,6 +28,9 @@
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDataObjectDecorator.h"
 
+#include <utility> // For pair.
+#include <vector>
+
 
 namespace itk
 {
@@ -69,6 +72,13 @@ namespace itk
  * ProcessObject::GenerateInputRequestedRegion() and
  * ProcessObject::GenerateOutputInformation().
  *
+ * The input requested region is the part of the input which the output
+ * requested region is mapped to, padded by the radius of the interpolator,
+ * so that the output may be streamed with bounded memory from a streaming
+ * input, when the transform is linear, or when its displacements are
+ * bounded: a displacement field or B-spline transform, or a composition
+ * of those. The whole input is requested for the other transforms.
+ *
  * This filter is implemented as a multithreaded filter.  It provides a
  * DynamicThreadedGenerateData() method for its implementation.
  * \warning For multithreading, the TransformPoint method of the
@@ -373,6 +383,34 @@ private:
   void
   InitializeTransform();
 
+  using DisplacementBoundType = FixedArray<double, OutputImageDimension>;
+
+  /** The transforms visited by ComputeDisplacementBound(), with their
+   * modified times. */
+  using TransformTimeStampListType = std::vector<std::pair<typename TransformType::ConstPointer, ModifiedTimeType>>;
+
+  /** Compute a bound of the displacements of the transform, such that
+   * |T(p)[i] - p[i]| <= bound[i] for every point p, when the transform is a
+   * displacement field or B-spline transform, including the bulk transform
+   * of a BSplineDeformableTransform, a translation, or a composition of
+   * those. Returns false for the other transforms. The transform, and those
+   * it is composed of, are added to the visited transforms. */
+  static bool
+  ComputeDisplacementBound(const TransformType &        transform,
+                           DisplacementBoundType &      bound,
+                           TransformTimeStampListType & visitedTransforms);
+
+  /** Get the displacement bound of the transform, computed again only when
+   * the transform, or one of the transforms it is composed of, was modified
+   * since the last call. */
+  bool
+  GetDisplacementBound(const TransformType & transform, DisplacementBoundType & bound);
+
+  /** Set the requested region of the input, padded by the radius of the
+   * interpolator, and cropped by the largest possible region. */
+  void
+  SetInputRequestedRegion(InputImageType & input, InputImageRegionType region) const;
+
   SizeType                m_Size{};         // Size of the output image
   InterpolatorPointerType m_Interpolator{}; // Image function for
                                             // interpolation
@@ -386,6 +424,10 @@ private:
   DirectionType   m_OutputDirection{};      // output image direction cosines
   IndexType       m_OutputStartIndex{};     // output image start index
   bool            m_UseReferenceImage{ false };
+
+  TransformTimeStampListType m_DisplacementBoundTransforms{};
+  DisplacementBoundType      m_DisplacementBound{};
+  bool                       m_IsDisplacementBounded{ false };
 };
 } // end namespace itk
 
@@ -26,9 +26,13 @@
 #include "itkSpecialCoordinatesImage.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkImageAlgorithm.h"
+#include "itkCompositeTransform.h"
+#include "itkBSplineDeformableTransform.h"
 
-#include <algorithm>   // For max.
+#include <algorithm>   // For all_of and max.
+#include <cmath>       // For ceil.
 #include <type_traits> // For is_same.
+#include <vector>
 #include "itkPrintHelper.h"
 
 namespace itk
@@ -446,25 +450,34 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
   // an oriented/scaled/translated line in the input image. Each scan
   // line has a starting and ending point. Since all transforms
   // are linear, the path between the points is linear and can be
-  // defined by interpolating between the two points. By using
-  // interpolation we avoid accumulation errors, and by using the
-  // whole scan line from the largest possible region we make the
-  // computation independent for each point and independent of the
-  // region we are processing which makes the method independent of
-  // how the whole image is split for processing ( threading,
+  // defined by stepping from the starting point. By counting the steps
+  // from the start of the whole scan line of the largest possible region
+  // we make the computation independent for each point and independent
+  // of the region we are processing which makes the method independent
+  // of how the whole image is split for processing ( threading,
   // streaming, etc ).
   //
+  // As the input buffer is convex, the points of a scan line inside it
+  // are contiguous. They are interpolated in one call, without a bounds
+  // check per point, while the points before and after them are
+  // checked, and extrapolated or set to the default value, one at a time.
 
   const auto transformIndex = [outputPtr, transformPtr, inputPtr](const IndexType & index) {
     return inputPtr->template TransformPhysicalPointToContinuousIndex<TInterpolatorPrecisionType>(
       transformPtr->TransformPoint(outputPtr->template TransformIndexToPhysicalPoint<double>(index)));
   };
 
+  const ContinuousInputIndexType startOfBuffer = m_Interpolator->GetStartContinuousIndex();
+  const ContinuousInputIndexType endOfBuffer = m_Interpolator->GetEndContinuousIndex();
+
+  std::vector<InterpolatorOutputType> values(outputRegionForThread.GetSize(0));
+
   // Create an iterator that will walk the output region for this thread.
   for (ImageScanlineIterator outIt(outputPtr, outputRegionForThread); !outIt.IsAtEnd(); outIt.NextLine())
   {
-    // Determine the continuous index of the first and end pixel of output
-    // scan line when mapped to the input coordinate frame.
+    // Determine the continuous index of the first pixel of the output scan
+    // line when mapped to the input coordinate frame, and the step from one
+    // pixel to the next.
 
     const auto computedIndex = outIt.ComputeIndex();
 
@@ -473,23 +486,61 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
 
     const ContinuousInputIndexType startIndex = transformIndex(index);
     index[0] += firstSizeValueOfLargestPossibleRegion;
-    const auto vectorFromStartIndex = transformIndex(index) - startIndex;
-
-    IndexValueType scanlineIndex = computedIndex[0];
-
-
-    while (!outIt.IsAtEndOfLine())
+    const typename InterpolatorType::ContinuousIndexVectorType step =
+      (transformIndex(index) - startIndex) /
+      static_cast<TInterpolatorPrecisionType>(firstSizeValueOfLargestPossibleRegion);
+
+    const auto lineBegin = static_cast<SizeValueType>(computedIndex[0] - firstIndexValueOfLargestPossibleRegion);
+    const auto lineEnd = lineBegin + outputRegionForThread.GetSize(0);
+
+    const auto isInside = [this, &startIndex, &step](SizeValueType i) {
+      return m_Interpolator->IsInsideBuffer(InterpolatorType::GetContinuousIndexOfLine(startIndex, step, i));
+    };
+
+    // Estimate the positions inside the buffer from its bounds, then
+    // correct the estimate by checking the points at its ends.
+    double lower = lineBegin;
+    double upper = lineEnd;
+    for (unsigned int j = 0; j < InputImageDimension; ++j)
     {
-
-      // Perform linear interpolation from startIndex, along vectorFromStartIndex
-      const double alpha =
-        (scanlineIndex - firstIndexValueOfLargestPossibleRegion) / firstSizeValueOfLargestPossibleRegion;
-
-      ContinuousInputIndexType inputIndex(startIndex);
-      for (unsigned int i = 0; i < InputImageDimension; ++i)
+      if (step[j] != 0.0)
       {
-        inputIndex[i] += alpha * vectorFromStartIndex[i];
+        const double toStart = (startOfBuffer[j] - startIndex[j]) / step[j];
+        const double toEnd = (endOfBuffer[j] - startIndex[j]) / step[j];
+        lower = std::max(lower, std::min(toStart, toEnd));
+        upper = std::min(upper, std::max(toStart, toEnd));
       }
+      else if (!(startIndex[j] >= startOfBuffer[j] && startIndex[j] < endOfBuffer[j]))
+      {
+        upper = lower;
+      }
+    }
+    lower = std::min(lower, static_cast<double>(lineEnd));
+    upper = std::max(upper, lower);
+    auto begin = static_cast<SizeValueType>(std::ceil(lower));
+    auto end = static_cast<SizeValueType>(std::ceil(upper));
+    while (begin < end && !isInside(begin))
+    {
+      ++begin;
+    }
+    while (end > begin && !isInside(end - 1))
+    {
+      --end;
+    }
+    if (begin < end)
+    {
+      while (begin > lineBegin && isInside(begin - 1))
+      {
+        --begin;
+      }
+      while (end < lineEnd && isInside(end))
+      {
+        ++end;
+      }
+    }
+
+    const auto evaluate = [&](SizeValueType i) {
+      const ContinuousInputIndexType inputIndex = InterpolatorType::GetContinuousIndexOfLine(startIndex, step, i);
 
       // Evaluate input at right position and copy to the output
       if (m_Interpolator->IsInsideBuffer(inputIndex))
@@ -507,9 +558,26 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
           outIt.Set(Self::CastPixelWithBoundsChecking(m_Extrapolator->EvaluateAtContinuousIndex(inputIndex)));
         }
       }
-
       ++outIt;
-      ++scanlineIndex;
+    };
+
+    SizeValueType i = lineBegin;
+    for (; i < begin; ++i)
+    {
+      evaluate(i);
+    }
+    if (begin < end)
+    {
+      m_Interpolator->EvaluateAtContinuousIndexLine(startIndex, step, begin, end, values.data());
+      for (; i < end; ++i)
+      {
+        outIt.Set(Self::CastPixelWithBoundsChecking(values[i - begin]));
+        ++outIt;
+      }
+    }
+    for (; i < lineEnd; ++i)
+    {
+      evaluate(i);
     }
     progress.Completed(outputRegionForThread.GetSize()[0]);
   }
@@ -553,31 +621,40 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
   // to the IsLinear() call.
   if (!isSpecialCoordinatesImage && transform->GetTransformCategory() == TransformType::TransformCategoryEnum::Linear)
   {
-    typename TInputImage::RegionType inputRequestedRegion =
-      ImageAlgorithm::EnlargeRegionOverBox(output->GetRequestedRegion(), output, input, transform);
+    this->SetInputRequestedRegion(
+      *input, ImageAlgorithm::EnlargeRegionOverBox(output->GetRequestedRegion(), output, input, transform));
+    return;
+  }
 
-    const typename TInputImage::RegionType inputLargestRegion(input->GetLargestPossibleRegion());
-    if (inputLargestRegion.IsInside(inputRequestedRegion.GetIndex()) ||
-        inputLargestRegion.IsInside(inputRequestedRegion.GetUpperIndex()))
-    {
-      // Input requested region is partially outside the largest possible region.
-      //   or
-      // Input requested region is completely inside the largest possible region.
-      inputRequestedRegion.PadByRadius(m_Interpolator->GetRadius());
-      inputRequestedRegion.Crop(inputLargestRegion);
-      input->SetRequestedRegion(inputRequestedRegion);
-    }
-    else if (inputRequestedRegion.IsInside(inputLargestRegion))
-    {
-      // Input requested region completely surrounds the largest possible region.
-      input->SetRequestedRegion(inputLargestRegion);
-    }
-    else
+  // Upstream streaming can also be used if the displacements of the
+  // transformation are bounded: the input requested region is then the one
+  // of the output requested region, padded by the bound.
+  if constexpr (InputImageDimension == OutputImageDimension)
+  {
+    DisplacementBoundType bound;
+    if (!isSpecialCoordinatesImage && this->GetDisplacementBound(*transform, bound))
     {
-      // Input requested region is completely outside the largest possible region. Do not set the requested region in
-      // this case.
+      InputImageRegionType inputRequestedRegion =
+        ImageAlgorithm::EnlargeRegionOverBox(output->GetRequestedRegion(), output, input);
+
+      // The bound of the continuous index offsets, along each dimension of
+      // the input, of the physical offsets within the bound.
+      const auto & inverseDirection = input->GetInverseDirection();
+      const auto & spacing = input->GetSpacing();
+      SizeType     radius;
+      for (unsigned int i = 0; i < InputImageDimension; ++i)
+      {
+        double indexBound = 0.0;
+        for (unsigned int j = 0; j < InputImageDimension; ++j)
+        {
+          indexBound += std::abs(inverseDirection[i][j]) * bound[j];
+        }
+        radius[i] = static_cast<SizeValueType>(std::ceil(indexBound / spacing[i]));
+      }
+      inputRequestedRegion.PadByRadius(radius);
+      this->SetInputRequestedRegion(*input, inputRequestedRegion);
+      return;
     }
-    return;
   }
 
   // Otherwise, determining the actual input region is non-trivial, especially
@@ -587,6 +664,177 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
   input->SetRequestedRegionToLargestPossibleRegion();
 }
 
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  SetInputRequestedRegion(InputImageType & input, InputImageRegionType region) const
+{
+  // When the region is completely outside the largest possible region, the
+  // requested region is not set.
+  region.PadByRadius(m_Interpolator->GetRadius());
+  if (region.Crop(input.GetLargestPossibleRegion()))
+  {
+    input.SetRequestedRegion(region);
+  }
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+bool
+ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetDisplacementBound(const TransformType & transform, DisplacementBoundType & bound)
+{
+  const auto isUpToDate = [](const auto & transformAndTimeStamp) {
+    return transformAndTimeStamp.first->GetMTime() == transformAndTimeStamp.second;
+  };
+  if (m_DisplacementBoundTransforms.empty() || m_DisplacementBoundTransforms.front().first != &transform ||
+      !std::all_of(m_DisplacementBoundTransforms.cbegin(), m_DisplacementBoundTransforms.cend(), isUpToDate))
+  {
+    m_DisplacementBoundTransforms.clear();
+    m_IsDisplacementBounded = ComputeDisplacementBound(transform, m_DisplacementBound, m_DisplacementBoundTransforms);
+  }
+  bound = m_DisplacementBound;
+  return m_IsDisplacementBounded;
+}
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+bool
+ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  ComputeDisplacementBound(const TransformType &        transform,
+                           DisplacementBoundType &      bound,
+                           TransformTimeStampListType & visitedTransforms)
+{
+  visitedTransforms.emplace_back(&transform, transform.GetMTime());
+  bound.Fill(0.0);
+
+  // The displacements of a composition are bounded by the sum of the bounds
+  // of its transforms.
+  if constexpr (InputImageDimension == OutputImageDimension)
+  {
+    using CompositeTransformType = CompositeTransform<TTransformPrecisionType, OutputImageDimension>;
+    if (const auto * composite = dynamic_cast<const CompositeTransformType *>(&transform))
+    {
+      for (SizeValueType n = 0; n < composite->GetNumberOfTransforms(); ++n)
+      {
+        DisplacementBoundType transformBound;
+        if (!ComputeDisplacementBound(*composite->GetNthTransformConstPointer(n), transformBound, visitedTransforms))
+        {
+          return false;
+        }
+        for (unsigned int i = 0; i < OutputImageDimension; ++i)
+        {
+          bound[i] += transformBound[i];
+        }
+      }
+      return true;
+    }
+
+    // The displacements of a linear transform whose matrix is the identity,
+    // like a translation, are all equal to its offset.
+    if (transform.IsLinear())
+    {
+      typename TransformType::InputPointType point{};
+      const auto                             offset = transform.TransformPoint(point) - point;
+      for (unsigned int j = 0; j < OutputImageDimension; ++j)
+      {
+        point.Fill(0.0);
+        point[j] = 1.0;
+        const auto column = transform.TransformPoint(point) - offset;
+        for (unsigned int i = 0; i < OutputImageDimension; ++i)
+        {
+          if (std::abs(column[i] - point[i]) > 1e-12)
+          {
+            return false;
+          }
+        }
+      }
+      for (unsigned int i = 0; i < OutputImageDimension; ++i)
+      {
+        bound[i] = std::abs(offset[i]);
+      }
+      return true;
+    }
+  }
+
+  // The displacements of a displacement field transform, interpolated
+  // linearly, and the ones of a B-spline transform, whose weights are
+  // positive and add up to one, are bounded by the largest components of
+  // their parameters. The first fixed parameters are the size of the
+  // displacement field, or of the grid of coefficients.
+  const auto category = transform.GetTransformCategory();
+  if (category != TransformType::TransformCategoryEnum::DisplacementField &&
+      category != TransformType::TransformCategoryEnum::BSpline)
+  {
+    return false;
+  }
+  const auto & fixedParameters = transform.GetFixedParameters();
+  const auto & parameters = transform.GetParameters();
+  if (fixedParameters.size() < OutputImageDimension)
+  {
+    return false;
+  }
+  SizeValueType numberOfPoints = 1;
+  for (unsigned int i = 0; i < OutputImageDimension; ++i)
+  {
+    numberOfPoints *= static_cast<SizeValueType>(fixedParameters[i]);
+  }
+  if (numberOfPoints == 0 || parameters.size() != numberOfPoints * OutputImageDimension)
+  {
+    return false;
+  }
+
+  // The components of the displacements are interleaved, and the ones of
+  // the coefficients are stored one dimension after the other.
+  const bool isInterleaved = (category == TransformType::TransformCategoryEnum::DisplacementField);
+  for (SizeValueType n = 0; n < parameters.size(); ++n)
+  {
+    const unsigned int i = isInterleaved ? n % OutputImageDimension : n / numberOfPoints;
+    bound[i] = std::max(bound[i], std::abs(static_cast<double>(parameters[n])));
+  }
+
+  // A BSplineDeformableTransform adds its displacements to the points
+  // mapped by its bulk transform, whose displacements add up to them.
+  if constexpr (InputImageDimension == OutputImageDimension)
+  {
+    const TransformType * bulkTransform = nullptr;
+    const auto            getBulkTransform = [&transform, &bulkTransform](auto splineOrder) {
+      using BSplineTransformType =
+        BSplineDeformableTransform<TTransformPrecisionType, OutputImageDimension, decltype(splineOrder)::value>;
+      const auto * bsplineTransform = dynamic_cast<const BSplineTransformType *>(&transform);
+      if (bsplineTransform != nullptr)
+      {
+        bulkTransform = bsplineTransform->GetBulkTransform();
+      }
+      return bsplineTransform != nullptr;
+    };
+    if ((getBulkTransform(std::integral_constant<unsigned int, 0>{}) ||
+         getBulkTransform(std::integral_constant<unsigned int, 1>{}) ||
+         getBulkTransform(std::integral_constant<unsigned int, 2>{}) ||
+         getBulkTransform(std::integral_constant<unsigned int, 3>{})) &&
+        bulkTransform != nullptr)
+    {
+      DisplacementBoundType bulkBound;
+      if (!ComputeDisplacementBound(*bulkTransform, bulkBound, visitedTransforms))
+      {
+        return false;
+      }
+      for (unsigned int i = 0; i < OutputImageDimension; ++i)
+      {
+        bound[i] += bulkBound[i];
+      }
+    }
+  }
+  return true;
+}
+
 template <typename TInputImage,
           typename TOutputImage,
           typename TInterpolatorPrecisionType,
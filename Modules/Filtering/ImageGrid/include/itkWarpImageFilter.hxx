@@ -20,6 +20,7 @@
 
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 #include "itkImageAlgorithm.h"
 #include "itkNumericTraits.h"
 #include "itkDefaultConvertPixelTraits.h"
@@ -29,6 +30,8 @@
 #include "itkTransform.h"
 #include "itkPrintHelper.h"
 
+#include <vector>
+
 namespace itk
 {
 template <typename TInputImage, typename TOutputImage, typename TDisplacementField>
@@ -278,78 +281,87 @@ WarpImageFilter<TInputImage, TOutputImage, TDisplacementField>::DynamicThreadedG
 {
   OutputImageType *             outputPtr = this->GetOutput();
   const DisplacementFieldType * fieldPtr = this->GetDisplacementField();
+  const InputImageType *        inputPtr = m_Interpolator->GetInputImage();
 
   TotalProgressReporter progress(this, outputPtr->GetRequestedRegion().GetNumberOfPixels());
 
-  // iterator for the output image
-  ImageRegionIteratorWithIndex outputIt(outputPtr, outputRegionForThread);
-  IndexType                    index{};
-  PointType                    point{};
-  DisplacementType             displacement{};
+  using ContinuousIndexType = typename InterpolatorType::ContinuousIndexType;
+  using InterpolatorOutputType = typename InterpolatorType::OutputType;
+
+  // The points of a scan line which fall inside the input buffer are
+  // gathered, interpolated in one call, and scattered back to the line.
+  const SizeValueType                 lineLength = outputRegionForThread.GetSize(0);
+  std::vector<bool>                   isInside(lineLength);
+  std::vector<ContinuousIndexType>    insideIndices(lineLength);
+  std::vector<InterpolatorOutputType> values(lineLength);
+
+  PointType        point{};
+  DisplacementType displacement{};
   NumericTraits<DisplacementType>::SetLength(displacement, ImageDimension);
   static_assert(PointType::Dimension == ImageDimension, "ERROR: Point type and ImageDimension must be the same!");
-  if (this->m_DefFieldSameInformation)
-  {
-    // iterator for the deformation field
-    ImageRegionConstIterator fieldIt(fieldPtr, outputRegionForThread);
 
-    while (!outputIt.IsAtEnd())
+  const auto warpLine = [&](ImageScanlineIterator<OutputImageType> & lineIt, const auto & getDisplacement) {
+    IndexType     index = lineIt.ComputeIndex();
+    SizeValueType numberOfInside = 0;
+    for (SizeValueType i = 0; i < lineLength; ++i, ++index[0])
     {
-      // get the output image index
-      index = outputIt.GetIndex();
       outputPtr->TransformIndexToPhysicalPoint(index, point);
 
-      // get the required displacement
-      displacement = fieldIt.Get();
-
       // compute the required input image point
+      getDisplacement(point, displacement);
       for (unsigned int j = 0; j < ImageDimension; ++j)
       {
         point[j] += displacement[j];
       }
 
-      // get the interpolated value
-      if (m_Interpolator->IsInsideBuffer(point))
+      const ContinuousIndexType inputIndex =
+        inputPtr->template TransformPhysicalPointToContinuousIndex<CoordinateType>(point);
+      isInside[i] = m_Interpolator->IsInsideBuffer(inputIndex);
+      if (isInside[i])
+      {
+        insideIndices[numberOfInside++] = inputIndex;
+      }
+    }
+
+    // get the interpolated values
+    m_Interpolator->EvaluateAtContinuousIndices(insideIndices.data(), numberOfInside, values.data());
+    numberOfInside = 0;
+    for (SizeValueType i = 0; i < lineLength; ++i)
+    {
+      if (isInside[i])
       {
-        auto value = static_cast<PixelType>(m_Interpolator->Evaluate(point));
-        outputIt.Set(value);
+        lineIt.Set(static_cast<PixelType>(values[numberOfInside++]));
       }
       else
       {
-        outputIt.Set(m_EdgePaddingValue);
+        lineIt.Set(m_EdgePaddingValue);
       }
-      ++outputIt;
-      ++fieldIt;
-      progress.CompletedPixel();
+      ++lineIt;
+    }
+    progress.Completed(lineLength);
+  };
+
+  ImageScanlineIterator outputIt(outputPtr, outputRegionForThread);
+  if (this->m_DefFieldSameInformation)
+  {
+    // iterator for the deformation field
+    ImageScanlineConstIterator fieldIt(fieldPtr, outputRegionForThread);
+
+    for (; !outputIt.IsAtEnd(); outputIt.NextLine(), fieldIt.NextLine())
+    {
+      warpLine(outputIt, [&fieldIt](const PointType &, DisplacementType & lineDisplacement) {
+        lineDisplacement = fieldIt.Get();
+        ++fieldIt;
+      });
     }
   }
   else
   {
-    while (!outputIt.IsAtEnd())
+    for (; !outputIt.IsAtEnd(); outputIt.NextLine())
     {
-      // get the output image index
-      index = outputIt.GetIndex();
-      outputPtr->TransformIndexToPhysicalPoint(index, point);
-
-      this->EvaluateDisplacementAtPhysicalPoint(point, fieldPtr, displacement);
-      // compute the required input image point
-      for (unsigned int j = 0; j < ImageDimension; ++j)
-      {
-        point[j] += displacement[j];
-      }
-
-      // get the interpolated value
-      if (m_Interpolator->IsInsideBuffer(point))
-      {
-        auto value = static_cast<PixelType>(m_Interpolator->Evaluate(point));
-        outputIt.Set(value);
-      }
-      else
-      {
-        outputIt.Set(m_EdgePaddingValue);
-      }
-      ++outputIt;
-      progress.CompletedPixel();
+      warpLine(outputIt, [this, fieldPtr](const PointType & outputPoint, DisplacementType & lineDisplacement) {
+        this->EvaluateDisplacementAtPhysicalPoint(outputPoint, fieldPtr, lineDisplacement);
+      });
     }
   }
 }
@@ -20,12 +20,17 @@
 #include "itkResampleImageFilter.h"
 
 #include "itkAffineTransform.h"
+#include "itkBSplineDeformableTransform.h"
+#include "itkBSplineTransform.h"
 #include "itkCastImageFilter.h"
+#include "itkCompositeTransform.h"
 #include "itkGaussianInterpolateImageFunction.h"
 #include "itkImage.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionSplitterDirection.h"
 #include "itkStreamingImageFilter.h"
+#include "itkTranslationTransform.h"
 
 // Google Test header file:
 #include <gtest/gtest.h>
@@ -241,3 +246,256 @@ TEST(ResampleImageFilter, StreamingMatchesNonStreamedWithGaussianInterpolator)
   }
   EXPECT_EQ(itU.IsAtEnd(), itS.IsAtEnd());
 }
+
+
+// Checks the resampling of scan lines which cross the border of the input
+// buffer, against evaluating the interpolator at each point, and that
+// splitting the output in columns does not change it.
+TEST(ResampleImageFilter, LinearTransformScanlinesMatchPointwiseEvaluation)
+{
+  constexpr unsigned int Dimension{ 2 };
+  using ImageType = itk::Image<float, Dimension>;
+
+  const auto input = ImageType::New();
+  input->SetRegions(ImageType::RegionType({ { 3, -4 } }, { { 40, 30 } }));
+  input->Allocate();
+  std::mt19937                          generator(1);
+  std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+  for (itk::ImageRegionIterator<ImageType> it(input, input->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(distribution(generator));
+  }
+
+  const auto transform = itk::AffineTransform<double, Dimension>::New();
+  transform->Rotate2D(0.4);
+  transform->Scale(0.8);
+  transform->Translate(itk::MakeVector(10.0, -12.0));
+
+  // The filter detaches its interpolator from the input after updating,
+  // so that the points are evaluated by another one.
+  constexpr float defaultValue{ -1.0f };
+  const auto      interpolator = itk::LinearInterpolateImageFunction<ImageType>::New();
+  interpolator->SetInputImage(input);
+
+  const auto resampler = itk::ResampleImageFilter<ImageType, ImageType>::New();
+  resampler->SetInput(input);
+  resampler->SetTransform(transform);
+  resampler->SetDefaultPixelValue(defaultValue);
+  resampler->SetOutputStartIndex({ { -5, -7 } });
+  resampler->SetSize({ { 67, 53 } });
+  resampler->SetOutputOrigin(itk::MakePoint(-2.5, 1.5));
+  resampler->SetOutputSpacing(itk::MakeVector(0.9, 1.1));
+  ASSERT_NO_THROW(resampler->Update());
+  const ImageType::Pointer output = resampler->GetOutput();
+  output->DisconnectPipeline();
+
+  unsigned int numberOfInside = 0;
+  unsigned int numberOfOutside = 0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(output, output->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const auto point = transform->TransformPoint(output->TransformIndexToPhysicalPoint<double>(it.GetIndex()));
+    const auto index = input->TransformPhysicalPointToContinuousIndex<double>(point);
+    if (interpolator->IsInsideBuffer(index))
+    {
+      EXPECT_NEAR(it.Get(), interpolator->EvaluateAtContinuousIndex(index), 1e-3) << "at " << it.GetIndex();
+      ++numberOfInside;
+    }
+    else if (it.Get() != defaultValue)
+    {
+      // Only points at the very border may be classified differently.
+      EXPECT_EQ(it.Get(), interpolator->EvaluateAtContinuousIndex(index)) << "at " << it.GetIndex();
+    }
+    else
+    {
+      ++numberOfOutside;
+    }
+  }
+  EXPECT_GT(numberOfInside, 0u);
+  EXPECT_GT(numberOfOutside, 0u);
+
+  // The requested regions are columns of the output, so that each scan
+  // line is resampled in pieces.
+  const auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(resampler->GetOutput());
+  const auto splitter = itk::ImageRegionSplitterDirection::New();
+  splitter->SetDirection(1);
+  streamer->SetRegionSplitter(splitter);
+  streamer->SetNumberOfStreamDivisions(7);
+  ASSERT_NO_THROW(streamer->UpdateLargestPossibleRegion());
+
+  itk::ImageRegionIterator<ImageType> itU(output, output->GetLargestPossibleRegion());
+  itk::ImageRegionIterator<ImageType> itS(streamer->GetOutput(), output->GetLargestPossibleRegion());
+  for (; !itU.IsAtEnd(); ++itU, ++itS)
+  {
+    EXPECT_EQ(itU.Get(), itS.Get());
+  }
+}
+
+
+// Checks that the input requested region of a chunk of the output is only a
+// part of the input, for transforms whose displacements are bounded, and
+// that streaming the output does not change it.
+TEST(ResampleImageFilter, BoundedDisplacementTransformRequestsPartOfInput)
+{
+  constexpr unsigned int Dimension{ 2 };
+  using ImageType = itk::Image<float, Dimension>;
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+
+  const auto input = ImageType::New();
+  input->SetRegions(ImageType::SizeType{ { 64, 64 } });
+  input->SetSpacing(itk::MakeVector(0.5, 2.0));
+  input->Allocate();
+  std::mt19937                          generator(1);
+  std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+  for (itk::ImageRegionIterator<ImageType> it(input, input->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(distribution(generator));
+  }
+
+  // Displacements of at most 2 along x and 4 along y, summed by the composite
+  // transform.
+  const auto compositeTransform = itk::CompositeTransform<double, Dimension>::New();
+  for (const double maximumDisplacement : { 1.0, 3.0 })
+  {
+    const auto transform = BSplineTransformType::New();
+    transform->SetTransformDomainOrigin(input->GetOrigin());
+    transform->SetTransformDomainPhysicalDimensions(itk::MakeVector(32.0, 128.0));
+    transform->SetTransformDomainMeshSize(BSplineTransformType::MeshSizeType::Filled(4));
+    auto                                   parameters = transform->GetParameters();
+    std::uniform_real_distribution<double> displacementDistribution(-maximumDisplacement, maximumDisplacement);
+    for (auto & parameter : parameters)
+    {
+      parameter = displacementDistribution(generator);
+    }
+    parameters[0] = maximumDisplacement;
+    transform->SetParametersByValue(parameters);
+    compositeTransform->AddTransform(transform);
+  }
+
+  const auto upstream = itk::CastImageFilter<ImageType, ImageType>::New();
+  upstream->SetInput(input);
+
+  const auto resampler = itk::ResampleImageFilter<ImageType, ImageType>::New();
+  resampler->SetInput(upstream->GetOutput());
+  resampler->SetTransform(compositeTransform);
+  resampler->UseReferenceImageOn();
+  resampler->SetReferenceImage(input);
+
+  const auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(resampler->GetOutput());
+  ASSERT_NO_THROW(streamer->UpdateLargestPossibleRegion());
+  const ImageType::Pointer unstreamed = streamer->GetOutput();
+  unstreamed->DisconnectPipeline();
+
+  // The last chunk is the rows from 56 to 63, enlarged by one row over the
+  // boxes of its pixels, padded by 2 rows for the displacements, and one
+  // more for the linear interpolator, and cropped by the input.
+  input->Modified();
+  streamer->SetNumberOfStreamDivisions(8);
+  ASSERT_NO_THROW(streamer->UpdateLargestPossibleRegion());
+  EXPECT_EQ(upstream->GetOutput()->GetRequestedRegion(), ImageType::RegionType({ { 0, 52 } }, { { 64, 12 } }));
+
+  itk::ImageRegionIterator<ImageType> itU(unstreamed, unstreamed->GetLargestPossibleRegion());
+  itk::ImageRegionIterator<ImageType> itS(streamer->GetOutput(), unstreamed->GetLargestPossibleRegion());
+  for (; !itU.IsAtEnd(); ++itU, ++itS)
+  {
+    EXPECT_EQ(itU.Get(), itS.Get());
+  }
+
+  // The whole input is requested for a transform which is not supported.
+  const auto affineTransform = itk::AffineTransform<double, Dimension>::New();
+  affineTransform->Scale(1.5);
+  compositeTransform->AddTransform(affineTransform);
+  compositeTransform->AddTransform(BSplineTransformType::New());
+  ASSERT_NO_THROW(streamer->UpdateLargestPossibleRegion());
+  EXPECT_EQ(upstream->GetOutput()->GetRequestedRegion(), input->GetLargestPossibleRegion());
+}
+
+
+// Checks that the bulk transform of a BSplineDeformableTransform is taken
+// into account by the input requested region, against the resampling of
+// the whole input.
+TEST(ResampleImageFilter, BulkTransformOfBSplineIsStreamed)
+{
+  constexpr unsigned int Dimension{ 2 };
+  using ImageType = itk::Image<float, Dimension>;
+  using BSplineTransformType = itk::BSplineDeformableTransform<double, Dimension, 3>;
+
+  const auto input = ImageType::New();
+  input->SetRegions(ImageType::SizeType{ { 64, 64 } });
+  input->SetSpacing(itk::MakeVector(0.5, 2.0));
+  input->Allocate();
+  std::mt19937                          generator(1);
+  std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+  for (itk::ImageRegionIterator<ImageType> it(input, input->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(distribution(generator));
+  }
+
+  const auto transform = BSplineTransformType::New();
+  transform->SetGridOrigin(itk::MakePoint(-8.0, -32.0));
+  transform->SetGridSpacing(itk::MakeVector(8.0, 32.0));
+  transform->SetGridRegion(BSplineTransformType::RegionType(BSplineTransformType::SizeType{ { 8, 8 } }));
+  BSplineTransformType::ParametersType   parameters(transform->GetNumberOfParameters());
+  std::uniform_real_distribution<double> displacementDistribution(-1.0, 1.0);
+  for (auto & parameter : parameters)
+  {
+    parameter = displacementDistribution(generator);
+  }
+  transform->SetParametersByValue(parameters);
+
+  // Shifts the input by 10 rows, much more than the B-spline displacements.
+  const auto bulkTransform = itk::TranslationTransform<double, Dimension>::New();
+  bulkTransform->SetOffset(itk::MakeVector(3.0, 20.0));
+  transform->SetBulkTransform(bulkTransform);
+
+  // The input is buffered whole, whatever the region requested.
+  const auto resampler = itk::ResampleImageFilter<ImageType, ImageType>::New();
+  resampler->SetInput(input);
+  resampler->SetTransform(transform);
+  resampler->UseReferenceImageOn();
+  resampler->SetReferenceImage(input);
+  ASSERT_NO_THROW(resampler->Update());
+  const ImageType::Pointer wholeInputOutput = resampler->GetOutput();
+  wholeInputOutput->DisconnectPipeline();
+
+  // Only the requested regions of the input are buffered.
+  const auto upstream = itk::CastImageFilter<ImageType, ImageType>::New();
+  upstream->SetInput(input);
+  resampler->SetInput(upstream->GetOutput());
+
+  const auto streamer = itk::StreamingImageFilter<ImageType, ImageType>::New();
+  streamer->SetInput(resampler->GetOutput());
+  streamer->SetNumberOfStreamDivisions(8);
+  ASSERT_NO_THROW(streamer->UpdateLargestPossibleRegion());
+  EXPECT_NE(upstream->GetOutput()->GetRequestedRegion(), input->GetLargestPossibleRegion());
+
+  itk::ImageRegionIterator<ImageType> itW(wholeInputOutput, wholeInputOutput->GetLargestPossibleRegion());
+  itk::ImageRegionIterator<ImageType> itS(streamer->GetOutput(), wholeInputOutput->GetLargestPossibleRegion());
+  for (; !itW.IsAtEnd(); ++itW, ++itS)
+  {
+    EXPECT_EQ(itW.Get(), itS.Get());
+  }
+
+  // The bound is computed again when the bulk transform alone is modified,
+  // which SetOffset() does not tell.
+  bulkTransform->SetOffset(itk::MakeVector(3.0, 44.0));
+  bulkTransform->Modified();
+  resampler->SetInput(input);
+  ASSERT_NO_THROW(resampler->UpdateLargestPossibleRegion());
+  const ImageType::Pointer shiftedWholeInputOutput = resampler->GetOutput();
+  shiftedWholeInputOutput->DisconnectPipeline();
+
+  resampler->SetInput(upstream->GetOutput());
+  streamer->SetInput(resampler->GetOutput());
+  ASSERT_NO_THROW(streamer->UpdateLargestPossibleRegion());
+  itk::ImageRegionIterator<ImageType> itShiftedW(shiftedWholeInputOutput,
+                                                 shiftedWholeInputOutput->GetLargestPossibleRegion());
+  itk::ImageRegionIterator<ImageType> itShiftedS(streamer->GetOutput(),
+                                                 shiftedWholeInputOutput->GetLargestPossibleRegion());
+  for (; !itShiftedW.IsAtEnd(); ++itShiftedW, ++itShiftedS)
+  {
+    EXPECT_EQ(itShiftedW.Get(), itShiftedS.Get());
+  }
+}
@@ -18,6 +18,7 @@
 #ifndef itkArithmeticOpsFunctors_h
 #define itkArithmeticOpsFunctors_h
 
+#include "itkIntTypes.h"
 #include "itkMath.h"
 
 namespace itk::Functor
@@ -44,6 +45,16 @@ public:
   {
     return static_cast<TOutput>(A + B);
   }
+
+  /** Batch overload, used by BinaryGeneratorImageFilter on contiguous scanlines. */
+  inline void
+  operator()(const TInput1 * A, const TInput2 * B, TOutput * output, SizeValueType n) const
+  {
+    for (SizeValueType i = 0; i < n; ++i)
+    {
+      output[i] = (*this)(A[i], B[i]);
+    }
+  }
 };
 
 
@@ -94,6 +105,16 @@ public:
   {
     return static_cast<TOutput>(A - B);
   }
+
+  /** Batch overload, used by BinaryGeneratorImageFilter on contiguous scanlines. */
+  inline void
+  operator()(const TInput1 * A, const TInput2 * B, TOutput * output, SizeValueType n) const
+  {
+    for (SizeValueType i = 0; i < n; ++i)
+    {
+      output[i] = (*this)(A[i], B[i]);
+    }
+  }
 };
 
 
@@ -119,6 +140,16 @@ public:
   {
     return static_cast<TOutput>(A * B);
   }
+
+  /** Batch overload, used by BinaryGeneratorImageFilter on contiguous scanlines. */
+  inline void
+  operator()(const TInput1 * A, const TInput2 * B, TOutput * output, SizeValueType n) const
+  {
+    for (SizeValueType i = 0; i < n; ++i)
+    {
+      output[i] = (*this)(A[i], B[i]);
+    }
+  }
 };
 
 
@@ -149,6 +180,16 @@ public:
 
     return NumericTraits<TOutput>::max(static_cast<TOutput>(A));
   }
+
+  /** Batch overload, used by BinaryGeneratorImageFilter on contiguous scanlines. */
+  inline void
+  operator()(const TInput1 * A, const TInput2 * B, TOutput * output, SizeValueType n) const
+  {
+    for (SizeValueType i = 0; i < n; ++i)
+    {
+      output[i] = (*this)(A[i], B[i]);
+    }
+  }
 };
 
 
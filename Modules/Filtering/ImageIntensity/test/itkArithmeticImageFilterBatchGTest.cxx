@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAddImageFilter.h"
+#include "itkDivideImageFilter.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkSubtractImageFilter.h"
+#include "itkImageBufferRange.h"
+#include "itkGTest.h"
+
+#include <algorithm>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+// An image whose rows are not a multiple of any vector width, with zeros.
+ImageType::Pointer
+MakeImage(float offset)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 37, 11, 5 } });
+  image->Allocate();
+  float value = offset;
+  for (float & pixel : itk::MakeImageBufferRange(image.GetPointer()))
+  {
+    value = value > 20.0f ? -20.0f : value + 0.75f;
+    pixel = value;
+  }
+  return image;
+}
+
+// Compares the output of a filter of the batch path with the per-pixel path
+// of BinaryGeneratorImageFilter, given a lambda calling the same functor,
+// for two images and for a constant second operand.
+template <typename TFilter>
+void
+ExpectBatchMatchesPerPixel()
+{
+  using FunctorType = typename TFilter::FunctorType;
+  static_assert(itk::Functor::BatchTraits::UseBinaryBatch<FunctorType, ImageType, ImageType, ImageType>);
+
+  const auto input1 = MakeImage(0.0f);
+  const auto input2 = MakeImage(0.25f);
+
+  for (const bool constantOperand : { false, true })
+  {
+    const auto batchFilter = TFilter::New();
+    const auto perPixelFilter = itk::BinaryGeneratorImageFilter<ImageType, ImageType, ImageType>::New();
+    perPixelFilter->SetFunctor([](const float & a, const float & b) { return FunctorType{}(a, b); });
+    batchFilter->SetNumberOfWorkUnits(3);
+    perPixelFilter->SetNumberOfWorkUnits(3);
+    batchFilter->SetInput1(input1);
+    perPixelFilter->SetInput1(input1);
+    if (constantOperand)
+    {
+      batchFilter->SetConstant2(1.5f);
+      perPixelFilter->SetConstant2(1.5f);
+    }
+    else
+    {
+      batchFilter->SetInput2(input2);
+      perPixelFilter->SetInput2(input2);
+    }
+    batchFilter->Update();
+    perPixelFilter->Update();
+
+    const auto batchRange = itk::MakeImageBufferRange(batchFilter->GetOutput());
+    const auto perPixelRange = itk::MakeImageBufferRange(perPixelFilter->GetOutput());
+    EXPECT_TRUE(std::equal(batchRange.cbegin(), batchRange.cend(), perPixelRange.cbegin(), perPixelRange.cend()))
+      << batchFilter->GetNameOfClass() << (constantOperand ? " with a constant" : "");
+  }
+}
+} // namespace
+
+
+TEST(ArithmeticImageFilterBatch, MatchesPerPixelPath)
+{
+  ExpectBatchMatchesPerPixel<itk::AddImageFilter<ImageType>>();
+  ExpectBatchMatchesPerPixel<itk::SubtractImageFilter<ImageType>>();
+  ExpectBatchMatchesPerPixel<itk::MultiplyImageFilter<ImageType>>();
+  ExpectBatchMatchesPerPixel<itk::DivideImageFilter<ImageType, ImageType, ImageType>>();
+}
@@ -89,3 +89,42 @@ TEST(ArithmeticOpsTest, UnaryMinus)
   EXPECT_EQ(-1, op1(1));
   EXPECT_EQ(2, op1(-2));
 }
+
+
+TEST(ArithmeticOpsTest, BatchOverloads)
+{
+  const float A[] = { 5.0f, -5.0f, 1.5f, 0.0f, 7.0f };
+  const float B[] = { 2.0f, 2.0f, -0.5f, 3.0f, 0.0f };
+  float       output[5];
+
+  const itk::Functor::Add2<float, float, float> add;
+  add(A, B, output, 5);
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(add(A[i], B[i]), output[i]);
+  }
+
+  const itk::Functor::Sub2<float, float, float> sub;
+  sub(A, B, output, 5);
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(sub(A[i], B[i]), output[i]);
+  }
+
+  // Including a division by zero.
+  const itk::Functor::Div<float, float, float> div;
+  div(A, B, output, 5);
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(div(A[i], B[i]), output[i]);
+  }
+
+  // In place
+  float inPlace[] = { 5.0f, -5.0f, 1.5f, 0.0f, 7.0f };
+  const itk::Functor::Mult<float, float, float> mult;
+  mult(inPlace, B, inPlace, 5);
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(A[i] * B[i], inPlace[i]);
+  }
+}
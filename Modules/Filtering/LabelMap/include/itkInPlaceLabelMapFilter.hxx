@@ -54,8 +54,10 @@ template <typename TInputImage>
 void
 InPlaceLabelMapFilter<TInputImage>::AllocateOutputs()
 {
-  // if told to run in place and the types support it,
-  if (this->m_InPlace && this->CanRunInPlace())
+  // if told to run in place and the types support it, and the input may be
+  // overwritten
+  const TInputImage * inputPtr = this->GetInput();
+  if (this->m_InPlace && this->CanRunInPlace() && (inputPtr == nullptr || inputPtr->GetReuseDataFlag()))
   {
     // Graft this first input to the output.  Later, we'll need to
     // remove the input's hold on the bulk data.
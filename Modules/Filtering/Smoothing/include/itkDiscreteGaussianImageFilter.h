@@ -22,9 +22,43 @@
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "ITKSmoothingExport.h"
+
+#include <type_traits>
 
 namespace itk
 {
+/** \class DiscreteGaussianImageFilterEnums
+ * \brief Contains all enum classes used by DiscreteGaussianImageFilter class.
+ * \ingroup ITKSmoothing
+ */
+class DiscreteGaussianImageFilterEnums
+{
+public:
+  /**
+   * \class Backend
+   * \ingroup ITKSmoothing
+   * How DiscreteGaussianImageFilter computes the convolution.
+   *
+   * DIRECT convolves with the directional Gaussian operators, one
+   * dimension after the other. FFT convolves with the same kernel in the
+   * frequency domain. RECURSIVE approximates the Gaussian with the
+   * infinite impulse response filters of RecursiveGaussianImageFilter.
+   * AUTOMATIC picks the fastest of them which meets MaximumError. The
+   * default is DIRECT.
+   */
+  enum class Backend : uint8_t
+  {
+    AUTOMATIC = 0,
+    DIRECT,
+    FFT,
+    RECURSIVE
+  };
+};
+// Define how to print enumeration
+extern ITKSmoothing_EXPORT std::ostream &
+operator<<(std::ostream & out, const DiscreteGaussianImageFilterEnums::Backend value);
+
 /**
  * \class DiscreteGaussianImageFilter
  * \brief Blurs an image by separable convolution with discrete gaussian kernels.
@@ -41,13 +75,26 @@ namespace itk
  * independently in each dimension.
  *
  * When the Gaussian kernel is small, this filter tends to run faster than
- * itk::RecursiveGaussianImageFilter.
+ * itk::RecursiveGaussianImageFilter. For larger kernels, the filter can
+ * compute the same convolution by FFT, or approximate it with recursive
+ * Gaussian filters, whose cost does not depend on sigma. By default the
+ * Backend is DIRECT, the separable convolution with the discrete kernel.
+ * When the Backend is set to AUTOMATIC, the filter estimates the cost of
+ * each backend from the kernel widths and the image size, and uses the
+ * cheapest one. The recursive backend is then only selected when the
+ * difference between its impulse response and the discrete Gaussian kernel
+ * is below MaximumError, and neither the FFT nor the recursive backend is
+ * selected for images of vector pixels or when a boundary condition other
+ * than the default one is set. Since the FFT and recursive backends do not
+ * compute exactly the same values as the direct convolution, AUTOMATIC
+ * trades reproducibility for speed.
  *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
  * \sa RecursiveGaussianImageFilter
+ * \sa FFTConvolutionImageFilter
  *
  * \ingroup ImageEnhancement
  * \ingroup ImageFeatureExtraction
@@ -119,6 +166,8 @@ public:
   using KernelType = GaussianOperator<RealOutputPixelValueType, ImageDimension>;
   using RadiusType = typename KernelType::RadiusType;
 
+  using BackendEnum = DiscreteGaussianImageFilterEnums::Backend;
+
   /** The variance for the discrete Gaussian kernel.  Sets the variance
    * independently for each dimension, but
    * see also SetVariance(const double v). The default is 0.0 in each
@@ -320,6 +369,21 @@ public:
   }
 #endif
 
+  /** Set/Get how the convolution is computed. The default is DIRECT.
+   * \sa DiscreteGaussianImageFilterEnums::Backend */
+  /** @ITKStartGrouping */
+  itkSetEnumMacro(Backend, BackendEnum);
+  itkGetEnumMacro(Backend, BackendEnum);
+  /** @ITKEndGrouping */
+
+  /** Get the backend which computes the output for the current input and
+   * parameters: the Backend, or the one selected from the estimated costs
+   * when the Backend is AUTOMATIC. Throws when no input is set, or when
+   * the FFT or recursive backend is pinned for pixel types which they do
+   * not support. */
+  [[nodiscard]] BackendEnum
+  GetSelectedBackend() const;
+
   /** \brief Set/Get number of pieces to divide the input for the
    * internal composite pipeline. The upstream pipeline will not be
    * effected.
@@ -377,6 +441,40 @@ protected:
   GetKernelVarianceArray() const;
 
 private:
+  /** Type of the real valued images of the FFT and recursive backends. */
+  using RealImageType = Image<RealOutputPixelValueType, ImageDimension>;
+
+  /** The FFT and recursive backends work on images of scalar pixels. */
+  static constexpr bool SupportsFFTAndRecursiveBackends =
+    std::is_arithmetic_v<InputPixelType> && std::is_arithmetic_v<OutputPixelType> &&
+    std::is_same_v<TInputImage, Image<InputPixelType, ImageDimension>> &&
+    std::is_same_v<TOutputImage, Image<OutputPixelType, ImageDimension>>;
+
+  /** Build an image of the separable kernel, as the product of the
+   * directional kernels of the filtered dimensions. */
+  typename RealImageType::Pointer
+  GenerateSeparableKernelImage(unsigned int filterDimensionality) const;
+
+  /** Convolve the input with the separable kernel by FFT. */
+  void
+  FFTGenerateData(const TInputImage * input, unsigned int filterDimensionality);
+
+  /** Smooth the input with a recursive Gaussian filter per dimension. */
+  void
+  RecursiveGenerateData(const TInputImage * input, unsigned int filterDimensionality);
+
+  /** Estimate of the sum of the absolute differences between the impulse
+   * response of the recursive Gaussian filter and the discrete Gaussian
+   * kernel, for a standard deviation in pixels. */
+  static double
+  EstimateRecursiveError(double sigma);
+
+  /** Costs of the FFT and recursive backends, relative to a multiply-add of
+   * the direct convolution, per pixel. The constants were measured with
+   * itkDiscreteGaussianImageFilterBackendBenchmark. */
+  static constexpr double RecursiveCostPerDimension = 6.0;
+  static constexpr double FFTCostPerLog2Size = 2.1;
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance{};
@@ -396,6 +494,8 @@ private:
   /** Flag to indicate whether to use image spacing */
   bool m_UseImageSpacing{};
 
+  BackendEnum m_Backend{ BackendEnum::DIRECT };
+
   /** Pointer to a persistent boundary condition object used
    ** for the image iterator. */
   BoundaryConditionType * m_InputBoundaryCondition{};
@@ -19,11 +19,18 @@
 #define itkDiscreteGaussianImageFilter_hxx
 
 #include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkFFTConvolutionImageFilter.h"
 #include "itkGaussianOperator.h"
+#include "itkRecursiveGaussianImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkProgressAccumulator.h"
+#include "itkRealToHalfHermitianForwardFFTImageFilter.h"
 #include "itkImageAlgorithm.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace itk
 {
 template <typename TInputImage, typename TOutputImage>
@@ -104,6 +111,212 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GetKernelVarianceArray()
   return this->GetVariance();
 }
 
+template <typename TInputImage, typename TOutputImage>
+double
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::EstimateRecursiveError(double sigma)
+{
+  // The recursive filters approximate a sampled Gaussian to about 0.0055,
+  // while the discrete Gaussian kernel differs from a sampled Gaussian by
+  // about 0.12 / sigma^2, as measured for sigma from 0.5 to 8 pixels.
+  if (sigma <= 0.0)
+  {
+    return NumericTraits<double>::max();
+  }
+  return 0.0055 + 0.125 / (sigma * sigma);
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GetSelectedBackend() const -> BackendEnum
+{
+  const TInputImage * input = this->GetInput();
+  if (input == nullptr)
+  {
+    itkExceptionStringMacro("Could not select the backend: no input image was provided");
+  }
+
+  if constexpr (!SupportsFFTAndRecursiveBackends)
+  {
+    if (m_Backend == BackendEnum::FFT || m_Backend == BackendEnum::RECURSIVE)
+    {
+      itkExceptionMacro("The " << m_Backend << " backend requires images of scalar pixels");
+    }
+    return BackendEnum::DIRECT;
+  }
+  else
+  {
+    if (m_Backend != BackendEnum::AUTOMATIC)
+    {
+      return m_Backend;
+    }
+
+    const unsigned int filterDimensionality = std::min(m_FilterDimensionality, ImageDimension);
+    if (filterDimensionality == 0 || m_InputBoundaryCondition != &m_InputDefaultBoundaryCondition ||
+        m_RealBoundaryCondition != &m_RealDefaultBoundaryCondition)
+    {
+      return BackendEnum::DIRECT;
+    }
+
+    // Estimate the costs per output pixel from the kernel widths, and from
+    // the size of the padded image for the FFT. The largest possible region
+    // is used so that every streamed piece selects the same backend.
+    const auto &    size = input->GetLargestPossibleRegion().GetSize();
+    const ArrayType variance = this->GetKernelVarianceArray();
+    double          directCost = 0.0;
+    double          numberOfPixels = 1.0;
+    double          paddedNumberOfPixels = 1.0;
+    bool            recursiveIsAccurate = true;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      numberOfPixels *= size[dim];
+      if (dim < filterDimensionality)
+      {
+        const double kernelWidth = 2.0 * this->GetKernelRadius(dim) + 1.0;
+        directCost += kernelWidth;
+        paddedNumberOfPixels *= size[dim] + kernelWidth - 1.0;
+        recursiveIsAccurate = recursiveIsAccurate && size[dim] >= 4 &&
+                              EstimateRecursiveError(std::sqrt(variance[dim])) <= m_MaximumError[dim];
+      }
+      else
+      {
+        paddedNumberOfPixels *= size[dim];
+      }
+    }
+    const double fftCost = FFTCostPerLog2Size * std::log2(paddedNumberOfPixels) * paddedNumberOfPixels / numberOfPixels;
+    const double recursiveCost = RecursiveCostPerDimension * filterDimensionality;
+
+    // The FFT filters are created by the object factories, which may not
+    // have been registered.
+    using ForwardFFTType = RealToHalfHermitianForwardFFTImageFilter<RealImageType>;
+    const std::string forwardFFTName = typeid(ForwardFFTType).name();
+    bool              fftIsAvailable = false;
+    if (fftCost < directCost)
+    {
+      for (ObjectFactoryBase * factory : ObjectFactoryBase::GetRegisteredFactories())
+      {
+        const std::list<std::string> overrides = factory->GetClassOverrideNames();
+        fftIsAvailable =
+          fftIsAvailable || std::find(overrides.cbegin(), overrides.cend(), forwardFFTName) != overrides.cend();
+      }
+    }
+
+    if (recursiveIsAccurate && recursiveCost < directCost && (!fftIsAvailable || recursiveCost < fftCost))
+    {
+      return BackendEnum::RECURSIVE;
+    }
+    return fftIsAvailable ? BackendEnum::FFT : BackendEnum::DIRECT;
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateSeparableKernelImage(
+  unsigned int filterDimensionality) const -> typename RealImageType::Pointer
+{
+  std::vector<KernelType> oper(filterDimensionality);
+  auto                    kernelSize = RealImageType::SizeType::Filled(1);
+  for (unsigned int dim = 0; dim < filterDimensionality; ++dim)
+  {
+    this->GenerateKernel(dim, oper[dim]);
+    kernelSize[dim] = oper[dim].GetRadius(dim) * 2 + 1;
+  }
+
+  auto kernelImage = RealImageType::New();
+  kernelImage->SetRegions(kernelSize);
+  kernelImage->SetSpacing(this->GetInput()->GetSpacing());
+  kernelImage->SetDirection(this->GetInput()->GetDirection());
+  kernelImage->Allocate();
+
+  for (ImageRegionIteratorWithIndex<RealImageType> it(kernelImage, kernelImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    RealOutputPixelValueType value = 1;
+    for (unsigned int dim = 0; dim < filterDimensionality; ++dim)
+    {
+      value *= oper[dim].GetElement(it.GetIndex()[dim]);
+    }
+    it.Set(value);
+  }
+  return kernelImage;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::FFTGenerateData(const TInputImage * input,
+                                                                        unsigned int        filterDimensionality)
+{
+  if constexpr (SupportsFFTAndRecursiveBackends)
+  {
+    using ConvolutionFilterType =
+      FFTConvolutionImageFilter<TInputImage, RealImageType, TOutputImage, RealOutputPixelValueType>;
+
+    TOutputImage * output = this->GetOutput();
+
+    auto progress = ProgressAccumulator::New();
+    progress->SetMiniPipelineFilter(this);
+
+    auto convolutionFilter = ConvolutionFilterType::New();
+    convolutionFilter->SetInput(input);
+    convolutionFilter->SetKernelImage(this->GenerateSeparableKernelImage(filterDimensionality));
+    convolutionFilter->SetBoundaryCondition(m_InputBoundaryCondition);
+    convolutionFilter->NormalizeOff(); // The kernel is already normalized
+    progress->RegisterInternalFilter(convolutionFilter, 1.0f);
+
+    convolutionFilter->GraftOutput(output);
+    convolutionFilter->Update();
+    this->GraftOutput(convolutionFilter->GetOutput());
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::RecursiveGenerateData(const TInputImage * input,
+                                                                              unsigned int        filterDimensionality)
+{
+  if constexpr (SupportsFFTAndRecursiveBackends)
+  {
+    using FirstFilterType = RecursiveGaussianImageFilter<TInputImage, RealImageType>;
+    using FilterType = RecursiveGaussianImageFilter<RealImageType, RealImageType>;
+
+    TOutputImage * output = this->GetOutput();
+
+    auto progress = ProgressAccumulator::New();
+    progress->SetMiniPipelineFilter(this);
+
+    // The recursive filters take their sigma in physical units.
+    const ArrayType variance = this->GetKernelVarianceArray();
+    const auto &    spacing = input->GetSpacing();
+
+    auto firstFilter = FirstFilterType::New();
+    firstFilter->SetInput(input);
+    firstFilter->SetDirection(0);
+    firstFilter->SetSigma(std::sqrt(variance[0]) * spacing[0]);
+    firstFilter->ReleaseDataFlagOn();
+    progress->RegisterInternalFilter(firstFilter, 1.0f / filterDimensionality);
+    RealImageType * smoothed = firstFilter->GetOutput();
+
+    std::vector<typename FilterType::Pointer> filters;
+    for (unsigned int dim = 1; dim < filterDimensionality; ++dim)
+    {
+      auto filter = FilterType::New();
+      filter->SetInput(smoothed);
+      filter->SetDirection(dim);
+      filter->SetSigma(std::sqrt(variance[dim]) * spacing[dim]);
+      filter->ReleaseDataFlagOn();
+      progress->RegisterInternalFilter(filter, 1.0f / filterDimensionality);
+      filters.push_back(filter);
+      smoothed = filter->GetOutput();
+    }
+
+    // Each recursive filter requests whole lines along its direction, which
+    // GenerateInputRequestedRegion() requested from the input. The output is
+    // then copied from the requested region of the last one.
+    smoothed->SetRequestedRegion(output->GetRequestedRegion());
+    smoothed->Update();
+    ImageAlgorithm::Copy(smoothed, output, output->GetRequestedRegion(), output->GetRequestedRegion());
+  }
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
@@ -144,6 +357,17 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRe
   // crop the input requested region at the input's largest possible region
   inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion());
 
+  // the recursive filters need whole lines along the filtered dimensions
+  if (this->GetSelectedBackend() == BackendEnum::RECURSIVE)
+  {
+    const auto & largestRegion = inputPtr->GetLargestPossibleRegion();
+    for (unsigned int i = 0; i < std::min(m_FilterDimensionality, ImageDimension); ++i)
+    {
+      inputRequestedRegion.SetIndex(i, largestRegion.GetIndex(i));
+      inputRequestedRegion.SetSize(i, largestRegion.GetSize(i));
+    }
+  }
+
   inputPtr->SetRequestedRegion(inputRequestedRegion);
 }
 
@@ -178,6 +402,21 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
     return;
   }
 
+  if constexpr (SupportsFFTAndRecursiveBackends)
+  {
+    switch (this->GetSelectedBackend())
+    {
+      case BackendEnum::FFT:
+        this->FFTGenerateData(localInput, filterDimensionality);
+        return;
+      case BackendEnum::RECURSIVE:
+        this->RecursiveGenerateData(localInput, filterDimensionality);
+        return;
+      default:
+        break;
+    }
+  }
+
   // Type definition for the internal neighborhood filter
   //
   // First filter convolves and changes type from input type to real type
@@ -342,6 +581,7 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream &
   os << indent << "MaximumKernelWidth: " << m_MaximumKernelWidth << std::endl;
   os << indent << "FilterDimensionality: " << m_FilterDimensionality << std::endl;
   itkPrintSelfBooleanMacro(UseImageSpacing);
+  os << indent << "Backend: " << m_Backend << std::endl;
   os << indent << "RealBoundaryCondition: " << m_RealBoundaryCondition << std::endl;
 }
 } // end namespace itk
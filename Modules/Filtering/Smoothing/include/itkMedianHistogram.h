@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMedianHistogram_h
+#define itkMedianHistogram_h
+
+#include "itkIntTypes.h"
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace itk::Function
+{
+/** \class MedianHistogram
+ * \brief A histogram of the values of an integer type of at most 16 bits,
+ * keeping track of a fixed rank as values are added and removed.
+ *
+ * The histogram has a bin for every value of the pixel type. As in the
+ * algorithm of Huang, Yang and Tang ("A fast two-dimensional median
+ * filtering algorithm", 1979), the bin holding the value of the given rank
+ * is kept, together with the number of values below it, and moved only by
+ * as many bins as needed after the histogram changed. Bins are grouped in
+ * blocks, whose counts allow skipping a whole block at once, so that even
+ * 16 bit values which change a lot are followed quickly.
+ *
+ * The rank is zero based: GetValue() returns the value which would be at
+ * position rank of the sorted values in the histogram, which must hold
+ * more than rank values.
+ *
+ * \sa MedianImageFilter
+ * \ingroup ITKSmoothing
+ */
+template <typename TInputPixel>
+class MedianHistogram
+{
+public:
+  static_assert(std::is_integral_v<TInputPixel> && !std::is_same_v<TInputPixel, bool> && sizeof(TInputPixel) <= 2,
+                "MedianHistogram supports integer types of at most 16 bits.");
+
+  explicit MedianHistogram(SizeValueType rank)
+    : m_Rank(rank)
+  {}
+
+  void
+  AddPixel(const TInputPixel & p)
+  {
+    const unsigned int bin = GetBin(p);
+    ++m_Counts[bin];
+    ++m_BlockCounts[bin / BlockSize];
+    if (bin < m_Bin)
+    {
+      ++m_Below;
+    }
+  }
+
+  void
+  RemovePixel(const TInputPixel & p)
+  {
+    const unsigned int bin = GetBin(p);
+    --m_Counts[bin];
+    --m_BlockCounts[bin / BlockSize];
+    if (bin < m_Bin)
+    {
+      --m_Below;
+    }
+  }
+
+  TInputPixel
+  GetValue()
+  {
+    // Too many values below: move down, a whole block at a time when the
+    // current bin starts a block.
+    while (m_Below > m_Rank)
+    {
+      if (m_Bin % BlockSize == 0 && m_Below - m_BlockCounts[m_Bin / BlockSize - 1] > m_Rank)
+      {
+        m_Below -= m_BlockCounts[m_Bin / BlockSize - 1];
+        m_Bin -= BlockSize;
+      }
+      else
+      {
+        --m_Bin;
+        m_Below -= m_Counts[m_Bin];
+      }
+    }
+    // Too few values up to the current bin: move up.
+    while (m_Below + m_Counts[m_Bin] <= m_Rank)
+    {
+      if (m_Bin % BlockSize == 0 && m_Below + m_BlockCounts[m_Bin / BlockSize] <= m_Rank)
+      {
+        m_Below += m_BlockCounts[m_Bin / BlockSize];
+        m_Bin += BlockSize;
+      }
+      else
+      {
+        m_Below += m_Counts[m_Bin];
+        ++m_Bin;
+      }
+    }
+    return static_cast<TInputPixel>(static_cast<int>(m_Bin) + Lowest);
+  }
+
+private:
+  static constexpr int          Lowest = std::numeric_limits<TInputPixel>::lowest();
+  static constexpr unsigned int NumberOfBins = 1u << (8 * sizeof(TInputPixel));
+  static constexpr unsigned int BlockSize = 1u << (4 * sizeof(TInputPixel));
+
+  static unsigned int
+  GetBin(const TInputPixel & p)
+  {
+    return static_cast<unsigned int>(static_cast<int>(p) - Lowest);
+  }
+
+  SizeValueType              m_Rank;
+  std::vector<unsigned int>  m_Counts = std::vector<unsigned int>(NumberOfBins);
+  std::vector<SizeValueType> m_BlockCounts = std::vector<SizeValueType>(NumberOfBins / BlockSize);
+
+  // The bin of the value of the given rank, when last computed, and the
+  // number of values in the bins below it.
+  unsigned int  m_Bin{ 0 };
+  SizeValueType m_Below{ 0 };
+};
+} // namespace itk::Function
+
+#endif
@@ -21,6 +21,8 @@
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
 
+#include <type_traits>
+
 namespace itk
 {
 /**
@@ -36,6 +38,13 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For itk::Image inputs of integer pixel types of at most 16 bits, the
+ * median is computed by default from a histogram of the neighborhood,
+ * which is updated as the neighborhood slides along each line of the
+ * image: only the pixels entering and leaving the neighborhood are visited,
+ * instead of all pixels of the neighborhood being partially sorted. Both
+ * ways compute the same output, see SetUseHistogram().
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -88,6 +97,22 @@ public:
   itkConceptMacro(InputConvertibleToOutputCheck, (Concept::Convertible<InputPixelType, OutputPixelType>));
   itkConceptMacro(InputLessThanComparableCheck, (Concept::LessThanComparable<InputPixelType>));
 
+  /** Whether the pixel type of the input allows computing the median from a
+   * histogram. */
+  static constexpr bool SupportsHistogram =
+    std::is_integral_v<InputPixelType> && !std::is_same_v<InputPixelType, bool> && sizeof(InputPixelType) <= 2 &&
+    std::is_same_v<InputImageType, Image<InputPixelType, InputImageDimension>>;
+
+  /** Compute the median from a sliding histogram, when the input supports
+   * it, rather than by partially sorting the neighborhood of every pixel.
+   * On by default; mostly useful to compare both. Small neighborhoods are
+   * sorted regardless, as that is faster for them. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseHistogram, bool);
+  itkGetConstMacro(UseHistogram, bool);
+  itkBooleanMacro(UseHistogram);
+  /** @ITKEndGrouping */
+
 protected:
   MedianImageFilter();
   ~MedianImageFilter() override = default;
@@ -104,6 +129,20 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Computes the median from a histogram which slides along every line of
+   * the region. */
+  void
+  HistogramThreadedGenerateData(const OutputImageRegionType & outputRegionForThread);
+
+  // The smallest neighborhood for which the histogram is faster than sorting.
+  static constexpr SizeValueType MinimumHistogramNeighborhoodSize = 25;
+
+  bool m_UseHistogram{ true };
 };
 } // end namespace itk
 
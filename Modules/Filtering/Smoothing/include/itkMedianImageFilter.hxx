@@ -21,7 +21,9 @@
 #include "itkBufferedImageNeighborhoodPixelAccessPolicy.h"
 #include "itkImageNeighborhoodOffsets.h"
 #include "itkImageRegionRange.h"
+#include "itkImageScanlineIterator.h"
 #include "itkIndexRange.h"
+#include "itkMedianHistogram.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkShapedImageNeighborhoodRange.h"
@@ -50,6 +52,24 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
 
   const auto radius = this->GetRadius();
 
+  if constexpr (SupportsHistogram)
+  {
+    // The histogram is cleared after each line by removing the pixels of
+    // the last neighborhood, which is only worth it when lines are longer
+    // than the neighborhood, and sorting is faster for small ones.
+    SizeValueType neighborhoodSize = 1;
+    for (unsigned int dimension = 0; dimension < InputImageDimension; ++dimension)
+    {
+      neighborhoodSize *= 2 * radius[dimension] + 1;
+    }
+    if (m_UseHistogram && outputRegionForThread.GetSize(0) > 2 * radius[0] + 1 &&
+        neighborhoodSize >= MinimumHistogramNeighborhoodSize)
+    {
+      this->HistogramThreadedGenerateData(outputRegionForThread);
+      return;
+    }
+  }
+
   // Find the data-set boundary "faces" and the center non-boundary subregion.
   const auto calculatorResult =
     NeighborhoodAlgorithm::ImageBoundaryFacesCalculator<InputImageType>::Compute(*input, outputRegionForThread, radius);
@@ -104,6 +124,115 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::HistogramThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  OutputImageType *      output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+
+  const auto radius = this->GetRadius();
+
+  // Outside of the buffered region, pixels have the value of the nearest
+  // pixel inside it, as with the zero flux Neumann boundary condition used
+  // when sorting.
+  const InputImageRegionType bufferedRegion = input->GetBufferedRegion();
+  const auto                 lower = bufferedRegion.GetIndex();
+  const auto                 upper = bufferedRegion.GetUpperIndex();
+  const auto clampedBufferOffset = [&lower, &upper](IndexValueType index, unsigned int dimension) {
+    return std::clamp(index, lower[dimension], upper[dimension]) - lower[dimension];
+  };
+
+  // The neighborhood of a pixel is made of columns along the line, one
+  // pixel wide along the other dimensions. Each column is made of one pixel
+  // of every row crossing the neighborhood.
+  SizeValueType numberOfRows = 1;
+  for (unsigned int dimension = 1; dimension < InputImageDimension; ++dimension)
+  {
+    numberOfRows *= 2 * radius[dimension] + 1;
+  }
+  std::vector<const InputPixelType *> rows(numberOfRows);
+  const SizeValueType                 neighborhoodSize = numberOfRows * (2 * radius[0] + 1);
+
+  Function::MedianHistogram<InputPixelType> histogram(neighborhoodSize / 2);
+
+  const auto addColumn = [&](IndexValueType x) {
+    const OffsetValueType column = clampedBufferOffset(x, 0);
+    for (const InputPixelType * const row : rows)
+    {
+      histogram.AddPixel(row[column]);
+    }
+  };
+  const auto removeColumn = [&](IndexValueType x) {
+    const OffsetValueType column = clampedBufferOffset(x, 0);
+    for (const InputPixelType * const row : rows)
+    {
+      histogram.RemovePixel(row[column]);
+    }
+  };
+
+  const InputPixelType * const buffer = input->GetBufferPointer();
+  const auto &                 offsetTable = input->GetOffsetTable();
+  const IndexValueType         radius0 = static_cast<IndexValueType>(radius[0]);
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  ImageScanlineIterator<OutputImageType> outputIt(output, outputRegionForThread);
+  while (!outputIt.IsAtEnd())
+  {
+    const auto lineIndex = outputIt.GetIndex();
+    for (SizeValueType row = 0; row < numberOfRows; ++row)
+    {
+      OffsetValueType offset = 0;
+      SizeValueType   remainder = row;
+      for (unsigned int dimension = 1; dimension < InputImageDimension; ++dimension)
+      {
+        const SizeValueType  span = 2 * radius[dimension] + 1;
+        const IndexValueType index = lineIndex[dimension] + static_cast<IndexValueType>(remainder % span) -
+                                     static_cast<IndexValueType>(radius[dimension]);
+        offset += clampedBufferOffset(index, dimension) * offsetTable[dimension];
+        remainder /= span;
+      }
+      rows[row] = buffer + offset;
+    }
+
+    IndexValueType x = lineIndex[0];
+    for (IndexValueType column = x - radius0; column <= x + radius0; ++column)
+    {
+      addColumn(column);
+    }
+    for (;;)
+    {
+      outputIt.Set(static_cast<OutputPixelType>(histogram.GetValue()));
+      ++outputIt;
+      if (outputIt.IsAtEndOfLine())
+      {
+        break;
+      }
+      ++x;
+      removeColumn(x - radius0 - 1);
+      addColumn(x + radius0);
+    }
+    for (IndexValueType column = x - radius0; column <= x + radius0; ++column)
+    {
+      removeColumn(column);
+    }
+
+    outputIt.NextLine();
+    progress.Completed(outputRegionForThread.GetSize(0));
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  BoxImageFilter<TInputImage, TOutputImage>::PrintSelf(os, indent);
+
+  itkPrintSelfBooleanMacro(UseHistogram);
+}
 } // end namespace itk
 
 #endif
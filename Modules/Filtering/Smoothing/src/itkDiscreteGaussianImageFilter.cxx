@@ -0,0 +1,42 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDiscreteGaussianImageFilter.h"
+
+namespace itk
+{
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const DiscreteGaussianImageFilterEnums::Backend value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case DiscreteGaussianImageFilterEnums::Backend::AUTOMATIC:
+        return "itk::DiscreteGaussianImageFilterEnums::Backend::AUTOMATIC";
+      case DiscreteGaussianImageFilterEnums::Backend::DIRECT:
+        return "itk::DiscreteGaussianImageFilterEnums::Backend::DIRECT";
+      case DiscreteGaussianImageFilterEnums::Backend::FFT:
+        return "itk::DiscreteGaussianImageFilterEnums::Backend::FFT";
+      case DiscreteGaussianImageFilterEnums::Backend::RECURSIVE:
+        return "itk::DiscreteGaussianImageFilterEnums::Backend::RECURSIVE";
+      default:
+        return "INVALID VALUE FOR itk::DiscreteGaussianImageFilterEnums::Backend";
+    }
+  }();
+}
+} // namespace itk
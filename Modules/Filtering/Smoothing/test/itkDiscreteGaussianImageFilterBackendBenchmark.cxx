@@ -0,0 +1,142 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the time DiscreteGaussianImageFilter takes with each of its
+// backends on a 3D float image, for sigmas of 1, 2, 4 and 8 pixels, and
+// reports the backend which AUTOMATIC selects. The FFT output is checked
+// against the direct one, and the recursive output against the tolerance.
+//
+// The benchmark is built into ITKSmoothingTestDriver but, like the ones of
+// the PerformanceBenchmarking remote module, not registered as a test;
+// itkDiscreteGaussianImageFilterGTest compares the outputs of the backends.
+// Run it as
+//   ITKSmoothingTestDriver itkDiscreteGaussianImageFilterBackendBenchmark size [iterations]
+// e.g. a size of 128 benchmarks 128^3 volumes.
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageBufferRange.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using FilterType = itk::DiscreteGaussianImageFilter<ImageType, ImageType>;
+using BackendEnum = FilterType::BackendEnum;
+
+float
+MaximumDifference(const ImageType * image1, const ImageType * image2)
+{
+  const auto range1 = itk::MakeImageBufferRange(image1);
+  const auto range2 = itk::MakeImageBufferRange(image2);
+  float      difference = 0.0f;
+  for (auto it1 = range1.cbegin(), it2 = range2.cbegin(); it1 != range1.cend(); ++it1, ++it2)
+  {
+    difference = std::max(difference, std::abs(*it1 - *it2));
+  }
+  return difference;
+}
+} // namespace
+
+int
+itkDiscreteGaussianImageFilterBackendBenchmark(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " size [iterations]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto         size = static_cast<itk::SizeValueType>(std::stoul(argv[1]));
+  const unsigned int iterations = argc > 2 ? std::stoi(argv[2]) : 1;
+
+  // Values from 0 to 100.
+  auto input = ImageType::New();
+  input->SetRegions(ImageType::SizeType::Filled(size));
+  input->Allocate();
+  std::mt19937                          generator(1);
+  std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+  for (float & pixel : itk::MakeImageBufferRange(input.GetPointer()))
+  {
+    pixel = distribution(generator);
+  }
+
+  constexpr double maximumError = 0.01;
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+  for (const double sigma : { 1.0, 2.0, 4.0, 8.0 })
+  {
+    const std::string label = "sigma " + std::to_string(static_cast<int>(sigma));
+
+    std::map<BackendEnum, ImageType::Pointer> outputs;
+    for (const auto & [backend, backendName] : { std::make_pair(BackendEnum::DIRECT, "direct"),
+                                                 std::make_pair(BackendEnum::FFT, "FFT"),
+                                                 std::make_pair(BackendEnum::RECURSIVE, "recursive") })
+    {
+      auto filter = FilterType::New();
+      filter->SetInput(input);
+      filter->SetSigma(sigma);
+      filter->SetMaximumError(maximumError);
+      filter->SetMaximumKernelWidth(128);
+      filter->SetBackend(backend);
+
+      const std::string name = label + ' ' + backendName;
+      for (unsigned int i = 0; i < iterations; ++i)
+      {
+        filter->Modified();
+        collector.Start(name.c_str());
+        filter->Update();
+        collector.Stop(name.c_str());
+      }
+      outputs[backend] = filter->GetOutput();
+
+      if (backend == BackendEnum::DIRECT)
+      {
+        filter->SetBackend(BackendEnum::AUTOMATIC);
+        std::cout << label << " kernel width " << filter->GetKernelSize()[0] << " selects "
+                  << filter->GetSelectedBackend() << std::endl;
+      }
+    }
+
+    const float fftDifference = MaximumDifference(outputs[BackendEnum::FFT], outputs[BackendEnum::DIRECT]);
+    const float recursiveDifference = MaximumDifference(outputs[BackendEnum::RECURSIVE], outputs[BackendEnum::DIRECT]);
+    std::cout << label << " maximum difference to direct: FFT " << fftDifference << ", recursive "
+              << recursiveDifference << std::endl;
+    if (fftDifference > 1e-3f)
+    {
+      std::cerr << "Error: " << label << " FFT and direct outputs differ" << std::endl;
+      ok = false;
+    }
+  }
+
+  collector.Report(std::cout);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkDiscreteGaussianImageFilter.h"
+
+#include "itkConstantBoundaryCondition.h"
+#include "itkImage.h"
+#include "itkImageBufferRange.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkVector.h"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <algorithm>
+#include <random>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+using BackendEnum = itk::DiscreteGaussianImageFilterEnums::Backend;
+
+// The FFT backend needs the FFT factories.
+class DiscreteGaussianImageFilter : public ::testing::Test
+{
+protected:
+  static void
+  SetUpTestSuite()
+  {
+    RegisterRequiredFFTFactories();
+  }
+};
+
+template <typename TImage>
+typename TImage::Pointer
+CreateRandomImage(const typename TImage::SizeType & size)
+{
+  const auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  std::mt19937                       generator(1);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  for (auto & pixel : itk::MakeImageBufferRange(image.GetPointer()))
+  {
+    pixel = static_cast<typename TImage::PixelType>(distribution(generator));
+  }
+  return image;
+}
+
+
+// Returns the largest absolute difference between the pixels of the images
+// in the given region.
+template <typename TImage>
+double
+MaximumDifference(const TImage * image1, const TImage * image2, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIterator<TImage> it1(image1, region);
+  itk::ImageRegionConstIterator<TImage> it2(image2, region);
+  double                                difference = 0.0;
+  for (; !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    difference = std::max(difference, std::abs(static_cast<double>(it1.Get()) - static_cast<double>(it2.Get())));
+  }
+  return difference;
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+typename TOutputImage::Pointer
+Smooth(const TInputImage *                       input,
+       double                                    sigma,
+       BackendEnum                               backend,
+       const typename TOutputImage::RegionType & requestedRegion,
+       unsigned int                              filterDimensionality = TInputImage::ImageDimension)
+{
+  const auto filter = itk::DiscreteGaussianImageFilter<TInputImage, TOutputImage>::New();
+  filter->SetInput(input);
+  filter->SetSigma(sigma);
+  filter->SetMaximumKernelWidth(64);
+  filter->SetFilterDimensionality(filterDimensionality);
+  filter->SetBackend(backend);
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  filter->Update();
+  EXPECT_TRUE(filter->GetOutput()->GetBufferedRegion().IsInside(requestedRegion));
+  return filter->GetOutput();
+}
+} // namespace
+
+
+TEST_F(DiscreteGaussianImageFilter, SelectsBackend)
+{
+  using ImageType = itk::Image<float, 3>;
+  using FilterType = itk::DiscreteGaussianImageFilter<ImageType>;
+
+  const auto filter = FilterType::New();
+  EXPECT_EQ(filter->GetBackend(), BackendEnum::DIRECT);
+  EXPECT_THROW([[maybe_unused]] const auto backend = filter->GetSelectedBackend(), itk::ExceptionObject);
+  filter->SetBackend(BackendEnum::AUTOMATIC);
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(128));
+  filter->SetInput(image);
+  filter->SetMaximumKernelWidth(128);
+
+  // Small kernels are convolved directly.
+  filter->SetSigma(1.0);
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::DIRECT);
+
+  // Large ones are approximated recursively, when that is accurate enough.
+  filter->SetSigma(8.0);
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::RECURSIVE);
+  filter->SetMaximumError(0.001);
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::FFT);
+  filter->SetMaximumError(0.01);
+
+  // The spacing converts sigma to pixels.
+  image->SetSpacing(itk::MakeFilled<ImageType::SpacingType>(8.0));
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::DIRECT);
+  filter->UseImageSpacingOff();
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::RECURSIVE);
+
+  // Too few pixels for the recursive filters.
+  const auto flatImage = ImageType::New();
+  flatImage->SetRegions(ImageType::SizeType{ { 128, 128, 3 } });
+  filter->SetInput(flatImage);
+  EXPECT_NE(filter->GetSelectedBackend(), BackendEnum::RECURSIVE);
+  filter->SetFilterDimensionality(2);
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::RECURSIVE);
+  filter->SetInput(image);
+
+  // Boundary conditions are only supported by the direct convolution.
+  itk::ConstantBoundaryCondition<ImageType> boundaryCondition;
+  filter->SetInputBoundaryCondition(&boundaryCondition);
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::DIRECT);
+
+  for (const auto backend : { BackendEnum::DIRECT, BackendEnum::FFT, BackendEnum::RECURSIVE })
+  {
+    filter->SetBackend(backend);
+    EXPECT_EQ(filter->GetSelectedBackend(), backend);
+  }
+}
+
+
+TEST_F(DiscreteGaussianImageFilter, SelectsDirectBackendForVectorPixels)
+{
+  using ImageType = itk::Image<itk::Vector<float, 2>, 2>;
+  using FilterType = itk::DiscreteGaussianImageFilter<ImageType>;
+
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(64));
+
+  const auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetSigma(16.0);
+  filter->SetMaximumKernelWidth(128);
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::DIRECT);
+  filter->SetBackend(BackendEnum::AUTOMATIC);
+  EXPECT_EQ(filter->GetSelectedBackend(), BackendEnum::DIRECT);
+
+  filter->SetBackend(BackendEnum::FFT);
+  EXPECT_THROW([[maybe_unused]] const auto backend = filter->GetSelectedBackend(), itk::ExceptionObject);
+  filter->SetBackend(BackendEnum::RECURSIVE);
+  EXPECT_THROW(filter->Update(), itk::ExceptionObject);
+}
+
+
+TEST_F(DiscreteGaussianImageFilter, BackendsComputeSameOutput)
+{
+  using ImageType = itk::Image<float, 3>;
+
+  const auto               input = CreateRandomImage<ImageType>({ { 40, 30, 20 } });
+  const ImageType::RegionType largestRegion = input->GetLargestPossibleRegion();
+  const ImageType::RegionType requestedRegion({ { 3, 5, 2 } }, { { 20, 10, 15 } });
+
+  for (const double sigma : { 1.0, 3.0 })
+  {
+    for (const auto & region : { largestRegion, requestedRegion })
+    {
+      const auto direct = Smooth<ImageType, ImageType>(input, sigma, BackendEnum::DIRECT, region);
+      const auto fft = Smooth<ImageType, ImageType>(input, sigma, BackendEnum::FFT, region);
+      EXPECT_LT(MaximumDifference<ImageType>(fft, direct, region), 1e-3) << sigma << region;
+
+      // The recursive filters approximate a sampled Gaussian rather than the
+      // discrete one, and depend on whole lines.
+      const auto recursive = Smooth<ImageType, ImageType>(input, sigma, BackendEnum::RECURSIVE, region);
+      const auto recursiveOfLargestRegion =
+        Smooth<ImageType, ImageType>(input, sigma, BackendEnum::RECURSIVE, largestRegion);
+      EXPECT_LT(MaximumDifference<ImageType>(recursive, direct, region), 0.1 * 255 / sigma) << sigma << region;
+      EXPECT_EQ(MaximumDifference<ImageType>(recursive, recursiveOfLargestRegion, region), 0.0) << sigma << region;
+    }
+  }
+
+  // Smoothing only the slices.
+  const auto direct = Smooth<ImageType, ImageType>(input, 4.0, BackendEnum::DIRECT, requestedRegion, 2);
+  const auto fft = Smooth<ImageType, ImageType>(input, 4.0, BackendEnum::FFT, requestedRegion, 2);
+  const auto recursive = Smooth<ImageType, ImageType>(input, 4.0, BackendEnum::RECURSIVE, requestedRegion, 2);
+  EXPECT_LT(MaximumDifference<ImageType>(fft, direct, requestedRegion), 1e-3);
+  EXPECT_LT(MaximumDifference<ImageType>(recursive, direct, requestedRegion), 2.0);
+}
+
+
+TEST_F(DiscreteGaussianImageFilter, BackendsSupportIntegerPixels)
+{
+  using InputImageType = itk::Image<unsigned char, 2>;
+  using OutputImageType = itk::Image<float, 2>;
+
+  const auto input = CreateRandomImage<InputImageType>({ { 50, 40 } });
+  const auto region = input->GetLargestPossibleRegion();
+
+  const auto direct = Smooth<InputImageType, OutputImageType>(input, 5.0, BackendEnum::DIRECT, region);
+  const auto fft = Smooth<InputImageType, OutputImageType>(input, 5.0, BackendEnum::FFT, region);
+  const auto recursive = Smooth<InputImageType, OutputImageType>(input, 5.0, BackendEnum::RECURSIVE, region);
+  EXPECT_LT(MaximumDifference<OutputImageType>(fft, direct, region), 1e-3);
+  EXPECT_LT(MaximumDifference<OutputImageType>(recursive, direct, region), 2.0);
+
+  const auto automatic = Smooth<InputImageType, OutputImageType>(input, 5.0, BackendEnum::AUTOMATIC, region);
+  EXPECT_LT(MaximumDifference<OutputImageType>(automatic, direct, region), 2.0);
+}
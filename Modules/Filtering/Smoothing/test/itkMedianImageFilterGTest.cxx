@@ -21,8 +21,12 @@
 
 #include "itkImage.h"
 #include "itkImageBufferRange.h"
+#include "itkImageRegionIteratorWithIndex.h"
 
+#include <algorithm>
+#include <limits>
 #include <numeric> // For iota.
+#include <random>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -92,6 +96,25 @@ Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numb
   EXPECT_EQ(outputPixelValues, expectedPixelValues);
 }
 
+
+// Creates a test image, filled with random values spread over the whole range of the pixel type.
+template <typename TPixel, unsigned int VDimension>
+typename itk::Image<TPixel, VDimension>::Pointer
+CreateRandomImage(const itk::Size<VDimension> & size)
+{
+  const auto image = itk::Image<TPixel, VDimension>::New();
+  image->SetRegions(size);
+  image->Allocate();
+  std::mt19937                       generator(42);
+  std::uniform_int_distribution<int> distribution(std::numeric_limits<TPixel>::lowest(),
+                                                  std::numeric_limits<TPixel>::max());
+  for (TPixel & value : itk::MakeImageBufferRange(image.GetPointer()))
+  {
+    value = static_cast<TPixel>(distribution(generator));
+  }
+  return image;
+}
+
 } // namespace
 
 
@@ -122,3 +145,77 @@ TEST(MedianImageFilter, ExpectedOutputPixelValuesForSequenceOfNaturalNumbers)
   Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numbers<itk::Image<int, 3>>(
     itk::Size<3>{ { 2, 2, 2 } }, { 3, 3, 3, 4, 5, 6, 6, 6 });
 }
+
+
+// Tests that the histogram of integer pixel values yields the same output as sorting the neighborhood.
+TEST(MedianImageFilter, HistogramSameAsSorting)
+{
+  const auto check = [](auto image, const auto & radius) {
+    using ImageType = typename decltype(image)::ObjectType;
+    using FilterType = itk::MedianImageFilter<ImageType, ImageType>;
+
+    const auto sortingFilter = FilterType::New();
+    sortingFilter->SetInput(image);
+    sortingFilter->SetRadius(radius);
+    sortingFilter->UseHistogramOff();
+    sortingFilter->Update();
+
+    const auto histogramFilter = FilterType::New();
+    EXPECT_TRUE(histogramFilter->GetUseHistogram());
+    histogramFilter->SetInput(image);
+    histogramFilter->SetRadius(radius);
+    histogramFilter->Update();
+
+    const auto sortingOutput = itk::MakeImageBufferRange(sortingFilter->GetOutput());
+    const auto histogramOutput = itk::MakeImageBufferRange(histogramFilter->GetOutput());
+    EXPECT_TRUE(std::equal(sortingOutput.cbegin(), sortingOutput.cend(), histogramOutput.cbegin()))
+      << "radius: " << radius;
+  };
+
+  for (const unsigned int radius : { 2, 3 })
+  {
+    check(CreateRandomImage<unsigned char>(itk::Size<2>{ { 37, 29 } }), itk::Size<2>::Filled(radius));
+    check(CreateRandomImage<signed char>(itk::Size<2>{ { 37, 29 } }), itk::Size<2>::Filled(radius));
+    check(CreateRandomImage<short>(itk::Size<3>{ { 21, 13, 9 } }), itk::Size<3>::Filled(radius));
+    check(CreateRandomImage<unsigned short>(itk::Size<3>{ { 21, 13, 9 } }), itk::Size<3>::Filled(radius));
+  }
+
+  // Anisotropic radii, and a radius larger than the image.
+  check(CreateRandomImage<short>(itk::Size<3>{ { 21, 13, 9 } }), itk::Size<3>{ { 4, 0, 2 } });
+  check(CreateRandomImage<short>(itk::Size<3>{ { 21, 13, 9 } }), itk::Size<3>{ { 1, 3, 5 } });
+  check(CreateRandomImage<unsigned char>(itk::Size<2>{ { 37, 5 } }), itk::Size<2>{ { 2, 7 } });
+}
+
+
+// Tests the histogram on a smooth image, whose median changes little from one pixel to the next, and on part of an
+// image, which is processed line by line as well.
+TEST(MedianImageFilter, HistogramOfRequestedRegion)
+{
+  using ImageType = itk::Image<short, 3>;
+  using FilterType = itk::MedianImageFilter<ImageType, ImageType>;
+
+  const auto image = ImageType::New();
+  image->SetRegions(itk::Size<3>{ { 40, 30, 20 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto index = it.GetIndex();
+    it.Set(static_cast<short>(100 * index[0] - 37 * index[1] * index[2] + (index[0] * 7 + index[1] * 3) % 11));
+  }
+
+  const ImageType::RegionType requestedRegion({ { 3, 4, 5 } }, { { 30, 20, 10 } });
+  std::vector<std::vector<short>> outputs;
+  for (const bool useHistogram : { false, true })
+  {
+    const auto filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetRadius(2);
+    filter->SetUseHistogram(useHistogram);
+    filter->GetOutput()->SetRequestedRegion(requestedRegion);
+    filter->Update();
+    EXPECT_EQ(filter->GetOutput()->GetBufferedRegion(), requestedRegion);
+    const auto output = itk::MakeImageBufferRange(filter->GetOutput());
+    outputs.emplace_back(output.cbegin(), output.cend());
+  }
+  EXPECT_EQ(outputs[0], outputs[1]);
+}
@@ -0,0 +1,142 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the time MedianImageFilter takes to compute the median from a
+// sliding histogram against partially sorting every neighborhood, on 3D
+// images of unsigned char and of short pixels, for radii from 1 to
+// maxRadius.
+//
+// The benchmark is built into ITKSmoothingTestDriver but, like the ones of
+// the PerformanceBenchmarking remote module, not registered as a test;
+// itkMedianImageFilterGTest compares the outputs of both methods. Run it as
+//   ITKSmoothingTestDriver itkMedianImageFilterHistogramBenchmark size maxRadius [iterations]
+// e.g. a size of 256 benchmarks 256^3 volumes.
+
+#include "itkMedianImageFilter.h"
+#include "itkImageBufferRange.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+template <typename TPixel>
+typename itk::Image<TPixel, 3>::Pointer
+MakeImage(itk::SizeValueType size, int minimum, int maximum)
+{
+  // Smooth structures and noise, somewhat like a CT volume.
+  auto image = itk::Image<TPixel, 3>::New();
+  image->SetRegions(itk::Size<3>::Filled(size));
+  image->Allocate();
+  std::mt19937                       generator(1);
+  std::uniform_int_distribution<int> noise(-(maximum - minimum) / 16, (maximum - minimum) / 16);
+  itk::SizeValueType                 n = 0;
+  for (TPixel & pixel : itk::MakeImageBufferRange(image.GetPointer()))
+  {
+    const auto x = n % size;
+    const auto y = n / size % size;
+    const auto z = n / size / size;
+    ++n;
+    const int value = ((x / 16 + y / 16 + z / 16) % 3) * (maximum - minimum) / 3 + minimum + noise(generator);
+    pixel = static_cast<TPixel>(std::clamp(value, minimum, maximum));
+  }
+  return image;
+}
+
+template <typename TPixel>
+bool
+Benchmark(const char *                   name,
+          const itk::Image<TPixel, 3> *  input,
+          unsigned int                   maxRadius,
+          unsigned int                   iterations,
+          itk::TimeProbesCollectorBase & collector)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  using FilterType = itk::MedianImageFilter<ImageType, ImageType>;
+
+  bool ok = true;
+  for (unsigned int radius = 1; radius <= maxRadius; ++radius)
+  {
+    const std::string label = std::string(name) + " radius " + std::to_string(radius);
+
+    auto histogramFilter = FilterType::New();
+    histogramFilter->SetInput(input);
+    histogramFilter->SetRadius(radius);
+
+    auto sortingFilter = FilterType::New();
+    sortingFilter->SetInput(input);
+    sortingFilter->SetRadius(radius);
+    sortingFilter->UseHistogramOff();
+
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+      histogramFilter->Modified();
+      collector.Start((label + " histogram").c_str());
+      histogramFilter->Update();
+      collector.Stop((label + " histogram").c_str());
+
+      sortingFilter->Modified();
+      collector.Start((label + " sorting").c_str());
+      sortingFilter->Update();
+      collector.Stop((label + " sorting").c_str());
+    }
+
+    const auto histogramOutput = itk::MakeImageBufferRange(histogramFilter->GetOutput());
+    const auto sortingOutput = itk::MakeImageBufferRange(sortingFilter->GetOutput());
+    if (!std::equal(histogramOutput.cbegin(), histogramOutput.cend(), sortingOutput.cbegin()))
+    {
+      std::cerr << "Error: " << label << " histogram and sorting outputs differ" << std::endl;
+      ok = false;
+    }
+  }
+  return ok;
+}
+} // namespace
+
+int
+itkMedianImageFilterHistogramBenchmark(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " size maxRadius [iterations]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto         size = static_cast<itk::SizeValueType>(std::stoul(argv[1]));
+  const unsigned int maxRadius = std::stoi(argv[2]);
+  const unsigned int iterations = argc > 3 ? std::stoi(argv[3]) : 1;
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+
+  ok &= Benchmark<unsigned char>("uchar", MakeImage<unsigned char>(size, 0, 255), maxRadius, iterations, collector);
+  ok &= Benchmark<short>("short", MakeImage<short>(size, -1024, 3071), maxRadius, iterations, collector);
+
+  collector.Report(std::cout);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
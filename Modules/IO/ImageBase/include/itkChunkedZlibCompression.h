@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkChunkedZlibCompression_h
+#define itkChunkedZlibCompression_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class ChunkedZlibCompression
+ *
+ * \brief Compresses and decompresses data as independent deflate chunks, in parallel.
+ *
+ * The data is split into chunks of a fixed number of bytes (the last chunk
+ * may be shorter), and each chunk is deflated independently, on the ITK
+ * thread pool. The deflated chunks are joined, as pigz does, into a single
+ * standard zlib or gzip stream: every chunk but the last ends on a full
+ * flush, and the checksums of the chunks are combined into the checksum
+ * of the stream. Any zlib or gzip reader can therefore decompress the
+ * stream as a whole.
+ *
+ * The compressed size of every chunk forms the chunk index. Knowing the
+ * index, the chunks can also be inflated independently: in parallel, and
+ * only those holding a requested range of bytes. The index can be stored
+ * as text, for example in the header of a file, using ChunkIndexToString()
+ * and ChunkIndexFromString().
+ *
+ * Errors are reported by throwing an ExceptionObject.
+ *
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT ChunkedZlibCompression
+{
+public:
+  /** The compressed size, in bytes, of every chunk. */
+  using ChunkIndexType = std::vector<SizeValueType>;
+
+  /** The number of bytes of data in a chunk, unless specified otherwise. */
+  static constexpr SizeValueType DefaultChunkSize = SizeValueType{ 1 } << 22;
+
+  /** The chunk size for `size` bytes of data: DefaultChunkSize, or more
+   * for very large data, so that the chunk index remains short enough to
+   * be stored in the header of a file. */
+  static SizeValueType
+  GetChunkSize(SizeValueType size);
+
+  /** Compress `size` bytes of `data` with the given zlib compression level
+   * (0 to 9, or negative for the zlib default), into a zlib stream, or into
+   * a gzip stream when `gzip` is true. The compressed size of every chunk is
+   * stored in `chunkIndex`. */
+  static std::vector<unsigned char>
+  Compress(const void *     data,
+           SizeValueType    size,
+           int              compressionLevel,
+           bool             gzip,
+           SizeValueType    chunkSize,
+           ChunkIndexType & chunkIndex);
+
+  /** The number of bytes of the stream header, which precedes the first
+   * chunk. */
+  static SizeValueType
+  GetHeaderSize(bool gzip);
+
+  /** The number of bytes of the stream trailer, which follows the last
+   * chunk. */
+  static SizeValueType
+  GetTrailerSize(bool gzip);
+
+  /** The number of bytes of the stream header, the chunks and the stream
+   * trailer together. */
+  static SizeValueType
+  GetStreamSize(const ChunkIndexType & chunkIndex, bool gzip);
+
+  /** Inflate the chunks [firstChunk, endChunk) of a stream produced by
+   * Compress(), into `output`, which receives the bytes starting at
+   * firstChunk * chunkSize. `stream` points at the first byte of the first
+   * chunk to inflate, that is, at the stream header plus the compressed
+   * size of the chunks before firstChunk. When all chunks are inflated,
+   * the checksum of the stream, which must then directly follow the last
+   * chunk, is verified as well. */
+  static void
+  Decompress(const unsigned char *  stream,
+             const ChunkIndexType & chunkIndex,
+             SizeValueType          chunkSize,
+             SizeValueType          size,
+             bool                   gzip,
+             SizeValueType          firstChunk,
+             SizeValueType          endChunk,
+             void *                 output);
+
+  /** Store the chunk size and the chunk index as a string of numbers
+   * separated by spaces, and read them back. ChunkIndexFromString()
+   * returns false when the string is not a valid index. */
+  static std::string
+  ChunkIndexToString(SizeValueType chunkSize, const ChunkIndexType & chunkIndex);
+
+  static bool
+  ChunkIndexFromString(const std::string & text, SizeValueType & chunkSize, ChunkIndexType & chunkIndex);
+
+  /** The name used for the chunk index in the headers of files. */
+  static constexpr const char * ChunkIndexKey = "ITK_CompressedDataChunks";
+};
+} // namespace itk
+
+#endif // itkChunkedZlibCompression_h
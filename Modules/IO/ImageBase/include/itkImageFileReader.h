@@ -121,6 +121,24 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
   /** @ITKEndGrouping */
+
+  /** Set/Get whether the pixel data may be memory mapped from the file
+   * instead of being read into a newly allocated buffer. When on, and the
+   * ImageIO reports that the file holds the whole image uncompressed, in
+   * native byte order and in exactly the layout of the output image (see
+   * ImageIOBase::GetPixelDataFileLocation()), the pixel container of the
+   * output is a copy-on-write memory mapping of the file. Reading then
+   * costs no more than parsing the header, and processes mapping the same
+   * file share its pages. Otherwise, for example when a pixel type
+   * conversion is needed, when only part of the image is requested, or
+   * when the data in the file is not aligned for the pixel type, the image
+   * is read as usual. Modifying the output never modifies the file. Only
+   * supported for outputs of type Image. Default is off. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstReferenceMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+  /** @ITKEndGrouping */
 protected:
   ImageFileReader();
   ~ImageFileReader() override = default;
@@ -163,7 +181,15 @@ protected:
 
   bool m_UseStreaming{};
 
+  bool m_UseMemoryMapping{};
+
 private:
+  /** Try to make the output a memory mapping of the file, as described in
+   * SetUseMemoryMapping(). Returns false when the data must be read, after
+   * releasing any mapping made by an earlier update. */
+  bool
+  MemoryMapOutput();
+
   std::string m_ExceptionMessage{};
 
   // The region that the ImageIO class will return when we ask to
@@ -24,10 +24,12 @@
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
+#include "itkMemoryMappedImportImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
 #include "itkMakeUniqueForOverwrite.h"
 #include <fstream>
+#include <type_traits>
 
 namespace itk
 {
@@ -49,6 +51,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   itkPrintSelfBooleanMacro(UserSpecifiedImageIO);
   itkPrintSelfBooleanMacro(UseStreaming);
+  itkPrintSelfBooleanMacro(UseMemoryMapping);
 
   os << indent << "ExceptionMessage: " << m_ExceptionMessage << std::endl;
   os << indent << "ActualIORegion: " << m_ActualIORegion << std::endl;
@@ -360,6 +363,12 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
                 << output->GetRequestedRegion() << '\n');
 
+  if (this->MemoryMapOutput())
+  {
+    this->UpdateProgress(1.0f);
+    return;
+  }
+
   // allocated the output image to the size of the enlarge requested region
   this->AllocateOutputs();
 
@@ -441,6 +450,75 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+bool
+ImageFileReader<TOutputImage, ConvertPixelTraits>::MemoryMapOutput()
+{
+  if constexpr (!std::is_same_v<TOutputImage, Image<typename TOutputImage::PixelType, TOutputImage::ImageDimension>>)
+  {
+    return false;
+  }
+  else
+  {
+    using PixelContainerType = typename TOutputImage::PixelContainer;
+    using MappedPixelContainerType =
+      MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier, OutputImagePixelType>;
+
+    const typename TOutputImage::Pointer output = this->GetOutput();
+
+    // Do not read into the pages of a file mapped by an earlier update.
+    if (dynamic_cast<MappedPixelContainerType *>(output->GetPixelContainer()) != nullptr)
+    {
+      output->SetPixelContainer(PixelContainerType::New());
+    }
+
+    if (!m_UseMemoryMapping)
+    {
+      return false;
+    }
+
+    // The file must hold the whole image, with pixels of exactly the output
+    // pixel type, and the whole image must be requested.
+    const IOComponentEnum ioType = ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
+    if (m_ImageIO->GetComponentType() != ioType ||
+        m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents() ||
+        sizeof(OutputImagePixelType) != m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents() ||
+        m_ActualIORegion.GetNumberOfPixels() != output->GetRequestedRegion().GetNumberOfPixels() ||
+        static_cast<ImageIOBase::SizeType>(m_ActualIORegion.GetNumberOfPixels()) != m_ImageIO->GetImageSizeInPixels())
+    {
+      return false;
+    }
+
+    std::string           dataFileName;
+    ImageIOBase::SizeType dataOffset = 0;
+    if (!m_ImageIO->GetPixelDataFileLocation(dataFileName, dataOffset) || dataOffset < 0 ||
+        dataOffset % alignof(OutputImagePixelType) != 0)
+    {
+      return false;
+    }
+
+    const auto container = MappedPixelContainerType::New();
+    try
+    {
+      container->SetMappedFileRegion(
+        std::make_unique<MemoryMappedFileRegion>(dataFileName,
+                                                 static_cast<SizeValueType>(dataOffset),
+                                                 static_cast<SizeValueType>(m_ImageIO->GetImageSizeInBytes())));
+    }
+    catch (const ExceptionObject & err)
+    {
+      itkDebugMacro("Cannot memory map " << dataFileName << ", reading it instead: " << err.GetDescription());
+      return false;
+    }
+
+    itkDebugMacro("Memory mapped " << dataFileName << " at offset " << dataOffset);
+
+    output->SetBufferedRegion(output->GetRequestedRegion());
+    output->SetPixelContainer(container);
+    return true;
+  }
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(const void * inputData, size_t numberOfPixels)
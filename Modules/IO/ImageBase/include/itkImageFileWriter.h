@@ -167,6 +167,18 @@ public:
   itkSetMacro(NumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
   /** @ITKEndGrouping */
+
+  /** Set/Get whether the pieces are written on a background thread while
+   * the upstream pipeline computes the next piece, so that IO and compute
+   * overlap when streaming. At most MaximumNumberOfPiecesInFlight computed
+   * pieces wait to be written. Off by default. \sa StreamingPieceQueue */
+  /** @ITKStartGrouping */
+  itkSetMacro(Pipelined, bool);
+  itkGetConstMacro(Pipelined, bool);
+  itkBooleanMacro(Pipelined);
+  itkSetClampMacro(MaximumNumberOfPiecesInFlight, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(MaximumNumberOfPiecesInFlight, unsigned int);
+  /** @ITKEndGrouping */
   /** Aliased to the Write() method to be consistent with the rest of the
    * pipeline. */
   void
@@ -231,6 +243,9 @@ private:
   unsigned int  m_NumberOfStreamDivisions{ 1 };
   bool          m_UserSpecifiedIORegion{ false };
 
+  bool         m_Pipelined{ false };
+  unsigned int m_MaximumNumberOfPiecesInFlight{ 2 };
+
   bool m_FactorySpecifiedImageIO{ false }; // did factory mechanism set the ImageIO?
   bool m_UseCompression{ false };
   int  m_CompressionLevel{ -1 };
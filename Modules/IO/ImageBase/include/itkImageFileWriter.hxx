@@ -31,7 +31,10 @@
 #include "itkDiffusionTensor3D.h"
 #include "itkMatrix.h"
 #include "itkImageAlgorithm.h"
+#include "itkStreamingPieceQueue.h"
 #include <complex>
+#include <memory>
+#include <vector>
 
 namespace itk
 {
@@ -256,6 +259,25 @@ ImageFileWriter<TInputImage>::Write()
   unsigned int numDivisions =
     m_ImageIO->GetActualNumberOfSplitsForWriting(m_NumberOfStreamDivisions, pasteIORegion, largestIORegion);
 
+  // When pipelined, every piece but the last is taken from the input and
+  // written in the background while the next one is computed. The last
+  // piece is written from the input, after the others.
+  std::unique_ptr<StreamingPieceQueue> pieceQueue;
+  if (m_Pipelined && numDivisions > 1)
+  {
+    pieceQueue = std::make_unique<StreamingPieceQueue>(m_MaximumNumberOfPiecesInFlight);
+  }
+
+  // Get the pieces to write before writing any of them: when pipelined,
+  // the ImageIO is used by the background writes until the last piece, and
+  // must not be called from this thread meanwhile.
+  std::vector<ImageIORegion> streamIORegions;
+  streamIORegions.reserve(numDivisions);
+  for (unsigned int piece = 0; piece < numDivisions; ++piece)
+  {
+    streamIORegions.push_back(m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion));
+  }
+
   /**
    * Loop over the number of pieces, execute the upstream pipeline on each
    * piece, and copy the results into the output image.
@@ -264,8 +286,7 @@ ImageFileWriter<TInputImage>::Write()
   for (unsigned int piece = 0; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
   {
     // get the actual piece to write
-    ImageIORegion streamIORegion =
-      m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion);
+    ImageIORegion streamIORegion = streamIORegions[piece];
 
     // Check whether the paste region is fully contained inside the
     // largest region or not.
@@ -309,14 +330,36 @@ ImageFileWriter<TInputImage>::Write()
       }
     }
 
-    m_ImageIO->SetIORegion(streamIORegion);
+    if (pieceQueue && piece + 1 < numDivisions)
+    {
+      const InputImagePointer inputPiece = StreamingPieceQueue::TakePiece(nonConstInput, streamRegion);
+      pieceQueue->Push([this, inputPiece, streamIORegion] {
+        m_ImageIO->SetIORegion(streamIORegion);
+        m_ImageIO->Write(inputPiece->GetBufferPointer());
+      });
+    }
+    else
+    {
+      // The background writes are done before the ImageIO is used here.
+      if (pieceQueue)
+      {
+        pieceQueue->Wait();
+      }
+
+      m_ImageIO->SetIORegion(streamIORegion);
 
-    // write the data
-    this->GenerateData();
+      // write the data
+      this->GenerateData();
+    }
 
     this->UpdateProgress(static_cast<float>(piece + 1) / static_cast<float>(numDivisions));
   }
 
+  if (pieceQueue)
+  {
+    pieceQueue->Wait();
+  }
+
   // Notify end event observers
   this->InvokeEvent(EndEvent());
 
@@ -395,6 +438,8 @@ ImageFileWriter<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
   itkPrintSelfBooleanMacro(UseCompression);
   itkPrintSelfBooleanMacro(UseInputMetaDataDictionary);
+  itkPrintSelfBooleanMacro(Pipelined);
+  os << indent << "MaximumNumberOfPiecesInFlight: " << m_MaximumNumberOfPiecesInFlight << std::endl;
   itkPrintSelfBooleanMacro(FactorySpecifiedImageIO);
 }
 } // end namespace itk
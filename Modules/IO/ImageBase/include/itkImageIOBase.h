@@ -518,6 +518,19 @@ public:
   virtual void
   Read(void * buffer) = 0;
 
+  /** Determine whether the pixel data of the file may be used as is, for
+   * example by memory mapping it instead of reading it. Returns true, and
+   * the name of the file holding the pixel data and the byte offset of the
+   * data within that file, when the whole image is stored there
+   * uncompressed, contiguously and in the byte order of this machine,
+   * exactly as Read() would produce it for the largest possible region.
+   * Must be called after ReadImageInformation(). Default is false. */
+  virtual bool
+  GetPixelDataFileLocation(std::string & itkNotUsed(fileName), SizeType & itkNotUsed(offset))
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
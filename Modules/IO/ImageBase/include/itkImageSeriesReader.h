@@ -179,6 +179,22 @@ public:
   itkBooleanMacro(UseStreaming);
   /** @ITKEndGrouping */
 
+  /** Set/Get the maximum number of files which are decoded concurrently.
+   *
+   * With the default value of 1 the files are read one after the other.
+   * Larger values decode up to that many files at the same time on the
+   * threads of the MultiThreader of this filter, each file being read
+   * directly into its final location in the output buffer. The
+   * MetaDataDictionaryArray is the same as for sequential reading.
+   *
+   * The ImageIO must support several instances being used concurrently.
+   * When an ImageIO is set with SetImageIO(), each concurrent read uses a
+   * new instance of the same class, created with CreateAnother(). */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfParallelReads, unsigned int, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfParallelReads, unsigned int);
+  /** @ITKEndGrouping */
+
   /** Set the relative threshold for issuing warnings about non-uniform sampling */
   /** @ITKStartGrouping */
   itkSetMacro(SpacingWarningRelThreshold, double);
@@ -222,9 +238,20 @@ protected:
 
   double m_SpacingWarningRelThreshold{ 1e-4 };
 
+  unsigned int m_NumberOfParallelReads{ 1 };
+
 private:
   using ReaderType = ImageFileReader<TOutputImage>;
 
+  /** Information about one file of the series, collected by GenerateData. */
+  struct SliceInformation
+  {
+    bool                             Read{ false };
+    typename TOutputImage::PointType Origin{};
+    bool                             HasDictionary{ false };
+    MetaDataDictionary               Dictionary{};
+  };
+
   int
   ComputeMovingDimensionIndex(ReaderType * reader);
 
@@ -24,8 +24,11 @@
 #include "itkVector.h"
 #include "itkMath.h"
 #include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include "itkMetaDataObject.h"
-#include <cstddef> // For ptrdiff_t.
+#include "itkMultiThreaderBase.h"
+#include <algorithm> // For min.
+#include <cstddef>   // For ptrdiff_t.
 #include <iomanip>
 
 namespace itk
@@ -39,6 +42,7 @@ ImageSeriesReader<TOutputImage>::PrintSelf(std::ostream & os, Indent indent) con
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "ForceOrthogonalDirection: " << m_ForceOrthogonalDirection << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "NumberOfParallelReads: " << m_NumberOfParallelReads << std::endl;
   os << indent << "FileNames:" << std::endl;
   for (const auto & fileName : m_FileNames)
   {
@@ -283,9 +287,6 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0, requestedRegion.GetSize(TOutputImage::ImageDimension - 1), 100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
@@ -295,18 +296,18 @@ ImageSeriesReader<TOutputImage>::GenerateData()
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime && m_MetaDataDictionaryArrayUpdate;
 
   typename TOutputImage::InternalPixelType * outputBuffer = output->GetBufferPointer();
-  IndexType                                  sliceStartIndex = requestedRegion.GetIndex();
   const auto                                 numberOfFiles = static_cast<int>(m_FileNames.size());
+  const bool readInParallel = m_NumberOfParallelReads > 1 && numberOfFiles > 1;
 
-  typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
-  typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
-  double                             maxSpacingDeviation = 0.0;
-  bool                               prevSliceIsValid = false;
+  // Information gathered while reading each slice. It is only combined
+  // after all the slices are read, in the order of the files, so that the
+  // result does not depend on the order in which the slices are decoded.
+  std::vector<SliceInformation> slices(static_cast<size_t>(numberOfFiles));
 
-  m_InternalMetaDataDictionaries.reserve(static_cast<size_t>(numberOfFiles));
+  const auto readSlice = [&](SizeValueType sliceNumber) {
+    const auto i = static_cast<int>(sliceNumber);
 
-  for (int i = 0; i != numberOfFiles; ++i)
-  {
+    IndexType sliceStartIndex = requestedRegion.GetIndex();
     if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
     {
       sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
@@ -314,13 +315,11 @@ ImageSeriesReader<TOutputImage>::GenerateData()
 
     const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
     const int  iFileName = (m_ReverseOrder ? numberOfFiles - i - 1 : i);
-    bool       nonUniformSampling = false;
-    double     spacingDeviation = 0.0;
 
     // check if we need this slice
     if (!insideRequestedRegion && !needToUpdateMetaDataDictionaryArray)
     {
-      continue;
+      return;
     }
 
     // configure reader
@@ -331,7 +330,17 @@ ImageSeriesReader<TOutputImage>::GenerateData()
 
     if (m_ImageIO)
     {
-      reader->SetImageIO(m_ImageIO);
+      if (readInParallel)
+      {
+        // ImageIO objects are not thread-safe, each concurrent reader
+        // gets its own instance of the same class.
+        const LightObject::Pointer anotherImageIO = m_ImageIO->CreateAnother();
+        reader->SetImageIO(dynamic_cast<ImageIOBase *>(anotherImageIO.GetPointer()));
+      }
+      else
+      {
+        reader->SetImageIO(m_ImageIO);
+      }
     }
     reader->SetUseStreaming(m_UseStreaming);
     readerOutput->SetRequestedRegion(sliceRegionToRequest);
@@ -422,17 +431,84 @@ ImageSeriesReader<TOutputImage>::GenerateData()
         ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
       }
 
-      // verify that slice spacing is the expected one
-      // since we can be skipping some slices because they are outside of requested region
-      // I am using additional variable
+      slices[i].Read = true;
+      slices[i].Origin = readerOutput->GetOrigin();
+    } // end !insideRequestedRegion
+
+    // Deep copy the MetaDataDictionary
+    if (reader->GetImageIO())
+    {
+      slices[i].HasDictionary = true;
+      slices[i].Dictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    }
+  };
+
+  if (readInParallel)
+  {
+    // Bound the number of slices in flight by the number of parallel
+    // reads: each range reads a contiguous run of slices, and reports the
+    // progress of its read slices like the serial loop below.
+    const auto numberOfRanges =
+      static_cast<int>(std::min(m_NumberOfParallelReads, static_cast<unsigned int>(numberOfFiles)));
+    const auto readRange = [&](SizeValueType range) {
+      TotalProgressReporter progress(this, requestedRegion.GetSize(TOutputImage::ImageDimension - 1));
+
+      const auto first = static_cast<int>(range) * numberOfFiles / numberOfRanges;
+      const auto afterLast = (static_cast<int>(range) + 1) * numberOfFiles / numberOfRanges;
+      for (int i = first; i != afterLast; ++i)
+      {
+        readSlice(i);
+
+        if (slices[i].Read)
+        {
+          progress.CompletedPixel();
+        }
+      }
+    };
+    this->GetMultiThreader()->ParallelizeArray(0, numberOfRanges, readRange, nullptr);
+  }
+  else
+  {
+    // progress reported on a per slice basis
+    ProgressReporter progress(this, 0, requestedRegion.GetSize(TOutputImage::ImageDimension - 1), 100);
+
+    for (int i = 0; i != numberOfFiles; ++i)
+    {
+      readSlice(i);
+
+      // report progress for read slices
+      if (slices[i].Read)
+      {
+        progress.CompletedPixel();
+      }
+    }
+  }
+
+  typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
+  typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
+  double                             maxSpacingDeviation = 0.0;
+  bool                               prevSliceIsValid = false;
+
+  m_InternalMetaDataDictionaries.reserve(static_cast<size_t>(numberOfFiles));
+
+  for (SliceInformation & slice : slices)
+  {
+    bool   nonUniformSampling = false;
+    double spacingDeviation = 0.0;
+
+    // verify that slice spacing is the expected one
+    // since we can be skipping some slices because they are outside of requested region
+    // I am using additional variable
+    if (slice.Read)
+    {
       if (prevSliceIsValid)
       {
-        typename TOutputImage::PointType sliceOrigin = readerOutput->GetOrigin();
         using SpacingScalarType = typename TOutputImage::SpacingValueType;
         Vector<SpacingScalarType, TOutputImage::ImageDimension> dirN;
         for (size_t j = 0; j < TOutputImage::ImageDimension; ++j)
         {
-          dirN[j] = static_cast<SpacingScalarType>(sliceOrigin[j]) - static_cast<SpacingScalarType>(prevSliceOrigin[j]);
+          dirN[j] =
+            static_cast<SpacingScalarType>(slice.Origin[j]) - static_cast<SpacingScalarType>(prevSliceOrigin[j]);
         }
         const SpacingScalarType dirNnorm = dirN.GetNorm();
 
@@ -450,28 +526,23 @@ ImageSeriesReader<TOutputImage>::GenerateData()
 
           needToUpdateMetaDataDictionaryArray = true;
         }
-        prevSliceOrigin = sliceOrigin;
       }
       else
       {
-        prevSliceOrigin = readerOutput->GetOrigin();
         prevSliceIsValid = true;
       }
+      prevSliceOrigin = slice.Origin;
+    }
 
-      // report progress for read slices
-      progress.CompletedPixel();
-    } // end !insideRequestedRegion
-
-    // Deep copy the MetaDataDictionary into the array
-    if (reader->GetImageIO() && needToUpdateMetaDataDictionaryArray)
+    // Move the MetaDataDictionary into the array
+    if (slice.HasDictionary && needToUpdateMetaDataDictionaryArray)
     {
-      MetaDataDictionary newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
       if (nonUniformSampling)
       {
         // slice-specific information
-        EncapsulateMetaData<double>(newDictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
+        EncapsulateMetaData<double>(slice.Dictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
       }
-      m_InternalMetaDataDictionaries.push_back(std::move(newDictionary));
+      m_InternalMetaDataDictionaries.push_back(std::move(slice.Dictionary));
     }
   } // end per slice loop
 
@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkIndexedGzipFile_h
+#define itkIndexedGzipFile_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class IndexedGzipFile
+ *
+ * \brief Random access to the uncompressed bytes of a gzip file.
+ *
+ * A gzip stream can only be inflated from its start. To avoid doing so for
+ * every read, the constructor inflates the whole file once, and records a
+ * checkpoint at a deflate block boundary about every checkpointSpacing
+ * uncompressed bytes: the position in the compressed and in the uncompressed
+ * stream, and the 32 KiB of uncompressed data preceding it, which later
+ * blocks may refer to. Read() then resumes inflating at the last checkpoint
+ * before the requested bytes, so that at most about checkpointSpacing bytes
+ * are inflated in vain. Reads at increasing offsets continue where the
+ * previous read ended, unless a checkpoint lies in between.
+ *
+ * The index can be stored in a file, and is then read back instead of being
+ * built again, as long as the size and the modification time of the gzip
+ * file did not change. Failing to write the index file is not an error.
+ *
+ * Files made of several concatenated gzip members are supported. Errors,
+ * including a corrupt or truncated gzip file, are reported by throwing an
+ * ExceptionObject.
+ *
+ * \sa ChunkedZlibCompression
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT IndexedGzipFile
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexedGzipFile);
+
+  /** The number of uncompressed bytes between checkpoints, unless specified
+   * otherwise. */
+  static constexpr SizeValueType DefaultCheckpointSpacing = SizeValueType{ 1 } << 20;
+
+  /** Open the gzip file, and read its index from indexFileName, or build it
+   * when indexFileName is empty, does not exist or is out of date. A newly
+   * built index is written to indexFileName, unless that is empty. */
+  explicit IndexedGzipFile(const std::string & fileName,
+                           const std::string & indexFileName = "",
+                           SizeValueType       checkpointSpacing = DefaultCheckpointSpacing);
+
+  ~IndexedGzipFile();
+
+  /** Copy the uncompressed bytes [offset, offset + length) into buffer. */
+  void
+  Read(SizeValueType offset, SizeValueType length, void * buffer);
+
+  const std::string &
+  GetFileName() const
+  {
+    return m_FileName;
+  }
+
+  /** The number of bytes of the uncompressed data. */
+  SizeValueType
+  GetUncompressedSize() const
+  {
+    return m_UncompressedSize;
+  }
+
+  SizeValueType
+  GetNumberOfCheckpoints() const
+  {
+    return m_Checkpoints.size();
+  }
+
+  /** Whether the index was read from the index file, rather than built. */
+  bool
+  GetIndexWasRead() const
+  {
+    return m_IndexWasRead;
+  }
+
+  /** The name of the index file conventionally kept next to a gzip file. */
+  static std::string
+  GetIndexFileName(const std::string & fileName);
+
+private:
+  struct Checkpoint
+  {
+    SizeValueType              UncompressedOffset{};
+    SizeValueType              CompressedOffset{};
+    // The number of bits of the byte preceding CompressedOffset which
+    // belong to the deflate block starting at the checkpoint.
+    unsigned int               Bits{};
+    std::vector<unsigned char> Window{};
+  };
+
+  void
+  BuildIndex(SizeValueType checkpointSpacing);
+
+  bool
+  ReadIndex(const std::string & indexFileName);
+
+  void
+  WriteIndex(const std::string & indexFileName) const;
+
+  // The state of the inflation between reads.
+  class InflateState;
+
+  std::string                   m_FileName{};
+  SizeValueType                 m_FileSize{};
+  long long                     m_ModifiedTime{};
+  SizeValueType                 m_UncompressedSize{};
+  std::vector<Checkpoint>       m_Checkpoints{};
+  bool                          m_IndexWasRead{};
+  std::unique_ptr<InflateState> m_State;
+};
+} // namespace itk
+
+#endif // itkIndexedGzipFile_h
@@ -0,0 +1,83 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFileRegion_h
+#define itkMemoryMappedFileRegion_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFileRegion
+ *
+ * \brief A copy-on-write memory mapping of a range of bytes of a file.
+ *
+ * The constructor maps the bytes [offset, offset + length) of the file
+ * into memory, and the destructor unmaps them. The mapping is private:
+ * the pages are shared with the page cache (and with every other process
+ * mapping the same file) until they are written to, at which point the
+ * writing process gets its own copy of the page. Writes are never carried
+ * through to the file.
+ *
+ * The offset does not need to be aligned to a page; the mapping starts at
+ * the preceding page boundary and GetPointer() points at the requested
+ * byte.
+ *
+ * An ExceptionObject is thrown when the file cannot be opened or mapped,
+ * or when it is smaller than offset + length.
+ *
+ * \sa MemoryMappedImportImageContainer
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MemoryMappedFileRegion
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedFileRegion);
+
+  MemoryMappedFileRegion(const std::string & fileName, SizeValueType offset, SizeValueType length);
+
+  ~MemoryMappedFileRegion();
+
+  /** Pointer to the byte at the requested offset of the file. */
+  void *
+  GetPointer() const
+  {
+    return m_Pointer;
+  }
+
+  /** Number of bytes available from GetPointer(). */
+  SizeValueType
+  GetLength() const
+  {
+    return m_Length;
+  }
+
+private:
+  void *        m_Pointer{};
+  SizeValueType m_Length{};
+
+  // The page aligned start and length of the actual mapping.
+  void *        m_MappedAddress{};
+  SizeValueType m_MappedLength{};
+};
+} // namespace itk
+
+#endif // itkMemoryMappedFileRegion_h
@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImportImageContainer_h
+#define itkMemoryMappedImportImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFileRegion.h"
+
+#include <memory>
+
+namespace itk
+{
+/** \class MemoryMappedImportImageContainer
+ * \brief An ImportImageContainer whose elements are a memory mapping of a file.
+ *
+ * The container takes ownership of a MemoryMappedFileRegion and exposes
+ * its bytes as the elements of the container. The mapping is released
+ * when the container is destroyed, or as soon as the container lets go of
+ * the mapped memory, for example when it is reallocated by Reserve() or
+ * Squeeze(), or replaced by SetImportPointer().
+ *
+ * The elements may be modified: the mapping is copy-on-write, so the
+ * modified pages become private to this process and the file is left
+ * untouched.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping()
+ * \ingroup ImageObjects
+ * \ingroup ITKIOImageBase
+ */
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImportImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedImportImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImportImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using typename Superclass::ElementIdentifier;
+  using typename Superclass::Element;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(MemoryMappedImportImageContainer);
+
+  /** Use the mapped bytes as the elements of the container. The length of
+   * the mapping must be a multiple of sizeof(TElement), and the mapped
+   * pointer must be suitably aligned for TElement. */
+  void
+  SetMappedFileRegion(std::unique_ptr<MemoryMappedFileRegion> region);
+
+  /** Whether the elements of the container are currently memory mapped. */
+  bool
+  IsMapped() const
+  {
+    return m_MappedFileRegion != nullptr;
+  }
+
+protected:
+  MemoryMappedImportImageContainer() = default;
+  ~MemoryMappedImportImageContainer() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  DeallocateManagedMemory() override;
+
+private:
+  std::unique_ptr<MemoryMappedFileRegion> m_MappedFileRegion{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkMemoryMappedImportImageContainer.hxx"
+#endif
+
+#endif
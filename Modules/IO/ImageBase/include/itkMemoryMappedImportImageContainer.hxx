@@ -0,0 +1,70 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImportImageContainer_hxx
+#define itkMemoryMappedImportImageContainer_hxx
+
+#include <cstdint>
+
+namespace itk
+{
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImportImageContainer<TElementIdentifier, TElement>::SetMappedFileRegion(
+  std::unique_ptr<MemoryMappedFileRegion> region)
+{
+  if (region == nullptr)
+  {
+    itkExceptionStringMacro("The memory mapped file region is null");
+  }
+  if (region->GetLength() % sizeof(TElement) != 0)
+  {
+    itkExceptionMacro("The memory mapped file region of " << region->GetLength()
+                                                           << " bytes does not hold a whole number of elements");
+  }
+  if (reinterpret_cast<std::uintptr_t>(region->GetPointer()) % alignof(TElement) != 0)
+  {
+    itkExceptionStringMacro("The memory mapped file region is not aligned for the element type");
+  }
+
+  // SetImportPointer releases the memory previously held, which may be
+  // an earlier mapping.
+  this->SetImportPointer(static_cast<TElement *>(region->GetPointer()),
+                         static_cast<ElementIdentifier>(region->GetLength() / sizeof(TElement)),
+                         false);
+  m_MappedFileRegion = std::move(region);
+}
+
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
+{
+  Superclass::DeallocateManagedMemory();
+  m_MappedFileRegion.reset();
+}
+
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImportImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Mapped: " << (m_MappedFileRegion ? "On" : "Off") << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,342 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkChunkedZlibCompression.h"
+#include "itkMultiThreaderBase.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+// Raw deflate data, without zlib or gzip header and trailer: these are
+// written once for the whole stream.
+constexpr int RawDeflateWindowBits = -15;
+
+// The level zlib uses for Z_DEFAULT_COMPRESSION.
+constexpr int DefaultCompressionLevel = 6;
+
+constexpr SizeValueType ZlibHeaderSize = 2;
+constexpr SizeValueType ZlibTrailerSize = 4;
+constexpr SizeValueType GzipHeaderSize = 10;
+constexpr SizeValueType GzipTrailerSize = 8;
+
+// Chunks are deflated and inflated with a single zlib call each, whose
+// lengths are of type uInt.
+constexpr SizeValueType MaximumChunkSize = SizeValueType{ 1 } << 30;
+
+// Keeps the text of the chunk index of any image within the 32 KiB a
+// MetaImage header field may hold.
+constexpr SizeValueType MaximumNumberOfChunks = 2048;
+
+SizeValueType
+GetNumberOfChunks(SizeValueType size, SizeValueType chunkSize)
+{
+  return std::max<SizeValueType>((size + chunkSize - 1) / chunkSize, 1);
+}
+
+SizeValueType
+GetChunkLength(SizeValueType chunk, SizeValueType size, SizeValueType chunkSize)
+{
+  return std::min(chunkSize, size - std::min(size, chunk * chunkSize));
+}
+
+unsigned long
+Checksum(bool gzip, const unsigned char * data, SizeValueType length)
+{
+  return gzip ? crc32(crc32(0L, Z_NULL, 0), data, static_cast<uInt>(length))
+              : adler32(adler32(0L, Z_NULL, 0), data, static_cast<uInt>(length));
+}
+
+unsigned long
+CombineChecksums(bool gzip, unsigned long checksum1, unsigned long checksum2, SizeValueType length2)
+{
+  return gzip ? crc32_combine(checksum1, checksum2, static_cast<z_off_t>(length2))
+              : adler32_combine(checksum1, checksum2, static_cast<z_off_t>(length2));
+}
+
+void
+CheckChunkSize(SizeValueType chunkSize)
+{
+  if (chunkSize == 0 || chunkSize > MaximumChunkSize)
+  {
+    itkGenericExceptionMacro("Invalid compression chunk size: " << chunkSize);
+  }
+}
+} // namespace
+
+
+SizeValueType
+ChunkedZlibCompression::GetChunkSize(SizeValueType size)
+{
+  return std::clamp((size + MaximumNumberOfChunks - 1) / MaximumNumberOfChunks, DefaultChunkSize, MaximumChunkSize);
+}
+
+
+std::vector<unsigned char>
+ChunkedZlibCompression::Compress(const void *     data,
+                                 SizeValueType    size,
+                                 int              compressionLevel,
+                                 bool             gzip,
+                                 SizeValueType    chunkSize,
+                                 ChunkIndexType & chunkIndex)
+{
+  CheckChunkSize(chunkSize);
+  compressionLevel = compressionLevel < 0 ? DefaultCompressionLevel : std::min(compressionLevel, 9);
+
+  const auto *        input = static_cast<const unsigned char *>(data);
+  const SizeValueType numberOfChunks = GetNumberOfChunks(size, chunkSize);
+
+  std::vector<std::vector<unsigned char>> chunks(numberOfChunks);
+  std::vector<unsigned long>              checksums(numberOfChunks);
+
+  const auto compressChunk = [&](SizeValueType chunk) {
+    const SizeValueType   length = GetChunkLength(chunk, size, chunkSize);
+    const unsigned char * chunkInput = input + chunk * chunkSize;
+    const bool            isLastChunk = chunk + 1 == numberOfChunks;
+
+    z_stream stream{};
+    if (deflateInit2(&stream, compressionLevel, Z_DEFLATED, RawDeflateWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      itkGenericExceptionMacro("Failed to initialize the compression of chunk " << chunk);
+    }
+
+    // Leave room for the empty stored block that ends a full flush.
+    std::vector<unsigned char> & output = chunks[chunk];
+    output.resize(deflateBound(&stream, static_cast<uLong>(length)) + 16);
+
+    stream.next_in = const_cast<unsigned char *>(chunkInput);
+    stream.avail_in = static_cast<uInt>(length);
+    int result = Z_OK;
+    for (;;)
+    {
+      stream.next_out = output.data() + stream.total_out;
+      stream.avail_out = static_cast<uInt>(output.size() - stream.total_out);
+      result = deflate(&stream, isLastChunk ? Z_FINISH : Z_FULL_FLUSH);
+      if (result == Z_STREAM_ERROR || (isLastChunk ? result == Z_STREAM_END : stream.avail_out != 0))
+      {
+        break;
+      }
+      output.resize(2 * output.size());
+    }
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (result == Z_STREAM_ERROR)
+    {
+      itkGenericExceptionMacro("Failed to compress chunk " << chunk);
+    }
+
+    checksums[chunk] = Checksum(gzip, chunkInput, length);
+  };
+  MultiThreaderBase::New()->ParallelizeArray(0, numberOfChunks, compressChunk, nullptr);
+
+  chunkIndex.resize(numberOfChunks);
+  unsigned long checksum = Checksum(gzip, nullptr, 0);
+  for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+  {
+    chunkIndex[chunk] = chunks[chunk].size();
+    checksum = CombineChecksums(gzip, checksum, checksums[chunk], GetChunkLength(chunk, size, chunkSize));
+  }
+
+  std::vector<unsigned char> compressed;
+  compressed.reserve(GetStreamSize(chunkIndex, gzip));
+  if (gzip)
+  {
+    // No file name, no modification time, unknown operating system.
+    compressed.insert(compressed.end(), { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 0xff });
+  }
+  else
+  {
+    // 32K window, and the compression level hint of the FLEVEL bits.
+    constexpr unsigned char compressionMethodAndFlags = 0x78;
+    const unsigned int levelFlags = compressionLevel < 2 ? 0 : compressionLevel < 6 ? 1 : compressionLevel == 6 ? 2 : 3;
+    unsigned int       flags = levelFlags << 6;
+    flags += 31 - (compressionMethodAndFlags * 256u + flags) % 31;
+    compressed.insert(compressed.end(), { compressionMethodAndFlags, static_cast<unsigned char>(flags) });
+  }
+  for (const auto & chunk : chunks)
+  {
+    compressed.insert(compressed.end(), chunk.cbegin(), chunk.cend());
+  }
+  const auto appendBytes = [&compressed](unsigned long value, bool bigEndian) {
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      const unsigned int shift = bigEndian ? 24 - 8 * i : 8 * i;
+      compressed.push_back(static_cast<unsigned char>((value >> shift) & 0xff));
+    }
+  };
+  if (gzip)
+  {
+    appendBytes(checksum, false);
+    appendBytes(static_cast<unsigned long>(size & 0xffffffff), false);
+  }
+  else
+  {
+    appendBytes(checksum, true);
+  }
+  return compressed;
+}
+
+
+SizeValueType
+ChunkedZlibCompression::GetHeaderSize(bool gzip)
+{
+  return gzip ? GzipHeaderSize : ZlibHeaderSize;
+}
+
+
+SizeValueType
+ChunkedZlibCompression::GetTrailerSize(bool gzip)
+{
+  return gzip ? GzipTrailerSize : ZlibTrailerSize;
+}
+
+
+SizeValueType
+ChunkedZlibCompression::GetStreamSize(const ChunkIndexType & chunkIndex, bool gzip)
+{
+  return GetHeaderSize(gzip) + std::accumulate(chunkIndex.cbegin(), chunkIndex.cend(), SizeValueType{ 0 }) +
+         GetTrailerSize(gzip);
+}
+
+
+void
+ChunkedZlibCompression::Decompress(const unsigned char *  stream,
+                                   const ChunkIndexType & chunkIndex,
+                                   SizeValueType          chunkSize,
+                                   SizeValueType          size,
+                                   bool                   gzip,
+                                   SizeValueType          firstChunk,
+                                   SizeValueType          endChunk,
+                                   void *                 output)
+{
+  CheckChunkSize(chunkSize);
+  const SizeValueType numberOfChunks = GetNumberOfChunks(size, chunkSize);
+  if (chunkIndex.size() != numberOfChunks)
+  {
+    itkGenericExceptionMacro("The chunk index holds " << chunkIndex.size() << " chunks, while " << size
+                                                      << " bytes in chunks of " << chunkSize << " bytes make "
+                                                      << numberOfChunks << " chunks");
+  }
+  if (firstChunk >= endChunk || endChunk > numberOfChunks)
+  {
+    itkGenericExceptionMacro("Invalid range of chunks [" << firstChunk << ", " << endChunk << ')');
+  }
+
+  std::vector<SizeValueType> offsets(endChunk - firstChunk);
+  std::exclusive_scan(
+    chunkIndex.cbegin() + firstChunk, chunkIndex.cbegin() + endChunk, offsets.begin(), SizeValueType{ 0 });
+
+  auto *                     outputBytes = static_cast<unsigned char *>(output);
+  std::vector<unsigned long> checksums(endChunk - firstChunk);
+  const bool                 verifyChecksum = firstChunk == 0 && endChunk == numberOfChunks;
+
+  const auto decompressChunk = [&](SizeValueType i) {
+    const SizeValueType chunk = firstChunk + i;
+    const SizeValueType length = GetChunkLength(chunk, size, chunkSize);
+    unsigned char *     chunkOutput = outputBytes + i * chunkSize;
+
+    z_stream zstream{};
+    if (inflateInit2(&zstream, RawDeflateWindowBits) != Z_OK)
+    {
+      itkGenericExceptionMacro("Failed to initialize the decompression of chunk " << chunk);
+    }
+    zstream.next_in = const_cast<unsigned char *>(stream + offsets[i]);
+    zstream.avail_in = static_cast<uInt>(chunkIndex[chunk]);
+    // inflate() rejects a null output, which empty data may have.
+    unsigned char emptyOutput = 0;
+    zstream.next_out = length > 0 ? chunkOutput : &emptyOutput;
+    zstream.avail_out = static_cast<uInt>(length);
+    const int result = inflate(&zstream, chunk + 1 == numberOfChunks ? Z_FINISH : Z_SYNC_FLUSH);
+    const auto decompressedLength = static_cast<SizeValueType>(zstream.total_out);
+    inflateEnd(&zstream);
+
+    // Only the last chunk ends the deflate stream.
+    const bool succeeded =
+      chunk + 1 == numberOfChunks ? result == Z_STREAM_END : (result == Z_OK || result == Z_BUF_ERROR);
+    if (!succeeded || decompressedLength != length)
+    {
+      itkGenericExceptionMacro("Failed to decompress chunk " << chunk << ": the compressed data is corrupt");
+    }
+    if (verifyChecksum)
+    {
+      checksums[i] = Checksum(gzip, chunkOutput, length);
+    }
+  };
+  MultiThreaderBase::New()->ParallelizeArray(0, endChunk - firstChunk, decompressChunk, nullptr);
+
+  if (verifyChecksum)
+  {
+    unsigned long checksum = Checksum(gzip, nullptr, 0);
+    for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      checksum = CombineChecksums(gzip, checksum, checksums[chunk], GetChunkLength(chunk, size, chunkSize));
+    }
+    const unsigned char * trailer = stream + offsets.back() + chunkIndex.back();
+    unsigned long         expected = 0;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      expected |= static_cast<unsigned long>(trailer[i]) << (gzip ? 8 * i : 24 - 8 * i);
+    }
+    if (checksum != expected)
+    {
+      itkGenericExceptionMacro("The checksum of the decompressed data does not match: the compressed data is corrupt");
+    }
+  }
+}
+
+
+std::string
+ChunkedZlibCompression::ChunkIndexToString(SizeValueType chunkSize, const ChunkIndexType & chunkIndex)
+{
+  std::ostringstream text;
+  text << chunkSize;
+  for (const SizeValueType compressedChunkSize : chunkIndex)
+  {
+    text << ' ' << compressedChunkSize;
+  }
+  return text.str();
+}
+
+
+bool
+ChunkedZlibCompression::ChunkIndexFromString(const std::string & text,
+                                             SizeValueType &     chunkSize,
+                                             ChunkIndexType &    chunkIndex)
+{
+  std::istringstream stream(text);
+  ChunkIndexType     values;
+  SizeValueType      value;
+  while (stream >> value)
+  {
+    values.push_back(value);
+  }
+  if (!stream.eof() || values.size() < 2 || values.front() == 0 || values.front() > MaximumChunkSize ||
+      std::any_of(values.cbegin() + 1, values.cend(), [](SizeValueType size) { return size > UINT_MAX; }))
+  {
+    return false;
+  }
+  chunkSize = values.front();
+  chunkIndex.assign(values.cbegin() + 1, values.cend());
+  return true;
+}
+} // end namespace itk
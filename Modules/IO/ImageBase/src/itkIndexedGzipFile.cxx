@@ -0,0 +1,455 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkIndexedGzipFile.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace itk
+{
+namespace
+{
+// The largest distance a deflate block may refer back to.
+constexpr SizeValueType WindowSize = 32768;
+
+constexpr SizeValueType InputBufferSize = SizeValueType{ 1 } << 16;
+
+// A gzip header, or a zlib header, or none.
+constexpr int AutomaticHeaderWindowBits = 15 + 32;
+constexpr int GzipWindowBits = 15 + 16;
+constexpr int RawDeflateWindowBits = -15;
+
+constexpr SizeValueType GzipTrailerSize = 8;
+
+constexpr char IndexFileSignature[8] = { 'I', 'T', 'K', 'G', 'Z', 'I', 'X', '1' };
+
+void
+WriteValue(std::ostream & stream, std::uint64_t value)
+{
+  ByteSwapper<std::uint64_t>::SwapFromSystemToLittleEndian(&value);
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+bool
+ReadValue(std::istream & stream, std::uint64_t & value)
+{
+  stream.read(reinterpret_cast<char *>(&value), sizeof(value));
+  ByteSwapper<std::uint64_t>::SwapFromSystemToLittleEndian(&value);
+  return static_cast<bool>(stream);
+}
+} // namespace
+
+
+class IndexedGzipFile::InflateState
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(InflateState);
+
+  InflateState() = default;
+
+  ~InflateState()
+  {
+    if (m_Initialized)
+    {
+      inflateEnd(&m_Stream);
+    }
+  }
+
+  // Initialize the inflation for the given window bits, discarding any
+  // earlier state.
+  void
+  Initialize(int windowBits)
+  {
+    if (m_Initialized)
+    {
+      inflateEnd(&m_Stream);
+      m_Initialized = false;
+    }
+    m_Stream = z_stream{};
+    if (inflateInit2(&m_Stream, windowBits) != Z_OK)
+    {
+      itkGenericExceptionMacro("Failed to initialize the decompression of " << m_FileName);
+    }
+    m_Initialized = true;
+  }
+
+  // Refill the input buffer when it is empty. Returns false at the end of
+  // the file.
+  bool
+  FillInput()
+  {
+    if (m_Stream.avail_in == 0)
+    {
+      m_File.read(reinterpret_cast<char *>(m_Input.data()), static_cast<std::streamsize>(m_Input.size()));
+      m_Stream.next_in = m_Input.data();
+      m_Stream.avail_in = static_cast<uInt>(m_File.gcount());
+    }
+    return m_Stream.avail_in != 0;
+  }
+
+  std::string                m_FileName{};
+  std::ifstream              m_File{};
+  z_stream                   m_Stream{};
+  bool                       m_Initialized{};
+  std::vector<unsigned char> m_Input = std::vector<unsigned char>(InputBufferSize);
+
+  // Whether the stream is raw deflate data, as it is when resumed at a
+  // checkpoint, rather than a gzip member.
+  bool m_Raw{};
+
+  // The uncompressed offset of the next byte to be inflated.
+  SizeValueType m_Position{};
+};
+
+
+IndexedGzipFile::IndexedGzipFile(const std::string & fileName,
+                                 const std::string & indexFileName,
+                                 SizeValueType       checkpointSpacing)
+  : m_FileName(fileName)
+  , m_State(std::make_unique<InflateState>())
+{
+  m_State->m_FileName = fileName;
+  m_State->m_File.open(fileName, std::ios::in | std::ios::binary);
+  if (!m_State->m_File.is_open())
+  {
+    itkGenericExceptionMacro("Failed to open " << fileName);
+  }
+  m_FileSize = itksys::SystemTools::FileLength(fileName);
+  m_ModifiedTime = itksys::SystemTools::ModifiedTime(fileName);
+
+  if (indexFileName.empty() || !this->ReadIndex(indexFileName))
+  {
+    this->BuildIndex(std::max<SizeValueType>(checkpointSpacing, 1));
+    if (!indexFileName.empty())
+    {
+      this->WriteIndex(indexFileName);
+    }
+  }
+}
+
+
+IndexedGzipFile::~IndexedGzipFile() = default;
+
+
+std::string
+IndexedGzipFile::GetIndexFileName(const std::string & fileName)
+{
+  return fileName + ".gzidx";
+}
+
+
+void
+IndexedGzipFile::BuildIndex(SizeValueType checkpointSpacing)
+{
+  InflateState & state = *m_State;
+  z_stream &     stream = state.m_Stream;
+
+  unsigned char signature[2]{};
+  state.m_File.read(reinterpret_cast<char *>(signature), sizeof(signature));
+  if (state.m_File.gcount() != 2 || signature[0] != 0x1f || signature[1] != 0x8b)
+  {
+    itkGenericExceptionMacro(<< m_FileName << " is not a gzip file");
+  }
+  state.m_File.seekg(0);
+
+  // The data is inflated into a circular buffer holding the last WindowSize
+  // bytes, which are copied into every checkpoint.
+  std::vector<unsigned char> window(WindowSize);
+  SizeValueType              totalIn = 0;
+  SizeValueType              totalOut = 0;
+
+  m_Checkpoints.clear();
+  state.Initialize(AutomaticHeaderWindowBits);
+  for (;;)
+  {
+    if (!state.FillInput())
+    {
+      itkGenericExceptionMacro("Unexpected end of the gzip file " << m_FileName);
+    }
+
+    int result = Z_OK;
+    do
+    {
+      if (stream.avail_out == 0)
+      {
+        stream.next_out = window.data();
+        stream.avail_out = static_cast<uInt>(WindowSize);
+      }
+      totalIn += stream.avail_in;
+      totalOut += stream.avail_out;
+      result = inflate(&stream, Z_BLOCK);
+      totalIn -= stream.avail_in;
+      totalOut -= stream.avail_out;
+      if (result == Z_NEED_DICT || result == Z_DATA_ERROR || result == Z_MEM_ERROR)
+      {
+        itkGenericExceptionMacro("Failed to decompress " << m_FileName << ": "
+                                                         << (stream.msg != nullptr ? stream.msg : "zlib error"));
+      }
+      if (result == Z_STREAM_END)
+      {
+        break;
+      }
+
+      // At the end of a block other than the last one of a member, when far
+      // enough from the previous checkpoint.
+      const bool isBlockBoundary = (stream.data_type & 128) != 0 && (stream.data_type & 64) == 0;
+      if (isBlockBoundary &&
+          (m_Checkpoints.empty() || totalOut - m_Checkpoints.back().UncompressedOffset >= checkpointSpacing))
+      {
+        Checkpoint checkpoint;
+        checkpoint.UncompressedOffset = totalOut;
+        checkpoint.CompressedOffset = totalIn;
+        checkpoint.Bits = static_cast<unsigned int>(stream.data_type & 7);
+
+        // The window, oldest byte first, starts at the next byte to write.
+        const SizeValueType written = WindowSize - stream.avail_out;
+        checkpoint.Window.resize(std::min(totalOut, WindowSize));
+        std::vector<unsigned char> ordered(WindowSize);
+        std::rotate_copy(window.cbegin(), window.cbegin() + written, window.cend(), ordered.begin());
+        std::copy(ordered.cend() - checkpoint.Window.size(), ordered.cend(), checkpoint.Window.begin());
+        m_Checkpoints.push_back(std::move(checkpoint));
+      }
+    } while (stream.avail_in != 0);
+
+    if (result == Z_STREAM_END)
+    {
+      // Another gzip member may follow.
+      if (!state.FillInput())
+      {
+        break;
+      }
+      inflateReset(&stream);
+    }
+  }
+  if (m_Checkpoints.empty())
+  {
+    itkGenericExceptionMacro("No deflate block found in " << m_FileName);
+  }
+  m_UncompressedSize = totalOut;
+
+  // Reads start from a checkpoint.
+  state.Initialize(RawDeflateWindowBits);
+  state.m_Position = m_UncompressedSize + 1;
+}
+
+
+bool
+IndexedGzipFile::ReadIndex(const std::string & indexFileName)
+{
+  std::ifstream file(indexFileName, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  char signature[sizeof(IndexFileSignature)]{};
+  file.read(signature, sizeof(signature));
+  std::uint64_t fileSize = 0;
+  std::uint64_t modifiedTime = 0;
+  std::uint64_t uncompressedSize = 0;
+  std::uint64_t numberOfCheckpoints = 0;
+  if (!file || !std::equal(signature, signature + sizeof(signature), IndexFileSignature) ||
+      !ReadValue(file, fileSize) || !ReadValue(file, modifiedTime) || !ReadValue(file, uncompressedSize) ||
+      !ReadValue(file, numberOfCheckpoints) || fileSize != m_FileSize ||
+      static_cast<long long>(modifiedTime) != m_ModifiedTime || numberOfCheckpoints == 0 ||
+      numberOfCheckpoints > uncompressedSize + 1)
+  {
+    return false;
+  }
+
+  std::vector<Checkpoint> checkpoints(numberOfCheckpoints);
+  for (Checkpoint & checkpoint : checkpoints)
+  {
+    std::uint64_t uncompressedOffset = 0;
+    std::uint64_t compressedOffset = 0;
+    std::uint64_t bits = 0;
+    std::uint64_t windowSize = 0;
+    if (!ReadValue(file, uncompressedOffset) || !ReadValue(file, compressedOffset) || !ReadValue(file, bits) ||
+        !ReadValue(file, windowSize) || uncompressedOffset > uncompressedSize || compressedOffset > fileSize ||
+        bits > 7 || windowSize > std::min<std::uint64_t>(uncompressedOffset, WindowSize) ||
+        (&checkpoint != &checkpoints.front() && uncompressedOffset <= (&checkpoint - 1)->UncompressedOffset))
+    {
+      return false;
+    }
+    checkpoint.UncompressedOffset = uncompressedOffset;
+    checkpoint.CompressedOffset = compressedOffset;
+    checkpoint.Bits = static_cast<unsigned int>(bits);
+    checkpoint.Window.resize(windowSize);
+    file.read(reinterpret_cast<char *>(checkpoint.Window.data()), static_cast<std::streamsize>(windowSize));
+    if (!file)
+    {
+      return false;
+    }
+  }
+  if (file.peek() != std::ifstream::traits_type::eof())
+  {
+    return false;
+  }
+
+  m_UncompressedSize = uncompressedSize;
+  m_Checkpoints = std::move(checkpoints);
+  m_IndexWasRead = true;
+  m_State->m_Position = m_UncompressedSize + 1;
+  return true;
+}
+
+
+void
+IndexedGzipFile::WriteIndex(const std::string & indexFileName) const
+{
+  // Written under another name first, so that a concurrent reader never
+  // sees a partial index.
+  const std::string temporaryFileName = indexFileName + ".tmp";
+  {
+    std::ofstream file(temporaryFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+      return;
+    }
+    file.write(IndexFileSignature, sizeof(IndexFileSignature));
+    WriteValue(file, m_FileSize);
+    WriteValue(file, static_cast<std::uint64_t>(m_ModifiedTime));
+    WriteValue(file, m_UncompressedSize);
+    WriteValue(file, m_Checkpoints.size());
+    for (const Checkpoint & checkpoint : m_Checkpoints)
+    {
+      WriteValue(file, checkpoint.UncompressedOffset);
+      WriteValue(file, checkpoint.CompressedOffset);
+      WriteValue(file, checkpoint.Bits);
+      WriteValue(file, checkpoint.Window.size());
+      file.write(reinterpret_cast<const char *>(checkpoint.Window.data()),
+                 static_cast<std::streamsize>(checkpoint.Window.size()));
+    }
+    if (!file.flush())
+    {
+      file.close();
+      std::remove(temporaryFileName.c_str());
+      return;
+    }
+  }
+  if (std::rename(temporaryFileName.c_str(), indexFileName.c_str()) != 0)
+  {
+    std::remove(temporaryFileName.c_str());
+  }
+}
+
+
+void
+IndexedGzipFile::Read(SizeValueType offset, SizeValueType length, void * buffer)
+{
+  if (offset > m_UncompressedSize || length > m_UncompressedSize - offset)
+  {
+    itkGenericExceptionMacro("Cannot read bytes [" << offset << ", " << offset + length << ") of the "
+                                                   << m_UncompressedSize << " bytes of " << m_FileName);
+  }
+  if (length == 0)
+  {
+    return;
+  }
+
+  InflateState & state = *m_State;
+  z_stream &     stream = state.m_Stream;
+
+  // Resume at the last checkpoint before offset, unless the current
+  // position is between that checkpoint and offset.
+  const auto checkpoint = std::prev(
+    std::upper_bound(m_Checkpoints.cbegin(),
+                     m_Checkpoints.cend(),
+                     offset,
+                     [](SizeValueType value, const Checkpoint & point) { return value < point.UncompressedOffset; }));
+  if (state.m_Position > offset || state.m_Position < checkpoint->UncompressedOffset)
+  {
+    state.Initialize(RawDeflateWindowBits);
+    state.m_Raw = true;
+    state.m_File.clear();
+    state.m_File.seekg(static_cast<std::streamoff>(checkpoint->CompressedOffset - (checkpoint->Bits != 0 ? 1 : 0)));
+    if (checkpoint->Bits != 0)
+    {
+      const int byte = state.m_File.get();
+      if (byte == std::ifstream::traits_type::eof() ||
+          inflatePrime(&stream, static_cast<int>(checkpoint->Bits), byte >> (8 - checkpoint->Bits)) != Z_OK)
+      {
+        itkGenericExceptionMacro("Failed to resume the decompression of " << m_FileName);
+      }
+    }
+    if (!checkpoint->Window.empty() &&
+        inflateSetDictionary(&stream, checkpoint->Window.data(), static_cast<uInt>(checkpoint->Window.size())) != Z_OK)
+    {
+      itkGenericExceptionMacro("Failed to resume the decompression of " << m_FileName);
+    }
+    state.m_Position = checkpoint->UncompressedOffset;
+  }
+
+  // Inflate up to offset into a scratch buffer, then into buffer.
+  std::vector<unsigned char> discarded(std::min(offset - state.m_Position, WindowSize));
+  auto *                     output = static_cast<unsigned char *>(buffer);
+  const SizeValueType        end = offset + length;
+  while (state.m_Position < end)
+  {
+    const bool          discarding = state.m_Position < offset;
+    const SizeValueType wanted = discarding ? std::min<SizeValueType>(offset - state.m_Position, discarded.size())
+                                            : std::min<SizeValueType>(end - state.m_Position, UINT_MAX);
+    if (!state.FillInput())
+    {
+      itkGenericExceptionMacro("Unexpected end of the gzip file " << m_FileName);
+    }
+    stream.next_out = discarding ? discarded.data() : output + (state.m_Position - offset);
+    stream.avail_out = static_cast<uInt>(wanted);
+    const int result = inflate(&stream, Z_NO_FLUSH);
+    if (result == Z_NEED_DICT || result == Z_DATA_ERROR || result == Z_MEM_ERROR || result == Z_STREAM_ERROR)
+    {
+      itkGenericExceptionMacro("Failed to decompress " << m_FileName << ": "
+                                                       << (stream.msg != nullptr ? stream.msg : "zlib error"));
+    }
+    state.m_Position += wanted - stream.avail_out;
+
+    if (result == Z_STREAM_END)
+    {
+      // The end of a gzip member. A raw deflate stream leaves the trailer
+      // of the member to skip.
+      if (state.m_Raw)
+      {
+        for (SizeValueType skipped = 0; skipped < GzipTrailerSize;)
+        {
+          if (!state.FillInput())
+          {
+            itkGenericExceptionMacro("Unexpected end of the gzip file " << m_FileName);
+          }
+          const SizeValueType count = std::min<SizeValueType>(GzipTrailerSize - skipped, stream.avail_in);
+          stream.next_in += count;
+          stream.avail_in -= static_cast<uInt>(count);
+          skipped += count;
+        }
+        inflateReset2(&stream, GzipWindowBits);
+        state.m_Raw = false;
+      }
+      else
+      {
+        inflateReset(&stream);
+      }
+    }
+  }
+}
+} // namespace itk
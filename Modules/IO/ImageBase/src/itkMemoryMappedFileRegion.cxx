@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFileRegion.h"
+#include "itksys/SystemTools.hxx"
+
+#if defined(_WIN32)
+#  include "itksys/Encoding.hxx"
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+#if defined(_WIN32)
+
+MemoryMappedFileRegion::MemoryMappedFileRegion(const std::string & fileName,
+                                               SizeValueType       offset,
+                                               SizeValueType       length)
+{
+  if (length == 0)
+  {
+    itkGenericExceptionMacro("Cannot memory map zero bytes of " << fileName);
+  }
+
+  const HANDLE file = CreateFileW(itksys::Encoding::ToWindowsExtendedPath(fileName).c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    itkGenericExceptionMacro("Cannot open " << fileName << " for memory mapping");
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || static_cast<SizeValueType>(fileSize.QuadPart) < offset + length)
+  {
+    CloseHandle(file);
+    itkGenericExceptionMacro("The file " << fileName << " is too small to hold " << length << " bytes at offset "
+                                         << offset);
+  }
+
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    itkGenericExceptionMacro("Cannot create a file mapping of " << fileName);
+  }
+
+  // The offset of a view must be a multiple of the allocation granularity.
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const SizeValueType alignedOffset = offset - offset % systemInfo.dwAllocationGranularity;
+
+  m_MappedLength = length + (offset - alignedOffset);
+  m_MappedAddress = MapViewOfFile(mapping,
+                                  FILE_MAP_COPY,
+                                  static_cast<DWORD>(alignedOffset >> 32),
+                                  static_cast<DWORD>(alignedOffset & 0xFFFFFFFF),
+                                  static_cast<SIZE_T>(m_MappedLength));
+  // The view keeps a reference to the mapping object.
+  CloseHandle(mapping);
+  if (m_MappedAddress == nullptr)
+  {
+    itkGenericExceptionMacro("Cannot memory map " << fileName);
+  }
+
+  m_Pointer = static_cast<char *>(m_MappedAddress) + (offset - alignedOffset);
+  m_Length = length;
+}
+
+MemoryMappedFileRegion::~MemoryMappedFileRegion()
+{
+  UnmapViewOfFile(m_MappedAddress);
+}
+
+#else
+
+MemoryMappedFileRegion::MemoryMappedFileRegion(const std::string & fileName,
+                                               SizeValueType       offset,
+                                               SizeValueType       length)
+{
+  if (length == 0)
+  {
+    itkGenericExceptionMacro("Cannot memory map zero bytes of " << fileName);
+  }
+
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    itkGenericExceptionMacro("Cannot open " << fileName << " for memory mapping"
+                                            << ". Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0 || static_cast<SizeValueType>(fileStatus.st_size) < offset + length)
+  {
+    close(fd);
+    itkGenericExceptionMacro("The file " << fileName << " is too small to hold " << length << " bytes at offset "
+                                         << offset);
+  }
+
+  // The offset of a mapping must be a multiple of the page size.
+  const auto          pageSize = static_cast<SizeValueType>(sysconf(_SC_PAGESIZE));
+  const SizeValueType alignedOffset = offset - offset % pageSize;
+
+  m_MappedLength = length + (offset - alignedOffset);
+  // A private writable mapping: the pages are shared until written to,
+  // and writes are never carried through to the file.
+  void * const address = mmap(nullptr,
+                              static_cast<size_t>(m_MappedLength),
+                              PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE,
+                              fd,
+                              static_cast<off_t>(alignedOffset));
+  // The mapping keeps its own reference to the file.
+  close(fd);
+  if (address == MAP_FAILED)
+  {
+    itkGenericExceptionMacro("Cannot memory map " << fileName
+                                                  << ". Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+
+  m_MappedAddress = address;
+  m_Pointer = static_cast<char *>(m_MappedAddress) + (offset - alignedOffset);
+  m_Length = length;
+}
+
+MemoryMappedFileRegion::~MemoryMappedFileRegion()
+{
+  munmap(m_MappedAddress, static_cast<size_t>(m_MappedLength));
+}
+
+#endif
+
+} // namespace itk
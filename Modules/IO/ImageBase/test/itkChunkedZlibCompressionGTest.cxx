@@ -0,0 +1,347 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkChunkedZlibCompression.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMetaImageIO.h"
+
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+
+using ImageType = itk::Image<short, 3>;
+
+struct ITKChunkedZlibCompressionTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+  }
+
+  // Compressible, but not trivially so.
+  static std::vector<unsigned char>
+  MakeData(size_t size)
+  {
+    std::vector<unsigned char> data(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+      data[i] = static_cast<unsigned char>((i * i) / 7 + (i >> 9));
+    }
+    return data;
+  }
+
+  // An image of a little more than two chunks of the default size.
+  static ImageType::Pointer
+  MakeImage()
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 160, 130, 110 } });
+    image->Allocate();
+    const auto data = MakeData(image->GetBufferedRegion().GetNumberOfPixels());
+    std::copy(data.cbegin(), data.cend(), image->GetBufferPointer());
+    image->SetSpacing(0.75);
+    return image;
+  }
+
+  static std::string
+  ReadText(const std::string & fileName)
+  {
+    std::ifstream      file(fileName, std::ios::in | std::ios::binary);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+  }
+
+  // Removes the line holding the chunk index from a header, so that the
+  // data is read the way any reader would.
+  static void
+  RemoveChunkIndex(const std::string & fileName)
+  {
+    std::string  text = ReadText(fileName);
+    const size_t begin = text.find(itk::ChunkedZlibCompression::ChunkIndexKey);
+    const size_t end = text.find('\n', begin);
+    ASSERT_NE(begin, std::string::npos);
+    text.erase(begin, end + 1 - begin);
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    file << text;
+  }
+};
+
+} // namespace
+
+
+TEST_F(ITKChunkedZlibCompressionTest, RoundTrip)
+{
+  using Compression = itk::ChunkedZlibCompression;
+
+  for (const bool gzip : { false, true })
+  {
+    for (const size_t size : { 0, 1, 1000, 1001, 123457 })
+    {
+      const auto                  data = MakeData(size);
+      Compression::ChunkIndexType chunks;
+      const auto compressed = Compression::Compress(data.data(), size, 6, gzip, 1000, chunks);
+
+      EXPECT_EQ(chunks.size(), std::max<size_t>((size + 999) / 1000, 1));
+      EXPECT_EQ(compressed.size(), Compression::GetStreamSize(chunks, gzip));
+      if (gzip)
+      {
+        EXPECT_EQ(compressed[0], 0x1f);
+        EXPECT_EQ(compressed[1], 0x8b);
+      }
+      else
+      {
+        EXPECT_EQ(compressed[0], 0x78);
+        EXPECT_EQ((compressed[0] * 256 + compressed[1]) % 31, 0);
+      }
+
+      std::vector<unsigned char> decompressed(size);
+      Compression::Decompress(compressed.data() + Compression::GetHeaderSize(gzip),
+                              chunks,
+                              1000,
+                              size,
+                              gzip,
+                              0,
+                              chunks.size(),
+                              decompressed.data());
+      EXPECT_EQ(decompressed, data) << "gzip: " << gzip << ", size: " << size;
+    }
+  }
+}
+
+
+TEST_F(ITKChunkedZlibCompressionTest, DecompressesChunkRanges)
+{
+  using Compression = itk::ChunkedZlibCompression;
+
+  const size_t                size = 10500;
+  const auto                  data = MakeData(size);
+  Compression::ChunkIndexType chunks;
+  const auto                  compressed = Compression::Compress(data.data(), size, 1, false, 1000, chunks);
+  ASSERT_EQ(chunks.size(), 11u);
+
+  // Chunks 3 to 5, and the last, shorter, chunk.
+  const unsigned char * chunk3 =
+    compressed.data() + Compression::GetHeaderSize(false) + chunks[0] + chunks[1] + chunks[2];
+  std::vector<unsigned char> decompressed(3000);
+  Compression::Decompress(chunk3, chunks, 1000, size, false, 3, 6, decompressed.data());
+  EXPECT_TRUE(std::equal(decompressed.cbegin(), decompressed.cend(), data.cbegin() + 3000));
+
+  const unsigned char * lastChunk = compressed.data() + compressed.size() - 4 - chunks.back();
+  Compression::Decompress(lastChunk, chunks, 1000, size, false, 10, 11, decompressed.data());
+  EXPECT_TRUE(std::equal(decompressed.cbegin(), decompressed.cbegin() + 500, data.cbegin() + 10000));
+
+  EXPECT_THROW(Compression::Decompress(chunk3, chunks, 1000, size, false, 6, 3, decompressed.data()),
+               itk::ExceptionObject);
+  EXPECT_THROW(Compression::Decompress(chunk3, chunks, 1000, size + 1000, false, 3, 6, decompressed.data()),
+               itk::ExceptionObject);
+}
+
+
+TEST_F(ITKChunkedZlibCompressionTest, DetectsCorruption)
+{
+  using Compression = itk::ChunkedZlibCompression;
+
+  for (const bool gzip : { false, true })
+  {
+    const size_t                size = 5000;
+    const auto                  data = MakeData(size);
+    Compression::ChunkIndexType chunks;
+    auto compressed = Compression::Compress(data.data(), size, 6, gzip, 1000, chunks);
+
+    std::vector<unsigned char> decompressed(size);
+    compressed[compressed.size() - Compression::GetTrailerSize(gzip)] ^= 1;
+    EXPECT_THROW(Compression::Decompress(compressed.data() + Compression::GetHeaderSize(gzip),
+                                         chunks,
+                                         1000,
+                                         size,
+                                         gzip,
+                                         0,
+                                         chunks.size(),
+                                         decompressed.data()),
+                 itk::ExceptionObject);
+
+    ++chunks[1];
+    --chunks[2];
+    EXPECT_THROW(Compression::Decompress(compressed.data() + Compression::GetHeaderSize(gzip),
+                                         chunks,
+                                         1000,
+                                         size,
+                                         gzip,
+                                         0,
+                                         chunks.size(),
+                                         decompressed.data()),
+                 itk::ExceptionObject);
+  }
+}
+
+
+TEST_F(ITKChunkedZlibCompressionTest, ChunkIndexText)
+{
+  using Compression = itk::ChunkedZlibCompression;
+
+  const Compression::ChunkIndexType chunks{ 17, 4096, 3 };
+  const std::string                 text = Compression::ChunkIndexToString(1024, chunks);
+  EXPECT_EQ(text, "1024 17 4096 3");
+
+  itk::SizeValueType          chunkSize = 0;
+  Compression::ChunkIndexType index;
+  EXPECT_TRUE(Compression::ChunkIndexFromString(text, chunkSize, index));
+  EXPECT_EQ(chunkSize, 1024u);
+  EXPECT_EQ(index, chunks);
+
+  for (const char * invalid : { "", "1024", "0 12", "1024 12 x", "1024 12.5" })
+  {
+    EXPECT_FALSE(Compression::ChunkIndexFromString(invalid, chunkSize, index)) << invalid;
+  }
+
+  EXPECT_EQ(Compression::GetChunkSize(1000), Compression::DefaultChunkSize);
+  EXPECT_EQ(Compression::GetChunkSize(itk::SizeValueType{ 1 } << 36), itk::SizeValueType{ 1 } << 25);
+}
+
+
+TEST_F(ITKChunkedZlibCompressionTest, WritesAndReadsCompressedFiles)
+{
+  const auto image = MakeImage();
+
+  for (const std::string extension : { ".mha", ".mhd", ".nrrd", ".nhdr" })
+  {
+    const std::string fileName = "itkChunkedZlibCompressionGTest" + extension;
+    itk::WriteImage(image, fileName, true);
+
+    EXPECT_NE(ReadText(fileName).find(itk::ChunkedZlibCompression::ChunkIndexKey), std::string::npos) << fileName;
+
+    const auto read = itk::ReadImage<ImageType>(fileName);
+    EXPECT_EQ(*read, *image) << fileName;
+    EXPECT_EQ(read->GetSpacing(), image->GetSpacing()) << fileName;
+
+    // The index describes the data of the file only.
+    EXPECT_FALSE(read->GetMetaDataDictionary().HasKey(itk::ChunkedZlibCompression::ChunkIndexKey)) << fileName;
+
+    // Writing the image read again does not copy the index of its file.
+    const std::string copyName = "itkChunkedZlibCompressionGTest_copy" + extension;
+    itk::WriteImage(read, copyName);
+    EXPECT_EQ(*itk::ReadImage<ImageType>(copyName), *image) << copyName;
+    EXPECT_EQ(ReadText(copyName).find(itk::ChunkedZlibCompression::ChunkIndexKey), std::string::npos) << copyName;
+  }
+}
+
+
+TEST_F(ITKChunkedZlibCompressionTest, WritesIndexOfChunkedDataOnly)
+{
+  const auto image = MakeImage();
+
+  // The data of a small image fits in one chunk, which needs no index.
+  auto smallImage = ImageType::New();
+  smallImage->SetRegions(ImageType::SizeType{ { 16, 16, 16 } });
+  smallImage->Allocate();
+  smallImage->FillBuffer(7);
+
+  const std::string smallFileName = "itkChunkedZlibCompressionGTest_small.mha";
+  itk::WriteImage(smallImage, smallFileName, true);
+  EXPECT_EQ(ReadText(smallFileName).find(itk::ChunkedZlibCompression::ChunkIndexKey), std::string::npos);
+  EXPECT_EQ(*itk::ReadImage<ImageType>(smallFileName), *smallImage);
+
+  // An ImageIO which wrote an index does not write it again along with
+  // uncompressed data.
+  const auto metaImageIO = itk::MetaImageIO::New();
+  auto       writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(metaImageIO);
+  writer->SetInput(image);
+  writer->SetFileName("itkChunkedZlibCompressionGTest_compressed.mha");
+  writer->UseCompressionOn();
+  ASSERT_NO_THROW(writer->Update());
+  EXPECT_NE(ReadText(writer->GetFileName()).find(itk::ChunkedZlibCompression::ChunkIndexKey), std::string::npos);
+
+  writer->SetFileName("itkChunkedZlibCompressionGTest_uncompressed.mha");
+  writer->UseCompressionOff();
+  ASSERT_NO_THROW(writer->Update());
+  EXPECT_EQ(ReadText(writer->GetFileName()).find(itk::ChunkedZlibCompression::ChunkIndexKey), std::string::npos);
+  EXPECT_EQ(*itk::ReadImage<ImageType>(writer->GetFileName()), *image);
+}
+
+
+TEST_F(ITKChunkedZlibCompressionTest, FilesRemainReadableWithoutIndex)
+{
+  const auto image = MakeImage();
+
+  // Without the index, the data must be read as a single zlib or gzip
+  // stream, by the MetaIO and NrrdIO libraries themselves.
+  for (const std::string extension : { ".mha", ".mhd", ".nhdr" })
+  {
+    const std::string fileName = "itkChunkedZlibCompressionGTest_noindex" + extension;
+    itk::WriteImage(image, fileName, true);
+    RemoveChunkIndex(fileName);
+    EXPECT_EQ(*itk::ReadImage<ImageType>(fileName), *image) << fileName;
+  }
+}
+
+
+TEST_F(ITKChunkedZlibCompressionTest, ReadsRequestedRegion)
+{
+  const auto image = MakeImage();
+
+  for (const std::string extension : { ".mha", ".mhd" })
+  {
+    const std::string fileName = "itkChunkedZlibCompressionGTest_region" + extension;
+    itk::WriteImage(image, fileName, true);
+
+    // Regions within one chunk, and spanning several chunks.
+    for (const ImageType::RegionType & region : { ImageType::RegionType({ { 3, 5, 7 } }, { { 20, 30, 4 } }),
+                                                  ImageType::RegionType({ { 0, 0, 40 } }, { { 160, 130, 70 } }),
+                                                  ImageType::RegionType({ { 150, 120, 100 } }, { { 10, 10, 10 } }) })
+    {
+      auto reader = itk::ImageFileReader<ImageType>::New();
+      reader->SetFileName(fileName);
+      reader->UpdateOutputInformation();
+      EXPECT_TRUE(reader->GetImageIO()->CanStreamRead()) << fileName;
+      reader->UseStreamingOn();
+      reader->GetOutput()->SetRequestedRegion(region);
+      reader->GetOutput()->Update();
+      EXPECT_EQ(reader->GetOutput()->GetBufferedRegion(), region) << fileName;
+      for (const auto & index : { region.GetIndex(), region.GetUpperIndex() })
+      {
+        EXPECT_EQ(reader->GetOutput()->GetPixel(index), image->GetPixel(index)) << fileName << index;
+      }
+      const auto sum = [&region](const ImageType & source) {
+        long long total = 0;
+        for (itk::ImageRegionConstIterator<ImageType> it(&source, region); !it.IsAtEnd(); ++it)
+        {
+          total += it.Get();
+        }
+        return total;
+      };
+      EXPECT_EQ(sum(*reader->GetOutput()), sum(*image)) << fileName << region;
+    }
+  }
+}
@@ -0,0 +1,222 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itkImage.h"
+
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <numeric>
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+
+struct ITKImageFileReaderMemoryMappingTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+  }
+
+  template <typename TImage>
+  static typename TImage::Pointer
+  MakeRamp()
+  {
+    auto image = TImage::New();
+    image->SetRegions(typename TImage::SizeType{ { 13, 7, 5 } });
+    image->Allocate();
+    std::iota(image->GetBufferPointer(),
+              image->GetBufferPointer() + image->GetBufferedRegion().GetNumberOfPixels(),
+              typename TImage::PixelType{});
+    image->SetSpacing(0.5);
+    return image;
+  }
+
+  template <typename TImage>
+  static typename TImage::Pointer
+  Read(const std::string & fileName, bool useMemoryMapping)
+  {
+    auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetFileName(fileName);
+    reader->SetUseMemoryMapping(useMemoryMapping);
+    reader->Update();
+    return reader->GetOutput();
+  }
+
+  template <typename TImage>
+  static bool
+  IsMemoryMapped(const TImage & image)
+  {
+    using MappedContainerType = itk::MemoryMappedImportImageContainer<itk::SizeValueType, typename TImage::PixelType>;
+    const auto * const container = dynamic_cast<const MappedContainerType *>(image.GetPixelContainer());
+    return container != nullptr && container->IsMapped();
+  }
+};
+
+} // namespace
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, MapsUncompressedFiles)
+{
+  using ImageType = itk::Image<unsigned char, 3>;
+  const auto ramp = MakeRamp<ImageType>();
+
+  // One byte pixels are always suitably aligned, so the data of all these
+  // files must be mapped, including the ones with the data after the header.
+  for (const std::string extension : { ".mha", ".mhd", ".nrrd", ".nhdr", ".nii", ".hdr" })
+  {
+    const std::string fileName = "itkImageFileReaderMemoryMappingGTest_uchar" + extension;
+    itk::WriteImage(ramp, fileName);
+
+    const auto mapped = Read<ImageType>(fileName, true);
+    EXPECT_TRUE(IsMemoryMapped(*mapped)) << fileName;
+    EXPECT_EQ(*mapped, *Read<ImageType>(fileName, false)) << fileName;
+    EXPECT_EQ(mapped->GetPixel({ { 12, 6, 4 } }), ramp->GetPixel({ { 12, 6, 4 } })) << fileName;
+    EXPECT_EQ(mapped->GetSpacing(), ramp->GetSpacing()) << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, MapsAlignedMultiByteData)
+{
+  using ImageType = itk::Image<float, 3>;
+  const auto ramp = MakeRamp<ImageType>();
+
+  // The data of detached headers starts at offset 0, and the NIfTI data
+  // offset is a multiple of 16 bytes.
+  for (const std::string extension : { ".mhd", ".nhdr", ".nii" })
+  {
+    const std::string fileName = "itkImageFileReaderMemoryMappingGTest_float" + extension;
+    itk::WriteImage(ramp, fileName);
+
+    const auto mapped = Read<ImageType>(fileName, true);
+    EXPECT_TRUE(IsMemoryMapped(*mapped)) << fileName;
+    EXPECT_EQ(*mapped, *ramp) << fileName;
+  }
+
+  // Whether or not the data following a header is aligned, the image must
+  // be read correctly.
+  for (const std::string extension : { ".mha", ".nrrd" })
+  {
+    const std::string fileName = "itkImageFileReaderMemoryMappingGTest_float" + extension;
+    itk::WriteImage(ramp, fileName);
+    EXPECT_EQ(*Read<ImageType>(fileName, true), *ramp) << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, FallsBackToReading)
+{
+  using ImageType = itk::Image<short, 3>;
+  const auto ramp = MakeRamp<ImageType>();
+
+  // Compressed data.
+  for (const std::string extension : { ".mha", ".nrrd", ".nii.gz" })
+  {
+    const std::string fileName = "itkImageFileReaderMemoryMappingGTest_compressed" + extension;
+    itk::WriteImage(ramp, fileName, true);
+
+    const auto image = Read<ImageType>(fileName, true);
+    EXPECT_FALSE(IsMemoryMapped(*image)) << fileName;
+    EXPECT_EQ(*image, *ramp) << fileName;
+  }
+
+  const std::string fileName = "itkImageFileReaderMemoryMappingGTest_short.mhd";
+  itk::WriteImage(ramp, fileName);
+
+  // Mapping is off by default.
+  EXPECT_FALSE(itk::ImageFileReader<ImageType>::New()->GetUseMemoryMapping());
+  EXPECT_FALSE(IsMemoryMapped(*Read<ImageType>(fileName, false)));
+
+  // A pixel type conversion is needed.
+  using FloatImageType = itk::Image<float, 3>;
+  const auto converted = Read<FloatImageType>(fileName, true);
+  EXPECT_FALSE(IsMemoryMapped(*converted));
+  EXPECT_EQ(converted->GetPixel({ { 12, 6, 4 } }), static_cast<float>(ramp->GetPixel({ { 12, 6, 4 } })));
+
+  // Only part of the image is requested.
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetUseMemoryMapping(true);
+  const ImageType::RegionType region({ { 0, 0, 2 } }, { { 13, 7, 1 } });
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->GetOutput()->Update();
+  EXPECT_FALSE(IsMemoryMapped(*reader->GetOutput()));
+  EXPECT_EQ(reader->GetOutput()->GetPixel({ { 3, 4, 2 } }), ramp->GetPixel({ { 3, 4, 2 } }));
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, WritesDoNotReachTheFile)
+{
+  using ImageType = itk::Image<short, 3>;
+  const auto ramp = MakeRamp<ImageType>();
+
+  const std::string fileName = "itkImageFileReaderMemoryMappingGTest_cow.nii";
+  itk::WriteImage(ramp, fileName);
+
+  const auto image1 = Read<ImageType>(fileName, true);
+  const auto image2 = Read<ImageType>(fileName, true);
+  ASSERT_TRUE(IsMemoryMapped(*image1));
+  ASSERT_TRUE(IsMemoryMapped(*image2));
+
+  image1->FillBuffer(-1);
+  EXPECT_EQ(image1->GetPixel({ { 1, 2, 3 } }), -1);
+
+  EXPECT_EQ(*image2, *ramp);
+  EXPECT_EQ(*Read<ImageType>(fileName, false), *ramp);
+
+  // Reallocating the buffer releases the mapping, and keeps the values.
+  image2->GetPixelContainer()->Reserve(image2->GetBufferedRegion().GetNumberOfPixels() + 1);
+  EXPECT_FALSE(IsMemoryMapped(*image2));
+  EXPECT_EQ(image2->GetPixel({ { 12, 6, 4 } }), ramp->GetPixel({ { 12, 6, 4 } }));
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, ReaderCanBeUpdatedAgain)
+{
+  using ImageType = itk::Image<unsigned char, 3>;
+  const auto ramp = MakeRamp<ImageType>();
+
+  const std::string fileName = "itkImageFileReaderMemoryMappingGTest_update.mhd";
+  itk::WriteImage(ramp, fileName);
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  EXPECT_TRUE(IsMemoryMapped(*reader->GetOutput()));
+
+  reader->UseMemoryMappingOff();
+  reader->Update();
+  EXPECT_FALSE(IsMemoryMapped(*reader->GetOutput()));
+  EXPECT_EQ(*reader->GetOutput(), *ramp);
+
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  EXPECT_TRUE(IsMemoryMapped(*reader->GetOutput()));
+  EXPECT_EQ(*reader->GetOutput(), *ramp);
+}
@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImage.h"
+#include "itkMetaImageIO.h"
+
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+
+// MetaImageIO which counts the calls made to it while it writes a piece.
+// ImageIO objects are not thread-safe, so there must be none.
+class WriteMonitoringMetaImageIO : public itk::MetaImageIO
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WriteMonitoringMetaImageIO);
+
+  using Self = WriteMonitoringMetaImageIO;
+  using Superclass = itk::MetaImageIO;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(WriteMonitoringMetaImageIO);
+
+  void
+  Write(const void * buffer) override
+  {
+    m_Writing = true;
+    // Leave time to the upstream pipeline to compute the next piece.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Superclass::Write(buffer);
+    m_Writing = false;
+  }
+
+  itk::ImageIORegion
+  GetSplitRegionForWriting(unsigned int               ithPiece,
+                           unsigned int               numberOfActualSplits,
+                           const itk::ImageIORegion & pasteRegion,
+                           const itk::ImageIORegion & largestPossibleRegion) override
+  {
+    this->CheckNotWriting();
+    return Superclass::GetSplitRegionForWriting(ithPiece, numberOfActualSplits, pasteRegion, largestPossibleRegion);
+  }
+
+  void
+  SetIORegion(const itk::ImageIORegion region) override
+  {
+    this->CheckNotWriting();
+    Superclass::SetIORegion(region);
+  }
+
+  unsigned int
+  GetNumberOfConcurrentCalls() const
+  {
+    return m_NumberOfConcurrentCalls;
+  }
+
+protected:
+  WriteMonitoringMetaImageIO() = default;
+  ~WriteMonitoringMetaImageIO() override = default;
+
+private:
+  void
+  CheckNotWriting()
+  {
+    if (m_Writing)
+    {
+      ++m_NumberOfConcurrentCalls;
+    }
+  }
+
+  std::atomic<bool>         m_Writing{ false };
+  std::atomic<unsigned int> m_NumberOfConcurrentCalls{ 0 };
+};
+
+} // namespace
+
+
+TEST(ImageFileWriter, PipelinedWritesDoNotShareTheImageIO)
+{
+  RegisterRequiredFactories();
+  itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+
+  using ImageType = itk::Image<unsigned char, 3>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 16, 12, 8 } });
+  image->Allocate();
+  unsigned char value = 0;
+  for (unsigned char * pixel = image->GetBufferPointer();
+       pixel != image->GetBufferPointer() + image->GetBufferedRegion().GetNumberOfPixels();
+       ++pixel)
+  {
+    *pixel = value++;
+  }
+  const std::string inputFileName = "itkImageFileWriterPipelinedGTest_input.mha";
+  itk::WriteImage(image, inputFileName);
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->UseStreamingOn();
+
+  const auto imageIO = WriteMonitoringMetaImageIO::New();
+  auto       writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(reader->GetOutput());
+  writer->SetImageIO(imageIO);
+  writer->SetFileName("itkImageFileWriterPipelinedGTest_output.mha");
+  writer->SetNumberOfStreamDivisions(8);
+  writer->PipelinedOn();
+  ASSERT_NO_THROW(writer->Update());
+
+  EXPECT_EQ(imageIO->GetNumberOfConcurrentCalls(), 0u);
+  EXPECT_EQ(*itk::ReadImage<ImageType>(writer->GetFileName()), *image);
+}
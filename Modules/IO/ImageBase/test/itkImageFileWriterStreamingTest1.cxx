@@ -29,7 +29,7 @@ itkImageFileWriterStreamingTest1(int argc, char * argv[])
   {
     std::cerr << "Missing parameters." << std::endl;
     std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv);
-    std::cerr << " input output [existingFile [ no-streaming 1|0] ]" << std::endl;
+    std::cerr << " input output [existingFile [ no-streaming 1|0 [ pipelined 1|0 ] ] ]" << std::endl;
     return EXIT_FAILURE;
   }
 
@@ -58,6 +58,16 @@ itkImageFileWriterStreamingTest1(int argc, char * argv[])
   }
 
 
+  bool pipelined = false;
+  if (argc > 5)
+  {
+    if (std::stoi(argv[5]) == 1)
+    {
+      pipelined = true;
+    }
+  }
+
+
   using PixelType = unsigned char;
   using ImageType = itk::Image<PixelType, 3>;
 
@@ -83,6 +93,7 @@ itkImageFileWriterStreamingTest1(int argc, char * argv[])
   writer->SetFileName(argv[2]);
   writer->SetInput(monitor->GetOutput());
   writer->SetNumberOfStreamDivisions(numberOfDataPieces);
+  ITK_TEST_SET_GET_BOOLEAN(writer, Pipelined, pipelined);
 
   ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
 
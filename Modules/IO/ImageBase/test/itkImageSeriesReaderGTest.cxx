@@ -0,0 +1,178 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaDataObject.h"
+#include "itkMetaImageIO.h"
+#include "itkImage.h"
+
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+
+struct ITKImageSeriesReaderTest : public ::testing::Test
+{
+  using SliceType = itk::Image<short, 2>;
+  using ImageType = itk::Image<short, 3>;
+  using ReaderType = itk::ImageSeriesReader<ImageType>;
+
+  static constexpr unsigned int NumberOfSlices = 13;
+
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+
+    // Write a series of slices, each holding its slice number, and its
+    // file name in its meta data dictionary. Each test has its own files,
+    // as the tests may run concurrently.
+    const std::string testName = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    m_FileNames.clear();
+    for (unsigned int i = 0; i < NumberOfSlices; ++i)
+    {
+      auto slice = SliceType::New();
+      slice->SetRegions(SliceType::SizeType{ { 7, 5 } });
+      slice->Allocate();
+      slice->FillBuffer(static_cast<short>(10 * i));
+      slice->SetPixel({ { 0, 0 } }, static_cast<short>(i));
+
+      const std::string fileName = "itkImageSeriesReaderGTest_" + testName + '_' + std::to_string(i) + ".mha";
+      itk::EncapsulateMetaData<std::string>(slice->GetMetaDataDictionary(), "SliceName", fileName);
+
+      itk::WriteImage(slice, fileName);
+
+      m_FileNames.push_back(fileName);
+    }
+  }
+
+  static std::vector<std::string>
+  GetSliceNames(const ReaderType & reader)
+  {
+    std::vector<std::string> names;
+    for (const itk::MetaDataDictionary * dictionary : *reader.GetMetaDataDictionaryArray())
+    {
+      std::string name;
+      itk::ExposeMetaData<std::string>(*dictionary, "SliceName", name);
+      names.push_back(name);
+    }
+    return names;
+  }
+
+  std::vector<std::string> m_FileNames{};
+};
+
+} // namespace
+
+
+TEST_F(ITKImageSeriesReaderTest, ParallelReadsMatchSequentialReads)
+{
+  auto sequentialReader = ReaderType::New();
+  sequentialReader->SetFileNames(m_FileNames);
+  EXPECT_EQ(sequentialReader->GetNumberOfParallelReads(), 1u);
+  ASSERT_NO_THROW(sequentialReader->Update());
+
+  for (const unsigned int numberOfParallelReads : { 2u, 4u, 64u })
+  {
+    auto parallelReader = ReaderType::New();
+    parallelReader->SetFileNames(m_FileNames);
+    parallelReader->SetNumberOfParallelReads(numberOfParallelReads);
+    EXPECT_EQ(parallelReader->GetNumberOfParallelReads(), numberOfParallelReads);
+    ASSERT_NO_THROW(parallelReader->Update());
+
+    EXPECT_EQ(*parallelReader->GetOutput(), *sequentialReader->GetOutput());
+    for (unsigned int i = 0; i < NumberOfSlices; ++i)
+    {
+      EXPECT_EQ(parallelReader->GetOutput()->GetPixel({ { 0, 0, i } }), static_cast<short>(i));
+      EXPECT_EQ(parallelReader->GetOutput()->GetPixel({ { 6, 4, i } }), static_cast<short>(10 * i));
+    }
+
+    // The dictionaries come out in the order of the files.
+    EXPECT_EQ(GetSliceNames(*parallelReader), m_FileNames);
+    EXPECT_EQ(GetSliceNames(*parallelReader), GetSliceNames(*sequentialReader));
+  }
+}
+
+
+TEST_F(ITKImageSeriesReaderTest, ParallelReadsWithImageIOAndReverseOrder)
+{
+  auto reader = ReaderType::New();
+  reader->SetFileNames(m_FileNames);
+  reader->SetImageIO(itk::MetaImageIO::New());
+  reader->ReverseOrderOn();
+  reader->SetNumberOfParallelReads(3);
+  ASSERT_NO_THROW(reader->Update());
+
+  for (unsigned int i = 0; i < NumberOfSlices; ++i)
+  {
+    EXPECT_EQ(reader->GetOutput()->GetPixel({ { 0, 0, i } }), static_cast<short>(NumberOfSlices - 1 - i));
+  }
+
+  const std::vector<std::string> reversedFileNames(m_FileNames.rbegin(), m_FileNames.rend());
+  EXPECT_EQ(GetSliceNames(*reader), reversedFileNames);
+}
+
+
+TEST_F(ITKImageSeriesReaderTest, ParallelReadsReportProgress)
+{
+  auto reader = ReaderType::New();
+  reader->SetFileNames(m_FileNames);
+  reader->SetNumberOfParallelReads(4);
+
+  const itk::ThreadIdType numberOfWorkUnits = reader->GetMultiThreader()->GetNumberOfWorkUnits();
+
+  std::vector<float> progressValues;
+  reader->AddObserver(itk::ProgressEvent(), [&progressValues, &reader](const itk::EventObject &) {
+    progressValues.push_back(reader->GetProgress());
+  });
+  ASSERT_NO_THROW(reader->Update());
+
+  // The progress is reported slice by slice, up to completion.
+  EXPECT_GT(progressValues.size(), 2u);
+  EXPECT_FLOAT_EQ(progressValues.back(), 1.0f);
+
+  // The multi-threader of the reader is left as it was.
+  EXPECT_EQ(reader->GetMultiThreader()->GetNumberOfWorkUnits(), numberOfWorkUnits);
+}
+
+
+TEST_F(ITKImageSeriesReaderTest, ParallelReadsPropagateErrors)
+{
+  std::vector<std::string> fileNames = m_FileNames;
+  fileNames[NumberOfSlices / 2] = "itkImageSeriesReaderGTest_missing.mha";
+
+  auto reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  EXPECT_THROW(reader->Update(), itk::ExceptionObject);
+
+  reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  reader->SetNumberOfParallelReads(4);
+  EXPECT_THROW(reader->Update(), itk::ExceptionObject);
+
+  // Zero is clamped to sequential reading.
+  reader->SetNumberOfParallelReads(0);
+  EXPECT_EQ(reader->GetNumberOfParallelReads(), 1u);
+}
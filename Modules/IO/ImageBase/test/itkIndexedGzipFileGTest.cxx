@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkIndexedGzipFile.h"
+#include "itkChunkedZlibCompression.h"
+
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
+#include <random>
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+
+struct ITKIndexedGzipFileTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    itksys::SystemTools::ChangeDirectory(TOSTRING(ITK_TEST_OUTPUT_DIR));
+  }
+
+  // Runs of random bytes and of repeated patterns, so that the deflate
+  // blocks are of varied kinds and lengths.
+  static std::vector<unsigned char>
+  MakeData(size_t size, unsigned int seed)
+  {
+    std::mt19937               generator(seed);
+    std::vector<unsigned char> data(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+      data[i] = (i / 5000) % 3 == 0 ? static_cast<unsigned char>(generator()) : static_cast<unsigned char>(i / 7);
+    }
+    return data;
+  }
+
+  // Writes the data as a gzip file of one member per part.
+  static void
+  WriteGzipFile(const std::string & fileName, const std::vector<unsigned char> & data, size_t numberOfParts = 1)
+  {
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    for (size_t part = 0; part < numberOfParts; ++part)
+    {
+      const size_t begin = data.size() * part / numberOfParts;
+      const size_t end = data.size() * (part + 1) / numberOfParts;
+
+      using Compression = itk::ChunkedZlibCompression;
+      Compression::ChunkIndexType chunks;
+      const auto member = Compression::Compress(data.data() + begin, end - begin, 6, true, 70000, chunks);
+      file.write(reinterpret_cast<const char *>(member.data()), static_cast<std::streamsize>(member.size()));
+    }
+  }
+
+  static void
+  ExpectRead(itk::IndexedGzipFile & file, const std::vector<unsigned char> & data, size_t offset, size_t length)
+  {
+    std::vector<unsigned char> read(length);
+    file.Read(offset, length, read.data());
+    EXPECT_TRUE(std::equal(read.cbegin(), read.cend(), data.cbegin() + offset)) << offset << ", " << length;
+  }
+};
+
+} // namespace
+
+
+TEST_F(ITKIndexedGzipFileTest, ReadsRanges)
+{
+  const auto        data = MakeData(300000, 1);
+  const std::string fileName = "itkIndexedGzipFileGTest.gz";
+  WriteGzipFile(fileName, data);
+
+  itk::IndexedGzipFile file(fileName, "", 4096);
+  EXPECT_EQ(file.GetFileName(), fileName);
+  EXPECT_EQ(file.GetUncompressedSize(), data.size());
+  EXPECT_GT(file.GetNumberOfCheckpoints(), 5u);
+  EXPECT_FALSE(file.GetIndexWasRead());
+
+  // Backwards, forwards, across checkpoints and within the same one.
+  for (const size_t offset : { 250000, 0, 123456, 123460, 200000, 299999, 5, 70000 })
+  {
+    ExpectRead(file, data, offset, std::min<size_t>(10000, data.size() - offset));
+  }
+  ExpectRead(file, data, 0, data.size());
+  ExpectRead(file, data, data.size(), 0);
+
+  // Consecutive rows.
+  for (size_t offset = 1000; offset < 200000; offset += 1500)
+  {
+    ExpectRead(file, data, offset, 1000);
+  }
+
+  std::vector<unsigned char> buffer(2);
+  EXPECT_THROW(file.Read(data.size() - 1, 2, buffer.data()), itk::ExceptionObject);
+  EXPECT_THROW(file.Read(data.size() + 1, 0, buffer.data()), itk::ExceptionObject);
+}
+
+
+TEST_F(ITKIndexedGzipFileTest, ReadsConcatenatedMembers)
+{
+  const auto        data = MakeData(200000, 2);
+  const std::string fileName = "itkIndexedGzipFileGTest_members.gz";
+  WriteGzipFile(fileName, data, 3);
+
+  itk::IndexedGzipFile file(fileName, "", 20000);
+  EXPECT_EQ(file.GetUncompressedSize(), data.size());
+
+  // Within members, and across the member boundaries at 66666 and 133333.
+  for (const size_t offset : { 60000, 130000, 0, 66666, 66000, 150000, 199000 })
+  {
+    ExpectRead(file, data, offset, std::min<size_t>(8000, data.size() - offset));
+  }
+  ExpectRead(file, data, 0, data.size());
+}
+
+
+TEST_F(ITKIndexedGzipFileTest, StoresIndexInFile)
+{
+  const std::string fileName = "itkIndexedGzipFileGTest_stored.gz";
+  const std::string indexFileName = itk::IndexedGzipFile::GetIndexFileName(fileName);
+  EXPECT_EQ(indexFileName, fileName + ".gzidx");
+  itksys::SystemTools::RemoveFile(indexFileName);
+
+  const auto data = MakeData(150000, 3);
+  WriteGzipFile(fileName, data);
+  {
+    itk::IndexedGzipFile file(fileName, indexFileName, 8192);
+    EXPECT_FALSE(file.GetIndexWasRead());
+    EXPECT_TRUE(itksys::SystemTools::FileExists(indexFileName));
+  }
+  {
+    itk::IndexedGzipFile file(fileName, indexFileName, 8192);
+    EXPECT_TRUE(file.GetIndexWasRead());
+    EXPECT_EQ(file.GetUncompressedSize(), data.size());
+    ExpectRead(file, data, 100000, 20000);
+    ExpectRead(file, data, 10, 20000);
+  }
+
+  // An index which does not match the file is built again.
+  const auto otherData = MakeData(160000, 4);
+  WriteGzipFile(fileName, otherData);
+  {
+    itk::IndexedGzipFile file(fileName, indexFileName, 8192);
+    EXPECT_FALSE(file.GetIndexWasRead());
+    ExpectRead(file, otherData, 155000, 5000);
+  }
+
+  // As is a corrupt one.
+  std::ofstream(indexFileName, std::ios::out | std::ios::binary | std::ios::app) << "x";
+  {
+    itk::IndexedGzipFile file(fileName, indexFileName, 8192);
+    EXPECT_FALSE(file.GetIndexWasRead());
+    ExpectRead(file, otherData, 0, 5000);
+  }
+  EXPECT_TRUE(itk::IndexedGzipFile(fileName, indexFileName).GetIndexWasRead());
+}
+
+
+TEST_F(ITKIndexedGzipFileTest, RejectsInvalidFiles)
+{
+  EXPECT_THROW(itk::IndexedGzipFile("itkIndexedGzipFileGTest_missing.gz"), itk::ExceptionObject);
+
+  const std::string notGzipName = "itkIndexedGzipFileGTest_notgzip.gz";
+  std::ofstream(notGzipName, std::ios::out | std::ios::binary | std::ios::trunc) << "not a gzip file";
+  EXPECT_THROW(itk::IndexedGzipFile{ notGzipName }, itk::ExceptionObject);
+
+  // Truncated, and corrupt.
+  const auto        data = MakeData(100000, 5);
+  const std::string fileName = "itkIndexedGzipFileGTest_invalid.gz";
+  WriteGzipFile(fileName, data);
+  std::string compressed;
+  {
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    compressed.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  std::ofstream(fileName, std::ios::out | std::ios::binary | std::ios::trunc) << compressed.substr(0, 1000);
+  EXPECT_THROW(itk::IndexedGzipFile{ fileName }, itk::ExceptionObject);
+
+  compressed[compressed.size() - 6] ^= 1;
+  std::ofstream(fileName, std::ios::out | std::ios::binary | std::ios::trunc) << compressed;
+  EXPECT_THROW(itk::IndexedGzipFile{ fileName }, itk::ExceptionObject);
+}
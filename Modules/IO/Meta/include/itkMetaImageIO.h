@@ -25,6 +25,7 @@
 #include "itkNumberToString.h"
 #include "itkSingletonMacro.h"
 #include "itkMetaDataObject.h"
+#include "itkChunkedZlibCompression.h"
 #include "metaObject.h"
 #include "metaImage.h"
 
@@ -83,6 +84,11 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Reports the location of the pixel data for binary, uncompressed
+   * images stored in a single file in native byte order. */
+  bool
+  GetPixelDataFileLocation(std::string & fileName, SizeType & offset) override;
+
   MetaImage *
   GetMetaImagePointer();
 
@@ -135,12 +141,13 @@ public:
                            const ImageIORegion & largestPossibleRegion) override;
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. Only time cannot stream read/write is if compression is used,
+   *  unless the compressed data was written in chunks.
    *  CanRead must be called prior to this function. */
   bool
   CanStreamRead() override
   {
-    if (m_MetaImage.CompressedData())
+    if (m_MetaImage.CompressedData() && m_CompressedDataChunks.empty())
     {
       return false;
     }
@@ -201,10 +208,29 @@ private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(unsigned int, DefaultDoublePrecision);
 
+  /** Locates the element data of the image read by ReadImageInformation(),
+   * which occupies dataSize bytes in its file. */
+  bool
+  GetElementDataFileLocation(SizeType dataSize, std::string & fileName, SizeType & offset);
+
+  /** Writes the compressed data as chunks compressed in parallel, with
+   * their index in the header when there are several chunks. */
+  bool
+  WriteCompressedDataChunks(const void * buffer);
+
+  /** Decompresses in parallel the chunks holding the requested region. */
+  void
+  ReadCompressedDataChunks(void * buffer);
+
   MetaImage m_MetaImage{};
 
   unsigned int m_SubSamplingFactor{};
 
+  /** The chunk size and chunk index of compressed data written in chunks,
+   * or an empty index. */
+  SizeValueType                          m_CompressedDataChunkSize{};
+  ChunkedZlibCompression::ChunkIndexType m_CompressedDataChunks{};
+
   static unsigned int * m_DefaultDoublePrecision;
 };
 
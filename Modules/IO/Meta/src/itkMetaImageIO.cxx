@@ -26,11 +26,52 @@
 #include "itkMakeUniqueForOverwrite.h"
 #include "metaImageUtils.h"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <numeric>
 #include <set>
 
 
 namespace itk
 {
+namespace
+{
+// MetaImage only sets the compressed data size written in its header while
+// compressing the data itself, and cannot remove a user field. Its
+// protected members are reached through this class, never instantiated.
+struct MetaImageAccess : public MetaImage
+{
+  static void
+  SetCompressedDataSize(MetaImage & image, std::streamoff compressedDataSize)
+  {
+    image.*(&MetaImageAccess::m_CompressedDataSize) = compressedDataSize;
+  }
+
+  // Removes a field added by AddUserField(), also from the fields of the
+  // header last written or read.
+  static void
+  RemoveUserField(MetaImage & image, const char * fieldName)
+  {
+    FieldsContainerType & fields = image.*(&MetaImageAccess::m_Fields);
+    for (FieldsContainerType * userFields : { &(image.*(&MetaImageAccess::m_UserDefinedWriteFields)),
+                                              &(image.*(&MetaImageAccess::m_UserDefinedReadFields)) })
+    {
+      const auto found = std::find_if(userFields->begin(), userFields->end(), [fieldName](const auto * field) {
+        return std::strcmp(field->name, fieldName) == 0;
+      });
+      if (found != userFields->end())
+      {
+        fields.erase(std::remove(fields.begin(), fields.end(), *found), fields.end());
+        delete *found;
+        userFields->erase(found);
+      }
+    }
+  }
+};
+} // namespace
+
 // Explicitly set std::numeric_limits<double>::max_digits10 this will provide
 // better accuracy when writing out floating point number in MetaImage header.
 itkGetGlobalValueMacro(MetaImageIO, unsigned int, DefaultDoublePrecision, 17);
@@ -101,6 +142,9 @@ MetaImageIO::CanReadFile(const char * filename)
 void
 MetaImageIO::ReadImageInformation()
 {
+  m_CompressedDataChunkSize = 0;
+  m_CompressedDataChunks.clear();
+
   if (!m_MetaImage.Read(m_FileName.c_str(), false))
   {
     itkExceptionMacro("File cannot be read: " << this->GetFileName() << " for reading." << std::endl
@@ -283,6 +327,19 @@ MetaImageIO::ReadImageInformation()
   {
     const std::string key(m_MetaImage.GetAdditionalReadFieldName(f));
     const std::string value(m_MetaImage.GetAdditionalReadFieldValue(f));
+    if (key == ChunkedZlibCompression::ChunkIndexKey)
+    {
+      // The chunk index only describes the data of this file, so it is not
+      // meta data to be written along with the image again.
+      const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+      if (m_MetaImage.BinaryData() && m_MetaImage.CompressedData() && m_SubSamplingFactor == 1 &&
+          elementDataFileName.compare(0, 4, "LIST") != 0 && elementDataFileName.find('%') == std::string::npos &&
+          !ChunkedZlibCompression::ChunkIndexFromString(value, m_CompressedDataChunkSize, m_CompressedDataChunks))
+      {
+        m_CompressedDataChunks.clear();
+      }
+      continue;
+    }
     EncapsulateMetaData<std::string>(thisMetaDict, key, value);
   }
 
@@ -306,6 +363,21 @@ MetaImageIO::ReadImageInformation()
 void
 MetaImageIO::Read(void * buffer)
 {
+  if (!m_CompressedDataChunks.empty())
+  {
+    // Any trouble with the chunks, for example an index left behind by a
+    // tool that compressed the data again, falls back on reading the
+    // compressed data as a whole.
+    try
+    {
+      this->ReadCompressedDataChunks(buffer);
+      return;
+    }
+    catch (const ExceptionObject &)
+    {
+    }
+  }
+
   const unsigned int nDims = this->GetNumberOfDimensions();
 
   // this will check to see if we are actually streaming
@@ -360,6 +432,175 @@ MetaImageIO::Read(void * buffer)
   }
 }
 
+bool
+MetaImageIO::GetPixelDataFileLocation(std::string & fileName, SizeType & offset)
+{
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  if (!m_MetaImage.BinaryData() || m_MetaImage.CompressedData() || elementDataFileName.empty() ||
+      elementDataFileName.compare(0, 4, "LIST") == 0 || elementDataFileName.find('%') != std::string::npos)
+  {
+    return false;
+  }
+
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  if (elementSize > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB())
+  {
+    return false;
+  }
+
+  // The header of an image read without its elements does not know its
+  // quantity yet.
+  auto dataSize = static_cast<SizeType>(m_MetaImage.ElementNumberOfChannels()) * elementSize;
+  for (int i = 0; i < m_MetaImage.NDims(); ++i)
+  {
+    dataSize *= m_MetaImage.DimSize(i);
+  }
+  if (dataSize != this->GetImageSizeInBytes())
+  {
+    return false;
+  }
+  return this->GetElementDataFileLocation(dataSize, fileName, offset);
+}
+
+bool
+MetaImageIO::GetElementDataFileLocation(SizeType dataSize, std::string & fileName, SizeType & offset)
+{
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  const bool        isLocal =
+    elementDataFileName == "LOCAL" || elementDataFileName == "Local" || elementDataFileName == "local";
+  if (isLocal)
+  {
+    fileName = m_FileName;
+  }
+  else if (itksys::SystemTools::FileIsFullPath(elementDataFileName))
+  {
+    fileName = elementDataFileName;
+  }
+  else
+  {
+    fileName = itksys::SystemTools::GetFilenamePath(m_FileName);
+    fileName = fileName.empty() ? elementDataFileName : fileName + '/' + elementDataFileName;
+  }
+
+  // Locate the data the way MetaImage::M_ReadElements does.
+  if (m_MetaImage.HeaderSize() > 0)
+  {
+    offset = m_MetaImage.HeaderSize();
+  }
+  else if (m_MetaImage.HeaderSize() == -1)
+  {
+    offset = static_cast<SizeType>(itksys::SystemTools::FileLength(fileName)) - dataSize;
+  }
+  else if (isLocal)
+  {
+    // The data directly follows the header.
+    std::ifstream stream(fileName, std::ios::in | std::ios::binary);
+    MetaImage     header;
+    if (!stream.is_open() || !header.ReadStream(0, &stream, false))
+    {
+      return false;
+    }
+    offset = static_cast<SizeType>(stream.tellg());
+  }
+  else
+  {
+    offset = 0;
+  }
+  return offset >= 0;
+}
+
+void
+MetaImageIO::ReadCompressedDataChunks(void * buffer)
+{
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  const auto     pixelSize = static_cast<SizeType>(m_MetaImage.ElementNumberOfChannels()) * elementSize;
+  const auto     nDims = static_cast<unsigned int>(m_MetaImage.NDims());
+  SizeType       dataSize = pixelSize;
+  const SizeType chunkSize = m_CompressedDataChunkSize;
+
+  // The requested region lies between the bytes of its first and its last
+  // pixel, so only the chunks holding these bytes are decompressed.
+  std::vector<SizeType> stride(nDims);
+  std::vector<SizeType> regionIndex(nDims);
+  std::vector<SizeType> regionSize(nDims);
+  SizeType              firstByte = 0;
+  SizeType              endByte = pixelSize;
+  for (unsigned int i = 0; i < nDims; ++i)
+  {
+    stride[i] = dataSize;
+    dataSize *= m_MetaImage.DimSize(i);
+    regionIndex[i] = i < m_IORegion.GetImageDimension() ? static_cast<SizeType>(m_IORegion.GetIndex(i)) : 0;
+    regionSize[i] = i < m_IORegion.GetImageDimension() ? static_cast<SizeType>(m_IORegion.GetSize(i)) : 1;
+    firstByte += regionIndex[i] * stride[i];
+    endByte += (regionIndex[i] + regionSize[i] - 1) * stride[i];
+  }
+  const SizeType numberOfChunks = m_CompressedDataChunks.size();
+  const SizeType firstChunk = firstByte / chunkSize;
+  const SizeType endChunk = std::min((endByte + chunkSize - 1) / chunkSize, numberOfChunks);
+
+  std::string fileName;
+  SizeType    offset = 0;
+  if (!this->GetElementDataFileLocation(
+        ChunkedZlibCompression::GetStreamSize(m_CompressedDataChunks, false), fileName, offset))
+  {
+    itkExceptionMacro("Cannot locate the compressed data of " << m_FileName);
+  }
+  const auto chunksBegin = m_CompressedDataChunks.cbegin();
+  offset += ChunkedZlibCompression::GetHeaderSize(false) +
+            std::accumulate(chunksBegin, chunksBegin + firstChunk, SizeType{ 0 });
+  std::vector<unsigned char> compressed(
+    std::accumulate(chunksBegin + firstChunk, chunksBegin + endChunk, SizeType{ 0 }) +
+    (endChunk == numberOfChunks ? ChunkedZlibCompression::GetTrailerSize(false) : 0));
+
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  file.seekg(static_cast<std::streamoff>(offset));
+  file.read(reinterpret_cast<char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+  if (!file)
+  {
+    itkExceptionMacro("File cannot be read: " << fileName << " for reading." << std::endl
+                                              << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+
+  const SizeType numberOfPixels = std::accumulate(
+    regionSize.cbegin(), regionSize.cend(), SizeType{ 1 }, std::multiplies<SizeType>());
+  if (firstByte == 0 && endByte == dataSize)
+  {
+    ChunkedZlibCompression::Decompress(
+      compressed.data(), m_CompressedDataChunks, chunkSize, dataSize, false, 0, numberOfChunks, buffer);
+  }
+  else
+  {
+    const SizeType             decompressedBegin = firstChunk * chunkSize;
+    std::vector<unsigned char> decompressed(std::min(endChunk * chunkSize, dataSize) - decompressedBegin);
+    ChunkedZlibCompression::Decompress(
+      compressed.data(), m_CompressedDataChunks, chunkSize, dataSize, false, firstChunk, endChunk, decompressed.data());
+
+    // Copy the requested region line by line.
+    const SizeType        lineSize = regionSize[0] * pixelSize;
+    std::vector<SizeType> position(nDims);
+    auto *                output = static_cast<unsigned char *>(buffer);
+    for (SizeType line = 0; line < numberOfPixels / regionSize[0]; ++line)
+    {
+      SizeType lineByte = regionIndex[0] * stride[0];
+      for (unsigned int i = 1; i < nDims; ++i)
+      {
+        lineByte += (regionIndex[i] + position[i]) * stride[i];
+      }
+      std::copy_n(decompressed.data() + (lineByte - decompressedBegin), lineSize, output);
+      output += lineSize;
+      for (unsigned int i = 1; i < nDims && ++position[i] == regionSize[i]; ++i)
+      {
+        position[i] = 0;
+      }
+    }
+  }
+
+  m_MetaImage.ElementData(buffer, false);
+  m_MetaImage.ElementByteOrderFix(static_cast<std::streamoff>(numberOfPixels));
+}
+
 MetaImage *
 MetaImageIO::GetMetaImagePointer()
 {
@@ -418,7 +659,7 @@ MetaImageIO::WriteImageInformation()
   const std::vector<std::string> keys = metaDict.GetKeys();
   for (auto & key : keys)
   {
-    if (key == ITK_ExperimentDate || key == ITK_VoxelUnits)
+    if (key == ITK_ExperimentDate || key == ITK_VoxelUnits || key == ChunkedZlibCompression::ChunkIndexKey)
     {
       continue;
     }
@@ -751,7 +992,11 @@ MetaImageIO::Write(const void * buffer)
   }
   else
   {
-    if (!m_MetaImage.Write(m_FileName.c_str()))
+    // Compressed data is written in chunks compressed in parallel, except
+    // when it is written to one file per slice.
+    const bool writeCompressedDataChunks =
+      m_UseCompression && binaryData && std::strchr(m_MetaImage.ElementDataFileName(), '%') == nullptr;
+    if (!(writeCompressedDataChunks ? this->WriteCompressedDataChunks(buffer) : m_MetaImage.Write(m_FileName.c_str())))
     {
       itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
                                                    << "Reason: " << itksys::SystemTools::GetLastSystemError());
@@ -759,6 +1004,96 @@ MetaImageIO::Write(const void * buffer)
   }
 }
 
+bool
+MetaImageIO::WriteCompressedDataChunks(const void * buffer)
+{
+  const SizeType                         dataSize = this->GetImageSizeInBytes();
+  const SizeValueType                    chunkSize = ChunkedZlibCompression::GetChunkSize(dataSize);
+  ChunkedZlibCompression::ChunkIndexType chunks;
+  const std::vector<unsigned char>       compressed =
+    ChunkedZlibCompression::Compress(buffer, dataSize, this->GetCompressionLevel(), false, chunkSize, chunks);
+
+  // The compressed data remains a single zlib stream, readable as a whole
+  // by any MetaImage reader, which ignores the index. Data held in a
+  // single chunk needs no index.
+  const bool writeChunkIndex = chunks.size() > 1;
+  if (writeChunkIndex)
+  {
+    const std::string index = ChunkedZlibCompression::ChunkIndexToString(chunkSize, chunks);
+    m_MetaImage.AddUserField(
+      ChunkedZlibCompression::ChunkIndexKey, MET_STRING, static_cast<int>(index.size()), index.c_str(), true, -1);
+  }
+
+  MetaImageAccess::SetCompressedDataSize(m_MetaImage, static_cast<std::streamoff>(compressed.size()));
+
+  // Name the header and the data file the way MetaImage::Write does.
+  std::string headerFileName = m_FileName;
+  const bool  userDataFileName = m_MetaImage.ElementDataFileName()[0] != '\0';
+  if (!userDataFileName)
+  {
+    int suffixPosition = 0;
+    MET_GetFileSuffixPtr(headerFileName, &suffixPosition);
+    if (headerFileName.compare(suffixPosition, std::string::npos, "mha") == 0)
+    {
+      m_MetaImage.ElementDataFileName("LOCAL");
+    }
+    else
+    {
+      MET_SetFileSuffix(headerFileName, "mhd");
+      std::string dataFileName = headerFileName;
+      MET_SetFileSuffix(dataFileName, "zraw");
+      m_MetaImage.ElementDataFileName(dataFileName.c_str());
+    }
+  }
+  std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  const bool  isLocal = elementDataFileName == "LOCAL";
+  MET_SetFileSuffix(headerFileName, isLocal ? "mha" : "mhd");
+
+  std::string pathName;
+  const bool  usePath = MET_GetFilePath(headerFileName, pathName);
+  if (usePath)
+  {
+    std::string elementPathName;
+    MET_GetFilePath(elementDataFileName, elementPathName);
+    if (pathName == elementPathName)
+    {
+      elementDataFileName = elementDataFileName.substr(pathName.length());
+      m_MetaImage.ElementDataFileName(elementDataFileName.c_str());
+    }
+  }
+
+  bool written = m_MetaImage.MetaObject::Write(headerFileName.c_str());
+  if (written)
+  {
+    std::ofstream dataFile;
+    if (isLocal)
+    {
+      dataFile.open(headerFileName, std::ios::out | std::ios::binary | std::ios::app);
+    }
+    else
+    {
+      const bool relative = usePath && !itksys::SystemTools::FileIsFullPath(elementDataFileName);
+      dataFile.open(relative ? pathName + elementDataFileName : elementDataFileName, std::ios::out | std::ios::binary);
+    }
+    dataFile.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+    written = !dataFile.fail();
+  }
+
+  MetaImageAccess::SetCompressedDataSize(m_MetaImage, 0);
+  if (!userDataFileName)
+  {
+    m_MetaImage.ElementDataFileName("");
+  }
+
+  // The index describes this data only, it must not be written along with
+  // the next image written by this ImageIO.
+  if (writeChunkIndex)
+  {
+    MetaImageAccess::RemoveUserField(m_MetaImage, ChunkedZlibCompression::ChunkIndexKey);
+  }
+  return written;
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
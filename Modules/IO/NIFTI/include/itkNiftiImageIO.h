@@ -24,6 +24,7 @@
 #include <fstream>
 #include <memory>
 #include "itkImageIOBase.h"
+#include "itkIndexedGzipFile.h"
 
 
 namespace itk
@@ -159,6 +160,12 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Reports the location of the pixel data for uncompressed images in
+   * native byte order which need neither rescaling nor reordering of
+   * their vector components. */
+  bool
+  GetPixelDataFileLocation(std::string & fileName, SizeType & offset) override;
+
   //-------- This part of the interfaces deals with writing data. -----
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -239,6 +246,26 @@ public:
   itkGetConstMacro(SFORM_Permissive, bool);
   itkBooleanMacro(SFORM_Permissive);
   /** @ITKEndGrouping */
+  /** Read regions of gzip compressed files (.nii.gz, .img.gz) through an
+   * index of checkpoints of the compressed stream, built by inflating the
+   * file once, so that reading a region only inflates the data from the
+   * checkpoint preceding it. Without the index, every region is inflated
+   * from the start of the file. The index is kept for further reads of the
+   * same file, as when streaming. Off by default. \sa IndexedGzipFile */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseGzipIndex, bool);
+  itkGetConstMacro(UseGzipIndex, bool);
+  itkBooleanMacro(UseGzipIndex);
+  /** @ITKEndGrouping */
+  /** Keep the gzip index in a file next to the compressed data file, whose
+   * name is that of the data file followed by ".gzidx", and read it from
+   * there rather than building it again while it is up to date. Only used
+   * when UseGzipIndex is on. Off by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseGzipIndexFile, bool);
+  itkGetConstMacro(UseGzipIndexFile, bool);
+  itkBooleanMacro(UseGzipIndexFile);
+  /** @ITKEndGrouping */
 protected:
   NiftiImageIO();
   ~NiftiImageIO() override;
@@ -281,6 +308,11 @@ private:
   void
   SetImageIOMetadataFromNIfTI();
 
+  // Reads a region of the gzip compressed data file through the gzip index,
+  // into a buffer allocated with malloc, as nifti_read_subregion_image does.
+  void *
+  ReadGzipSubregion(const int * start, const int * size);
+
   double m_RescaleSlope{ 1.0 };
   double m_RescaleIntercept{ 0.0 };
 
@@ -294,6 +326,10 @@ private:
 
   bool m_SFORM_Permissive{ false };
   bool m_SFORM_Corrected{ false };
+
+  bool                             m_UseGzipIndex{ false };
+  bool                             m_UseGzipIndexFile{ false };
+  std::unique_ptr<IndexedGzipFile> m_GzipIndex;
 };
 
 
@@ -28,6 +28,8 @@
 #include "itksys/SystemTools.hxx"
 #include "itksys/SystemInformation.hxx"
 
+#include <cmath>
+
 namespace itk
 {
 
@@ -211,6 +213,8 @@ NiftiImageIO::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "OnDiskComponentType: " << m_OnDiskComponentType << std::endl;
   os << indent << "LegacyAnalyze75Mode: " << m_LegacyAnalyze75Mode << std::endl;
   os << indent << "SFORM permissive: " << (m_SFORM_Permissive ? "On" : "Off") << std::endl;
+  itkPrintSelfBooleanMacro(UseGzipIndex);
+  itkPrintSelfBooleanMacro(UseGzipIndexFile);
 }
 
 bool
@@ -257,6 +261,43 @@ CastCopy(float * to, const void * from, size_t pixelcount)
   }
 }
 
+template <typename TBuffer>
+void
+ZeroNonFinite(TBuffer * buffer, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+  {
+    if (!std::isfinite(buffer[i]))
+    {
+      buffer[i] = 0;
+    }
+  }
+}
+
+// The byte swapping, and the replacement of non-finite floating point values
+// by zero, that nifti_read_buffer applies to the data it reads.
+void
+FixReadBuffer(const nifti_image & image, void * buffer, size_t numberOfBytes)
+{
+  if (image.swapsize > 1 && image.byteorder != nifti_short_order())
+  {
+    nifti_swap_Nbytes(numberOfBytes / image.swapsize, image.swapsize, buffer);
+  }
+  switch (image.datatype)
+  {
+    case NIFTI_TYPE_FLOAT32:
+    case NIFTI_TYPE_COMPLEX64:
+      ZeroNonFinite(static_cast<float *>(buffer), numberOfBytes / sizeof(float));
+      break;
+    case NIFTI_TYPE_FLOAT64:
+    case NIFTI_TYPE_COMPLEX128:
+      ZeroNonFinite(static_cast<double *>(buffer), numberOfBytes / sizeof(double));
+      break;
+    default:
+      break;
+  }
+}
+
 // Internal function to convert vectors between RAS and LPS coordinate systems.
 // Dimensions are CXYZT (ITK memory layout)
 template <typename TBuffer>
@@ -360,6 +401,11 @@ NiftiImageIO::Read(void * buffer)
       }
       data = m_Holder->ptr->data;
     }
+    else if (m_UseGzipIndex && m_Holder->ptr->iname != nullptr && nifti_is_gzfile(m_Holder->ptr->iname) &&
+             m_Holder->ptr->iname_offset >= 0)
+    {
+      data = this->ReadGzipSubregion(_origin, _size);
+    }
     else
     {
       // read in a subregion
@@ -452,12 +498,13 @@ NiftiImageIO::Read(void * buffer)
   {
     // otherwise nifti is x y z t vec l m 0, itk is
     // vec x y z t l m o
+    // The data holds the region read, rather than the whole image.
     const auto * niftibuf = static_cast<const char *>(data);
     auto *       itkbuf = static_cast<char *>(buffer);
-    const size_t rowdist = m_Holder->ptr->dim[1];
-    const size_t slicedist = rowdist * m_Holder->ptr->dim[2];
-    const size_t volumedist = slicedist * m_Holder->ptr->dim[3];
-    const size_t seriesdist = volumedist * m_Holder->ptr->dim[4];
+    const size_t rowdist = _size[0];
+    const size_t slicedist = rowdist * _size[1];
+    const size_t volumedist = slicedist * _size[2];
+    const size_t seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -475,13 +522,13 @@ NiftiImageIO::Read(void * buffer)
         vecOrder[i] = i;
       }
     }
-    for (int t = 0; t < m_Holder->ptr->dim[4]; ++t)
+    for (int t = 0; t < _size[3]; ++t)
     {
-      for (int z = 0; z < m_Holder->ptr->dim[3]; ++z)
+      for (int z = 0; z < _size[2]; ++z)
       {
-        for (int y = 0; y < m_Holder->ptr->dim[2]; ++y)
+        for (int y = 0; y < _size[1]; ++y)
         {
-          for (int x = 0; x < m_Holder->ptr->dim[1]; ++x)
+          for (int x = 0; x < _size[0]; ++x)
           {
             for (unsigned int c = 0; c < numComponents; ++c)
             {
@@ -582,6 +629,107 @@ NiftiImageIO::Read(void * buffer)
   }
 }
 
+void *
+NiftiImageIO::ReadGzipSubregion(const int * start, const int * size)
+{
+  const nifti_image & image = *m_Holder->ptr;
+  if (m_GzipIndex == nullptr || m_GzipIndex->GetFileName() != image.iname)
+  {
+    m_GzipIndex.reset();
+    m_GzipIndex = std::make_unique<IndexedGzipFile>(
+      image.iname, m_UseGzipIndexFile ? IndexedGzipFile::GetIndexFileName(image.iname) : std::string());
+  }
+
+  // The region, and the strides of the data in the file, in all 7 nifti
+  // dimensions.
+  int           regionStart[7];
+  int           regionSize[7];
+  SizeValueType strides[7];
+  SizeValueType numberOfBytes = image.nbyper;
+  for (int i = 0; i < 7; ++i)
+  {
+    regionStart[i] = i < image.ndim ? start[i] : 0;
+    regionSize[i] = i < image.ndim ? size[i] : 1;
+    strides[i] = i == 0 ? image.nbyper : strides[i - 1] * image.dim[i];
+    if (i < image.ndim &&
+        (regionStart[i] < 0 || regionSize[i] < 1 || regionStart[i] + regionSize[i] > image.dim[i + 1]))
+    {
+      itkExceptionMacro("The region to read does not fit within the image of file: " << this->GetFileName());
+    }
+    numberOfBytes *= regionSize[i];
+  }
+
+  auto * data = static_cast<char *>(malloc(numberOfBytes));
+  if (data == nullptr)
+  {
+    itkExceptionMacro("Failed to allocate " << numberOfBytes << " bytes to read file: " << this->GetFileName());
+  }
+  try
+  {
+    // Read a row at a time. Successive rows are at increasing offsets, so
+    // the index inflates every byte at most once.
+    const SizeValueType rowBytes = regionSize[0] * strides[0];
+    int                 index[7];
+    std::copy(regionStart, regionStart + 7, index);
+    for (char * row = data; row != data + numberOfBytes; row += rowBytes)
+    {
+      SizeValueType offset = image.iname_offset;
+      for (int i = 0; i < 7; ++i)
+      {
+        offset += index[i] * strides[i];
+      }
+      m_GzipIndex->Read(offset, rowBytes, row);
+
+      for (int i = 1; i < 7; ++i)
+      {
+        if (++index[i] < regionStart[i] + regionSize[i])
+        {
+          break;
+        }
+        index[i] = regionStart[i];
+      }
+    }
+  }
+  catch (...)
+  {
+    free(data);
+    throw;
+  }
+  FixReadBuffer(image, data, numberOfBytes);
+  return data;
+}
+
+bool
+NiftiImageIO::GetPixelDataFileLocation(std::string & fileName, SizeType & offset)
+{
+  // The header is not kept after ReadImageInformation(), read it again.
+  const std::unique_ptr<nifti_image, NiftiImageDeleter> image(nifti_image_read(this->GetFileName(), false));
+  if (image == nullptr || image->iname == nullptr || nifti_is_gzfile(image->iname) || image->iname_offset < 0)
+  {
+    return false;
+  }
+
+  // Read() changes the values of rescaled images, RAS vectors, and the
+  // layout of images of vector pixels.
+  const IOPixelEnum pixelType = this->GetPixelType();
+  if (this->MustRescale() || this->m_ConvertRAS ||
+      (this->GetNumberOfComponents() != 1 && pixelType != IOPixelEnum::COMPLEX && pixelType != IOPixelEnum::RGB &&
+       pixelType != IOPixelEnum::RGBA))
+  {
+    return false;
+  }
+
+  if ((image->swapsize > 1 && image->byteorder != nifti_short_order()) ||
+      static_cast<SizeType>(nifti_get_volsize(image.get())) != this->GetImageSizeInBytes())
+  {
+    return false;
+  }
+
+  fileName = image->iname;
+  offset = image->iname_offset;
+  return true;
+}
+
 NiftiImageIOEnums::NiftiFileEnum
 NiftiImageIO::DetermineFileType(const char * FileNameToRead)
 {
@@ -774,6 +922,9 @@ NiftiImageIO::ReadImageInformation()
     }
   }
 
+  // The file may have changed since its gzip index was built.
+  m_GzipIndex.reset();
+
   m_Holder->ptr.reset(nifti_image_read(this->GetFileName(), false));
   if (m_Holder->ptr == nullptr)
   {
@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkNiftiImageIO.h"
+#include "itkStreamingImageFilter.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+
+template <typename TImage>
+bool
+SameRegion(const TImage * image, const TImage * expected, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIterator<TImage> it(image, region);
+  itk::ImageRegionConstIterator<TImage> expectedIt(expected, region);
+  for (; !it.IsAtEnd(); ++it, ++expectedIt)
+  {
+    if (it.Get() != expectedIt.Get())
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " differs: " << it.Get() << " != " << expectedIt.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+int
+ReadRegions(const std::string & fileName, const TImage * expected, bool useGzipIndexFile)
+{
+  const typename TImage::RegionType regions[] = {
+    typename TImage::RegionType({ { 0, 0, 33 } }, { { 131, 97, 1 } }),
+    typename TImage::RegionType({ { 5, 7, 2 } }, { { 20, 30, 40 } }),
+    typename TImage::RegionType({ { 0, 90, 0 } }, { { 131, 7, 45 } }),
+    typename TImage::RegionType({ { 130, 96, 44 } }, { { 1, 1, 1 } })
+  };
+
+  auto niftiIO = itk::NiftiImageIO::New();
+  niftiIO->UseGzipIndexOn();
+  niftiIO->SetUseGzipIndexFile(useGzipIndexFile);
+
+  int status = EXIT_SUCCESS;
+  for (const auto & region : regions)
+  {
+    auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(niftiIO);
+    reader->GetOutput()->SetRequestedRegion(region);
+    reader->GetOutput()->Update();
+    if (reader->GetOutput()->GetBufferedRegion() != region || !SameRegion(reader->GetOutput(), expected, region))
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error reading region " << region << " of " << fileName << std::endl;
+      status = EXIT_FAILURE;
+    }
+  }
+
+  // Streaming reuses the index built for the first piece.
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(niftiIO);
+  auto streamer = itk::StreamingImageFilter<TImage, TImage>::New();
+  streamer->SetInput(reader->GetOutput());
+  streamer->SetNumberOfStreamDivisions(9);
+  streamer->Update();
+  if (!SameRegion(streamer->GetOutput(), expected, expected->GetLargestPossibleRegion()))
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Error streaming " << fileName << std::endl;
+    status = EXIT_FAILURE;
+  }
+  return status;
+}
+
+} // namespace
+
+
+int
+itkNiftiImageIOGzipIndexTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  using ImageType = itk::Image<short, 3>;
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 131, 97, 45 } });
+  image->Allocate();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<short>((7 * i) ^ (i >> 3));
+  }
+
+  int status = EXIT_SUCCESS;
+
+  const std::string fileName = outputDirectory + "/itkNiftiImageIOGzipIndexTest.nii.gz";
+  const std::string indexFileName = itk::IndexedGzipFile::GetIndexFileName(fileName);
+  itksys::SystemTools::RemoveFile(indexFileName);
+  itk::WriteImage(image, fileName, true);
+
+  ITK_TEST_EXPECT_TRUE(!itk::NiftiImageIO::New()->GetUseGzipIndex());
+  ITK_TEST_EXPECT_TRUE(!itk::NiftiImageIO::New()->GetUseGzipIndexFile());
+
+  if (ReadRegions(fileName, image.GetPointer(), false) != EXIT_SUCCESS)
+  {
+    status = EXIT_FAILURE;
+  }
+  ITK_TEST_EXPECT_TRUE(!itksys::SystemTools::FileExists(indexFileName));
+
+  // The index is stored, then read from its file.
+  for (int i = 0; i < 2; ++i)
+  {
+    if (ReadRegions(fileName, image.GetPointer(), true) != EXIT_SUCCESS)
+    {
+      status = EXIT_FAILURE;
+    }
+    ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(indexFileName));
+  }
+
+  // Vector pixels, which nifti stores a component at a time.
+  using VectorImageType = itk::VectorImage<float, 3>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(image->GetLargestPossibleRegion());
+  vectorImage->SetNumberOfComponentsPerPixel(2);
+  vectorImage->Allocate();
+  for (itk::ImageRegionConstIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    VectorImageType::PixelType pixel(2);
+    pixel[0] = it.Get();
+    pixel[1] = 0.5f * it.GetIndex()[2];
+    vectorImage->SetPixel(it.GetIndex(), pixel);
+  }
+  const std::string vectorFileName = outputDirectory + "/itkNiftiImageIOGzipIndexTest_vector.nii.gz";
+  itk::WriteImage(vectorImage, vectorFileName, true);
+  if (ReadRegions(vectorFileName, vectorImage.GetPointer(), false) != EXIT_SUCCESS)
+  {
+    status = EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
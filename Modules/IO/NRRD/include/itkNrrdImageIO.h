@@ -21,6 +21,7 @@
 
 
 #include "itkImageIOBase.h"
+#include "itkChunkedZlibCompression.h"
 #include <fstream>
 
 struct NrrdEncoding_t;
@@ -125,6 +126,12 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Reports the location of the pixel data for raw encoded images in a
+   * single data file, in native byte order and with the pixel components
+   * on the fastest axis. */
+  bool
+  GetPixelDataFileLocation(std::string & fileName, SizeType & offset) override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool
@@ -226,6 +233,22 @@ protected:
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
 
   AxesReorderEnum m_AxesReorder{ AxesReorderEnum::UseAnyRangeAxisAsPixel };
+
+private:
+  /** Locates the data of a single data file with the given encoding, in
+   * native byte order and with the pixel components on the fastest axis. */
+  bool
+  GetDataFileLocation(const NrrdEncoding_t * encoding, std::string & fileName, SizeType & offset);
+
+  /** Decompresses in parallel gzip data written in chunks. Returns false
+   * when the data cannot be read this way. */
+  bool
+  ReadCompressedDataChunks(void * buffer);
+
+  /** The chunk size and chunk index of gzip data written in chunks, or an
+   * empty index. */
+  SizeValueType                          m_CompressedDataChunkSize{};
+  ChunkedZlibCompression::ChunkIndexType m_CompressedDataChunks{};
 };
 } // end namespace itk
 
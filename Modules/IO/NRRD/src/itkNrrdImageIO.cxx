@@ -24,6 +24,7 @@
 #include "itkFloatingPointExceptions.h"
 #include "itkNumericLocale.h"
 #include "itkNumberToString.h"
+#include "itksys/SystemTools.hxx"
 
 #include <cstdio>
 #include <cstring>
@@ -576,6 +577,9 @@ NrrdImageIO::ReadImageInformation()
   Nrrd *        nrrd = nrrdNew();
   NrrdIoState * nio = nrrdIoStateNew();
 
+  m_CompressedDataChunkSize = 0;
+  m_CompressedDataChunks.clear();
+
   try
   {
     // nrrd causes exceptions on purpose, so mask them
@@ -931,7 +935,20 @@ NrrdImageIO::ReadImageInformation()
       char * keyPtr = nullptr;
       char * valPtr = nullptr;
       nrrdKeyValueIndex(nrrd, &keyPtr, &valPtr, kvpi);
-      EncapsulateMetaData<std::string>(thisDic, std::string(keyPtr), std::string(valPtr));
+      if (std::strcmp(keyPtr, ChunkedZlibCompression::ChunkIndexKey) == 0)
+      {
+        // The chunk index only describes the data of this file, so it is
+        // not meta data to be written along with the image again.
+        if (nio->encoding != nrrdEncodingGzip ||
+            !ChunkedZlibCompression::ChunkIndexFromString(valPtr, m_CompressedDataChunkSize, m_CompressedDataChunks))
+        {
+          m_CompressedDataChunks.clear();
+        }
+      }
+      else
+      {
+        EncapsulateMetaData<std::string>(thisDic, std::string(keyPtr), std::string(valPtr));
+      }
       keyPtr = static_cast<char *>(airFree(keyPtr));
       valPtr = static_cast<char *>(airFree(valPtr));
     }
@@ -1071,6 +1088,23 @@ NrrdImageIO::ReadImageInformation()
 void
 NrrdImageIO::Read(void * buffer)
 {
+  if (!m_CompressedDataChunks.empty() && this->GetPixelType() != IOPixelEnum::SYMMETRICSECONDRANKTENSOR)
+  {
+    // Any trouble with the chunks, for example an index left behind by a
+    // tool that compressed the data again, falls back on reading the file
+    // as a whole.
+    try
+    {
+      if (this->ReadCompressedDataChunks(buffer))
+      {
+        return;
+      }
+    }
+    catch (const ExceptionObject &)
+    {
+    }
+  }
+
   Nrrd * nrrd = nrrdNew();
   bool   nrrdAllocated;
 
@@ -1215,6 +1249,118 @@ NrrdImageIO::Read(void * buffer)
   }
 }
 
+bool
+NrrdImageIO::GetPixelDataFileLocation(std::string & fileName, SizeType & offset)
+{
+  return this->GetDataFileLocation(nrrdEncodingRaw, fileName, offset);
+}
+
+bool
+NrrdImageIO::GetDataFileLocation(const NrrdEncoding_t * encoding, std::string & fileName, SizeType & offset)
+{
+  Nrrd *        nrrd = nrrdNew();
+  NrrdIoState * nio = nrrdIoStateNew();
+
+  // Parse the header once more, keeping the data file open, positioned at
+  // the first byte of the data, after any line or byte skipping.
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+
+  bool located = false;
+  {
+    bool saveFPEState(false);
+    if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+    {
+      saveFPEState = FloatingPointExceptions::GetEnabled();
+      FloatingPointExceptions::Disable();
+    }
+    NumericLocale cLocale;
+
+    if (nrrdLoad(nrrd, this->GetFileName(), nio) != 0)
+    {
+      free(biffGetDone(NRRD));
+    }
+    else if (nio->encoding == encoding && nio->dataFile != nullptr && nrrdIoDataFNNumber(nio) == 1 &&
+             nio->dataFSkip == nullptr &&
+             (nrrdElementSize(nrrd) == 1 || nio->endian == airMyEndian()) &&
+             static_cast<SizeType>(nrrdElementSize(nrrd) * nrrdElementNumber(nrrd)) == this->GetImageSizeInBytes())
+    {
+      int                       pixelAxisIndex{ -1 };
+      std::vector<unsigned int> imageAxes_nrrd;
+      bool                      needPermutation{ false };
+      unsigned int              numberOfDomainAxes{ 0 };
+      GetAxisOrderForFileReading(
+        nrrd, imageAxes_nrrd, pixelAxisIndex, numberOfDomainAxes, needPermutation, this->GetAxesReorder());
+
+      const long position = ftell(nio->dataFile);
+      if (!needPermutation && position >= 0)
+      {
+        if (nio->dataFNArr->len == 0)
+        {
+          // The data is attached to the header.
+          fileName = this->GetFileName();
+        }
+        else
+        {
+          // A single detached data file, whose name may be relative to the
+          // header, as in nrrdIoStateDataFileIterNext.
+          fileName = nio->dataFN[0];
+          if (fileName != "-" && !itksys::SystemTools::FileIsFullPath(fileName) && airStrlen(nio->path) > 0)
+          {
+            fileName = std::string(nio->path) + '/' + fileName;
+          }
+        }
+        offset = position;
+        located = fileName != "-";
+      }
+    }
+
+    if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+    {
+      FloatingPointExceptions::SetEnabled(saveFPEState);
+    }
+  }
+
+  if (nio->dataFile != nullptr)
+  {
+    airFclose(nio->dataFile);
+    nio->dataFile = nullptr;
+  }
+  nrrdNix(nrrd);
+  nrrdIoStateNix(nio);
+  return located;
+}
+
+bool
+NrrdImageIO::ReadCompressedDataChunks(void * buffer)
+{
+  std::string fileName;
+  SizeType    offset = 0;
+  if (!this->GetDataFileLocation(nrrdEncodingGzip, fileName, offset))
+  {
+    return false;
+  }
+
+  std::vector<unsigned char> compressed(ChunkedZlibCompression::GetStreamSize(m_CompressedDataChunks, true));
+  std::ifstream              file(fileName, std::ios::in | std::ios::binary);
+  file.seekg(static_cast<std::streamoff>(offset));
+  file.read(reinterpret_cast<char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+  if (!file)
+  {
+    return false;
+  }
+
+  ChunkedZlibCompression::Decompress(compressed.data() + ChunkedZlibCompression::GetHeaderSize(true),
+                                     m_CompressedDataChunks,
+                                     m_CompressedDataChunkSize,
+                                     this->GetImageSizeInBytes(),
+                                     true,
+                                     0,
+                                     m_CompressedDataChunks.size(),
+                                     buffer);
+  return true;
+}
+
 bool
 NrrdImageIO::CanWriteFile(const char * name)
 {
@@ -1373,6 +1519,10 @@ NrrdImageIO::Write(const void * buffer)
   const std::vector<std::string> keys = thisDic.GetKeys();
   for (const std::string & metaKey : keys)
   {
+    if (metaKey == ChunkedZlibCompression::ChunkIndexKey)
+    {
+      continue;
+    }
     if (!std::strncmp(NRRD_KEY_PREFIX.c_str(), metaKey.c_str(), NRRD_KEY_PREFIX.size()))
     {
       const char *              keyField = metaKey.c_str() + NRRD_KEY_PREFIX.size();
@@ -1444,6 +1594,21 @@ NrrdImageIO::Write(const void * buffer)
   // Using thread-safe NumericLocale from ITKCommon.
   NumericLocale cLocale;
 
+  // Gzip data is compressed in parallel, in chunks whose index is stored
+  // in the header, and written after the header. It remains a single gzip
+  // stream, readable as a whole by any NRRD reader.
+  std::vector<unsigned char> compressed;
+  if (nio->encoding == nrrdEncodingGzip)
+  {
+    const auto          dataSize = static_cast<SizeValueType>(nrrdElementSize(nrrd) * nrrdElementNumber(nrrd));
+    const SizeValueType chunkSize = ChunkedZlibCompression::GetChunkSize(dataSize);
+    ChunkedZlibCompression::ChunkIndexType chunks;
+    compressed = ChunkedZlibCompression::Compress(buffer, dataSize, nio->zlibLevel, true, chunkSize, chunks);
+    const std::string index = ChunkedZlibCompression::ChunkIndexToString(chunkSize, chunks);
+    nrrdKeyValueAdd(nrrd, ChunkedZlibCompression::ChunkIndexKey, index.c_str());
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  }
+
   // Write the nrrd to file.
   if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
@@ -1451,6 +1616,30 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  if (nio->skipData)
+  {
+    std::ofstream dataFile;
+    if (nio->dataFNArr->len == 0)
+    {
+      dataFile.open(this->GetFileName(), std::ios::out | std::ios::binary | std::ios::app);
+    }
+    else
+    {
+      // The data file name that nrrdSave wrote in the detached header.
+      std::string dataFileName = nio->dataFN[0];
+      if (!itksys::SystemTools::FileIsFullPath(dataFileName) && airStrlen(nio->path) > 0)
+      {
+        dataFileName = std::string(nio->path) + '/' + dataFileName;
+      }
+      dataFile.open(dataFileName, std::ios::out | std::ios::binary);
+    }
+    dataFile.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+    if (dataFile.fail())
+    {
+      itkExceptionMacro("Write: Error writing the data of " << this->GetFileName());
+    }
+  }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
@@ -70,6 +70,17 @@ namespace itk
  * See GetValueCommonAfterThreadedExecution(), GetValueAndDerivative()
  * and threader::AfterThreadedExecution().
  *
+ * For global-support transforms the derivative is by default accumulated in
+ * the joint PDF derivatives, an image of the number of parameters times the
+ * squared number of histogram bins, shared by all threads. With
+ * UseSparseDerivativeAccumulation, it is instead computed in a second pass over
+ * the points, once the joint PDF of the first pass is known: each work unit
+ * then only adds to its own vector of derivatives, and for a BSplineTransform
+ * only to the parameters of the support of each point. The per work unit
+ * results are merged by a parallel tree reduction. This scales much better
+ * with the number of parameters and of threads, at the cost of evaluating
+ * every point twice, and leaves GetJointPDFDerivatives() null.
+ *
  * The algorithm and much of the code was copied from the previous
  * Mattes MI metric, i.e. itkMattesMutualInformationImageToImageMetric.
  *
@@ -147,6 +158,16 @@ public:
   itkGetConstReferenceMacro(NumberOfHistogramBins, SizeValueType);
   /** @ITKEndGrouping */
 
+  /** Compute the derivative for global-support transforms in a second pass
+   * over the points, accumulating per work unit only the parameters which the
+   * transform Jacobian involves at each point. Off by default.
+   * \sa MattesMutualInformationImageToImageMetricv4 */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseSparseDerivativeAccumulation, bool);
+  itkGetConstMacro(UseSparseDerivativeAccumulation, bool);
+  itkBooleanMacro(UseSparseDerivativeAccumulation);
+  /** @ITKEndGrouping */
+
   void
   Initialize() override;
 
@@ -234,6 +255,19 @@ protected:
   OffsetValueType
   ComputeSingleFixedImageParzenWindowIndex(const FixedImagePixelType & value) const;
 
+  /** Runs the threader once, or, with sparse derivative accumulation, a
+   * first time for the joint PDF and a second time for the derivative. */
+  void
+  GetValueAndDerivativeExecute() const override;
+
+  /** Whether the derivative of this iteration is computed by the second,
+   * sparse, pass over the points. */
+  [[nodiscard]] bool
+  GetSparseDerivativeAccumulationActive() const
+  {
+    return this->m_UseSparseDerivativeAccumulation && this->GetComputeDerivative() && !this->HasLocalSupport();
+  }
+
   /** Variables to define the marginal and joint histograms. */
   SizeValueType m_NumberOfHistogramBins{ 50 };
   PDFValueType  m_MovingImageNormalizedMin{};
@@ -355,6 +389,12 @@ protected:
 
   PDFValueType m_JointPDFSum{};
 
+  /** Sparse derivative accumulation: whether the threader is running the
+   * derivative pass, and the derivative accumulated by each work unit. */
+  bool                                          m_UseSparseDerivativeAccumulation{ false };
+  mutable bool                                  m_SparseDerivativePass{ false };
+  std::vector<std::vector<DerivativeValueType>> m_ThreaderSparseDerivatives{};
+
   /** Store the per-point local derivative result by parzen window bin.
    * For local-support transforms only. */
   mutable std::vector<DerivativeType> m_LocalDerivativeByParzenBin{};
@@ -338,7 +338,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::FinalizeThread(const ThreadIdType threadId)
 {
-  if (this->GetComputeDerivative() && (!this->HasLocalSupport()))
+  if (this->GetComputeDerivative() && (!this->HasLocalSupport()) && !this->m_UseSparseDerivativeAccumulation)
   {
     this->m_ThreaderDerivativeManager[threadId].BlockAndReduce();
   }
@@ -445,7 +445,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
 
           if (this->GetComputeDerivative())
           {
-            if (!this->HasLocalSupport())
+            if (!this->HasLocalSupport() && !this->m_UseSparseDerivativeAccumulation)
             {
               // Collect global derivative contributions
               const JointPDFValueType * derivPtr = this->m_JointPDFDerivatives->GetBufferPointer() +
@@ -463,7 +463,8 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
             else
             {
               // Collect the pRatio per pdf indices.
-              // Will be applied subsequently to local-support derivative
+              // Will be applied subsequently to local-support derivative,
+              // or by the sparse derivative pass.
               const OffsetValueType index = movingIndex + (fixedIndex * this->m_NumberOfHistogramBins);
               this->m_PRatioArray[index] = pRatio * nFactor;
             }
@@ -511,7 +512,10 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::GetValueCommonAfterThreadedExecution()
 {
-  const ThreadIdType localNumberOfWorkUnitsUsed = this->GetNumberOfWorkUnitsUsed();
+  // With sparse derivative accumulation, the threader already summed the
+  // per-thread PDFs by a tree reduction.
+  const ThreadIdType localNumberOfWorkUnitsUsed =
+    this->m_UseSparseDerivativeAccumulation ? 1 : this->GetNumberOfWorkUnitsUsed();
 
   const SizeValueType       numberOfVoxels = this->m_NumberOfHistogramBins * this->m_NumberOfHistogramBins;
   JointPDFValueType * const pdfPtrStart = this->m_ThreaderJointPDF[0]->GetBufferPointer();
@@ -555,6 +559,33 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TMetricTraits>::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfBooleanMacro(UseSparseDerivativeAccumulation);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage,
+                                            TMovingImage,
+                                            TVirtualImage,
+                                            TInternalComputationValueType,
+                                            TMetricTraits>::GetValueAndDerivativeExecute() const
+{
+  this->m_SparseDerivativePass = false;
+  this->Superclass::GetValueAndDerivativeExecute();
+
+  if (this->GetSparseDerivativeAccumulationActive())
+  {
+    // The first pass computed the value and the pRatio of every joint PDF
+    // bin, which weight the derivative contributions of the second.
+    this->m_SparseDerivativePass = true;
+    this->Superclass::GetValueAndDerivativeExecute();
+    this->m_SparseDerivativePass = false;
+  }
 }
 
 template <typename TFixedImage,
@@ -19,6 +19,7 @@
 #define itkMattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader_h
 
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkBSplineBaseTransform.h"
 
 #include <mutex>
 
@@ -120,10 +121,35 @@ protected:
                                              const PDFValueType &            cubicBSplineDerivativeValue,
                                              DerivativeValueType *           localSupportDerivativeResultPtr) const;
 
+  /** Subtract the derivative contribution of a point, given the sum of the
+   * pRatio weighted Parzen window derivatives of its bins, from the derivative
+   * of a work unit, during the sparse derivative pass. Only the parameters of
+   * the support of the point are touched for a cubic BSplineBaseTransform. */
+  virtual void
+  ComputePDFDerivativesSparse(const VirtualPointType &        virtualPoint,
+                              const MovingImageGradientType & movingImageGradient,
+                              const PDFValueType &            coefficient,
+                              DerivativeValueType *           derivativeResultPtr,
+                              const ThreadIdType              threadId) const;
+
 private:
+  /** Sum the buffers of all the work units into the first one, by a parallel
+   * tree reduction. */
+  template <typename TValue>
+  void
+  ReduceWorkUnitBuffers(const std::vector<TValue *> & buffers, SizeValueType length) const;
+
+  using CubicBSplineMovingTransformType = BSplineBaseTransform<typename MovingTransformType::ParametersValueType,
+                                                               MovingTransformType::InputSpaceDimension,
+                                                               3>;
+
   /** Internal pointer to the Mattes metric object in use by this threader.
    *  This will avoid costly dynamic casting in tight loops. */
   TMattesMutualInformationMetric * m_MattesAssociate{};
+
+  /** The moving transform, during the sparse derivative pass, if it is a
+   * cubic B-spline transform. */
+  const CubicBSplineMovingTransformType * m_CubicBSplineMovingTransform{};
 };
 
 } // end namespace itk
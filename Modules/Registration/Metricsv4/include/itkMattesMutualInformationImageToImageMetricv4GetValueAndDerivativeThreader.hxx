@@ -44,6 +44,26 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
     itkExceptionStringMacro("Dynamic casting of associate pointer failed.");
   }
 
+  if (this->m_MattesAssociate->m_SparseDerivativePass)
+  {
+    // The joint PDF and the pRatios of the first pass are kept: only the
+    // derivative of each work unit is accumulated, zeroed by its own thread.
+    this->m_CubicBSplineMovingTransform =
+      dynamic_cast<const CubicBSplineMovingTransformType *>(this->m_MattesAssociate->GetMovingTransform());
+
+    auto &                       derivatives = this->m_MattesAssociate->m_ThreaderSparseDerivatives;
+    const NumberOfParametersType numberOfParameters = this->m_MattesAssociate->GetNumberOfParameters();
+    derivatives.resize(this->GetNumberOfWorkUnitsUsed());
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      derivatives.size(),
+      [&derivatives, numberOfParameters](SizeValueType workUnit) {
+        derivatives[workUnit].assign(numberOfParameters, DerivativeValueType{});
+      },
+      nullptr);
+    return;
+  }
+
   /* Porting: these next blocks of code are from MattesMutualImageToImageMetric::Initialize */
 
   /*
@@ -157,7 +177,17 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
       this->m_MattesAssociate->m_LocalDerivativeByParzenBin[n].Fill(DerivativeValueType{});
     }
   }
-  if (this->m_MattesAssociate->GetComputeDerivative() && !this->m_MattesAssociate->HasLocalSupport())
+  if (this->m_MattesAssociate->GetSparseDerivativeAccumulationActive())
+  {
+    // The derivative is computed by the second pass, from the pRatios of
+    // this one.
+    this->m_MattesAssociate->m_PRatioArray.assign(
+      this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins, 0.0);
+    this->m_MattesAssociate->m_JointPdfIndex1DArray.clear();
+    this->m_MattesAssociate->m_LocalDerivativeByParzenBin.clear();
+    this->m_MattesAssociate->m_JointPDFDerivatives = nullptr;
+  }
+  else if (this->m_MattesAssociate->GetComputeDerivative() && !this->m_MattesAssociate->HasLocalSupport())
   {
     // Don't need this with global transforms
     this->m_MattesAssociate->m_PRatioArray.clear();
@@ -229,7 +259,10 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
                                                 DerivativeType &,
                                                 const ThreadIdType threadId) const
 {
-  const bool doComputeDerivative = this->m_MattesAssociate->GetComputeDerivative();
+  // With sparse derivative accumulation, the first pass only computes the
+  // joint PDF.
+  const bool doComputeDerivative = this->m_MattesAssociate->GetComputeDerivative() &&
+                                   !this->m_MattesAssociate->GetSparseDerivativeAccumulationActive();
   /**
    * Compute this sample's contribution to the marginal
    *   and joint distributions.
@@ -269,6 +302,31 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   const OffsetValueType fixedImageParzenWindowIndex =
     this->m_MattesAssociate->ComputeSingleFixedImageParzenWindowIndex(fixedImageValue);
 
+  if (this->m_MattesAssociate->m_SparseDerivativePass)
+  {
+    // The contributions of the four affected bins only differ by the pRatio
+    // and the Parzen window derivative, so they are summed first.
+    const PDFValueType * pRatioPtr = this->m_MattesAssociate->m_PRatioArray.data() +
+                                     (fixedImageParzenWindowIndex * this->m_MattesAssociate->m_NumberOfHistogramBins) +
+                                     pdfMovingIndex;
+    PDFValueType movingImageParzenWindowArg =
+      static_cast<PDFValueType>(pdfMovingIndex) - static_cast<PDFValueType>(movingImageParzenWindowTerm);
+    PDFValueType coefficient = 0.0;
+    for (; pdfMovingIndex <= pdfMovingIndexMax; ++pdfMovingIndex, ++pRatioPtr)
+    {
+      coefficient += *pRatioPtr * CubicBSplineDerivativeFunctionType::FastEvaluate(movingImageParzenWindowArg);
+      movingImageParzenWindowArg += 1.0;
+    }
+    this->ComputePDFDerivativesSparse(virtualPoint,
+                                      movingImageGradient,
+                                      coefficient,
+                                      this->m_MattesAssociate->m_ThreaderSparseDerivatives[threadId].data(),
+                                      threadId);
+
+    this->m_GetValueAndDerivativePerThreadVariables[threadId].NumberOfValidPoints++;
+    return false;
+  }
+
   // Since a zero-order BSpline (box car) kernel is used for
   // the fixed image marginal pdf, we need only increment the
   // fixedImageParzenWindowIndex by value of 1.0.
@@ -410,6 +468,94 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<TDomain
   }
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric>
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
+                                                                         TImageToImageMetric,
+                                                                         TMattesMutualInformationMetric>::
+  ComputePDFDerivativesSparse(const VirtualPointType &        virtualPoint,
+                              const MovingImageGradientType & movingImageGradient,
+                              const PDFValueType &            coefficient,
+                              DerivativeValueType *           derivativeResultPtr,
+                              const ThreadIdType              threadId) const
+{
+  // Note: as for local-support transforms, the contribution is subtracted,
+  // the pRatios being scaled by a positive factor.
+  if (this->m_CubicBSplineMovingTransform != nullptr)
+  {
+    // The Jacobian of a dimension is the B-spline weight of each coefficient
+    // of the support, at the parameters of that dimension.
+    typename CubicBSplineMovingTransformType::WeightsType             weights;
+    typename CubicBSplineMovingTransformType::ParameterIndexArrayType indices;
+    this->m_CubicBSplineMovingTransform->ComputeJacobianFromBSplineWeightsWithRespectToPosition(
+      virtualPoint, weights, indices);
+    const NumberOfParametersType numberOfParametersPerDimension =
+      this->m_CubicBSplineMovingTransform->GetNumberOfParametersPerDimension();
+
+    for (SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim)
+    {
+      const PDFValueType    dimensionCoefficient = coefficient * movingImageGradient[dim];
+      DerivativeValueType * dimensionDerivativePtr = derivativeResultPtr + dim * numberOfParametersPerDimension;
+      for (unsigned int k = 0; k < CubicBSplineMovingTransformType::NumberOfWeights; ++k)
+      {
+        dimensionDerivativePtr[indices[k]] -= dimensionCoefficient * weights[k];
+      }
+    }
+    return;
+  }
+
+  JacobianType & jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
+  JacobianType & jacobianPositional =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
+  this->m_MattesAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
+    virtualPoint, jacobian, jacobianPositional);
+  for (NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement; ++mu)
+  {
+    PDFValueType innerProduct = 0.0;
+    for (SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim)
+    {
+      innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+    }
+    derivativeResultPtr[mu] -= coefficient * innerProduct;
+  }
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric>
+template <typename TValue>
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
+  TDomainPartitioner,
+  TImageToImageMetric,
+  TMattesMutualInformationMetric>::ReduceWorkUnitBuffers(const std::vector<TValue *> & buffers,
+                                                         SizeValueType                 length) const
+{
+  // Buffers 1, 2, 4, ... apart are summed pairwise, level by level. A level
+  // is split over its pairs and over chunks of the buffers, so that even the
+  // last one, a single pair, runs in parallel.
+  constexpr SizeValueType chunkLength = 4096;
+  const SizeValueType     numberOfChunks = (length + chunkLength - 1) / chunkLength;
+  const SizeValueType     numberOfBuffers = buffers.size();
+  for (SizeValueType distance = 1; distance < numberOfBuffers; distance *= 2)
+  {
+    const SizeValueType numberOfPairs = (numberOfBuffers + distance - 1) / (2 * distance);
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfPairs * numberOfChunks,
+      [&buffers, distance, numberOfChunks, length](SizeValueType item) {
+        const SizeValueType  pair = item / numberOfChunks;
+        const SizeValueType  begin = (item % numberOfChunks) * chunkLength;
+        const SizeValueType  end = std::min(begin + chunkLength, length);
+        TValue * const       target = buffers[2 * distance * pair];
+        const TValue * const source = buffers[2 * distance * pair + distance];
+        for (SizeValueType i = begin; i < end; ++i)
+        {
+          target[i] += source[i];
+        }
+      },
+      nullptr);
+  }
+}
+
 template <typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric>
 void
 MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
@@ -417,6 +563,24 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   TImageToImageMetric,
   TMattesMutualInformationMetric>::AfterThreadedExecution()
 {
+  if (this->m_MattesAssociate->m_SparseDerivativePass)
+  {
+    auto &                             derivatives = this->m_MattesAssociate->m_ThreaderSparseDerivatives;
+    std::vector<DerivativeValueType *> derivativePtrs;
+    for (auto & derivative : derivatives)
+    {
+      derivativePtrs.push_back(derivative.data());
+    }
+    this->ReduceWorkUnitBuffers(derivativePtrs, this->m_MattesAssociate->GetNumberOfParameters());
+
+    DerivativeType & derivativeResult = *(this->m_MattesAssociate->m_DerivativeResult);
+    for (NumberOfParametersType mu = 0, lastParameter = derivativeResult.Size(); mu < lastParameter; ++mu)
+    {
+      derivativeResult[mu] += derivatives[0][mu];
+    }
+    return;
+  }
+
   const ThreadIdType localNumberOfWorkUnitsUsed = this->GetNumberOfWorkUnitsUsed();
   /* Store the number of valid points in the enclosing class
    * m_NumberOfValidPoints by collecting the valid points per thread.
@@ -428,12 +592,27 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
       this->m_GetValueAndDerivativePerThreadVariables[workUnitID].NumberOfValidPoints;
   }
 
+  if (this->m_MattesAssociate->m_UseSparseDerivativeAccumulation)
+  {
+    std::vector<JointPDFValueType *> jointPDFPtrs;
+    std::vector<PDFValueType *>      fixedImageMarginalPDFPtrs;
+    for (ThreadIdType workUnitID = 0; workUnitID < localNumberOfWorkUnitsUsed; ++workUnitID)
+    {
+      jointPDFPtrs.push_back(this->m_MattesAssociate->m_ThreaderJointPDF[workUnitID]->GetBufferPointer());
+      fixedImageMarginalPDFPtrs.push_back(this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF[workUnitID].data());
+    }
+    const SizeValueType numberOfHistogramBins = this->m_MattesAssociate->m_NumberOfHistogramBins;
+    this->ReduceWorkUnitBuffers(jointPDFPtrs, numberOfHistogramBins * numberOfHistogramBins);
+    this->ReduceWorkUnitBuffers(fixedImageMarginalPDFPtrs, numberOfHistogramBins);
+  }
+
   /* Porting: This code is from
    * MattesMutualInformationImageToImageMetric::GetValueAndDerivativeThreadPostProcess */
   /* Post-processing that is common the GetValue and GetValueAndDerivative */
   this->m_MattesAssociate->GetValueCommonAfterThreadedExecution();
 
-  if (this->m_MattesAssociate->GetComputeDerivative() && (!this->m_MattesAssociate->HasLocalSupport()))
+  if (this->m_MattesAssociate->GetComputeDerivative() && (!this->m_MattesAssociate->HasLocalSupport()) &&
+      !this->m_MattesAssociate->m_UseSparseDerivativeAccumulation)
   {
     // This entire block of code is used to accumulate the per-thread buffers
     // into 1 thread.
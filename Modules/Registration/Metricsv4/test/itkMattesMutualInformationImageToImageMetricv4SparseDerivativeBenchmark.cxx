@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the time MattesMutualInformationImageToImageMetricv4 takes to
+// compute its value and derivative for a 3D BSplineTransform, accumulating
+// the derivative in the shared joint PDF derivatives or sparsely per work
+// unit, for 1, 2, 4, ... up to maxNumberOfWorkUnits work units. The
+// derivatives of both modes are checked to match, also for an
+// AffineTransform.
+//
+// The benchmark is built into ITKMetricsv4TestDriver but, like the ones of
+// the PerformanceBenchmarking remote module, not registered as a test; the
+// agreement of both modes is tested by
+// itkMattesMutualInformationImageToImageMetricv4Test. Run it as
+//   ITKMetricsv4TestDriver itkMattesMutualInformationImageToImageMetricv4SparseDerivativeBenchmark
+//     size meshSize [maxNumberOfWorkUnits] [iterations]
+// e.g. a size of 128 and a meshSize of 12 benchmarks 128^3 volumes and
+// 3 * 15^3 parameters, for up to 64 work units by default.
+
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using MetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+ImageType::Pointer
+MakeImage(itk::SizeValueType size, double shift, bool inverted)
+{
+  // Blobs, of intensities which are inverted between the images, so that
+  // their mutual information is high while their difference is not small.
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    double value = 1.0;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      value *= std::sin((it.GetIndex()[d] + shift * (d + 1)) * 6.0 / size);
+    }
+    it.Set(static_cast<float>(100.0 * (inverted ? 1.0 - value : value)));
+  }
+  return image;
+}
+
+bool
+Compare(const char *                       label,
+        MetricType::MeasureType            value,
+        const MetricType::DerivativeType & derivative,
+        MetricType::MeasureType            sparseValue,
+        const MetricType::DerivativeType & sparseDerivative)
+{
+  double maximum = 0.0;
+  double maximumDifference = 0.0;
+  for (unsigned int i = 0; i < derivative.Size(); ++i)
+  {
+    maximum = std::max(maximum, std::abs(derivative[i]));
+    maximumDifference = std::max(maximumDifference, std::abs(derivative[i] - sparseDerivative[i]));
+  }
+  if (std::abs(value - sparseValue) > 1e-9 * std::abs(value) || maximumDifference > 1e-8 * maximum)
+  {
+    std::cerr << "Error: " << label << " sparse value " << sparseValue << " instead of " << value
+              << ", maximum derivative difference " << maximumDifference << " for a maximum of " << maximum
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+template <typename TTransform>
+bool
+Benchmark(const char *                   name,
+          TTransform *                   transform,
+          const ImageType *              fixedImage,
+          const ImageType *              movingImage,
+          itk::ThreadIdType              maxNumberOfWorkUnits,
+          unsigned int                   iterations,
+          itk::TimeProbesCollectorBase & collector)
+{
+  bool ok = true;
+  for (itk::ThreadIdType workUnits = 1; workUnits <= maxNumberOfWorkUnits; workUnits *= 2)
+  {
+    const std::string label = std::string(name) + " " + std::to_string(workUnits) + " work units";
+
+    MetricType::MeasureType    values[2];
+    MetricType::DerivativeType derivatives[2];
+    for (const bool sparse : { false, true })
+    {
+      auto metric = MetricType::New();
+      metric->SetFixedImage(fixedImage);
+      metric->SetMovingImage(movingImage);
+      metric->SetMovingTransform(transform);
+      metric->SetMaximumNumberOfWorkUnits(workUnits);
+      metric->SetUseSparseDerivativeAccumulation(sparse);
+      metric->Initialize();
+
+      const std::string probe = label + (sparse ? " sparse" : " dense");
+      for (unsigned int i = 0; i < iterations; ++i)
+      {
+        collector.Start(probe.c_str());
+        metric->GetValueAndDerivative(values[sparse], derivatives[sparse]);
+        collector.Stop(probe.c_str());
+      }
+      if (sparse && metric->GetJointPDFDerivatives().IsNotNull())
+      {
+        std::cerr << "Error: " << label << " sparse accumulation allocated the joint PDF derivatives" << std::endl;
+        ok = false;
+      }
+    }
+    ok &= Compare(label.c_str(), values[0], derivatives[0], values[1], derivatives[1]);
+  }
+  return ok;
+}
+} // namespace
+
+int
+itkMattesMutualInformationImageToImageMetricv4SparseDerivativeBenchmark(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv)
+              << " size meshSize [maxNumberOfWorkUnits] [iterations]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto              size = static_cast<itk::SizeValueType>(std::stoul(argv[1]));
+  const auto              meshSize = static_cast<itk::SizeValueType>(std::stoul(argv[2]));
+  const itk::ThreadIdType maxNumberOfWorkUnits = argc > 3 ? std::stoi(argv[3]) : 64;
+  const unsigned int      iterations = argc > 4 ? std::stoi(argv[4]) : 1;
+
+  const auto fixedImage = MakeImage(size, 0.0, false);
+  const auto movingImage = MakeImage(size, 1.5, true);
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto bSplineTransform = BSplineTransformType::New();
+  bSplineTransform->SetTransformDomainOrigin(fixedImage->GetOrigin());
+  bSplineTransform->SetTransformDomainDirection(fixedImage->GetDirection());
+  bSplineTransform->SetTransformDomainPhysicalDimensions(
+    BSplineTransformType::PhysicalDimensionsType(static_cast<double>(size - 1)));
+  bSplineTransform->SetTransformDomainMeshSize(BSplineTransformType::MeshSizeType::Filled(meshSize));
+
+  BSplineTransformType::ParametersType parameters(bSplineTransform->GetNumberOfParameters());
+  std::mt19937                         generator(1);
+  std::uniform_real_distribution<>     displacement(-0.5, 0.5);
+  for (auto & parameter : parameters)
+  {
+    parameter = displacement(generator);
+  }
+  bSplineTransform->SetParameters(parameters);
+
+  auto affineTransform = itk::AffineTransform<double, Dimension>::New();
+  auto translation = itk::AffineTransform<double, Dimension>::OutputVectorType(0.7);
+  affineTransform->SetTranslation(translation);
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+
+  ok &= Benchmark(
+    "BSpline", bSplineTransform.GetPointer(), fixedImage, movingImage, maxNumberOfWorkUnits, iterations, collector);
+  ok &= Benchmark("affine", affineTransform.GetPointer(), fixedImage, movingImage, 4, 1, collector);
+
+  collector.Report(std::cout);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,11 +22,15 @@
 #include "itkBSplineInterpolateImageFunction.h"
 #include "itkTextOutput.h"
 #include "itkBSplineSmoothingOnUpdateDisplacementFieldTransform.h"
+#include "itkBSplineTransform.h"
 #include "itkImageMaskSpatialObject.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkTimeProbe.h"
 #include "itkTestingMacros.h"
 
+#include <cmath>
 #include <iostream>
+#include <random>
 
 /**
  * This test was copied for v4 metric from itkMattesMutualInformationImageToMetricTest
@@ -224,6 +228,8 @@ TestMattesMetricWithAffineTransform(TInterpolator * const interpolator, const bo
   metric->SetNumberOfHistogramBins(numberOfHistogramBins);
   ITK_TEST_SET_GET_VALUE(numberOfHistogramBins, metric->GetNumberOfHistogramBins());
 
+  ITK_TEST_SET_GET_BOOLEAN(metric, UseSparseDerivativeAccumulation, false);
+
   // this test doesn't pass when using gradient image filters,
   // presumably because of different derivative scaling created
   // by the filter output. The derivative results match those
@@ -433,6 +439,110 @@ TestMattesMetricWithAffineTransform(TInterpolator * const interpolator, const bo
   return EXIT_SUCCESS;
 }
 
+/**
+ * Checks that the value and derivative computed with
+ * UseSparseDerivativeAccumulation on match the ones accumulated in the joint
+ * PDF derivatives, for a BSplineTransform, whose derivative is accumulated
+ * sparsely, and for an AffineTransform, which falls back to the dense
+ * Jacobian, over several work units.
+ */
+template <typename TImage>
+int
+TestMattesMetricSparseDerivativeAccumulation()
+{
+  constexpr unsigned int ImageDimension = TImage::ImageDimension;
+  constexpr double       size = 40.0;
+
+  // Blobs, of intensities which are inverted between the images.
+  const auto makeImage = [size](double shift, bool inverted) {
+    auto image = TImage::New();
+    image->SetRegions(TImage::SizeType::Filled(static_cast<itk::SizeValueType>(size)));
+    image->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      double value = 1.0;
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+      {
+        value *= std::sin((it.GetIndex()[d] + shift * (d + 1)) * 6.0 / size);
+      }
+      it.Set(100.0 * (inverted ? 1.0 - value : value));
+    }
+    return image;
+  };
+  const auto fixedImage = makeImage(0.0, false);
+  const auto movingImage = makeImage(1.5, true);
+
+  using BSplineTransformType = itk::BSplineTransform<double, ImageDimension, 3>;
+  auto bSplineTransform = BSplineTransformType::New();
+  bSplineTransform->SetTransformDomainOrigin(fixedImage->GetOrigin());
+  bSplineTransform->SetTransformDomainDirection(fixedImage->GetDirection());
+  bSplineTransform->SetTransformDomainPhysicalDimensions(
+    typename BSplineTransformType::PhysicalDimensionsType(size - 1.0));
+  bSplineTransform->SetTransformDomainMeshSize(BSplineTransformType::MeshSizeType::Filled(4));
+  typename BSplineTransformType::ParametersType parameters(bSplineTransform->GetNumberOfParameters());
+  std::mt19937                                  generator(1);
+  std::uniform_real_distribution<>              displacement(-0.5, 0.5);
+  for (auto & parameter : parameters)
+  {
+    parameter = displacement(generator);
+  }
+  bSplineTransform->SetParameters(parameters);
+
+  using AffineTransformType = itk::AffineTransform<double, ImageDimension>;
+  auto affineTransform = AffineTransformType::New();
+  affineTransform->SetTranslation(typename AffineTransformType::OutputVectorType(0.7));
+
+  using MetricType = itk::MattesMutualInformationImageToImageMetricv4<TImage, TImage>;
+  using TransformType = typename MetricType::MovingTransformType;
+
+  int result = EXIT_SUCCESS;
+  for (TransformType * transform :
+       { static_cast<TransformType *>(bSplineTransform.GetPointer()), static_cast<TransformType *>(affineTransform) })
+  {
+    for (const itk::ThreadIdType workUnits : { 1, 3 })
+    {
+      typename MetricType::MeasureType    values[2];
+      typename MetricType::DerivativeType derivatives[2];
+      for (const bool sparse : { false, true })
+      {
+        auto metric = MetricType::New();
+        metric->SetFixedImage(fixedImage);
+        metric->SetMovingImage(movingImage);
+        metric->SetMovingTransform(transform);
+        metric->SetMaximumNumberOfWorkUnits(workUnits);
+        metric->SetUseSparseDerivativeAccumulation(sparse);
+        metric->Initialize();
+        metric->GetValueAndDerivative(values[sparse], derivatives[sparse]);
+
+        if (sparse && metric->GetJointPDFDerivatives().IsNotNull())
+        {
+          std::cerr << "Sparse accumulation allocated the joint PDF derivatives for " << transform->GetNameOfClass()
+                    << std::endl;
+          result = EXIT_FAILURE;
+        }
+      }
+
+      double maximum = 0.0;
+      double maximumDifference = 0.0;
+      for (unsigned int i = 0; i < derivatives[0].Size(); ++i)
+      {
+        maximum = std::max(maximum, std::abs(derivatives[0][i]));
+        maximumDifference = std::max(maximumDifference, std::abs(derivatives[0][i] - derivatives[1][i]));
+      }
+      std::cout << transform->GetNameOfClass() << ", " << workUnits << " work units: value " << values[0]
+                << ", maximum derivative " << maximum << ", maximum difference " << maximumDifference << std::endl;
+      if (maximum == 0.0 || std::abs(values[0] - values[1]) > 1e-9 * std::abs(values[0]) ||
+          maximumDifference > 1e-8 * maximum)
+      {
+        std::cerr << "Sparse value " << values[1] << " instead of " << values[0] << ", or derivatives differ, for "
+                  << transform->GetNameOfClass() << " with " << workUnits << " work units" << std::endl;
+        result = EXIT_FAILURE;
+      }
+    }
+  }
+  return result;
+}
+
 /**
  * Test entry point.
  */
@@ -567,6 +677,13 @@ itkMattesMutualInformationImageToImageMetricv4Test(int, char *[])
     return EXIT_FAILURE;
   }
 
+  std::cout << "Test metric with a sparse derivative accumulation." << std::endl;
+  if (TestMattesMetricSparseDerivativeAccumulation<ImageType>() != EXIT_SUCCESS)
+  {
+    std::cout << "Test failed with a sparse derivative accumulation" << std::endl;
+    return EXIT_FAILURE;
+  }
+
   std::cout << "Test passed" << std::endl;
   return EXIT_SUCCESS;
 }
@@ -45,26 +45,26 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, T
   using BSplineDisplacementFieldTransformAdaptorType =
     BSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor<OutputTransformType>;
 
-  if (level == 0)
+  if (level == this->m_StartLevel)
   {
     this->m_FixedToMiddleTransform->SetSplineOrder(this->m_OutputTransform->GetSplineOrder());
     this->m_FixedToMiddleTransform->SetNumberOfControlPointsForTheUpdateField(
       dynamic_cast<BSplineDisplacementFieldTransformAdaptorType *>(
-        this->m_TransformParametersAdaptorsPerLevel[0].GetPointer())
+        this->m_TransformParametersAdaptorsPerLevel[level].GetPointer())
         ->GetNumberOfControlPointsForTheUpdateField());
     this->m_FixedToMiddleTransform->SetNumberOfControlPointsForTheTotalField(
       dynamic_cast<BSplineDisplacementFieldTransformAdaptorType *>(
-        this->m_TransformParametersAdaptorsPerLevel[0].GetPointer())
+        this->m_TransformParametersAdaptorsPerLevel[level].GetPointer())
         ->GetNumberOfControlPointsForTheTotalField());
 
     this->m_MovingToMiddleTransform->SetSplineOrder(this->m_OutputTransform->GetSplineOrder());
     this->m_MovingToMiddleTransform->SetNumberOfControlPointsForTheUpdateField(
       dynamic_cast<BSplineDisplacementFieldTransformAdaptorType *>(
-        this->m_TransformParametersAdaptorsPerLevel[0].GetPointer())
+        this->m_TransformParametersAdaptorsPerLevel[level].GetPointer())
         ->GetNumberOfControlPointsForTheUpdateField());
     this->m_MovingToMiddleTransform->SetNumberOfControlPointsForTheTotalField(
       dynamic_cast<BSplineDisplacementFieldTransformAdaptorType *>(
-        this->m_TransformParametersAdaptorsPerLevel[0].GetPointer())
+        this->m_TransformParametersAdaptorsPerLevel[level].GetPointer())
         ->GetNumberOfControlPointsForTheTotalField());
   }
 }
@@ -94,6 +94,10 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, T
   using ConvergenceMonitoringType = itk::Function::WindowConvergenceMonitoringFunction<RealType>;
   auto convergenceMonitoring = ConvergenceMonitoringType::New();
   convergenceMonitoring->SetWindowSize(this->m_ConvergenceWindowSize);
+  for (const RealType metricValue : this->m_CurrentLevelMetricValues)
+  {
+    convergenceMonitoring->AddEnergyValue(metricValue);
+  }
 
   IterationReporter reporter(this, 0, 1);
 
@@ -143,14 +147,7 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, T
 
     if (this->m_AverageMidPointGradients)
     {
-      for (ImageRegionIteratorWithIndex ItF(fixedToMiddleSmoothUpdateField,
-                                            fixedToMiddleSmoothUpdateField->GetLargestPossibleRegion());
-           !ItF.IsAtEnd();
-           ++ItF)
-      {
-        ItF.Set(ItF.Get() - movingToMiddleSmoothUpdateField->GetPixel(ItF.GetIndex()));
-        movingToMiddleSmoothUpdateField->SetPixel(ItF.GetIndex(), -ItF.Get());
-      }
+      this->AverageMidPointGradientFields(fixedToMiddleSmoothUpdateField, movingToMiddleSmoothUpdateField);
     }
 
     // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
@@ -201,6 +198,7 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, T
     this->m_CurrentMetricValue = 0.5 * (movingMetricValue + fixedMetricValue);
 
     convergenceMonitoring->AddEnergyValue(this->m_CurrentMetricValue);
+    this->m_CurrentLevelMetricValues.push_back(this->m_CurrentMetricValue);
     this->m_CurrentConvergenceValue = convergenceMonitoring->GetConvergenceValue();
 
     if (this->m_CurrentConvergenceValue < this->m_ConvergenceThreshold)
@@ -28,10 +28,13 @@
 #include "itkImageToImageMetricv4.h"
 #include "itkPointSetToPointSetMetricWithIndexv4.h"
 #include "itkShrinkImageFilter.h"
+#include "itkSmoothedImagePyramid.h"
 #include "itkIdentityTransform.h"
 #include "itkTransformParametersAdaptorBase.h"
 #include "ITKRegistrationMethodsv4Export.h"
 
+#include <iostream>
+#include <string>
 #include <vector>
 
 namespace itk
@@ -102,6 +105,18 @@ operator<<(std::ostream & out, const ImageRegistrationMethodv4Enums::MetricSampl
  * given stage so typical use will be to assign the base adaptor class to
  * level 0 of all stages but we leave that open to the user.
  *
+ * Fixed image pyramids:  When many moving images are registered to the
+ * same fixed image, e.g. an atlas, the smoothed fixed images of each level
+ * can be computed once and shared by the registrations through a
+ * SmoothedImagePyramid set with SetFixedImagePyramid().
+ *
+ * Checkpoints:  The state of an ongoing registration, i.e. the current
+ * level and iteration and the transforms being optimized, may be saved with
+ * WriteCheckpoint() from an observer of the iteration events.  Another
+ * registration, set up identically, resumes it from there after
+ * ReadCheckpoint().  For this class, the optimizer must be a plain
+ * GradientDescentOptimizerv4Template, whose scales and learning rate are saved.
+ *
  * Output: The output is the updated transform.
  *
  * \author Nick Tustison
@@ -144,6 +159,10 @@ public:
   using MovingImageConstPointer = typename MovingImageType::ConstPointer;
   using MovingImagesContainerType = std::vector<MovingImageConstPointer>;
 
+  using FixedImagePyramidType = SmoothedImagePyramid<FixedImageType>;
+  using FixedImagePyramidPointer = typename FixedImagePyramidType::Pointer;
+  using FixedImagePyramidsContainerType = std::vector<FixedImagePyramidPointer>;
+
   using PointSetType = TPointSet;
   using PointSetConstPointer = typename PointSetType::ConstPointer;
   using PointSetsContainerType = std::vector<PointSetConstPointer>;
@@ -257,6 +276,27 @@ public:
   virtual const MovingImageType * GetMovingImage(SizeValueType) const;
   /** @ITKEndGrouping */
 
+  /** Set/Get the pyramids of the fixed images.  When the pyramid of a fixed
+   * image is set, the smoothed fixed images of the levels are requested from
+   * it, and shared with the other registrations using it, instead of being
+   * computed by each registration.  The image of the pyramid must be the
+   * fixed image. */
+  /** @ITKStartGrouping */
+  virtual void
+  SetFixedImagePyramid(FixedImagePyramidType * pyramid)
+  {
+    this->SetFixedImagePyramid(0, pyramid);
+  }
+  virtual FixedImagePyramidType *
+  GetFixedImagePyramid() const
+  {
+    return this->GetFixedImagePyramid(0);
+  }
+  virtual void
+                                  SetFixedImagePyramid(SizeValueType, FixedImagePyramidType *);
+  virtual FixedImagePyramidType * GetFixedImagePyramid(SizeValueType) const;
+  /** @ITKEndGrouping */
+
   /** Set/get the fixed point sets. */
   /** @ITKStartGrouping */
   virtual void
@@ -504,6 +544,32 @@ public:
   /** Get the current convergence state per level.  This is a helper function for reporting observations. */
   itkGetConstReferenceMacro(IsConverged, bool);
 
+  /**
+   * Write the state of the ongoing registration to a binary stream: the
+   * current level and iteration, the transform being optimized and the
+   * scales and learning rate of the optimizer.  It is meant to be called by an
+   * observer of the iteration events of the optimizer, or of the registration
+   * when it optimizes the transforms itself, e.g. SyNImageRegistrationMethod.
+   * An exception is thrown if the state of the optimizer cannot be saved, i.e.
+   * if it is not a plain GradientDescentOptimizerv4Template: the state of its
+   * subclasses, e.g. the momentum or the step length, is not saved.
+   */
+  void
+  WriteCheckpoint(std::ostream & os) const;
+
+  /**
+   * Read a checkpoint written by WriteCheckpoint(), from which the following
+   * updates resume the registration, until one of them completes.  The
+   * registration must be set up as the one which wrote the checkpoint: the
+   * inputs, the levels, the metric and the optimizer.  The resumed
+   * registration is identical to an uninterrupted one, except that the
+   * convergence monitoring and the tracking of the best parameters of the
+   * optimizer restart at the resumed iteration.  As by WriteCheckpoint(), an
+   * exception is thrown if the optimizer is not supported.
+   */
+  void
+  ReadCheckpoint(std::istream & is);
+
   /** Request that the InitialTransform be grafted onto the output,
    * there by not creating a copy.
    */
@@ -564,6 +630,67 @@ protected:
   virtual void
   SetMetricSamplePoints();
 
+  /** Write/Read the state of the ongoing registration specific to the
+   * registration method: the transform being optimized and the state of the
+   * optimizer, for this class.  ReadCheckpointState() is called once the
+   * level resumed is initialized. */
+  /** @ITKStartGrouping */
+  virtual void
+  WriteCheckpointState(std::ostream & os) const;
+  virtual void
+  ReadCheckpointState(std::istream & is);
+  /** @ITKEndGrouping */
+
+  /** Throw an exception if the state written by WriteCheckpointState() does
+   * not cover the state of the registration, for this class if the optimizer
+   * is not a plain GradientDescentOptimizerv4Template. */
+  virtual void
+  VerifyCheckpointIsSupported() const;
+
+  /** Restore the state read by ReadCheckpoint(), if any, when the current
+   * level is the level resumed. */
+  void
+  RestoreCheckpoint();
+
+  /** Helpers writing/reading values and arrays to/from the checkpoints. */
+  /** @ITKStartGrouping */
+  template <typename TValue>
+  static void
+  WriteCheckpointValue(std::ostream & os, const TValue & value)
+  {
+    os.write(reinterpret_cast<const char *>(&value), sizeof(TValue));
+  }
+  template <typename TValue>
+  static void
+  ReadCheckpointValue(std::istream & is, TValue & value)
+  {
+    if (!is.read(reinterpret_cast<char *>(&value), sizeof(TValue)))
+    {
+      itkGenericExceptionMacro("The checkpoint is truncated.");
+    }
+  }
+  template <typename TArray>
+  static void
+  WriteCheckpointArray(std::ostream & os, const TArray & array)
+  {
+    const auto size = static_cast<uint64_t>(array.Size());
+    WriteCheckpointValue(os, size);
+    os.write(reinterpret_cast<const char *>(array.data_block()), size * sizeof(typename TArray::ValueType));
+  }
+  template <typename TArray>
+  static void
+  ReadCheckpointArray(std::istream & is, TArray & array)
+  {
+    uint64_t size = 0;
+    ReadCheckpointValue(is, size);
+    array.SetSize(static_cast<SizeValueType>(size));
+    if (!is.read(reinterpret_cast<char *>(array.data_block()), size * sizeof(typename TArray::ValueType)))
+    {
+      itkGenericExceptionMacro("The checkpoint is truncated.");
+    }
+  }
+  /** @ITKEndGrouping */
+
   SizeValueType m_CurrentLevel{};
   SizeValueType m_NumberOfLevels{ 0 };
   SizeValueType m_CurrentIteration{};
@@ -581,6 +708,8 @@ protected:
   SizeValueType                 m_NumberOfFixedObjects{};
   SizeValueType                 m_NumberOfMovingObjects{};
 
+  FixedImagePyramidsContainerType m_FixedImagePyramids{};
+
   OptimizerPointer     m_Optimizer{};
   OptimizerWeightsType m_OptimizerWeights{};
   bool                 m_OptimizerWeightsAreIdentity{};
@@ -607,6 +736,15 @@ protected:
   //      the pipeline
   OutputTransformPointer m_OutputTransform{};
 
+  // The checkpoint read by ReadCheckpoint(), from which the registration
+  // resumes at m_StartLevel.  The random seed is the one of the start of
+  // the level.
+  bool          m_IsResumingFromCheckpoint{ false };
+  SizeValueType m_StartLevel{ 0 };
+  int           m_StartRandomSeed{};
+  std::string   m_CheckpointState{};
+  int           m_CurrentLevelRandomSeed{};
+
 
 private:
   bool m_InPlace{};
@@ -30,6 +30,10 @@
 #include "itkRegistrationParameterScalesFromPhysicalShift.h"
 #include "itkPrintHelper.h"
 
+#include <limits>
+#include <sstream>
+#include <typeinfo>
+
 namespace itk
 {
 
@@ -164,6 +168,37 @@ const typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform,
   return static_cast<const MovingImageType *>(this->ProcessObject::GetInput(2 * index + 1));
 }
 
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::SetFixedImagePyramid(
+  SizeValueType           index,
+  FixedImagePyramidType * pyramid)
+{
+  itkDebugMacro("setting fixed image pyramid " << index << " to " << pyramid);
+  if (index >= this->m_FixedImagePyramids.size())
+  {
+    this->m_FixedImagePyramids.resize(index + 1);
+  }
+  if (this->m_FixedImagePyramids[index] != pyramid)
+  {
+    this->m_FixedImagePyramids[index] = pyramid;
+    this->Modified();
+  }
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+  FixedImagePyramidType *
+  ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::GetFixedImagePyramid(
+    SizeValueType index) const
+{
+  if (index >= this->m_FixedImagePyramids.size())
+  {
+    return nullptr;
+  }
+  return this->m_FixedImagePyramids[index];
+}
+
 template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
 void
 ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::SetFixedPointSet(
@@ -267,9 +302,12 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   // throughout this function if the current enumerated metric type is MULTI_METRIC
   const typename MultiMetricType::Pointer multiMetric = dynamic_cast<MultiMetricType *>(this->m_Metric.GetPointer());
 
+  // The seed of the samples of the level, to resume it from a checkpoint
+  this->m_CurrentLevelRandomSeed = this->m_CurrentRandomSeed;
+
   // Sanity checks and find the virtual domain image
 
-  if (level == 0)
+  if (level == this->m_StartLevel)
   {
     const SizeValueType numberOfObjectPairs = static_cast<unsigned int>(0.5 * this->GetNumberOfIndexedInputs());
     if (numberOfObjectPairs == 0)
@@ -332,7 +370,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
   // Set-up the composite transform at initialization
   // Also, find the virtual domain image
-  if (level == 0)
+  if (level == this->m_StartLevel)
   {
     this->m_CompositeTransform->ClearTransformQueue();
 
@@ -591,7 +629,6 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
       if (this->m_SmoothingSigmasPerLevel[level] > 0)
       {
         using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
-        auto fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
         typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray(
           this->m_SmoothingSigmasPerLevel[level]);
 
@@ -603,12 +640,32 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
             fixedImageSigmaArray[i] *= fixedSpacing[i];
           }
         }
-        fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
-        fixedImageSmoothingFilter->SetInput(this->GetFixedImage(n));
 
-        this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
-        fixedImageSmoothingFilter->Update();
-        fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+        // The smoothed fixed image may be shared with other registrations by its pyramid.
+        FixedImagePyramidType * fixedImagePyramid = this->GetFixedImagePyramid(n);
+        if (fixedImagePyramid)
+        {
+          if (fixedImagePyramid->GetImage() != this->GetFixedImage(n))
+          {
+            itkExceptionMacro("The image of the fixed image pyramid " << n << " is not the fixed image.");
+          }
+          typename FixedImagePyramidType::SigmaArrayType pyramidSigmaArray;
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+            pyramidSigmaArray[i] = fixedImageSigmaArray[i];
+          }
+          this->m_FixedSmoothImages[n] = fixedImagePyramid->GetSmoothedImage(pyramidSigmaArray);
+        }
+        else
+        {
+          auto fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
+          fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
+          fixedImageSmoothingFilter->SetInput(this->GetFixedImage(n));
+
+          this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
+          fixedImageSmoothingFilter->Update();
+          fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+        }
 
         using MovingImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<MovingImageType, MovingImageType>;
         auto movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
@@ -793,13 +850,246 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   // Ensure the same seed is used for each update
   this->m_CurrentRandomSeed = this->m_RandomSeed;
 
-  for (this->m_CurrentLevel = 0; this->m_CurrentLevel < this->m_NumberOfLevels; this->m_CurrentLevel++)
+  if (this->m_IsResumingFromCheckpoint)
+  {
+    if (this->m_StartLevel >= this->m_NumberOfLevels)
+    {
+      itkExceptionStringMacro("The level of the checkpoint is greater than the number of levels.");
+    }
+    this->m_CurrentRandomSeed = this->m_StartRandomSeed;
+  }
+
+  for (this->m_CurrentLevel = this->m_StartLevel; this->m_CurrentLevel < this->m_NumberOfLevels;
+       this->m_CurrentLevel++)
   {
     this->InitializeRegistrationAtEachLevel(this->m_CurrentLevel);
 
+    this->RestoreCheckpoint();
+
     this->m_Metric->Initialize();
 
-    this->m_Optimizer->StartOptimization();
+    if (this->m_CurrentIteration == 0)
+    {
+      this->m_Optimizer->StartOptimization();
+      continue;
+    }
+
+    // The level is resumed from a checkpoint: the optimizer runs the remaining
+    // iterations with the scales and the learning rate restored.
+
+    using GradientDescentOptimizerType = GradientDescentOptimizerv4Template<RealType>;
+    auto * gradientDescentOptimizer = dynamic_cast<GradientDescentOptimizerType *>(this->m_Optimizer.GetPointer());
+
+    const SizeValueType numberOfIterations = this->m_Optimizer->GetNumberOfIterations();
+    const bool          doEstimateScales = this->m_Optimizer->GetDoEstimateScales();
+    const bool          doEstimateLearningRateOnce =
+      gradientDescentOptimizer && gradientDescentOptimizer->GetDoEstimateLearningRateOnce();
+    const auto restoreOptimizer = [&]() {
+      this->m_Optimizer->SetNumberOfIterations(numberOfIterations);
+      this->m_Optimizer->SetDoEstimateScales(doEstimateScales);
+      if (gradientDescentOptimizer)
+      {
+        gradientDescentOptimizer->SetDoEstimateLearningRateOnce(doEstimateLearningRateOnce);
+      }
+    };
+
+    this->m_Optimizer->SetNumberOfIterations(
+      numberOfIterations > this->m_CurrentIteration ? numberOfIterations - this->m_CurrentIteration : 0);
+    this->m_Optimizer->SetDoEstimateScales(false);
+    if (gradientDescentOptimizer)
+    {
+      gradientDescentOptimizer->SetDoEstimateLearningRateOnce(false);
+    }
+    try
+    {
+      this->m_Optimizer->StartOptimization();
+    }
+    catch (...)
+    {
+      restoreOptimizer();
+      throw;
+    }
+    restoreOptimizer();
+  }
+
+  // The registration is complete, and the checkpoint is discarded.
+  this->m_IsResumingFromCheckpoint = false;
+  this->m_StartLevel = 0;
+  this->m_CheckpointState.clear();
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::WriteCheckpoint(
+  std::ostream & os) const
+{
+  this->VerifyCheckpointIsSupported();
+
+  // The state reported to the observers, followed by the state specific to the method
+  std::ostringstream state;
+  WriteCheckpointValue(state, this->m_IsConverged);
+  WriteCheckpointValue(state, this->m_CurrentMetricValue);
+  WriteCheckpointValue(state, this->m_CurrentConvergenceValue);
+  this->WriteCheckpointState(state);
+  const std::string stateString = state.str();
+
+  const std::string className = this->GetNameOfClass();
+  WriteCheckpointValue(os, static_cast<uint64_t>(className.size()));
+  os.write(className.data(), className.size());
+  WriteCheckpointValue(os, uint32_t{ 1 }); // The version of the format
+  WriteCheckpointValue(os, static_cast<uint64_t>(this->m_NumberOfLevels));
+  WriteCheckpointValue(os, static_cast<uint64_t>(this->m_CurrentLevel));
+  WriteCheckpointValue(os, this->m_CurrentLevelRandomSeed);
+  WriteCheckpointValue(os, static_cast<uint64_t>(stateString.size()));
+  os.write(stateString.data(), stateString.size());
+
+  if (!os)
+  {
+    itkExceptionStringMacro("The checkpoint could not be written.");
+  }
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::ReadCheckpoint(
+  std::istream & is)
+{
+  this->VerifyCheckpointIsSupported();
+
+  const auto readString = [&is](std::string & string, uint64_t maximumSize) {
+    uint64_t size = 0;
+    ReadCheckpointValue(is, size);
+    if (size > maximumSize)
+    {
+      itkGenericExceptionMacro("The stream is not a registration checkpoint.");
+    }
+    string.resize(size);
+    if (!is.read(&string[0], size))
+    {
+      itkGenericExceptionMacro("The checkpoint is truncated.");
+    }
+  };
+
+  std::string className;
+  readString(className, 256);
+  if (className != this->GetNameOfClass())
+  {
+    itkExceptionMacro("The checkpoint was written by " << className << ", not by " << this->GetNameOfClass() << '.');
+  }
+  uint32_t version = 0;
+  ReadCheckpointValue(is, version);
+  if (version != 1)
+  {
+    itkExceptionMacro("The version " << version << " of the checkpoint is not supported.");
+  }
+
+  uint64_t numberOfLevels = 0;
+  uint64_t level = 0;
+  int      randomSeed = 0;
+  ReadCheckpointValue(is, numberOfLevels);
+  ReadCheckpointValue(is, level);
+  ReadCheckpointValue(is, randomSeed);
+  if (numberOfLevels != this->m_NumberOfLevels)
+  {
+    itkExceptionMacro("The checkpoint was written by a registration with " << numberOfLevels << " levels, instead of "
+                                                                           << this->m_NumberOfLevels << '.');
+  }
+
+  std::string state;
+  readString(state, std::numeric_limits<uint64_t>::max());
+
+  this->m_IsResumingFromCheckpoint = true;
+  this->m_StartLevel = static_cast<SizeValueType>(level);
+  this->m_StartRandomSeed = randomSeed;
+  this->m_CheckpointState = std::move(state);
+  this->Modified();
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::RestoreCheckpoint()
+{
+  if (!this->m_IsResumingFromCheckpoint || this->m_CurrentLevel != this->m_StartLevel)
+  {
+    return;
+  }
+
+  std::istringstream state(this->m_CheckpointState);
+  ReadCheckpointValue(state, this->m_IsConverged);
+  ReadCheckpointValue(state, this->m_CurrentMetricValue);
+  ReadCheckpointValue(state, this->m_CurrentConvergenceValue);
+  this->ReadCheckpointState(state);
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::WriteCheckpointState(
+  std::ostream & os) const
+{
+  // The transform being optimized
+  WriteCheckpointArray(os, this->m_OutputTransform->GetFixedParameters());
+  WriteCheckpointArray(os, this->m_OutputTransform->GetParameters());
+
+  // The iteration of the optimizer, counted from the start of the level when
+  // the level was resumed, its scales and its learning rate
+  const SizeValueType iteration = this->m_CurrentIteration + this->m_Optimizer->GetCurrentIteration();
+  WriteCheckpointValue(os, static_cast<uint64_t>(iteration));
+  WriteCheckpointArray(os, this->m_Optimizer->GetScales());
+
+  using GradientDescentOptimizerType = GradientDescentOptimizerv4Template<RealType>;
+  const auto * gradientDescentOptimizer =
+    static_cast<const GradientDescentOptimizerType *>(this->m_Optimizer.GetPointer());
+  WriteCheckpointValue(os, gradientDescentOptimizer->GetLearningRate());
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::ReadCheckpointState(
+  std::istream & is)
+{
+  typename OutputTransformType::FixedParametersType fixedParameters;
+  typename OutputTransformType::ParametersType      parameters;
+  ReadCheckpointArray(is, fixedParameters);
+  ReadCheckpointArray(is, parameters);
+
+  this->m_OutputTransform->SetFixedParameters(fixedParameters);
+  if (parameters.Size() != this->m_OutputTransform->GetNumberOfParameters())
+  {
+    itkExceptionStringMacro("The transform of the checkpoint does not match the transform being optimized.");
+  }
+  this->m_OutputTransform->SetParameters(parameters);
+
+  // The iterations run before the checkpoint are skipped at this level.
+  uint64_t iteration = 0;
+  ReadCheckpointValue(is, iteration);
+  this->m_CurrentIteration = static_cast<SizeValueType>(iteration);
+
+  typename OptimizerType::ScalesType scales;
+  ReadCheckpointArray(is, scales);
+  if (scales.Size() > 0)
+  {
+    this->m_Optimizer->SetScales(scales);
+  }
+
+  RealType learningRate{};
+  ReadCheckpointValue(is, learningRate);
+
+  using GradientDescentOptimizerType = GradientDescentOptimizerv4Template<RealType>;
+  static_cast<GradientDescentOptimizerType *>(this->m_Optimizer.GetPointer())->SetLearningRate(learningRate);
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+  VerifyCheckpointIsSupported() const
+{
+  // Only the scales and the learning rate of the optimizer are saved, which is
+  // the whole state of the plain gradient descent only.
+  if (this->m_Optimizer.IsNull() || typeid(*this->m_Optimizer) != typeid(GradientDescentOptimizerv4Template<RealType>))
+  {
+    itkExceptionMacro("Checkpoints are not supported with the optimizer "
+                      << (this->m_Optimizer ? this->m_Optimizer->GetNameOfClass() : "(none)")
+                      << ", only with GradientDescentOptimizerv4Template.");
   }
 }
 
@@ -1123,6 +1413,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   itkPrintSelfBooleanMacro(IsConverged);
 
   os << indent << "FixedSmoothImages: " << m_FixedSmoothImages << std::endl;
+  os << indent << "FixedImagePyramids: " << m_FixedImagePyramids << std::endl;
   os << indent << "MovingSmoothImages: " << m_MovingSmoothImages << std::endl;
   os << indent << "FixedImageMasks: " << m_FixedImageMasks << std::endl;
   os << indent << "MovingImageMasks: " << m_MovingImageMasks << std::endl;
@@ -1164,6 +1455,12 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   itkPrintSelfObjectMacro(CompositeTransform);
   itkPrintSelfObjectMacro(OutputTransform);
 
+  itkPrintSelfBooleanMacro(IsResumingFromCheckpoint);
+  print_helper::PrintNumericTrait(os, indent, "StartLevel", m_StartLevel);
+  os << indent << "StartRandomSeed: " << m_StartRandomSeed << std::endl;
+  os << indent << "CheckpointStateSize: " << m_CheckpointState.size() << std::endl;
+  os << indent << "CurrentLevelRandomSeed: " << m_CurrentLevelRandomSeed << std::endl;
+
   itkPrintSelfBooleanMacro(InPlace);
 
   itkPrintSelfBooleanMacro(InitializeCenterOfLinearOutputTransform);
@@ -0,0 +1,123 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSmoothedImagePyramid_h
+#define itkSmoothedImagePyramid_h
+
+#include "itkObject.h"
+#include "itkFixedArray.h"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class SmoothedImagePyramid
+ * \brief Caches the smoothed versions of an image used by the levels of
+ * multi-resolution registrations.
+ *
+ * At each level, ImageRegistrationMethodv4 smooths its fixed images with a
+ * recursive Gaussian filter whose sigmas are given by the
+ * SmoothingSigmasPerLevel.  When many moving images are registered to the
+ * same fixed image, e.g. an atlas, the same smoothed images are computed
+ * again by each registration.  A pyramid set as the fixed image pyramid of
+ * the registrations computes each smoothed image once, on the first
+ * request, and shares it with the following ones.
+ *
+ * The smoothed images are identified by their sigmas, in physical units,
+ * and are computed with SmoothingRecursiveGaussianImageFilter, so that
+ * they are identical to those computed by the registration itself.  They
+ * are discarded when the image is changed or modified.  The pyramid may be
+ * used by registrations running concurrently.
+ *
+ * \sa ImageRegistrationMethodv4::SetFixedImagePyramid()
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template <typename TImage>
+class ITK_TEMPLATE_EXPORT SmoothedImagePyramid : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SmoothedImagePyramid);
+
+  /** Standard class type aliases. */
+  using Self = SmoothedImagePyramid;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(SmoothedImagePyramid);
+
+  /** Image type alias. */
+  using ImageType = TImage;
+  using ImageConstPointer = typename ImageType::ConstPointer;
+
+  static constexpr unsigned int ImageDimension = ImageType::ImageDimension;
+
+  /** Sigmas of the Gaussian kernel along each dimension, in physical units. */
+  using SigmaArrayType = FixedArray<double, ImageDimension>;
+
+  /** Set/Get the image to smooth.  Setting another image discards the
+   * smoothed images. */
+  /** @ITKStartGrouping */
+  void
+  SetImage(const ImageType * image);
+  itkGetConstObjectMacro(Image, ImageType);
+  /** @ITKEndGrouping */
+
+  /** Get the image smoothed with the given sigmas, computed on the first
+   * request.  A null sigma leaves the image unchanged. */
+  ImageConstPointer
+  GetSmoothedImage(const SigmaArrayType & sigmas);
+
+  /** Discard the smoothed images. */
+  void
+  Clear();
+
+  /** Get the number of smoothed images cached. */
+  SizeValueType
+  GetNumberOfSmoothedImages() const;
+
+protected:
+  SmoothedImagePyramid() = default;
+  ~SmoothedImagePyramid() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ImageConstPointer m_Image{};
+
+  // The modification time of the image when the smoothed images were computed.
+  ModifiedTimeType m_ImageMTime{ 0 };
+
+  std::vector<std::pair<SigmaArrayType, ImageConstPointer>> m_SmoothedImages{};
+
+  mutable std::mutex m_Mutex{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkSmoothedImagePyramid.hxx"
+#endif
+
+#endif
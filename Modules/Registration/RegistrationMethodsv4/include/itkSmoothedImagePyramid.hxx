@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSmoothedImagePyramid_hxx
+#define itkSmoothedImagePyramid_hxx
+
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+
+namespace itk
+{
+
+template <typename TImage>
+void
+SmoothedImagePyramid<TImage>::SetImage(const ImageType * image)
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  if (this->m_Image != image)
+  {
+    this->m_Image = image;
+    this->m_SmoothedImages.clear();
+    this->Modified();
+  }
+}
+
+template <typename TImage>
+auto
+SmoothedImagePyramid<TImage>::GetSmoothedImage(const SigmaArrayType & sigmas) -> ImageConstPointer
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (this->m_Image.IsNull())
+  {
+    itkExceptionStringMacro("The image is not set.");
+  }
+  if (sigmas == SigmaArrayType::Filled(0.0))
+  {
+    return this->m_Image;
+  }
+
+  if (this->m_Image->GetMTime() != this->m_ImageMTime)
+  {
+    this->m_SmoothedImages.clear();
+    this->m_ImageMTime = this->m_Image->GetMTime();
+  }
+  for (const auto & sigmasAndImage : this->m_SmoothedImages)
+  {
+    if (sigmasAndImage.first == sigmas)
+    {
+      return sigmasAndImage.second;
+    }
+  }
+
+  using SmoothingFilterType = SmoothingRecursiveGaussianImageFilter<ImageType, ImageType>;
+  typename SmoothingFilterType::SigmaArrayType sigmaArray;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    sigmaArray[d] = sigmas[d];
+  }
+  auto smoothingFilter = SmoothingFilterType::New();
+  smoothingFilter->SetSigmaArray(sigmaArray);
+  smoothingFilter->SetInput(this->m_Image);
+  smoothingFilter->Update();
+
+  const typename ImageType::Pointer smoothedImage = smoothingFilter->GetOutput();
+  smoothedImage->DisconnectPipeline();
+
+  this->m_SmoothedImages.emplace_back(sigmas, smoothedImage.GetPointer());
+  return smoothedImage.GetPointer();
+}
+
+template <typename TImage>
+void
+SmoothedImagePyramid<TImage>::Clear()
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  this->m_SmoothedImages.clear();
+}
+
+template <typename TImage>
+SizeValueType
+SmoothedImagePyramid<TImage>::GetNumberOfSmoothedImages() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return static_cast<SizeValueType>(this->m_SmoothedImages.size());
+}
+
+template <typename TImage>
+void
+SmoothedImagePyramid<TImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(Image);
+  os << indent << "ImageMTime: " << m_ImageMTime << std::endl;
+  os << indent << "NumberOfSmoothedImages: " << this->GetNumberOfSmoothedImages() << std::endl;
+}
+} // end namespace itk
+
+#endif
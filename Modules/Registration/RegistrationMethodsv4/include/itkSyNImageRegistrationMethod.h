@@ -216,6 +216,27 @@ protected:
   void
   InitializeRegistrationAtEachLevel(const SizeValueType) override;
 
+  /** Write/Read the displacement fields of the transforms to the middle
+   * image, their inverses and the metric values of the current level. */
+  /** @ITKStartGrouping */
+  void
+  WriteCheckpointState(std::ostream & os) const override;
+  void
+  ReadCheckpointState(std::istream & is) override;
+  /** @ITKEndGrouping */
+
+  /** The transforms are optimized by this class, whatever the optimizer. */
+  void
+  VerifyCheckpointIsSupported() const override;
+
+  /** Write/Read a displacement field to/from a checkpoint. */
+  /** @ITKStartGrouping */
+  static void
+  WriteCheckpointDisplacementField(std::ostream & os, const DisplacementFieldType * field);
+  static DisplacementFieldPointer
+  ReadCheckpointDisplacementField(std::istream & is);
+  /** @ITKEndGrouping */
+
   virtual DisplacementFieldPointer
   ComputeUpdateField(const FixedImagesContainerType,
                      const PointSetsContainerType,
@@ -237,6 +258,11 @@ protected:
                              const MovingImageMasksContainerType,
                              MeasureType &);
 
+  /** Subtract the moving to middle update field from the fixed to middle
+   * one, and set the moving to middle update field to its opposite. */
+  void
+  AverageMidPointGradientFields(DisplacementFieldType *, DisplacementFieldType *);
+
   virtual DisplacementFieldPointer
   ScaleUpdateField(const DisplacementFieldType *);
   virtual DisplacementFieldPointer
@@ -256,6 +282,10 @@ protected:
   bool                        m_DownsampleImagesForMetricDerivatives{ true };
   bool                        m_AverageMidPointGradients{ false };
 
+  // The metric values of the iterations of the current level, which resume
+  // the convergence monitoring of a level resumed from a checkpoint.
+  std::vector<RealType> m_CurrentLevelMetricValues{};
+
 private:
   RealType m_GaussianSmoothingVarianceForTheUpdateField{ 3.0 };
   RealType m_GaussianSmoothingVarianceForTheTotalField{ 0.5 };
@@ -22,6 +22,8 @@
 #include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkGaussianOperator.h"
 #include "itkImageMaskSpatialObject.h"
+#include "itkImageRegionRange.h"
+#include "itkImageScanlineIterator.h"
 #include "itkImportImageFilter.h"
 #include "itkInvertDisplacementFieldImageFilter.h"
 #include "itkIterationReporter.h"
@@ -30,6 +32,9 @@
 #include "itkWindowConvergenceMonitoringFunction.h"
 #include "itkPrintHelper.h"
 
+#include <algorithm>
+#include <mutex>
+
 namespace itk
 {
 
@@ -60,7 +65,9 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 {
   Superclass::InitializeRegistrationAtEachLevel(level);
 
-  if (level == 0)
+  this->m_CurrentLevelMetricValues.clear();
+
+  if (level == this->m_StartLevel)
   {
     // If FixedToMiddle and MovingToMiddle transforms are not set already for state restoration
     //
@@ -105,10 +112,10 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
           this->m_MovingToMiddleTransform->GetInverseDisplacementField())
       {
         itkDebugMacro("SyN registration is initialized by restoring the state.");
-        this->m_TransformParametersAdaptorsPerLevel[0]->SetTransform(this->m_MovingToMiddleTransform);
-        this->m_TransformParametersAdaptorsPerLevel[0]->AdaptTransformParameters();
-        this->m_TransformParametersAdaptorsPerLevel[0]->SetTransform(this->m_FixedToMiddleTransform);
-        this->m_TransformParametersAdaptorsPerLevel[0]->AdaptTransformParameters();
+        this->m_TransformParametersAdaptorsPerLevel[level]->SetTransform(this->m_MovingToMiddleTransform);
+        this->m_TransformParametersAdaptorsPerLevel[level]->AdaptTransformParameters();
+        this->m_TransformParametersAdaptorsPerLevel[level]->SetTransform(this->m_FixedToMiddleTransform);
+        this->m_TransformParametersAdaptorsPerLevel[level]->AdaptTransformParameters();
       }
       else
       {
@@ -146,6 +153,10 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   using ConvergenceMonitoringType = itk::Function::WindowConvergenceMonitoringFunction<RealType>;
   auto convergenceMonitoring = ConvergenceMonitoringType::New();
   convergenceMonitoring->SetWindowSize(this->m_ConvergenceWindowSize);
+  for (const RealType metricValue : this->m_CurrentLevelMetricValues)
+  {
+    convergenceMonitoring->AddEnergyValue(metricValue);
+  }
 
   IterationReporter reporter(this, 0, 1);
 
@@ -194,14 +205,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 
     if (this->m_AverageMidPointGradients)
     {
-      for (ImageRegionIteratorWithIndex ItF(fixedToMiddleSmoothUpdateField,
-                                            fixedToMiddleSmoothUpdateField->GetLargestPossibleRegion());
-           !ItF.IsAtEnd();
-           ++ItF)
-      {
-        ItF.Set(ItF.Get() - movingToMiddleSmoothUpdateField->GetPixel(ItF.GetIndex()));
-        movingToMiddleSmoothUpdateField->SetPixel(ItF.GetIndex(), -ItF.Get());
-      }
+      this->AverageMidPointGradientFields(fixedToMiddleSmoothUpdateField, movingToMiddleSmoothUpdateField);
     }
 
     // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
@@ -246,6 +250,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
     this->m_CurrentMetricValue = 0.5 * (movingMetricValue + fixedMetricValue);
 
     convergenceMonitoring->AddEnergyValue(this->m_CurrentMetricValue);
+    this->m_CurrentLevelMetricValues.push_back(this->m_CurrentMetricValue);
     this->m_CurrentConvergenceValue = convergenceMonitoring->GetConvergenceValue();
 
     if (this->m_CurrentConvergenceValue < this->m_ConvergenceThreshold)
@@ -600,15 +605,13 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
 
   // Ensure that the size of the optimizer weights is the same as the
   // number of local transform parameters (=ImageDimension)
+  DisplacementVectorType weights;
+  weights.Fill(1.0);
   if (!this->m_OptimizerWeightsAreIdentity && this->m_OptimizerWeights.Size() == ImageDimension)
   {
-    typename MetricDerivativeType::iterator it;
-    for (it = metricDerivative.begin(); it != metricDerivative.end(); it += ImageDimension)
+    for (unsigned int d = 0; d < ImageDimension; ++d)
     {
-      for (unsigned int d = 0; d < ImageDimension; ++d)
-      {
-        *(it + d) *= this->m_OptimizerWeights[d];
-      }
+      weights[d] = this->m_OptimizerWeights[d];
     }
   }
 
@@ -621,20 +624,57 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   gradientField->SetRegions(virtualDomainImage->GetRequestedRegion());
   gradientField->Allocate();
 
-  SizeValueType count = 0;
-  for (ImageRegionIterator ItG(gradientField, gradientField->GetRequestedRegion()); !ItG.IsAtEnd(); ++ItG)
-  {
-    DisplacementVectorType displacement;
-    for (SizeValueType d = 0; d < ImageDimension; ++d)
-    {
-      displacement[d] = metricDerivative[count++];
-    }
-    ItG.Set(displacement);
-  }
+  // The derivative holds the displacements of the pixels in the order of
+  // the buffer, which are weighted as they are copied.
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    gradientField->GetBufferedRegion(),
+    [&gradientField, &metricDerivative, &weights](const typename DisplacementFieldType::RegionType & region) {
+      for (ImageScanlineIterator ItG(gradientField.GetPointer(), region); !ItG.IsAtEnd(); ItG.NextLine())
+      {
+        SizeValueType count = gradientField->ComputeOffset(ItG.GetIndex()) * ImageDimension;
+        for (; !ItG.IsAtEndOfLine(); ++ItG)
+        {
+          DisplacementVectorType displacement;
+          for (SizeValueType d = 0; d < ImageDimension; ++d)
+          {
+            displacement[d] = metricDerivative[count++] * weights[d];
+          }
+          ItG.Set(displacement);
+        }
+      }
+    },
+    nullptr);
 
   return gradientField;
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  AverageMidPointGradientFields(DisplacementFieldType * fixedToMiddleField, DisplacementFieldType * movingToMiddleField)
+{
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    fixedToMiddleField->GetLargestPossibleRegion(),
+    [fixedToMiddleField, movingToMiddleField](const typename DisplacementFieldType::RegionType & region) {
+      const ImageRegionRange<DisplacementFieldType> fixedToMiddleRange(*fixedToMiddleField, region);
+      const ImageRegionRange<DisplacementFieldType> movingToMiddleRange(*movingToMiddleField, region);
+
+      auto movingToMiddleIt = movingToMiddleRange.begin();
+      for (auto && fixedToMiddleDisplacement : fixedToMiddleRange)
+      {
+        const DisplacementVectorType difference = fixedToMiddleDisplacement - *movingToMiddleIt;
+        fixedToMiddleDisplacement = difference;
+        *movingToMiddleIt = -difference;
+        ++movingToMiddleIt;
+      }
+    },
+    nullptr);
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TOutputTransform,
@@ -647,23 +687,29 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
 {
   typename DisplacementFieldType::SpacingType spacing = updateField->GetSpacing();
 
-  RealType maxNorm = NumericTraits<RealType>::NonpositiveMin();
-  for (ImageRegionConstIterator ItF(updateField, updateField->GetLargestPossibleRegion()); !ItF.IsAtEnd(); ++ItF)
-  {
-    DisplacementVectorType vector = ItF.Get();
+  // The squared norms are compared, and the root taken once.
+  RealType   maxSquaredNorm = NumericTraits<RealType>::NonpositiveMin();
+  std::mutex maxSquaredNormMutex;
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    updateField->GetLargestPossibleRegion(),
+    [updateField, &spacing, &maxSquaredNorm, &maxSquaredNormMutex](
+      const typename DisplacementFieldType::RegionType & region) {
+      RealType regionMaxSquaredNorm = NumericTraits<RealType>::NonpositiveMin();
+      for (const DisplacementVectorType & vector : ImageRegionRange<const DisplacementFieldType>(*updateField, region))
+      {
+        RealType localSquaredNorm = 0;
+        for (SizeValueType d = 0; d < ImageDimension; ++d)
+        {
+          localSquaredNorm += itk::Math::sqr(vector[d] / spacing[d]);
+        }
+        regionMaxSquaredNorm = std::max(regionMaxSquaredNorm, localSquaredNorm);
+      }
 
-    RealType localNorm = 0;
-    for (SizeValueType d = 0; d < ImageDimension; ++d)
-    {
-      localNorm += itk::Math::sqr(vector[d] / spacing[d]);
-    }
-    localNorm = std::sqrt(localNorm);
-
-    if (localNorm > maxNorm)
-    {
-      maxNorm = localNorm;
-    }
-  }
+      const std::lock_guard<std::mutex> lock(maxSquaredNormMutex);
+      maxSquaredNorm = std::max(maxSquaredNorm, regionMaxSquaredNorm);
+    },
+    nullptr);
+  const RealType maxNorm = maxSquaredNorm > RealType{} ? std::sqrt(maxSquaredNorm) : maxSquaredNorm;
 
   RealType scale = this->m_LearningRate;
   if (maxNorm > RealType{})
@@ -778,31 +824,36 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   const RealType weight2 = 1.0 - weight1;
 
   const typename DisplacementFieldType::RegionType region = field->GetLargestPossibleRegion();
-  const typename DisplacementFieldType::SizeType   size = region.GetSize();
   const typename DisplacementFieldType::IndexType  startIndex = region.GetIndex();
+  const typename DisplacementFieldType::IndexType  upperIndex = region.GetUpperIndex();
 
-  ImageRegionIteratorWithIndex ItS(smoothField, smoothField->GetLargestPossibleRegion());
-  for (ImageRegionConstIteratorWithIndex ItF(field, field->GetLargestPossibleRegion()); !ItF.IsAtEnd(); ++ItF, ++ItS)
-  {
-    typename DisplacementFieldType::IndexType index = ItF.GetIndex();
-    bool                                      isOnBoundary = false;
-    for (unsigned int d = 0; d < ImageDimension; ++d)
-    {
-      if (index[d] == startIndex[d] || index[d] == static_cast<IndexValueType>(size[d]) - startIndex[d] - 1)
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [&](const typename DisplacementFieldType::RegionType & subregion) {
+      ImageRegionIteratorWithIndex ItS(smoothField.GetPointer(), subregion);
+      for (ImageRegionConstIterator ItF(field, subregion); !ItF.IsAtEnd(); ++ItF, ++ItS)
       {
-        isOnBoundary = true;
-        break;
+        typename DisplacementFieldType::IndexType index = ItS.GetIndex();
+        bool                                      isOnBoundary = false;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          if (index[d] == startIndex[d] || index[d] == upperIndex[d])
+          {
+            isOnBoundary = true;
+            break;
+          }
+        }
+        if (isOnBoundary)
+        {
+          ItS.Set(zeroVector);
+        }
+        else
+        {
+          ItS.Set(ItS.Get() * weight1 + ItF.Get() * weight2);
+        }
       }
-    }
-    if (isOnBoundary)
-    {
-      ItS.Set(zeroVector);
-    }
-    else
-    {
-      ItS.Set(ItS.Get() * weight1 + ItF.Get() * weight2);
-    }
-  }
+    },
+    nullptr);
 
   return smoothField;
 }
@@ -817,10 +868,22 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 {
   this->AllocateOutputs();
 
-  for (this->m_CurrentLevel = 0; this->m_CurrentLevel < this->m_NumberOfLevels; this->m_CurrentLevel++)
+  if (this->m_IsResumingFromCheckpoint)
+  {
+    if (this->m_StartLevel >= this->m_NumberOfLevels)
+    {
+      itkExceptionStringMacro("The level of the checkpoint is greater than the number of levels.");
+    }
+    this->m_CurrentRandomSeed = this->m_StartRandomSeed;
+  }
+
+  for (this->m_CurrentLevel = this->m_StartLevel; this->m_CurrentLevel < this->m_NumberOfLevels;
+       this->m_CurrentLevel++)
   {
     this->InitializeRegistrationAtEachLevel(this->m_CurrentLevel);
 
+    this->RestoreCheckpoint();
+
     // The base class adds the transform to be optimized at initialization.
     // However, since this class handles its own optimization, we remove it
     // to optimize separately.  We then add it after the optimization loop.
@@ -848,6 +911,123 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   this->m_OutputTransform->SetInverseDisplacementField(inverseComposer->GetOutput());
 
   this->GetTransformOutput()->Set(this->m_OutputTransform);
+
+  // The registration is complete, and the checkpoint is discarded.
+  this->m_IsResumingFromCheckpoint = false;
+  this->m_StartLevel = 0;
+  this->m_CheckpointState.clear();
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  WriteCheckpointState(std::ostream & os) const
+{
+  Superclass::WriteCheckpointValue(os, static_cast<uint64_t>(this->m_CurrentIteration));
+
+  WriteCheckpointDisplacementField(os, this->m_FixedToMiddleTransform->GetDisplacementField());
+  WriteCheckpointDisplacementField(os, this->m_FixedToMiddleTransform->GetInverseDisplacementField());
+  WriteCheckpointDisplacementField(os, this->m_MovingToMiddleTransform->GetDisplacementField());
+  WriteCheckpointDisplacementField(os, this->m_MovingToMiddleTransform->GetInverseDisplacementField());
+
+  Superclass::WriteCheckpointValue(os, static_cast<uint64_t>(this->m_CurrentLevelMetricValues.size()));
+  os.write(reinterpret_cast<const char *>(this->m_CurrentLevelMetricValues.data()),
+           this->m_CurrentLevelMetricValues.size() * sizeof(RealType));
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  ReadCheckpointState(std::istream & is)
+{
+  uint64_t iteration = 0;
+  Superclass::ReadCheckpointValue(is, iteration);
+  this->m_CurrentIteration = static_cast<SizeValueType>(iteration);
+
+  this->m_FixedToMiddleTransform->SetDisplacementField(ReadCheckpointDisplacementField(is));
+  this->m_FixedToMiddleTransform->SetInverseDisplacementField(ReadCheckpointDisplacementField(is));
+  this->m_MovingToMiddleTransform->SetDisplacementField(ReadCheckpointDisplacementField(is));
+  this->m_MovingToMiddleTransform->SetInverseDisplacementField(ReadCheckpointDisplacementField(is));
+
+  uint64_t numberOfMetricValues = 0;
+  Superclass::ReadCheckpointValue(is, numberOfMetricValues);
+  this->m_CurrentLevelMetricValues.resize(numberOfMetricValues);
+  if (!is.read(reinterpret_cast<char *>(this->m_CurrentLevelMetricValues.data()),
+               numberOfMetricValues * sizeof(RealType)))
+  {
+    itkExceptionStringMacro("The checkpoint is truncated.");
+  }
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  VerifyCheckpointIsSupported() const
+{}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  WriteCheckpointDisplacementField(std::ostream & os, const DisplacementFieldType * field)
+{
+  const typename DisplacementFieldType::RegionType & region = field->GetBufferedRegion();
+  Superclass::WriteCheckpointValue(os, region.GetIndex());
+  Superclass::WriteCheckpointValue(os, region.GetSize());
+  Superclass::WriteCheckpointValue(os, field->GetOrigin());
+  Superclass::WriteCheckpointValue(os, field->GetSpacing());
+  Superclass::WriteCheckpointValue(os, field->GetDirection());
+  os.write(reinterpret_cast<const char *>(field->GetBufferPointer()),
+           region.GetNumberOfPixels() * sizeof(typename DisplacementFieldType::PixelType));
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+auto
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  ReadCheckpointDisplacementField(std::istream & is) -> DisplacementFieldPointer
+{
+  typename DisplacementFieldType::IndexType     index;
+  typename DisplacementFieldType::SizeType      size;
+  typename DisplacementFieldType::PointType     origin;
+  typename DisplacementFieldType::SpacingType   spacing;
+  typename DisplacementFieldType::DirectionType direction;
+  Superclass::ReadCheckpointValue(is, index);
+  Superclass::ReadCheckpointValue(is, size);
+  Superclass::ReadCheckpointValue(is, origin);
+  Superclass::ReadCheckpointValue(is, spacing);
+  Superclass::ReadCheckpointValue(is, direction);
+
+  auto field = DisplacementFieldType::New();
+  field->SetRegions(typename DisplacementFieldType::RegionType(index, size));
+  field->SetOrigin(origin);
+  field->SetSpacing(spacing);
+  field->SetDirection(direction);
+  field->Allocate();
+  if (!is.read(reinterpret_cast<char *>(field->GetBufferPointer()),
+               field->GetBufferedRegion().GetNumberOfPixels() * sizeof(typename DisplacementFieldType::PixelType)))
+  {
+    itkGenericExceptionMacro("The checkpoint is truncated.");
+  }
+  return field;
 }
 
 template <typename TFixedImage,
@@ -860,6 +1040,8 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   std::ostream & os,
   Indent         indent) const
 {
+  using namespace print_helper;
+
   Superclass::PrintSelf(os, indent);
 
   print_helper::PrintNumericTrait(os, indent, "LearningRate", this->m_LearningRate);
@@ -872,6 +1054,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
   os << indent << "NumberOfIterationsPerLevel: " << this->m_NumberOfIterationsPerLevel << std::endl;
   os << indent << "DownsampleImagesForMetricDerivatives: " << m_DownsampleImagesForMetricDerivatives << std::endl;
   os << indent << "AverageMidPointGradients: " << m_AverageMidPointGradients << std::endl;
+  os << indent << "CurrentLevelMetricValues: " << m_CurrentLevelMetricValues << std::endl;
   print_helper::PrintNumericTrait(
     os, indent, "GaussianSmoothingVarianceForTheUpdateField", this->m_GaussianSmoothingVarianceForTheUpdateField);
   print_helper::PrintNumericTrait(
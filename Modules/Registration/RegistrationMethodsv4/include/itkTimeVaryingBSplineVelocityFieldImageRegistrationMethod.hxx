@@ -823,6 +823,10 @@ TimeVaryingBSplineVelocityFieldImageRegistrationMethod<TFixedImage,
                                                        TVirtualImage,
                                                        TPointSet>::GenerateData()
 {
+  if (this->m_IsResumingFromCheckpoint)
+  {
+    itkExceptionStringMacro("Resuming the registration from a checkpoint is not supported.");
+  }
 
   this->AllocateOutputs();
 
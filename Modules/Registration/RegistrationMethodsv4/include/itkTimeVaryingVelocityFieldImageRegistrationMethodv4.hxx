@@ -410,6 +410,10 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage,
                                                   TVirtualImage,
                                                   TPointSet>::GenerateData()
 {
+  if (this->m_IsResumingFromCheckpoint)
+  {
+    itkExceptionStringMacro("Resuming the registration from a checkpoint is not supported.");
+  }
 
   this->AllocateOutputs();
 
@@ -0,0 +1,341 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Checks that registrations interrupted after writing a checkpoint, and
+// resumed from it by other registrations, end as uninterrupted ones, and
+// that the registrations sharing a fixed image pyramid end as those which
+// smooth their fixed image themselves.
+
+#include "itkAffineTransform.h"
+#include "itkDisplacementFieldTransformParametersAdaptor.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkRegularStepGradientDescentOptimizerv4.h"
+#include "itkImageBufferRange.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegistrationMethodv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using AffineTransformType = itk::AffineTransform<double, Dimension>;
+using AffineRegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, AffineTransformType>;
+using SyNType = itk::SyNImageRegistrationMethod<ImageType, ImageType>;
+using FieldType = SyNType::DisplacementFieldType;
+
+constexpr itk::SizeValueType imageSize = 48;
+
+// An elliptic Gaussian blob of a sixth of the size, centered at the given
+// fraction of the size.
+ImageType::Pointer
+MakeBlob(double centerX, double centerY, double elongation)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(imageSize));
+  image->Allocate();
+  const double sigma = imageSize / 6.0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const double x = (it.GetIndex()[0] - centerX * imageSize) / elongation;
+    const double y = it.GetIndex()[1] - centerY * imageSize;
+    it.Set(100.0 * std::exp(-(x * x + y * y) / (2.0 * sigma * sigma)));
+  }
+  return image;
+}
+
+// An affine registration in two levels, whose optimizer estimates its scales
+// and its learning rate at the start of each level, and which samples the
+// metric randomly.
+AffineRegistrationType::Pointer
+MakeAffineRegistration(const ImageType * fixedImage, const ImageType * movingImage)
+{
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  auto metric = MetricType::New();
+
+  auto scalesEstimator = itk::RegistrationParameterScalesFromPhysicalShift<MetricType>::New();
+  scalesEstimator->SetMetric(metric);
+  scalesEstimator->SetTransformForward(true);
+
+  auto optimizer = itk::GradientDescentOptimizerv4::New();
+  optimizer->SetNumberOfIterations(20);
+  optimizer->SetScalesEstimator(scalesEstimator);
+  optimizer->SetDoEstimateLearningRateOnce(true);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(false);
+  optimizer->SetMaximumStepSizeInPhysicalUnits(0.5);
+
+  AffineRegistrationType::ShrinkFactorsArrayType shrinkFactorsPerLevel(2);
+  shrinkFactorsPerLevel[0] = 2;
+  shrinkFactorsPerLevel[1] = 1;
+  AffineRegistrationType::SmoothingSigmasArrayType smoothingSigmasPerLevel(2);
+  smoothingSigmasPerLevel[0] = 2.0;
+  smoothingSigmasPerLevel[1] = 1.0;
+
+  auto registration = AffineRegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetNumberOfLevels(2);
+  registration->SetShrinkFactorsPerLevel(shrinkFactorsPerLevel);
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmasPerLevel);
+  registration->SetMetricSamplingStrategy(AffineRegistrationType::MetricSamplingStrategyEnum::RANDOM);
+  registration->SetMetricSamplingPercentage(0.5);
+  registration->MetricSamplingReinitializeSeed(1234);
+  return registration;
+}
+
+// A SyN registration in two levels, whose convergence is monitored over a
+// window shorter than the levels.
+SyNType::Pointer
+MakeSyNRegistration(const ImageType * fixedImage, const ImageType * movingImage)
+{
+  SyNType::ShrinkFactorsArrayType shrinkFactorsPerLevel(2);
+  shrinkFactorsPerLevel[0] = 2;
+  shrinkFactorsPerLevel[1] = 1;
+  SyNType::SmoothingSigmasArrayType smoothingSigmasPerLevel(2);
+  smoothingSigmasPerLevel[0] = 1.0;
+  smoothingSigmasPerLevel[1] = 0.0;
+  SyNType::NumberOfIterationsArrayType numberOfIterationsPerLevel(2);
+  numberOfIterationsPerLevel.Fill(12);
+
+  auto registration = SyNType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>::New());
+  registration->SetNumberOfLevels(2);
+  registration->SetShrinkFactorsPerLevel(shrinkFactorsPerLevel);
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmasPerLevel);
+  registration->SetNumberOfIterationsPerLevel(numberOfIterationsPerLevel);
+  registration->SetConvergenceWindowSize(4);
+  registration->SetConvergenceThreshold(1.0e-2);
+
+  // The displacement fields are resampled to the virtual domain of each level.
+  SyNType::TransformParametersAdaptorsContainerType adaptors;
+  for (unsigned int level = 0; level < 2; ++level)
+  {
+    using ShrinkFilterType = itk::ShrinkImageFilter<ImageType, ImageType>;
+    auto shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors(shrinkFactorsPerLevel[level]);
+    shrinkFilter->SetInput(fixedImage);
+    shrinkFilter->Update();
+
+    auto adaptor = itk::DisplacementFieldTransformParametersAdaptor<SyNType::OutputTransformType>::New();
+    adaptor->SetRequiredSpacing(shrinkFilter->GetOutput()->GetSpacing());
+    adaptor->SetRequiredSize(shrinkFilter->GetOutput()->GetBufferedRegion().GetSize());
+    adaptor->SetRequiredDirection(shrinkFilter->GetOutput()->GetDirection());
+    adaptor->SetRequiredOrigin(shrinkFilter->GetOutput()->GetOrigin());
+    adaptors.push_back(adaptor);
+  }
+  registration->SetTransformParametersAdaptorsPerLevel(adaptors);
+
+  auto field = FieldType::New();
+  field->CopyInformation(fixedImage);
+  field->SetRegions(fixedImage->GetBufferedRegion());
+  field->AllocateInitialized();
+  auto outputTransform = SyNType::OutputTransformType::New();
+  outputTransform->SetDisplacementField(field);
+  registration->SetInitialTransform(outputTransform);
+  registration->InPlaceOn();
+  return registration;
+}
+
+double
+MaximumDifference(const FieldType * field1, const FieldType * field2)
+{
+  const auto range1 = itk::MakeImageBufferRange(field1);
+  const auto range2 = itk::MakeImageBufferRange(field2);
+  if (range1.size() != range2.size())
+  {
+    return itk::NumericTraits<double>::max();
+  }
+  double difference = 0.0;
+  for (auto it1 = range1.cbegin(), it2 = range2.cbegin(); it1 != range1.cend(); ++it1, ++it2)
+  {
+    difference = std::max(difference, (*it1 - *it2).GetNorm());
+  }
+  return difference;
+}
+
+double
+MaximumDifference(const AffineTransformType::ParametersType & parameters1,
+                  const AffineTransformType::ParametersType & parameters2)
+{
+  double difference = 0.0;
+  for (unsigned int i = 0; i < parameters1.Size(); ++i)
+  {
+    difference = std::max(difference, std::abs(parameters1[i] - parameters2[i]));
+  }
+  return difference;
+}
+} // namespace
+
+int
+itkImageRegistrationCheckpointTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeBlob(0.5, 0.5, 1.0);
+  const ImageType::Pointer movingImage = MakeBlob(0.55, 0.45, 1.2);
+
+  bool ok = true;
+
+  // An affine registration interrupted at the 8th iteration of its second
+  // level, and resumed from its checkpoint.
+  {
+    const AffineRegistrationType::Pointer reference = MakeAffineRegistration(fixedImage, movingImage);
+    reference->Update();
+    const AffineTransformType::ParametersType referenceParameters = reference->GetTransform()->GetParameters();
+
+    const AffineRegistrationType::Pointer interrupted = MakeAffineRegistration(fixedImage, movingImage);
+    std::stringstream                     checkpoint;
+    interrupted->GetOptimizer()->AddObserver(itk::IterationEvent(), [&](const itk::EventObject &) {
+      if (interrupted->GetCurrentLevel() == 1 && interrupted->GetOptimizer()->GetCurrentIteration() == 7)
+      {
+        interrupted->WriteCheckpoint(checkpoint);
+        throw itk::ExceptionObject(__FILE__, __LINE__, "Interrupted");
+      }
+    });
+    ITK_TRY_EXPECT_EXCEPTION(interrupted->Update());
+
+    const AffineRegistrationType::Pointer resumed = MakeAffineRegistration(fixedImage, movingImage);
+    unsigned int                          numberOfIterations = 0;
+    resumed->GetOptimizer()->AddObserver(itk::IterationEvent(),
+                                         [&numberOfIterations](const itk::EventObject &) { ++numberOfIterations; });
+    ITK_TRY_EXPECT_NO_EXCEPTION(resumed->ReadCheckpoint(checkpoint));
+    ITK_TRY_EXPECT_NO_EXCEPTION(resumed->Update());
+    ITK_TEST_EXPECT_EQUAL(numberOfIterations, 20 - 7);
+
+    const double difference = MaximumDifference(resumed->GetTransform()->GetParameters(), referenceParameters);
+    std::cout << "Affine: maximum difference to the uninterrupted registration: " << difference << std::endl;
+    if (difference > 1e-9)
+    {
+      std::cerr << "Error: the resumed affine registration differs from the uninterrupted one" << std::endl;
+      ok = false;
+    }
+
+    // The checkpoint is discarded once the registration is complete.
+    resumed->Modified();
+    resumed->Update();
+    ITK_TEST_EXPECT_EQUAL(numberOfIterations, 20 - 7 + 2 * 20);
+
+    // A checkpoint is read only by the registration method which wrote it.
+    checkpoint.seekg(0);
+    ITK_TRY_EXPECT_EXCEPTION(SyNType::New()->ReadCheckpoint(checkpoint));
+
+    // The state of an optimizer other than the plain gradient descent is not
+    // saved.
+    const AffineRegistrationType::Pointer regularStep = MakeAffineRegistration(fixedImage, movingImage);
+    regularStep->SetOptimizer(itk::RegularStepGradientDescentOptimizerv4<double>::New());
+    std::stringstream regularStepCheckpoint;
+    ITK_TRY_EXPECT_EXCEPTION(regularStep->WriteCheckpoint(regularStepCheckpoint));
+    checkpoint.seekg(0);
+    ITK_TRY_EXPECT_EXCEPTION(regularStep->ReadCheckpoint(checkpoint));
+  }
+
+  // A SyN registration interrupted at the 5th iteration of its second level,
+  // and resumed from its checkpoint.
+  {
+    const SyNType::Pointer reference = MakeSyNRegistration(fixedImage, movingImage);
+    reference->Update();
+    const FieldType * referenceField = reference->GetTransform()->GetDisplacementField();
+
+    const SyNType::Pointer interrupted = MakeSyNRegistration(fixedImage, movingImage);
+    std::stringstream      checkpoint;
+    interrupted->AddObserver(itk::IterationEvent(), [&](const itk::EventObject &) {
+      if (interrupted->GetCurrentLevel() == 1 && interrupted->GetCurrentIteration() == 5)
+      {
+        interrupted->WriteCheckpoint(checkpoint);
+        throw itk::ExceptionObject(__FILE__, __LINE__, "Interrupted");
+      }
+    });
+    ITK_TRY_EXPECT_EXCEPTION(interrupted->Update());
+
+    const SyNType::Pointer resumed = MakeSyNRegistration(fixedImage, movingImage);
+    ITK_TRY_EXPECT_NO_EXCEPTION(resumed->ReadCheckpoint(checkpoint));
+    ITK_TRY_EXPECT_NO_EXCEPTION(resumed->Update());
+    std::cout << "SyN: iterations of the last level: " << reference->GetCurrentIteration() << std::endl;
+    ITK_TEST_EXPECT_EQUAL(resumed->GetCurrentIteration(), reference->GetCurrentIteration());
+
+    const double difference = MaximumDifference(resumed->GetTransform()->GetDisplacementField(), referenceField);
+    std::cout << "SyN: maximum difference to the uninterrupted registration: " << difference << std::endl;
+    if (difference > 1e-9)
+    {
+      std::cerr << "Error: the resumed SyN registration differs from the uninterrupted one" << std::endl;
+      ok = false;
+    }
+  }
+
+  // Registrations of two moving images to a fixed image whose pyramid is
+  // shared.
+  {
+    auto pyramid = AffineRegistrationType::FixedImagePyramidType::New();
+    ITK_EXERCISE_BASIC_OBJECT_METHODS(pyramid, SmoothedImagePyramid, Object);
+    pyramid->SetImage(fixedImage);
+
+    for (const double elongation : { 1.2, 0.8 })
+    {
+      const ImageType::Pointer otherMovingImage = MakeBlob(0.55, 0.45, elongation);
+
+      const AffineRegistrationType::Pointer reference = MakeAffineRegistration(fixedImage, otherMovingImage);
+      reference->Update();
+
+      const AffineRegistrationType::Pointer registration = MakeAffineRegistration(fixedImage, otherMovingImage);
+      registration->SetFixedImagePyramid(pyramid);
+      ITK_TEST_SET_GET_VALUE(pyramid.GetPointer(), registration->GetFixedImagePyramid());
+      registration->Update();
+
+      const double difference = MaximumDifference(registration->GetTransform()->GetParameters(),
+                                                  reference->GetTransform()->GetParameters());
+      std::cout << "Pyramid: maximum difference to the registration without pyramid: " << difference << std::endl;
+      if (difference > 1e-9)
+      {
+        std::cerr << "Error: the registration with a pyramid differs from the one without" << std::endl;
+        ok = false;
+      }
+      ITK_TEST_EXPECT_EQUAL(pyramid->GetNumberOfSmoothedImages(), 2);
+    }
+
+    // The smoothed images are computed once, and discarded when the image is modified.
+    AffineRegistrationType::FixedImagePyramidType::SigmaArrayType sigmas;
+    sigmas.Fill(2.0);
+    const ImageType::ConstPointer smoothedImage = pyramid->GetSmoothedImage(sigmas);
+    ITK_TEST_EXPECT_TRUE(pyramid->GetSmoothedImage(sigmas) == smoothedImage);
+    fixedImage->Modified();
+    ITK_TEST_EXPECT_TRUE(pyramid->GetSmoothedImage(sigmas) != smoothedImage);
+    ITK_TEST_EXPECT_EQUAL(pyramid->GetNumberOfSmoothedImages(), 1);
+    pyramid->Clear();
+    ITK_TEST_EXPECT_EQUAL(pyramid->GetNumberOfSmoothedImages(), 0);
+
+    // The image of the pyramid must be the fixed image.
+    const AffineRegistrationType::Pointer registration = MakeAffineRegistration(movingImage, fixedImage);
+    registration->SetFixedImagePyramid(pyramid);
+    ITK_TRY_EXPECT_EXCEPTION(registration->Update());
+  }
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compares the time SyNImageRegistrationMethod and
+// BSplineSyNImageRegistrationMethod take to register two 3D images of a
+// shifted blob, with 1, 2, 4, ... threads up to the default number of
+// threads, or to the given maximum. The displacement fields obtained with
+// more threads are checked against those obtained with one.
+//
+// The benchmark is built into ITKRegistrationMethodsv4TestDriver but, like
+// the ones of the PerformanceBenchmarking remote module, not registered as a
+// test; itkSyNImageRegistrationMultiThreadingTest checks the fields against
+// the single-threaded ones. Run it as
+//   ITKRegistrationMethodsv4TestDriver itkSyNImageRegistrationMethodBenchmark
+//     size [iterations] [maximumNumberOfThreads]
+// e.g. a size of 128 benchmarks 128^3 images.
+
+#include "itkBSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor.h"
+#include "itkBSplineSyNImageRegistrationMethod.h"
+#include "itkImageBufferRange.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FieldType = itk::Image<itk::Vector<double, Dimension>, Dimension>;
+
+// A Gaussian blob of a sixth of the size, centered at the given fraction of
+// the size.
+ImageType::Pointer
+MakeBlob(itk::SizeValueType size, double center)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  const double sigma = size / 6.0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    double squaredDistance = 0.0;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      squaredDistance += itk::Math::sqr(it.GetIndex()[d] - center * size);
+    }
+    it.Set(100.0 * std::exp(-squaredDistance / (2.0 * sigma * sigma)));
+  }
+  return image;
+}
+
+FieldType::Pointer
+MakeZeroField(const ImageType * image)
+{
+  auto field = FieldType::New();
+  field->CopyInformation(image);
+  field->SetRegions(image->GetBufferedRegion());
+  field->AllocateInitialized();
+  return field;
+}
+
+// Registers the images with the method, and returns the displacement field
+// of its output transform.
+template <typename TRegistration>
+FieldType::Pointer
+Register(TRegistration *                                         registration,
+         const ImageType *                                       fixedImage,
+         const ImageType *                                       movingImage,
+         unsigned int                                            iterations,
+         typename TRegistration::TransformParametersAdaptorsContainerType adaptors = {})
+{
+  auto outputTransform = TRegistration::OutputTransformType::New();
+  outputTransform->SetDisplacementField(MakeZeroField(fixedImage));
+  outputTransform->SetInverseDisplacementField(MakeZeroField(fixedImage));
+
+  typename TRegistration::ShrinkFactorsArrayType shrinkFactorsPerLevel(1);
+  shrinkFactorsPerLevel.Fill(1);
+  typename TRegistration::SmoothingSigmasArrayType smoothingSigmasPerLevel(1);
+  smoothingSigmasPerLevel.Fill(0.0);
+  typename TRegistration::NumberOfIterationsArrayType numberOfIterationsPerLevel(1);
+  numberOfIterationsPerLevel.Fill(iterations);
+
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>::New());
+  registration->SetNumberOfLevels(1);
+  registration->SetShrinkFactorsPerLevel(shrinkFactorsPerLevel);
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmasPerLevel);
+  registration->SetNumberOfIterationsPerLevel(numberOfIterationsPerLevel);
+  if (!adaptors.empty())
+  {
+    registration->SetTransformParametersAdaptorsPerLevel(adaptors);
+  }
+  registration->SetConvergenceThreshold(0.0);
+  registration->SetAverageMidPointGradients(true);
+  registration->SetInitialTransform(outputTransform);
+  registration->InPlaceOn();
+  registration->Update();
+
+  return outputTransform->GetModifiableDisplacementField();
+}
+
+double
+MaximumDifference(const FieldType * field1, const FieldType * field2)
+{
+  const auto range1 = itk::MakeImageBufferRange(field1);
+  const auto range2 = itk::MakeImageBufferRange(field2);
+  double     difference = 0.0;
+  for (auto it1 = range1.cbegin(), it2 = range2.cbegin(); it1 != range1.cend(); ++it1, ++it2)
+  {
+    difference = std::max(difference, (*it1 - *it2).GetNorm());
+  }
+  return difference;
+}
+} // namespace
+
+int
+itkSyNImageRegistrationMethodBenchmark(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv)
+              << " size [iterations] [maximumNumberOfThreads]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto         size = static_cast<itk::SizeValueType>(std::stoul(argv[1]));
+  const unsigned int iterations = argc > 2 ? std::stoi(argv[2]) : 10;
+  const unsigned int defaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  const unsigned int maximumNumberOfThreads = argc > 3 ? std::stoi(argv[3]) : defaultNumberOfThreads;
+
+  const ImageType::Pointer fixedImage = MakeBlob(size, 0.5);
+  const ImageType::Pointer movingImage = MakeBlob(size, 0.55);
+
+  using SyNType = itk::SyNImageRegistrationMethod<ImageType, ImageType>;
+  using BSplineTransformType = itk::BSplineSmoothingOnUpdateDisplacementFieldTransform<double, Dimension>;
+  using BSplineSyNType = itk::BSplineSyNImageRegistrationMethod<ImageType, ImageType, BSplineTransformType>;
+
+  // The update field is fitted by cubic B-splines on a mesh of 8 elements,
+  // and the total field is not smoothed.
+  auto adaptor = itk::BSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor<BSplineTransformType>::New();
+  adaptor->SetRequiredSpacing(fixedImage->GetSpacing());
+  adaptor->SetRequiredSize(fixedImage->GetBufferedRegion().GetSize());
+  adaptor->SetRequiredDirection(fixedImage->GetDirection());
+  adaptor->SetRequiredOrigin(fixedImage->GetOrigin());
+  adaptor->SetNumberOfControlPointsForTheUpdateField(itk::MakeFilled<BSplineTransformType::ArrayType>(8 + 3));
+  const BSplineSyNType::TransformParametersAdaptorsContainerType bsplineAdaptors(1, adaptor.GetPointer());
+
+  itk::TimeProbesCollectorBase collector;
+  bool                         ok = true;
+  FieldType::Pointer           singleThreadedFields[2];
+  for (unsigned int numberOfThreads = 1; numberOfThreads <= maximumNumberOfThreads; numberOfThreads *= 2)
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+    const std::string label = std::to_string(numberOfThreads) + " threads";
+
+    FieldType::Pointer fields[2];
+
+    collector.Start(("SyN " + label).c_str());
+    fields[0] = Register(SyNType::New().GetPointer(), fixedImage, movingImage, iterations);
+    collector.Stop(("SyN " + label).c_str());
+
+    collector.Start(("BSplineSyN " + label).c_str());
+    fields[1] = Register(BSplineSyNType::New().GetPointer(), fixedImage, movingImage, iterations, bsplineAdaptors);
+    collector.Stop(("BSplineSyN " + label).c_str());
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      if (numberOfThreads == 1)
+      {
+        singleThreadedFields[i] = fields[i];
+        continue;
+      }
+      const double difference = MaximumDifference(fields[i], singleThreadedFields[i]);
+      std::cout << (i == 0 ? "SyN " : "BSplineSyN ") << label
+                << " maximum difference to the single-threaded displacement field: " << difference << std::endl;
+      if (difference > 1e-3)
+      {
+        std::cerr << "Error: " << label << " displacement fields differ" << std::endl;
+        ok = false;
+      }
+    }
+  }
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(defaultNumberOfThreads);
+
+  collector.Report(std::cout);
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Registers two 3D images of a shifted blob with SyNImageRegistrationMethod
+// and BSplineSyNImageRegistrationMethod, with one thread and with several,
+// and checks that the displacement fields do not depend on the number of
+// threads.
+
+#include "itkBSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor.h"
+#include "itkBSplineSyNImageRegistrationMethod.h"
+#include "itkImageBufferRange.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FieldType = itk::Image<itk::Vector<double, Dimension>, Dimension>;
+
+// A Gaussian blob of a sixth of the size, centered at the given fraction of
+// the size.
+ImageType::Pointer
+MakeBlob(itk::SizeValueType size, double center)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  const double sigma = size / 6.0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    double squaredDistance = 0.0;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      squaredDistance += itk::Math::sqr(it.GetIndex()[d] - center * size);
+    }
+    it.Set(100.0 * std::exp(-squaredDistance / (2.0 * sigma * sigma)));
+  }
+  return image;
+}
+
+FieldType::Pointer
+MakeZeroField(const ImageType * image)
+{
+  auto field = FieldType::New();
+  field->CopyInformation(image);
+  field->SetRegions(image->GetBufferedRegion());
+  field->AllocateInitialized();
+  return field;
+}
+
+// Registers the images with the method, and returns the displacement field
+// of its output transform.
+template <typename TRegistration>
+FieldType::Pointer
+Register(TRegistration *                                                  registration,
+         const ImageType *                                                fixedImage,
+         const ImageType *                                                movingImage,
+         typename TRegistration::TransformParametersAdaptorsContainerType adaptors = {})
+{
+  auto outputTransform = TRegistration::OutputTransformType::New();
+  outputTransform->SetDisplacementField(MakeZeroField(fixedImage));
+  outputTransform->SetInverseDisplacementField(MakeZeroField(fixedImage));
+
+  typename TRegistration::ShrinkFactorsArrayType shrinkFactorsPerLevel(1);
+  shrinkFactorsPerLevel.Fill(1);
+  typename TRegistration::SmoothingSigmasArrayType smoothingSigmasPerLevel(1);
+  smoothingSigmasPerLevel.Fill(0.0);
+  typename TRegistration::NumberOfIterationsArrayType numberOfIterationsPerLevel(1);
+  numberOfIterationsPerLevel.Fill(4);
+
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>::New());
+  registration->SetNumberOfLevels(1);
+  registration->SetShrinkFactorsPerLevel(shrinkFactorsPerLevel);
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmasPerLevel);
+  registration->SetNumberOfIterationsPerLevel(numberOfIterationsPerLevel);
+  if (!adaptors.empty())
+  {
+    registration->SetTransformParametersAdaptorsPerLevel(adaptors);
+  }
+  registration->SetConvergenceThreshold(0.0);
+  registration->SetAverageMidPointGradients(true);
+  registration->SetInitialTransform(outputTransform);
+  registration->InPlaceOn();
+  registration->Update();
+
+  return outputTransform->GetModifiableDisplacementField();
+}
+
+// Returns the maximum norm of the displacements of the field, and of their
+// differences to the ones of the reference field.
+std::pair<double, double>
+MaximumNormAndDifference(const FieldType * field, const FieldType * reference)
+{
+  const auto range = itk::MakeImageBufferRange(field);
+  const auto referenceRange = itk::MakeImageBufferRange(reference);
+  double     norm = 0.0;
+  double     difference = 0.0;
+  for (auto it = range.cbegin(), referenceIt = referenceRange.cbegin(); it != range.cend(); ++it, ++referenceIt)
+  {
+    norm = std::max(norm, it->GetNorm());
+    difference = std::max(difference, (*it - *referenceIt).GetNorm());
+  }
+  return { norm, difference };
+}
+} // namespace
+
+int
+itkSyNImageRegistrationMultiThreadingTest(int, char *[])
+{
+  constexpr itk::SizeValueType size = 20;
+  const ImageType::Pointer     fixedImage = MakeBlob(size, 0.5);
+  const ImageType::Pointer     movingImage = MakeBlob(size, 0.55);
+
+  using SyNType = itk::SyNImageRegistrationMethod<ImageType, ImageType>;
+  using BSplineTransformType = itk::BSplineSmoothingOnUpdateDisplacementFieldTransform<double, Dimension>;
+  using BSplineSyNType = itk::BSplineSyNImageRegistrationMethod<ImageType, ImageType, BSplineTransformType>;
+
+  // The update field is fitted by cubic B-splines on a mesh of 4 elements,
+  // and the total field is not smoothed.
+  auto adaptor = itk::BSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor<BSplineTransformType>::New();
+  adaptor->SetRequiredSpacing(fixedImage->GetSpacing());
+  adaptor->SetRequiredSize(fixedImage->GetBufferedRegion().GetSize());
+  adaptor->SetRequiredDirection(fixedImage->GetDirection());
+  adaptor->SetRequiredOrigin(fixedImage->GetOrigin());
+  adaptor->SetNumberOfControlPointsForTheUpdateField(itk::MakeFilled<BSplineTransformType::ArrayType>(4 + 3));
+  const BSplineSyNType::TransformParametersAdaptorsContainerType bsplineAdaptors(1, adaptor.GetPointer());
+
+  const unsigned int defaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  FieldType::Pointer fields[2][2];
+  for (const unsigned int numberOfThreads : { 1, 4 })
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+    const unsigned int run = numberOfThreads > 1;
+    fields[run][0] = Register(SyNType::New().GetPointer(), fixedImage, movingImage);
+    fields[run][1] = Register(BSplineSyNType::New().GetPointer(), fixedImage, movingImage, bsplineAdaptors);
+  }
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(defaultNumberOfThreads);
+
+  bool ok = true;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    const auto [norm, difference] = MaximumNormAndDifference(fields[1][i], fields[0][i]);
+    std::cout << (i == 0 ? "SyN" : "BSplineSyN") << ": maximum displacement " << norm
+              << ", maximum difference to the single-threaded displacement field " << difference << std::endl;
+    if (norm == 0.0 || difference > 1e-6 * norm)
+    {
+      std::cerr << "Error: " << (i == 0 ? "SyN" : "BSplineSyN")
+                << " displacement fields are null or depend on the number of threads" << std::endl;
+      ok = false;
+    }
+  }
+
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}